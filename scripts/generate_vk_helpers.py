@@ -62,6 +62,7 @@ def get_device_cmds():
         Cmd("vkCmdSetScissor"),
         Cmd("vkCmdSetViewport"),
         Cmd("vkCmdClearColorImage"),
+        Cmd("vkCmdClearDepthStencilImage"),
         Cmd("vkCmdEndRenderPass"),
         Cmd("vkCmdBindDescriptorSets"),
         Cmd("vkCmdBindPipeline"),
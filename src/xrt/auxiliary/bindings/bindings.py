@@ -325,6 +325,21 @@ class Bindings:
         self.profiles = [Profile(profile_name, json_profile) for
                          profile_name, json_profile in json_root["profiles"].items()]
 
+        # Every path string used by the templates, sorted and deduplicated,
+        # the templates refer to paths by their index into this list.
+        paths = set()
+        for profile in self.profiles:
+            paths.add(profile.name)
+            for component in profile.components:
+                paths.add(component.subaction_path)
+                paths.update(component.get_full_openxr_paths())
+            for identifier in profile.identifiers:
+                if identifier.dpad:
+                    paths.add(identifier.subaction_path)
+                    paths.update(identifier.dpad.paths)
+        self.paths = sorted(paths)
+        self.path_indices = {path: idx for idx, path in enumerate(self.paths)}
+
 
 header = '''// Copyright 2020-2022, Collabora, Ltd.
 // SPDX-License-Identifier: BSL-1.0
@@ -363,6 +378,15 @@ def write_verify_func(f, name, dict_of_lists):
     f.write("\tdefault:\n\t\treturn false;\n\t}\n}\n")
 
 
+def write_path_indices(f, indent, p, paths):
+    """Write the indices into the path table and count for a list of paths."""
+    f.write(f'{indent}.path_indices = {{ ')
+    for path in paths:
+        f.write(f'{p.path_indices[path]}, ')
+    f.write('},\n')
+    f.write(f'{indent}.path_count = {len(paths)},\n')
+
+
 def generate_bindings_c(file, p):
     """Generate the file to verify subpaths on a interaction profile."""
     f = open(file, "w")
@@ -382,6 +406,11 @@ def generate_bindings_c(file, p):
         name = "oxr_verify_" + profile.validation_func_name + "_dpad_emulator"
         write_verify_func(f, name, profile.dpad_emulators_by_length)
 
+    f.write(f'\n\nconst struct binding_path binding_paths[NUM_BINDING_PATHS] = {{ // array of binding_path\n')
+    for idx, path in enumerate(p.paths):
+        f.write(f'\t{{ "{path}", {len(path)} }}, // {idx}\n')
+    f.write('}; // /array of binding_path\n')
+
     f.write(
         f'\n\nstruct profile_template profile_templates[{len(p.profiles)}] = {{ // array of profile_template\n')
     for profile in p.profiles:
@@ -394,6 +423,7 @@ def generate_bindings_c(file, p):
         f.write(f'\t{{ // profile_template\n')
         f.write(f'\t\t.name = {profile.monado_device_enum},\n')
         f.write(f'\t\t.path = "{profile.name}",\n')
+        f.write(f'\t\t.path_index = {p.path_indices[profile.name]},\n')
         f.write(f'\t\t.localized_name = "{profile.localized_name}",\n')
         f.write(f'\t\t.steamvr_input_profile_path = "{fname}",\n')
         f.write(f'\t\t.steamvr_controller_type = "{controller_type}",\n')
@@ -410,6 +440,7 @@ def generate_bindings_c(file, p):
 
             f.write(f'\t\t\t{{ // binding_template {idx}\n')
             f.write(f'\t\t\t\t.subaction_path = "{component.subaction_path}",\n')
+            f.write(f'\t\t\t\t.subaction_path_index = {p.path_indices[component.subaction_path]},\n')
             f.write(f'\t\t\t\t.steamvr_path = "{steamvr_path}",\n')
             f.write(
                 f'\t\t\t\t.localized_name = "{component.subpath_localized_name}",\n')
@@ -419,6 +450,7 @@ def generate_bindings_c(file, p):
                 f.write(f'\t\t\t\t\t"{path}",\n')
             f.write('\t\t\t\t\tNULL\n')
             f.write('\t\t\t\t}, // /array of paths\n')
+            write_path_indices(f, '\t\t\t\t', p, component.get_full_openxr_paths())
 
             # print("component", component.__dict__)
 
@@ -470,10 +502,12 @@ def generate_bindings_c(file, p):
             for idx, identifier in enumerate(dpads):
                 f.write('\t\t\t{\n')
                 f.write(f'\t\t\t\t.subaction_path = "{identifier.subaction_path}",\n')
+                f.write(f'\t\t\t\t.subaction_path_index = {p.path_indices[identifier.subaction_path]},\n')
                 f.write('\t\t\t\t.paths = {\n')
                 for path in identifier.dpad.paths:
                     f.write(f'\t\t\t\t\t"{path}",\n')
                 f.write('\t\t\t\t},\n')
+                write_path_indices(f, '\t\t\t\t', p, identifier.dpad.paths)
                 f.write(f'\t\t\t\t.position = {identifier.dpad.position_component.monado_binding},\n')
                 if identifier.dpad.activate_component:
                     f.write(f'\t\t\t\t.activate = {identifier.dpad.activate_component.monado_binding},\n')
@@ -560,6 +594,7 @@ def generate_bindings_h(file, p):
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "xrt/xrt_defines.h"
 
@@ -586,10 +621,26 @@ enum oxr_dpad_binding_point
 \tOXR_DPAD_BINDING_POINT_RIGHT,
 }};
 
+/*!
+ * A path string used by the templates, with its length so it can be
+ * interned without calling strlen.
+ */
+struct binding_path
+{{
+\tconst char *str;
+\tsize_t length;
+}};
+
+#define NUM_BINDING_PATHS {len(p.paths)}
+extern const struct binding_path binding_paths[NUM_BINDING_PATHS];
+
 struct dpad_emulation
 {{
 \tconst char *subaction_path;
+\tuint32_t subaction_path_index;
 \tconst char *paths[PATHS_PER_BINDING_TEMPLATE];
+\tuint32_t path_indices[PATHS_PER_BINDING_TEMPLATE];
+\tuint32_t path_count;
 \tenum xrt_input_name position;
 \tenum xrt_input_name activate; // Can be zero
 }};
@@ -597,9 +648,12 @@ struct dpad_emulation
 struct binding_template
 {{
 \tconst char *subaction_path;
+\tuint32_t subaction_path_index;
 \tconst char *steamvr_path;
 \tconst char *localized_name;
 \tconst char *paths[PATHS_PER_BINDING_TEMPLATE];
+\tuint32_t path_indices[PATHS_PER_BINDING_TEMPLATE];
+\tuint32_t path_count;
 \tenum xrt_input_name input;
 \tenum xrt_input_name dpad_activate;
 \tenum xrt_output_name output;
@@ -609,6 +663,7 @@ struct profile_template
 {{
 \tenum xrt_device_name name;
 \tconst char *path;
+\tuint32_t path_index;
 \tconst char *localized_name;
 \tconst char *steamvr_input_profile_path;
 \tconst char *steamvr_controller_type;
@@ -13,10 +13,13 @@
 #include "math/m_vec2.h"
 #include "math/m_vec3.h"
 #include "math/m_space.h"
+#include "math/m_eigen_interop.hpp"
 
 #include <stdio.h>
 #include <assert.h>
 
+using namespace xrt::auxiliary::math;
+
 
 /*
  *
@@ -83,6 +86,22 @@ has_step_with_no_pose(const struct xrt_relation_chain *xrc)
 	return false;
 }
 
+static bool
+has_step_with_velocity(const struct xrt_relation_chain *xrc)
+{
+	const enum xrt_space_relation_flags velocity_flags = (enum xrt_space_relation_flags)(
+	    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT | XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT);
+
+	for (uint32_t i = 0; i < xrc->step_count; i++) {
+		const struct xrt_space_relation *r = &xrc->steps[i];
+		if ((r->relation_flags & velocity_flags) != 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 struct flags
 {
 	unsigned int has_orientation : 1;
@@ -271,6 +290,55 @@ apply_relation(const struct xrt_space_relation *a,
 }
 
 
+/*!
+ * Resolves a chain of at least two steps where no step has any velocity, it
+ * gives the same result as folding @ref apply_relation over the chain but
+ * keeps the accumulated pose in Eigen types the whole way. This lets Eigen use
+ * its vectorised (SSE/NEON) quaternion product and skips the velocity math and
+ * the per step copies of the relation.
+ */
+static void
+resolve_poses_only(const struct xrt_relation_chain *xrc, struct xrt_space_relation *out_relation)
+{
+	const enum xrt_space_relation_flags tracked_flags = (enum xrt_space_relation_flags)(
+	    XRT_SPACE_RELATION_POSITION_TRACKED_BIT | XRT_SPACE_RELATION_ORIENTATION_TRACKED_BIT);
+
+	assert(xrc->step_count >= 2);
+
+	struct xrt_pose first = XRT_POSE_IDENTITY;
+	make_valid_pose(get_flags(&xrc->steps[0]), &xrc->steps[0].pose, &first);
+
+	Eigen::Quaternionf orientation = map_quat(first.orientation);
+	Eigen::Vector3f position = map_vec3(first.position);
+	int new_flags = xrc->steps[0].relation_flags & tracked_flags;
+
+	for (uint32_t i = 1; i < xrc->step_count; i++) {
+		const struct xrt_space_relation *r = &xrc->steps[i];
+
+		struct xrt_pose base = XRT_POSE_IDENTITY;
+		make_valid_pose(get_flags(r), &r->pose, &base);
+
+		Eigen::Quaternionf base_orientation = map_quat(base.orientation);
+
+		// Same order of operations as math_pose_transform.
+		position = base_orientation * position + map_vec3(base.position);
+		orientation = base_orientation * orientation;
+		new_flags |= r->relation_flags & tracked_flags;
+	}
+
+	// See apply_relation for why these are always set.
+	new_flags |= XRT_SPACE_RELATION_POSITION_VALID_BIT;
+	new_flags |= XRT_SPACE_RELATION_ORIENTATION_VALID_BIT;
+
+	struct xrt_space_relation tmp = {};
+	tmp.relation_flags = (enum xrt_space_relation_flags)new_flags;
+	map_quat(tmp.pose.orientation) = orientation;
+	map_vec3(tmp.pose.position) = position;
+
+	*out_relation = tmp;
+}
+
+
 /*
  *
  * Exported functions.
@@ -285,9 +353,15 @@ m_relation_chain_resolve(const struct xrt_relation_chain *xrc, struct xrt_space_
 		return;
 	}
 
-	struct xrt_space_relation r = xrc->steps[0];
-	for (uint32_t i = 1; i < xrc->step_count; i++) {
-		apply_relation(&r, &xrc->steps[i], &r);
+	struct xrt_space_relation r;
+	if (xrc->step_count >= 2 && !has_step_with_velocity(xrc)) {
+		// Common case for most spaces and views, take the fast path.
+		resolve_poses_only(xrc, &r);
+	} else {
+		r = xrc->steps[0];
+		for (uint32_t i = 1; i < xrc->step_count; i++) {
+			apply_relation(&r, &xrc->steps[i], &r);
+		}
 	}
 
 #if 0
@@ -9,36 +9,75 @@
 
 #include "t_euroc_recorder.h"
 
+#include "math/m_api.h"
 #include "os/os_time.h"
 #include "util/u_frame.h"
+#include "util/u_logging.h"
 #include "util/u_sink.h"
 #include "util/u_var.h"
 #include "util/u_debug.h"
+#include "util/u_packed_dataset.h"
 #include "xrt/xrt_defines.h"
 #include "xrt/xrt_tracking.h"
 
 #include <cassert>
+#include <cinttypes>
+#include <condition_variable>
 #include <ctime>
+#include <deque>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
 #include <string>
 #include <queue>
 #include <iomanip>
+#include <thread>
 
 #include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
 
 DEBUG_GET_ONCE_BOOL_OPTION(euroc_recorder_use_jpg, "EUROC_RECORDER_USE_JPG", false)
-
+DEBUG_GET_ONCE_BOOL_OPTION(euroc_recorder_packed, "EUROC_RECORDER_PACKED", false)
+DEBUG_GET_ONCE_BOOL_OPTION(euroc_recorder_packed_lz4, "EUROC_RECORDER_PACKED_LZ4", false)
+DEBUG_GET_ONCE_OPTION(euroc_recorder_format, "EUROC_RECORDER_FORMAT", "png")
+DEBUG_GET_ONCE_NUM_OPTION(euroc_recorder_png_level, "EUROC_RECORDER_PNG_LEVEL", -1)
+DEBUG_GET_ONCE_NUM_OPTION(euroc_recorder_writers, "EUROC_RECORDER_WRITERS", 2)
+DEBUG_GET_ONCE_NUM_OPTION(euroc_recorder_queue_size, "EUROC_RECORDER_QUEUE_SIZE", 32)
+DEBUG_GET_ONCE_BOOL_OPTION(euroc_recorder_block, "EUROC_RECORDER_BLOCK", false)
+
+//! Source frames each cloner queue holds when the cloner may block, newer frames are dropped by the queue
+#define EUROC_RECORDER_BLOCKING_CLONER_QUEUE_SIZE 2
+
+using std::condition_variable;
+using std::deque;
 using std::lock_guard;
 using std::mutex;
 using std::ofstream;
 using std::queue;
 using std::string;
+using std::thread;
 using std::to_string;
+using std::unique_lock;
 using std::vector;
 using std::filesystem::create_directories;
 
+//! How frames are written to disk
+enum euroc_recorder_encoder
+{
+	EUROC_RECORDER_PNG, //!< Lossless, slowest to write
+	EUROC_RECORDER_JPG, //!< Lossy, not suitable for evaluating trackers
+	EUROC_RECORDER_PNM, //!< Uncompressed PGM/PPM, fastest to write but large
+};
+
+//! A cloned frame waiting to be written by the writer pool
+struct euroc_recorder_job
+{
+	struct xrt_frame *frame; //!< Owned reference to the cloned frame
+	int cam_index;
+	string img_path;         //!< Destination file, empty when writing a packed dataset
+	timepoint_ns queued_ts;  //!< When the job was queued
+};
+
 struct euroc_recorder
 {
 	struct xrt_frame_node node;
@@ -49,19 +88,46 @@ struct euroc_recorder
 	bool files_created;                //!< Whether the dataset directory structure has been created
 	struct u_var_button recording_btn; //!< UI button to start/stop `recording`
 
-	bool use_jpg; //! Whether or not we should save images as .jpg files
+	enum euroc_recorder_encoder encoder; //!< Image format of the frames
+	int png_level;                       //!< PNG compression level, negative for the OpenCV default
+
+	// Packed dataset, single file instead of the EuRoC directory structure
+	bool use_packed;                      //!< Whether to write a packed dataset instead
+	enum u_pd_codec packed_codec;         //!< How frames are stored in the packed dataset
+	struct u_pd_writer *packed = nullptr; //!< Writer of the packed dataset
+	mutex packed_lock{};                  //!< Cameras are written from different threads
 
 	// Cloner sinks: copy frame to heap for quick release of the original
 	struct xrt_slam_sinks cloner_queues; //!< Queue sinks that write into cloner sinks
 	struct xrt_imu_sink cloner_imu_sink;
 	struct xrt_pose_sink cloner_gt_sink;
 	struct xrt_frame_sink cloner_sinks[XRT_TRACKING_MAX_SLAM_CAMS];
+	struct xrt_frame_bundle_sink cloner_bundle_sink; //!< Splits bundles into the cloner queues
 
-	// Writer sinks: write copied frame to disk
-	struct xrt_slam_sinks writer_queues; //!< Queue sinks that write into writer sinks
+	// Writer sinks: write IMU and GT samples to disk
 	struct xrt_imu_sink writer_imu_sink;
 	struct xrt_pose_sink writer_gt_sink;
-	struct xrt_frame_sink writer_sinks[XRT_TRACKING_MAX_SLAM_CAMS];
+
+	// Writer pool: encodes and writes copied frames to disk
+	vector<thread> writers{};         //!< Writer threads
+	deque<euroc_recorder_job> jobs{}; //!< Frames waiting for a writer
+	mutex jobs_lock{};                //!< Lock for jobs, the flags and stats below
+	condition_variable jobs_cv{};     //!< A job was queued or the writers should stop
+	condition_variable space_cv{};    //!< A job was taken or the writers should stop
+	size_t max_jobs;                  //!< Frames that can wait before applying backpressure
+	bool block_when_full;             //!< Whether to block the cloner instead of dropping frames
+	bool stop_writers;                //!< Writers exit once the queue is empty
+
+	// Writer pool stats, exposed in the UI
+	uint64_t queue_depth;        //!< Frames currently waiting for a writer
+	uint64_t max_queue_depth;    //!< Highest queue_depth seen
+	uint64_t written_count;      //!< Frames written
+	uint64_t dropped_count;      //!< Frames dropped because the queue was full
+	uint64_t blocked_count;      //!< Times a cloner had to wait for space in the queue
+	double write_ms;             //!< Average time to encode and write a frame
+	double latency_ms;           //!< Average time from queueing to written
+	time_duration_ns write_ns;   //!< Total time spent encoding and writing
+	time_duration_ns latency_ns; //!< Total time from queueing to written
 
 	queue<xrt_imu_sample> imu_queue{}; //!< IMU pushes get saved here and are delayed until left_frame pushes
 	mutex imu_queue_lock{};            //!< Lock for imu_queue
@@ -94,6 +160,15 @@ euroc_recorder_try_mkfiles(struct euroc_recorder *er)
 
 	string path = er->path;
 
+	if (er->use_packed) {
+		string file_path = path;
+		if (file_path.size() < 4 || file_path.compare(file_path.size() - 4, 4, ".mpk") != 0) {
+			file_path += ".mpk";
+		}
+		u_pd_writer_create(file_path.c_str(), er->cam_count, 0, &er->packed);
+		return;
+	}
+
 	create_directories(path + "/mav0/imu0");
 	er->imu_csv = new ofstream{path + "/mav0/imu0/data.csv"};
 	*er->imu_csv << std::fixed << std::setprecision(CSV_PRECISION);
@@ -151,12 +226,13 @@ euroc_recorder_flush(struct euroc_recorder *er)
 		xrt_sink_push_pose(&er->writer_gt_sink, &sample);
 	}
 
+	if (er->use_packed) {
+		return;
+	}
+
 	// Flush csv streams. Not necessary, doing it only to increase flush frequency
 	er->imu_csv->flush();
 	er->gt_csv->flush();
-	for (int i = 0; i < er->cam_count; i++) {
-		er->cams_csv[i]->flush();
-	}
 }
 
 extern "C" void
@@ -164,6 +240,14 @@ euroc_recorder_save_imu(xrt_imu_sink *sink, struct xrt_imu_sample *sample)
 {
 	euroc_recorder *er = container_of(sink, euroc_recorder, writer_imu_sink);
 
+	if (er->use_packed) {
+		lock_guard lock{er->packed_lock};
+		if (er->packed != nullptr) {
+			u_pd_writer_push_imu(er->packed, sample);
+		}
+		return;
+	}
+
 	timepoint_ns ts = sample->timestamp_ns;
 	xrt_vec3_f64 a = sample->accel_m_s2;
 	xrt_vec3_f64 w = sample->gyro_rad_secs;
@@ -178,6 +262,14 @@ euroc_recorder_save_gt(xrt_pose_sink *sink, struct xrt_pose_sample *sample)
 {
 	euroc_recorder *er = container_of(sink, euroc_recorder, writer_gt_sink);
 
+	if (er->use_packed) {
+		lock_guard lock{er->packed_lock};
+		if (er->packed != nullptr) {
+			u_pd_writer_push_gt(er->packed, sample);
+		}
+		return;
+	}
+
 	timepoint_ns ts = sample->timestamp_ns;
 	xrt_vec3 p = sample->pose.position;
 	xrt_quat o = sample->pose.orientation;
@@ -188,48 +280,136 @@ euroc_recorder_save_gt(xrt_pose_sink *sink, struct xrt_pose_sample *sample)
 }
 
 static void
-euroc_recorder_save_frame(euroc_recorder *er, struct xrt_frame *frame, int cam_index)
+euroc_recorder_save_frame(euroc_recorder *er, const euroc_recorder_job &job)
 {
-	string cam_name = "cam" + to_string(cam_index);
-	uint64_t ts = frame->timestamp;
+	struct xrt_frame *frame = job.frame;
+
+	if (er->use_packed) {
+		lock_guard lock{er->packed_lock};
+		if (er->packed != nullptr) {
+			u_pd_writer_push_frame(er->packed, job.cam_index, frame, er->packed_codec);
+		}
+		return;
+	}
 
 	assert(frame->format == XRT_FORMAT_L8 || frame->format == XRT_FORMAT_R8G8B8); // Only formats supported
 	auto img_type = frame->format == XRT_FORMAT_L8 ? CV_8UC1 : CV_8UC3;
-	string file_extension = er->use_jpg ? ".jpg" : ".png";
-	string filename = std::to_string(ts) + file_extension;
-	string img_path = er->path + "/mav0/" + cam_name + "/data/" + filename;
 	cv::Mat img{(int)frame->height, (int)frame->width, img_type, frame->data, frame->stride};
-	cv::imwrite(img_path, img);
 
-	*er->cams_csv[cam_index] << ts << "," << filename << CSV_EOL;
+	// Image files are in OpenCV's BGR order, the player converts them back to RGB
+	if (frame->format == XRT_FORMAT_R8G8B8) {
+		cv::Mat bgr;
+		cv::cvtColor(img, bgr, cv::COLOR_RGB2BGR);
+		img = bgr;
+	}
+
+	vector<int> params;
+	if (er->encoder == EUROC_RECORDER_PNG && er->png_level >= 0) {
+		params = {cv::IMWRITE_PNG_COMPRESSION, er->png_level};
+	}
+	cv::imwrite(job.img_path, img, params);
 }
 
-#define DEFINE_SAVE_CAM(cam_id)                                                                                        \
-	extern "C" void euroc_recorder_save_cam##cam_id(struct xrt_frame_sink *sink, struct xrt_frame *frame)          \
-	{                                                                                                              \
-		euroc_recorder *er = container_of(sink, euroc_recorder, writer_sinks[cam_id]);                         \
-		if (cam_id == 0) {                                                                                     \
-			euroc_recorder_flush(er);                                                                      \
-		}                                                                                                      \
-		euroc_recorder_save_frame(er, frame, cam_id);                                                          \
+static void
+euroc_recorder_writer_run(euroc_recorder *er)
+{
+	unique_lock lock{er->jobs_lock};
+
+	while (true) {
+		er->jobs_cv.wait(lock, [er] { return er->stop_writers || !er->jobs.empty(); });
+
+		// Finish pending jobs even when stopping, they were already accepted
+		if (er->jobs.empty()) {
+			break;
+		}
+
+		euroc_recorder_job job = er->jobs.front();
+		er->jobs.pop_front();
+		er->queue_depth = er->jobs.size();
+		er->space_cv.notify_one();
+
+		lock.unlock();
+		timepoint_ns start_ts = (timepoint_ns)os_monotonic_get_ns();
+		euroc_recorder_save_frame(er, job);
+		timepoint_ns end_ts = (timepoint_ns)os_monotonic_get_ns();
+		xrt_frame_reference(&job.frame, NULL);
+		lock.lock();
+
+		er->written_count++;
+		er->write_ns += end_ts - start_ts;
+		er->latency_ns += end_ts - job.queued_ts;
+		er->write_ms = (double)er->write_ns / er->written_count / U_TIME_1MS_IN_NS;
+		er->latency_ms = (double)er->latency_ns / er->written_count / U_TIME_1MS_IN_NS;
 	}
+}
+
+/*!
+ * Queue a cloned frame for the writer pool, takes ownership of @p frame.
+ *
+ * @return false if the frame was dropped
+ */
+static bool
+euroc_recorder_queue_frame(euroc_recorder *er, struct xrt_frame *frame, int cam_index, const string &img_path)
+{
+	unique_lock lock{er->jobs_lock};
 
-DEFINE_SAVE_CAM(0)
-DEFINE_SAVE_CAM(1)
-DEFINE_SAVE_CAM(2)
-DEFINE_SAVE_CAM(3)
-DEFINE_SAVE_CAM(4)
+	if (er->jobs.size() >= er->max_jobs && er->block_when_full && !er->stop_writers) {
+		er->blocked_count++;
+		er->space_cv.wait(lock, [er] { return er->stop_writers || er->jobs.size() < er->max_jobs; });
+	}
 
-//! Be sure to define the same number of defined functions as
-//! XRT_TRACKING_MAX_SLAM_CAMS and to add them to to euroc_recorder_save_cam
-static void (*euroc_recorder_save_cam[XRT_TRACKING_MAX_SLAM_CAMS])(struct xrt_frame_sink *sink,
-                                                                   struct xrt_frame *frame) = {
-    euroc_recorder_save_cam0, //
-    euroc_recorder_save_cam1, //
-    euroc_recorder_save_cam2, //
-    euroc_recorder_save_cam3, //
-    euroc_recorder_save_cam4, //
-};
+	if (er->jobs.size() >= er->max_jobs || er->stop_writers) {
+		er->dropped_count++;
+		lock.unlock();
+		xrt_frame_reference(&frame, NULL);
+		return false;
+	}
+
+	er->jobs.push_back({frame, cam_index, img_path, (timepoint_ns)os_monotonic_get_ns()});
+	er->queue_depth = er->jobs.size();
+	er->max_queue_depth = MAX(er->max_queue_depth, er->queue_depth);
+	er->jobs_cv.notify_one();
+
+	return true;
+}
+
+static void
+euroc_recorder_start_writers(euroc_recorder *er, int writer_count)
+{
+	// The packed writer serializes frames anyway, and one thread keeps them in order
+	if (er->use_packed) {
+		writer_count = 1;
+	}
+
+	for (int i = 0; i < MAX(writer_count, 1); i++) {
+		er->writers.emplace_back(euroc_recorder_writer_run, er);
+	}
+}
+
+static void
+euroc_recorder_stop_writers(euroc_recorder *er)
+{
+	if (er->writers.empty()) {
+		return;
+	}
+
+	{
+		lock_guard lock{er->jobs_lock};
+		er->stop_writers = true;
+		er->jobs_cv.notify_all();
+		er->space_cv.notify_all();
+	}
+
+	for (thread &t : er->writers) {
+		t.join();
+	}
+	er->writers.clear();
+
+	U_LOG_I("EuRoC recorder: wrote %" PRIu64 " frames (%.2fms each, %.2fms after queueing), dropped %" PRIu64
+	        ", blocked %" PRIu64 " times, max queue depth %" PRIu64,
+	        er->written_count, er->write_ms, er->latency_ms, er->dropped_count, er->blocked_count,
+	        er->max_queue_depth);
+}
 
 
 /*
@@ -280,13 +460,56 @@ euroc_recorder_receive_frame(euroc_recorder *er, struct xrt_frame *src_frame, in
 		return;
 	}
 
+	// Write IMU and GT samples up to this frame
+	if (cam_index == 0) {
+		euroc_recorder_flush(er);
+	}
+
 	// Let's clone the frame so that we can release the src_frame quickly
 	xrt_frame *copy = nullptr;
 	u_frame_clone(src_frame, &copy);
 
-	xrt_sink_push_frame(er->writer_queues.cams[cam_index], copy);
+	if (er->use_packed) {
+		euroc_recorder_queue_frame(er, copy, cam_index, "");
+		return;
+	}
+
+	const char *file_extension = ".png";
+	if (er->encoder == EUROC_RECORDER_JPG) {
+		file_extension = ".jpg";
+	} else if (er->encoder == EUROC_RECORDER_PNM) {
+		file_extension = src_frame->format == XRT_FORMAT_L8 ? ".pgm" : ".ppm";
+	}
+
+	uint64_t ts = src_frame->timestamp;
+	string filename = to_string(ts) + file_extension;
+	string img_path = er->path + "/mav0/cam" + to_string(cam_index) + "/data/" + filename;
+
+	// Written here to keep the csv in order, writers may finish out of order
+	if (euroc_recorder_queue_frame(er, copy, cam_index, img_path)) {
+		*er->cams_csv[cam_index] << ts << "," << filename << CSV_EOL;
 
-	xrt_frame_reference(&copy, NULL);
+		// Flushed here instead of in euroc_recorder_flush as only this thread writes to it
+		er->cams_csv[cam_index]->flush();
+	}
+}
+
+extern "C" void
+euroc_recorder_receive_bundle(struct xrt_frame_bundle_sink *sink, struct xrt_frame_bundle *bundle)
+{
+	euroc_recorder *er = container_of(sink, euroc_recorder, cloner_bundle_sink);
+
+	// Avoid making frames out of the views when they are not needed
+	if (!er->recording) {
+		return;
+	}
+
+	for (int i = 0; i < bundle->view_count && i < er->cam_count; i++) {
+		xrt_frame *view = nullptr;
+		u_frame_get_bundle_view(bundle, i, &view);
+		xrt_sink_push_frame(er->cloner_queues.cams[i], view);
+		xrt_frame_reference(&view, NULL);
+	}
 }
 
 #define DEFINE_RECEIVE_CAM(cam_id)                                                                                     \
@@ -322,12 +545,17 @@ static void (*euroc_recorder_receive_cam[XRT_TRACKING_MAX_SLAM_CAMS])(struct xrt
 
 extern "C" void
 euroc_recorder_node_break_apart(struct xrt_frame_node *node)
-{}
+{
+	struct euroc_recorder *er = container_of(node, struct euroc_recorder, node);
+	euroc_recorder_stop_writers(er);
+}
 
 extern "C" void
 euroc_recorder_node_destroy(struct xrt_frame_node *node)
 {
 	struct euroc_recorder *er = container_of(node, struct euroc_recorder, node);
+	euroc_recorder_stop_writers(er);
+	u_pd_writer_close(&er->packed);
 	delete er->imu_csv;
 	delete er->gt_csv;
 	for (int i = 0; i < er->cam_count; i++) {
@@ -368,44 +596,64 @@ euroc_recorder_create(struct xrt_frame_context *xfctx, const char *record_path,
 		er->path = default_path;
 	}
 
+	string format = debug_get_option_euroc_recorder_format();
+	if (debug_get_bool_option_euroc_recorder_use_jpg() || format == "jpg") {
+		er->encoder = EUROC_RECORDER_JPG;
+	} else if (format == "pnm" || format == "raw") {
+		er->encoder = EUROC_RECORDER_PNM;
+	} else {
+		er->encoder = EUROC_RECORDER_PNG;
+	}
+	er->png_level = (int)debug_get_num_option_euroc_recorder_png_level();
+	er->max_jobs = MAX(debug_get_num_option_euroc_recorder_queue_size(), 1);
+	er->block_when_full = debug_get_bool_option_euroc_recorder_block();
+	er->use_packed = debug_get_bool_option_euroc_recorder_packed();
+	er->packed_codec = debug_get_bool_option_euroc_recorder_packed_lz4() ? U_PD_CODEC_LZ4 : U_PD_CODEC_RAW;
+
 	if (record_from_start) {
 		euroc_recorder_try_mkfiles(er);
 	}
 
-	er->use_jpg = debug_get_bool_option_euroc_recorder_use_jpg();
-
 	// Setup sink pipeline
 
 	// We expose a "cloner" sink that will clone frames in memory so that original
 	// frames can be released as soon as possible. Not doing this could result in
-	// frame queues from the user being filled up. After that we write to disk. We
-	// also put queues between these to support sensors streaming on different
-	// threads.
-	// cloner_queue -> cloner_sink (clone ) -> writer_queue -> writer_sink (write to disk)
+	// frame queues from the user being filled up. The clones are then handed to a
+	// bounded pool of writer threads that encode and write them to disk. When the
+	// pool falls behind frames are dropped, or with EUROC_RECORDER_BLOCK the
+	// cloner waits, but the sinks of the user never do.
+	//
+	// A waiting cloner still holds its source frame, and the cloner queues keep a
+	// reference to every frame pushed to them. So when blocking the queues are
+	// bounded, otherwise a slow disk would pile up driver frames without limit
+	// and could starve the driver frame pools. The trade-off is that blocking only
+	// moves the drops: once the writer pool and the cloner queue are full the
+	// queue drops the newest frames, uncounted by the recorder stats.
+	// cloner_queue -> cloner_sink (clone) -> writer pool (write to disk)
+	uint64_t cloner_queue_size = er->block_when_full ? EUROC_RECORDER_BLOCKING_CLONER_QUEUE_SIZE : 0;
 
 	er->cloner_queues.cam_count = er->cam_count;
-	er->writer_queues.cam_count = er->cam_count;
 	for (int i = 0; i < er->cam_count; i++) {
 
-		// If any of these asserts failed see docs on euroc_recorder_receive/save_cam
+		// If this assert failed see docs on euroc_recorder_receive_cam
 		assert(euroc_recorder_receive_cam[ARRAY_SIZE(euroc_recorder_receive_cam) - 1] != nullptr);
-		assert(euroc_recorder_save_cam[ARRAY_SIZE(euroc_recorder_save_cam) - 1] != nullptr);
 
-		u_sink_queue_create(xfctx, 0, &er->cloner_sinks[i], &er->cloner_queues.cams[i]);
+		u_sink_queue_create(xfctx, cloner_queue_size, &er->cloner_sinks[i], &er->cloner_queues.cams[i]);
 		er->cloner_sinks[i].push_frame = euroc_recorder_receive_cam[i];
-		u_sink_queue_create(xfctx, 0, &er->writer_sinks[i], &er->writer_queues.cams[i]);
-		er->writer_sinks[i].push_frame = euroc_recorder_save_cam[i];
 	}
 
 	er->cloner_queues.imu = &er->cloner_imu_sink;
 	er->cloner_imu_sink.push_imu = euroc_recorder_receive_imu;
-	er->writer_queues.imu = nullptr; // We use a std::queue instead
-	er->writer_imu_sink.push_imu = euroc_recorder_save_imu;
+	er->writer_imu_sink.push_imu = euroc_recorder_save_imu; // Called when flushing the std::queue
+
+	er->cloner_queues.bundle = &er->cloner_bundle_sink;
+	er->cloner_bundle_sink.push_bundle = euroc_recorder_receive_bundle;
 
 	er->cloner_queues.gt = &er->cloner_gt_sink;
 	er->cloner_gt_sink.push_pose = euroc_recorder_receive_gt;
-	er->writer_queues.gt = nullptr; // We use a std::queue instead
-	er->writer_gt_sink.push_pose = euroc_recorder_save_gt;
+	er->writer_gt_sink.push_pose = euroc_recorder_save_gt; // Called when flushing the std::queue
+
+	euroc_recorder_start_writers(er, (int)debug_get_num_option_euroc_recorder_writers());
 
 	xrt_slam_sinks *public_sinks = &er->cloner_queues;
 	return public_sinks;
@@ -431,4 +679,12 @@ euroc_recorder_add_ui(struct xrt_slam_sinks *public_sinks, void *root, const cha
 	char tmp[256];
 	(void)snprintf(tmp, sizeof(tmp), "%s%s", prefix, er->recording ? "Stop recording" : "Record EuRoC dataset");
 	u_var_add_button(root, &er->recording_btn, tmp);
+
+	u_var_add_ro_u64(root, &er->queue_depth, "Recorder queue depth");
+	u_var_add_ro_u64(root, &er->max_queue_depth, "Recorder max queue depth");
+	u_var_add_ro_u64(root, &er->written_count, "Recorder frames written");
+	u_var_add_ro_u64(root, &er->dropped_count, "Recorder frames dropped");
+	u_var_add_ro_u64(root, &er->blocked_count, "Recorder times blocked");
+	u_var_add_ro_f64(root, &er->write_ms, "Recorder write time (ms)");
+	u_var_add_ro_f64(root, &er->latency_ms, "Recorder queue to disk (ms)");
 }
@@ -12,13 +12,16 @@
 #include "xrt/xrt_tracking.h"
 #include "xrt/xrt_frameserver.h"
 #include "util/u_debug.h"
+#include "util/u_frame.h"
 #include "util/u_logging.h"
 #include "util/u_misc.h"
 #include "util/u_sink.h"
 #include "util/u_var.h"
 #include "util/u_trace_marker.h"
 #include "os/os_threading.h"
+#include "os/os_time.h"
 #include "math/m_api.h"
+#include "math/m_eigen_interop.hpp"
 #include "math/m_filter_fifo.h"
 #include "math/m_filter_one_euro.h"
 #include "math/m_predict.h"
@@ -32,7 +35,9 @@
 #include <slam_tracker.hpp>
 #include <opencv2/core/mat.hpp>
 #include <opencv2/core/version.hpp>
+#include <Eigen/Geometry>
 
+#include <algorithm>
 #include <deque>
 #include <filesystem>
 #include <fstream>
@@ -98,6 +103,7 @@ using std::vector;
 using std::filesystem::create_directories;
 using Trajectory = map<timepoint_ns, xrt_pose>;
 
+using xrt::auxiliary::math::map_vec3;
 using xrt::auxiliary::math::RelationHistory;
 
 using cv::Mat;
@@ -137,15 +143,17 @@ using cv::AccessFlag;
 class MatFrame final : public MatAllocator
 {
 public:
-	//! Wraps a @ref xrt_frame in a `cv::Mat`
+	//! Wraps the @p roi area of a @ref xrt_frame in a `cv::Mat`
 	Mat
-	wrap(struct xrt_frame *frame)
+	wrap(struct xrt_frame *frame, const struct xrt_rect &roi)
 	{
 		SLAM_DASSERT_(frame->format == XRT_FORMAT_L8 || frame->format == XRT_FORMAT_R8G8B8);
 		auto img_type = frame->format == XRT_FORMAT_L8 ? CV_8UC1 : CV_8UC3;
+		size_t pixel_size = frame->format == XRT_FORMAT_L8 ? 1 : 3;
 
 		// Wrap the frame data into a cv::Mat header
-		cv::Mat img{(int)frame->height, (int)frame->width, img_type, frame->data, frame->stride};
+		uint8_t *data = frame->data + roi.offset.h * frame->stride + roi.offset.w * pixel_size;
+		cv::Mat img{roi.extent.h, roi.extent.w, img_type, data, frame->stride};
 
 		// Enable reference counting for a user-allocated cv::Mat (i.e., using existing frame->data)
 		img.u = this->allocate(img.dims, img.size.p, img.type(), img.data, img.step.p, ACCESS_RW,
@@ -354,6 +362,7 @@ struct TrackerSlam
 	struct xrt_frame_sink cam_sinks[XRT_TRACKING_MAX_SLAM_CAMS]; //!< Sends camera frames to the SLAM system
 	struct xrt_imu_sink imu_sink = {};                           //!< Sends imu samples to the SLAM system
 	struct xrt_pose_sink gt_sink = {};                           //!< Register groundtruth trajectory for stats
+	struct xrt_frame_bundle_sink bundle_sink = {};               //!< Sends synchronised captures to the SLAM system
 	bool submit;   //!< Whether to submit data pushed to sinks to the SLAM tracker
 	int cam_count; //!< Number of cameras used for tracking
 
@@ -478,6 +487,14 @@ struct TrackerSlam
 		struct u_var_timing diff_ui;          //!< Realtime UI for positional error
 		bool override_tracking = false;       //!< Force the tracker to report gt poses instead
 	} gt;
+
+	//! Session history for @ref t_slam_get_metrics
+	struct
+	{
+		bool enabled = false;                       //!< Whether to keep the history, it grows unbounded
+		vector<pair<timepoint_ns, xrt_pose>> poses; //!< Estimated poses in the SLAM system frame
+		vector<time_duration_ns> latencies;         //!< Time in the SLAM system of each pose
+	} metrics;
 };
 
 
@@ -777,6 +794,135 @@ gt_ui_push(TrackerSlam &t, timepoint_ns ts, xrt_pose tracked_pose)
 	t.gt.diff_ui.reference_timing = (1 - a) * t.gt.diff_ui.reference_timing + a * len_mm;
 }
 
+/*
+ *
+ * Metrics functionality
+ *
+ */
+
+//! Absolute trajectory error after a rigid alignment, as done by offline evaluation tools.
+static void
+metrics_compute_ate(const TrackerSlam &t, t_slam_metrics &m)
+{
+	const Trajectory &gt = *t.gt.trajectory;
+	timepoint_ns gt_first_ts = gt.begin()->first;
+	timepoint_ns gt_last_ts = std::prev(gt.end())->first;
+
+	vector<Eigen::Vector3d> est_pts;
+	vector<Eigen::Vector3d> gt_pts;
+	for (const auto &[ts, pose] : t.metrics.poses) {
+		if (ts < gt_first_ts || ts > gt_last_ts) {
+			continue;
+		}
+		est_pts.push_back(map_vec3(pose.position).cast<double>());
+		gt_pts.push_back(map_vec3(get_gt_pose_at(gt, ts).position).cast<double>());
+	}
+
+	size_t n = est_pts.size();
+	if (n < 3) {
+		return;
+	}
+
+	Eigen::Matrix3Xd est_mat(3, n);
+	Eigen::Matrix3Xd gt_mat(3, n);
+	for (size_t i = 0; i < n; i++) {
+		est_mat.col(i) = est_pts[i];
+		gt_mat.col(i) = gt_pts[i];
+	}
+
+	// Trajectories start in different frames, VIO has no scale ambiguity
+	Eigen::Matrix4d T_gt_est = Eigen::umeyama(est_mat, gt_mat, false);
+	Eigen::Matrix3Xd aligned = (T_gt_est.topLeftCorner<3, 3>() * est_mat).colwise() + T_gt_est.topRightCorner<3, 1>();
+	Eigen::VectorXd errors = (aligned - gt_mat).colwise().norm();
+
+	m.ate_count = n;
+	m.ate_rmse_m = std::sqrt(errors.squaredNorm() / n);
+	m.ate_max_m = errors.maxCoeff();
+}
+
+//! Relative pose error between poses @ref T_SLAM_METRICS_RPE_DELTA_NS apart, independent of alignment.
+static void
+metrics_compute_rpe(const TrackerSlam &t, t_slam_metrics &m)
+{
+	const Trajectory &gt = *t.gt.trajectory;
+	const auto &poses = t.metrics.poses;
+
+	double trans_sq_sum = 0;
+	double rot_sq_sum = 0;
+	uint32_t count = 0;
+
+	size_t j = 0;
+	for (size_t i = 0; i < poses.size(); i++) {
+		const auto &[ts_i, est_i] = poses[i];
+		while (j < poses.size() && poses[j].first < ts_i + T_SLAM_METRICS_RPE_DELTA_NS) {
+			j++;
+		}
+		if (j == poses.size()) {
+			break;
+		}
+
+		const auto &[ts_j, est_j] = poses[j];
+		if (ts_i < gt.begin()->first || ts_j > std::prev(gt.end())->first) {
+			continue;
+		}
+
+		xrt_pose gt_i = get_gt_pose_at(gt, ts_i);
+		xrt_pose gt_j = get_gt_pose_at(gt, ts_j);
+
+		// Motion between both poses, and the error of the estimated one
+		xrt_pose inv{};
+		xrt_pose est_rel{};
+		xrt_pose gt_rel{};
+		xrt_pose err{};
+		math_pose_invert(&est_i, &inv);
+		math_pose_transform(&inv, &est_j, &est_rel);
+		math_pose_invert(&gt_i, &inv);
+		math_pose_transform(&inv, &gt_j, &gt_rel);
+		math_pose_invert(&gt_rel, &inv);
+		math_pose_transform(&inv, &est_rel, &err);
+
+		double trans = m_vec3_len(err.position);
+		xrt_vec3 axis{err.orientation.x, err.orientation.y, err.orientation.z};
+		double rot = 2 * std::atan2(m_vec3_len(axis), std::abs(err.orientation.w)); // Robust to unnormalized quats
+		trans_sq_sum += trans * trans;
+		rot_sq_sum += rot * rot;
+		count++;
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	m.rpe_count = count;
+	m.rpe_trans_rmse_m = std::sqrt(trans_sq_sum / count);
+	m.rpe_rot_rmse_deg = std::sqrt(rot_sq_sum / count) * 180 / M_PI;
+}
+
+static void
+metrics_compute_latency(const TrackerSlam &t, t_slam_metrics &m)
+{
+	vector<time_duration_ns> lats = t.metrics.latencies;
+	size_t n = lats.size();
+	if (n == 0) {
+		return;
+	}
+
+	std::sort(lats.begin(), lats.end());
+
+	double sum_ns = 0;
+	for (time_duration_ns l : lats) {
+		sum_ns += l;
+	}
+
+	constexpr double ms = U_TIME_1MS_IN_NS;
+	m.latency_count = n;
+	m.latency_mean_ms = sum_ns / n / ms;
+	m.latency_p50_ms = lats[n / 2] / ms;
+	m.latency_p95_ms = lats[std::min(n - 1, n * 95 / 100)] / ms;
+	m.latency_max_ms = lats.back() / ms;
+}
+
+
 /*
  *
  * Tracker functionality
@@ -826,6 +972,14 @@ flush_poses(TrackerSlam &t)
 		auto tss = timing_ui_push(t, np);
 		t.slam_times_writer->push(tss);
 
+		if (t.metrics.enabled) {
+			t.metrics.poses.emplace_back(nts, rel.pose);
+			// Only the extension has timestamps from inside the SLAM system
+			if (tss.size() > 2) {
+				t.metrics.latencies.push_back(tss.back() - tss[1]);
+			}
+		}
+
 		if (t.features.ext_enabled) {
 			vector feat_count = features_ui_push(t, np);
 			t.slam_features_writer->push(nts, feat_count);
@@ -1212,26 +1366,18 @@ t_slam_receive_imu(struct xrt_imu_sink *sink, struct xrt_imu_sample *s)
 	m_ff_vec3_f32_push(t.accel_ff, &accel, ts);
 }
 
-//! Push the frame to the external SLAM system
+//! Send the @p roi area of a frame to the external SLAM system as an image of @p cam_index
 static void
-receive_frame(TrackerSlam &t, struct xrt_frame *frame, int cam_index)
+push_image(TrackerSlam &t, struct xrt_frame *frame, const struct xrt_rect &roi, timepoint_ns ts, int cam_index)
 {
-	XRT_TRACE_MARKER();
-
-	if (cam_index == 1) {
-		flush_poses(t); // Useful to flush SLAM poses when no openxr app is open
-	}
-	SLAM_DASSERT(t.last_cam_ts[0] != INT64_MIN || cam_index == 0, "First frame was not a cam0 frame");
-
 	// Construct and send the image sample
-	cv::Mat img = t.cv_wrapper->wrap(frame);
-	SLAM_DASSERT_(frame->timestamp < INT64_MAX);
-	img_sample sample{(int64_t)frame->timestamp, img, cam_index};
+	cv::Mat img = t.cv_wrapper->wrap(frame, roi);
+	img_sample sample{ts, img, cam_index};
 	if (t.submit) {
 		XRT_TRACE_IDENT(slam_push);
 		t.slam->push_frame(sample);
 	}
-	SLAM_TRACE("cam%d frame t=%lu", cam_index, frame->timestamp);
+	SLAM_TRACE("cam%d frame t=%ld", cam_index, ts);
 
 	// Check monotonically increasing timestamps
 	timepoint_ns &last_ts = t.last_cam_ts[cam_index];
@@ -1239,6 +1385,22 @@ receive_frame(TrackerSlam &t, struct xrt_frame *frame, int cam_index)
 	last_ts = sample.timestamp;
 }
 
+//! Push the frame to the external SLAM system
+static void
+receive_frame(TrackerSlam &t, struct xrt_frame *frame, int cam_index)
+{
+	XRT_TRACE_MARKER();
+
+	if (cam_index == 1) {
+		flush_poses(t); // Useful to flush SLAM poses when no openxr app is open
+	}
+	SLAM_DASSERT(t.last_cam_ts[0] != INT64_MIN || cam_index == 0, "First frame was not a cam0 frame");
+
+	SLAM_DASSERT_(frame->timestamp < INT64_MAX);
+	xrt_rect whole{{0, 0}, {(int)frame->width, (int)frame->height}};
+	push_image(t, frame, whole, (timepoint_ns)frame->timestamp, cam_index);
+}
+
 #define DEFINE_RECEIVE_CAM(cam_id)                                                                                     \
 	extern "C" void t_slam_receive_cam##cam_id(struct xrt_frame_sink *sink, struct xrt_frame *frame)               \
 	{                                                                                                              \
@@ -1263,6 +1425,33 @@ void (*t_slam_receive_cam[XRT_TRACKING_MAX_SLAM_CAMS])(xrt_frame_sink *, xrt_fra
     t_slam_receive_cam4, //
 };
 
+//! Push all views of a synchronised capture, no need to wait for each camera
+extern "C" void
+t_slam_receive_bundle(struct xrt_frame_bundle_sink *sink, struct xrt_frame_bundle *bundle)
+{
+	XRT_TRACE_MARKER();
+
+	auto &t = *container_of(sink, TrackerSlam, bundle_sink);
+	SLAM_DASSERT(bundle->view_count == t.cam_count, "Bundle has %d views for %d cams", bundle->view_count,
+	             t.cam_count);
+
+	flush_poses(t); // Useful to flush SLAM poses when no openxr app is open
+
+	for (int i = 0; i < bundle->view_count; i++) {
+		push_image(t, bundle->frames[i], bundle->rois[i], bundle->timestamp, i);
+
+		// Only make a frame of the view if someone is looking at it
+		if (u_sink_debug_is_active(&t.ui_sink[i])) {
+			xrt_frame *view = nullptr;
+			u_frame_get_bundle_view(bundle, i, &view);
+			u_sink_debug_push_frame(&t.ui_sink[i], view);
+			xrt_frame_reference(&view, NULL);
+		}
+	}
+
+	xrt_sink_push_bundle(t.euroc_recorder->bundle, bundle);
+}
+
 extern "C" void
 t_slam_node_break_apart(struct xrt_frame_node *node)
 {
@@ -1326,6 +1515,60 @@ t_slam_start(struct xrt_tracked_slam *xts)
 	return ret;
 }
 
+//! Wait until the SLAM system estimated the last frame pushed to it, or until it goes @p idle_ns without a new pose.
+static void
+drain_poses(TrackerSlam &t, time_duration_ns idle_ns)
+{
+	timepoint_ns last_frame_ts = t.last_cam_ts[0];
+	if (!t.submit || last_frame_ts == INT64_MIN) {
+		return;
+	}
+
+	timepoint_ns idle_since = os_monotonic_get_ns();
+	while (true) {
+		timepoint_ns now = os_monotonic_get_ns();
+		if (flush_poses(t)) {
+			idle_since = now;
+		}
+
+		uint64_t lts = 0;
+		xrt_space_relation lr = XRT_SPACE_RELATION_ZERO;
+		if (t.slam_rels.get_latest(&lts, &lr) && (timepoint_ns)lts >= last_frame_ts) {
+			return;
+		}
+
+		// Frames can be dropped or fail to track, so the last pose might never come
+		if (now - idle_since > idle_ns) {
+			SLAM_WARN("No pose for the last frame (%ld) after waiting %.1fs", last_frame_ts, time_ns_to_s(idle_ns));
+			return;
+		}
+
+		os_nanosleep(U_TIME_1MS_IN_NS * 10);
+	}
+}
+
+extern "C" void
+t_slam_get_metrics(struct xrt_tracked_slam *xts, struct t_slam_metrics *out_metrics)
+{
+	auto &t = *container_of(xts, TrackerSlam, base);
+	SLAM_ASSERT(t.metrics.enabled, "Tracker created without metrics");
+
+	// Include the poses still being estimated or not yet dequeued
+	drain_poses(t, T_SLAM_METRICS_DRAIN_IDLE_NS);
+
+	t_slam_metrics m{};
+	m.pose_count = t.metrics.poses.size();
+	m.gt_pose_count = t.gt.trajectory->size();
+
+	if (!t.gt.trajectory->empty()) {
+		metrics_compute_ate(t, m);
+		metrics_compute_rpe(t, m);
+	}
+	metrics_compute_latency(t, m);
+
+	*out_metrics = m;
+}
+
 extern "C" void
 t_slam_fill_default_config(struct t_slam_tracker_config *config)
 {
@@ -1339,6 +1582,7 @@ t_slam_fill_default_config(struct t_slam_tracker_config *config)
 	config->csv_path = debug_get_option_slam_csv_path();
 	config->timing_stat = debug_get_bool_option_slam_timing_stat();
 	config->features_stat = debug_get_bool_option_slam_features_stat();
+	config->metrics = false;
 	config->cam_count = int(debug_get_num_option_slam_cam_count());
 	config->slam_calib = NULL;
 }
@@ -1413,6 +1657,9 @@ t_slam_create(struct xrt_frame_context *xfctx,
 	t.gt_sink.push_pose = t_slam_gt_sink_push;
 	t.sinks.gt = &t.gt_sink;
 
+	t.bundle_sink.push_bundle = t_slam_receive_bundle;
+	t.sinks.bundle = &t.bundle_sink;
+
 	t.submit = config->submit_from_start;
 	t.cam_count = config->cam_count;
 
@@ -1436,6 +1683,8 @@ t_slam_create(struct xrt_frame_context *xfctx,
 
 	t.gt.trajectory = new Trajectory{};
 
+	t.metrics.enabled = config->metrics;
+
 	// Setup timing extension
 
 	// Probe for timing extension.
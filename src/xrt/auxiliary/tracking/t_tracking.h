@@ -655,11 +655,49 @@ struct t_slam_tracker_config
 	const char *csv_path;                   //!< Path to write CSVs to
 	bool timing_stat;                       //!< Enable timing metric in external system
 	bool features_stat;                     //!< Enable feature metric in external system
+	bool metrics;                           //!< Keep estimated poses and latencies for @ref t_slam_get_metrics
 
 	//!< Instead of a slam_config file you can set custom calibration data
 	const struct t_slam_calibration *slam_calib;
 };
 
+/*!
+ * Time between the poses compared by the relative pose error of @ref t_slam_metrics.
+ */
+#define T_SLAM_METRICS_RPE_DELTA_NS (1000 * 1000 * 1000)
+
+/*!
+ * How long @ref t_slam_get_metrics waits for a new pose before giving up on
+ * the pose of the last frame.
+ */
+#define T_SLAM_METRICS_DRAIN_IDLE_NS (2LL * 1000 * 1000 * 1000)
+
+/*!
+ * Accuracy and performance of a SLAM tracker session, the error fields are
+ * only valid when their count is not zero.
+ *
+ * @see t_slam_get_metrics
+ */
+struct t_slam_metrics
+{
+	uint32_t pose_count;    //!< Poses estimated by the SLAM system
+	uint32_t gt_pose_count; //!< Ground truth poses received
+
+	uint32_t ate_count; //!< Estimated poses within the ground truth time range
+	double ate_rmse_m;  //!< Absolute trajectory error, after a rigid alignment of both trajectories
+	double ate_max_m;   //!< Largest absolute error
+
+	uint32_t rpe_count;      //!< Pose pairs compared for the relative pose error
+	double rpe_trans_rmse_m; //!< Translation drift over @ref T_SLAM_METRICS_RPE_DELTA_NS
+	double rpe_rot_rmse_deg; //!< Rotation drift over @ref T_SLAM_METRICS_RPE_DELTA_NS
+
+	uint32_t latency_count; //!< Poses with timing information from the SLAM system
+	double latency_mean_ms; //!< From the frame reaching the SLAM system to its pose being dequeued
+	double latency_p50_ms;  //!< Median latency
+	double latency_p95_ms;  //!< 95th percentile latency
+	double latency_max_ms;  //!< Worst latency
+};
+
 /*!
  * Fills in a @ref t_slam_tracker_config with default values.
  *
@@ -683,6 +721,17 @@ t_slam_create(struct xrt_frame_context *xfctx,
 int
 t_slam_start(struct xrt_tracked_slam *xts);
 
+/*!
+ * Compute the metrics of the session so far, only available if the tracker
+ * was created with @ref t_slam_tracker_config::metrics set. Waits for the
+ * pose of the last frame pushed to the tracker first, so no more frames should
+ * be pushed while this is called.
+ *
+ * @public @memberof xrt_tracked_slam
+ */
+void
+t_slam_get_metrics(struct xrt_tracked_slam *xts, struct t_slam_metrics *out_metrics);
+
 /*
  *
  * Camera calibration
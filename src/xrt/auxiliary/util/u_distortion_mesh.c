@@ -12,6 +12,8 @@
 #include "util/u_frame.h"
 #include "util/u_debug.h"
 #include "util/u_format.h"
+#include "util/u_worker.h"
+#include "util/u_trace_marker.h"
 #include "util/u_distortion_mesh.h"
 
 #include "math/m_vec2.h"
@@ -22,6 +24,19 @@
 
 
 DEBUG_GET_ONCE_NUM_OPTION(mesh_size, "XRT_MESH_SIZE", 64)
+DEBUG_GET_ONCE_NUM_OPTION(distortion_threads, "XRT_DISTORTION_THREADS", 4)
+
+/*!
+ * Don't bother splitting the work up into chunks smaller then this, the cost
+ * of pushing it to a worker thread is larger then the work itself.
+ */
+#define MIN_POINTS_PER_TASK (256)
+
+/*!
+ * Number of floats in a @ref xrt_uv_triplet, used by the batch functions to
+ * write the results channel by channel.
+ */
+#define TRIPLET_FLOATS (6)
 
 
 typedef bool (*func_calc)(struct xrt_device *xdev, uint32_t view, float u, float v, struct xrt_uv_triplet *result);
@@ -56,11 +71,23 @@ run_func(struct xrt_device *xdev, func_calc calc, int view_count, struct xrt_hmd
 
 	float *verts = U_TYPED_ARRAY_CALLOC(float, float_count);
 
+	// Scratch arrays for evaluating one view in a single batch.
+	float *us = U_TYPED_ARRAY_CALLOC(float, vertex_count_per_view);
+	float *vs = U_TYPED_ARRAY_CALLOC(float, vertex_count_per_view);
+	struct xrt_uv_triplet *results = U_TYPED_ARRAY_CALLOC(struct xrt_uv_triplet, vertex_count_per_view);
+
+	// Shared by all views, NULL if the batch function isn't used.
+	struct u_worker_thread_pool *pool = NULL;
+	if (xdev->compute_distortion == calc) {
+		pool = u_distortion_mesh_create_worker_pool();
+	}
+
 	// Setup the vertices for all views.
 	uint32_t i = 0;
 	for (int view = 0; view < view_count; view++) {
 		vertex_offsets[view] = i / stride_in_floats;
 
+		uint32_t k = 0;
 		for (uint32_t r = 0; r < vert_rows; r++) {
 			// This goes from 0 to 1.0 inclusive.
 			float v = (float)r / (float)cells_rows;
@@ -69,21 +96,49 @@ run_func(struct xrt_device *xdev, func_calc calc, int view_count, struct xrt_hmd
 				// This goes from 0 to 1.0 inclusive.
 				float u = (float)c / (float)cells_cols;
 
-				// Make the position in the range of [-1, 1]
-				verts[i + 0] = u * 2.0f - 1.0f;
-				verts[i + 1] = v * 2.0f - 1.0f;
-
-				if (!calc(xdev, view, u, v, (struct xrt_uv_triplet *)&verts[i + 2])) {
-					// bail on error, without updating
-					// distortion.preferred
-					return;
-				}
+				us[k] = u;
+				vs[k] = v;
+				k++;
+			}
+		}
 
-				i += stride_in_floats;
+		bool ret;
+		if (xdev->compute_distortion == calc) {
+			ret = u_distortion_mesh_compute_batch(pool, xdev, view, vertex_count_per_view, us, vs, results);
+		} else {
+			ret = true;
+			for (k = 0; k < vertex_count_per_view && ret; k++) {
+				ret = calc(xdev, view, us[k], vs[k], &results[k]);
 			}
 		}
+
+		if (!ret) {
+			// bail on error, without updating
+			// distortion.preferred
+			free(us);
+			free(vs);
+			free(results);
+			free(verts);
+			u_worker_thread_pool_reference(&pool, NULL);
+			return;
+		}
+
+		for (k = 0; k < vertex_count_per_view; k++) {
+			// Make the position in the range of [-1, 1]
+			verts[i + 0] = us[k] * 2.0f - 1.0f;
+			verts[i + 1] = vs[k] * 2.0f - 1.0f;
+
+			*(struct xrt_uv_triplet *)&verts[i + 2] = results[k];
+
+			i += stride_in_floats;
+		}
 	}
 
+	free(us);
+	free(vs);
+	free(results);
+	u_worker_thread_pool_reference(&pool, NULL);
+
 	uint32_t index_count_per_view = cells_rows * (vert_cols * 2 + 2);
 	uint32_t index_count_total = index_count_per_view * view_count;
 	int *indices = U_TYPED_ARRAY_CALLOC(int, index_count_total);
@@ -184,6 +239,49 @@ u_compute_distortion_vive(struct u_vive_values *values, float u, float v, struct
 	return true;
 }
 
+bool
+u_compute_distortion_vive_batch(
+    struct u_vive_values *values, uint32_t count, const float *u, const float *v, struct xrt_uv_triplet *results)
+{
+	// Same math as u_compute_distortion_vive, but with everything that
+	// doesn't depend on the point hoisted out of the loop.
+	const struct u_vive_values val = *values;
+
+	const float common_factor_value = 0.5f / (1.0f + val.grow_for_undistort);
+	const float factor_x = common_factor_value;
+	const float factor_y = common_factor_value * val.aspect_x_over_y;
+
+	float *out = (float *)results;
+
+	// One pass per channel, keeps the loop body branch free for the compiler.
+	for (int c = 0; c < 3; c++) {
+		const float center_x = val.center[c].x;
+		const float center_y = val.center[c].y;
+		const float k1 = val.coefficients[c][0];
+		const float k2 = val.coefficients[c][1];
+		const float k3 = val.coefficients[c][2];
+		const float k4 = val.coefficients[c][3];
+
+		for (uint32_t i = 0; i < count; i++) {
+			float x = 2.f * u[i] - 1.f;
+			float y = 2.f * v[i] - 1.f;
+
+			y /= val.aspect_x_over_y;
+			x -= center_x;
+			y -= center_y;
+
+			float r2 = x * x + y * y;
+			float bottom = 1.f + r2 * (k1 + r2 * (k2 + r2 * k3));
+			float d = (1.f / bottom) + k4;
+
+			out[i * TRIPLET_FLOATS + c * 2 + 0] = 0.5f + (x * d + center_x) * factor_x;
+			out[i * TRIPLET_FLOATS + c * 2 + 1] = 0.5f + (y * d + center_y) * factor_y;
+		}
+	}
+
+	return true;
+}
+
 
 #define mul m_vec2_mul
 #define mul_scalar m_vec2_mul_scalar
@@ -232,6 +330,50 @@ u_compute_distortion_panotools(struct u_panotools_values *values, float u, float
 	return true;
 }
 
+bool
+u_compute_distortion_panotools_batch(struct u_panotools_values *values,
+                                     uint32_t count,
+                                     const float *u,
+                                     const float *v,
+                                     struct xrt_uv_triplet *results)
+{
+	const struct u_panotools_values val = *values;
+
+	const float size_x = val.viewport_size.x;
+	const float size_y = val.viewport_size.y;
+	const float center_x = val.lens_center.x;
+	const float center_y = val.lens_center.y;
+	const float k0 = val.distortion_k[0];
+	const float k1 = val.distortion_k[1];
+	const float k2 = val.distortion_k[2];
+	const float k3 = val.distortion_k[3];
+	const float k4 = val.distortion_k[4];
+
+	float *out = (float *)results;
+
+	for (uint32_t i = 0; i < count; i++) {
+		float x = (u[i] * size_x - center_x) / val.scale;
+		float y = (v[i] * size_y - center_y) / val.scale;
+
+		float r_mag = sqrtf(x * x + y * y);
+		r_mag = k0 +                                // r^1
+		        k1 * r_mag +                        // r^2
+		        k2 * r_mag * r_mag +                // r^3
+		        k3 * r_mag * r_mag * r_mag +        // r^4
+		        k4 * r_mag * r_mag * r_mag * r_mag; // r^5
+
+		float dist_x = x * r_mag * val.scale;
+		float dist_y = y * r_mag * val.scale;
+
+		for (int c = 0; c < 3; c++) {
+			out[i * TRIPLET_FLOATS + c * 2 + 0] = (dist_x * val.aberration_k[c] + center_x) / size_x;
+			out[i * TRIPLET_FLOATS + c * 2 + 1] = (dist_y * val.aberration_k[c] + center_y) / size_y;
+		}
+	}
+
+	return true;
+}
+
 bool
 u_compute_distortion_cardboard(struct u_cardboard_distortion_values *values,
                                float u,
@@ -268,6 +410,41 @@ u_compute_distortion_cardboard(struct u_cardboard_distortion_values *values,
 	return true;
 }
 
+bool
+u_compute_distortion_cardboard_batch(struct u_cardboard_distortion_values *values,
+                                     uint32_t count,
+                                     const float *u,
+                                     const float *v,
+                                     struct xrt_uv_triplet *results)
+{
+	const struct u_cardboard_distortion_values val = *values;
+
+	for (uint32_t i = 0; i < count; i++) {
+		float x = u[i] * val.screen.size.x - val.screen.offset.x;
+		float y = v[i] * val.screen.size.y - val.screen.offset.y;
+
+		float sqrd = x * x + y * y;
+		float r = 1.0f;
+		float fact = 1.0f;
+		for (int k = 0; k < 5; k++) {
+			r *= sqrd;
+			fact += val.distortion_k[k] * r;
+		}
+
+		x = (x * fact + val.texture.offset.x) / val.texture.size.x;
+		y = (y * fact + val.texture.offset.y) / val.texture.size.y;
+
+		results[i].r.x = x;
+		results[i].r.y = y;
+		results[i].g.x = x;
+		results[i].g.y = y;
+		results[i].b.x = x;
+		results[i].b.y = y;
+	}
+
+	return true;
+}
+
 /*
  *
  * North Star "2D Polynomial" distortion
@@ -321,6 +498,45 @@ u_compute_distortion_ns_p2d(struct u_ns_p2d_values *values, int view, float u, f
 	return true;
 }
 
+bool
+u_compute_distortion_ns_p2d_batch(struct u_ns_p2d_values *values,
+                                  int view,
+                                  uint32_t count,
+                                  const float *u,
+                                  const float *v,
+                                  struct xrt_uv_triplet *results)
+{
+	// Same coefficient selection as u_compute_distortion_ns_p2d.
+	float *x_coefficients = view ? values->x_coefficients_left : values->x_coefficients_right;
+	float *y_coefficients = view ? values->y_coefficients_left : values->y_coefficients_right;
+
+	// The ray bounds only depend on the view, compute them once.
+	struct xrt_fov fov = values->fov[view];
+	const float left_ray_bound = tanf(fov.angle_left);
+	const float right_ray_bound = tanf(fov.angle_right);
+	const float up_ray_bound = tanf(fov.angle_up);
+	const float down_ray_bound = tanf(fov.angle_down);
+
+	for (uint32_t i = 0; i < count; i++) {
+		float flipped_v = 1.0f - v[i];
+
+		float x_ray = u_ns_polyval2d(u[i], flipped_v, x_coefficients);
+		float y_ray = u_ns_polyval2d(u[i], flipped_v, y_coefficients);
+
+		float u_eye = (float)math_map_ranges(x_ray, left_ray_bound, right_ray_bound, 0, 1);
+		float v_eye = (float)math_map_ranges(y_ray, down_ray_bound, up_ray_bound, 0, 1);
+
+		results[i].r.x = u_eye;
+		results[i].r.y = v_eye;
+		results[i].g.x = u_eye;
+		results[i].g.y = v_eye;
+		results[i].b.x = u_eye;
+		results[i].b.y = v_eye;
+	}
+
+	return true;
+}
+
 
 /*
  *
@@ -404,6 +620,66 @@ u_compute_distortion_ns_meshgrid(
 	return true;
 }
 
+bool
+u_compute_distortion_ns_meshgrid_batch(struct u_ns_meshgrid_values *values,
+                                       int view,
+                                       uint32_t count,
+                                       const float *u,
+                                       const float *v,
+                                       struct xrt_uv_triplet *results)
+{
+	// The ray bounds only depend on the view, compute them once.
+	struct xrt_fov fov = values->fov[view];
+	const float left_ray_bound = tan(fov.angle_left);
+	const float right_ray_bound = tan(fov.angle_right);
+	const float up_ray_bound = tan(fov.angle_up);
+	const float down_ray_bound = tan(fov.angle_down);
+
+	const int u_edge_num = (values->num_grid_points_u - 1);
+	const int v_edge_num = (values->num_grid_points_v - 1);
+	const int stride = values->num_grid_points_u;
+	const struct xrt_vec2 *grid = values->grid[view];
+	const float eps = 0.000001;
+
+	for (uint32_t i = 0; i < count; i++) {
+		int u_index_int = floorf(u[i] * u_edge_num);
+		int v_index_int = floorf(v[i] * v_edge_num);
+		float u_index_frac = (u[i] * u_edge_num) - u_index_int;
+		float v_index_frac = (v[i] * v_edge_num) - v_index_int;
+
+		int topleft_i = (v_index_int * stride) + u_index_int;
+		int topright_i = topleft_i + 1;
+		int bottomleft_i = topleft_i + stride;
+		int bottomright_i = bottomleft_i + 1;
+
+		// Same edge handling as u_compute_distortion_ns_meshgrid, never read outside of the grid.
+		struct xrt_vec2 bearing;
+		if (u_index_frac > eps && v_index_frac > eps) {
+			struct xrt_vec2 left = m_vec2_lerp(grid[topleft_i], grid[bottomleft_i], v_index_frac);
+			struct xrt_vec2 right = m_vec2_lerp(grid[topright_i], grid[bottomright_i], v_index_frac);
+			bearing = m_vec2_lerp(left, right, u_index_frac);
+		} else if (v_index_frac > eps) {
+			bearing = m_vec2_lerp(grid[topleft_i], grid[bottomleft_i], v_index_frac);
+		} else if (u_index_frac > eps) {
+			bearing = m_vec2_lerp(grid[topleft_i], grid[topright_i], u_index_frac);
+		} else {
+			bearing = grid[topleft_i];
+		}
+
+		float u_eye = math_map_ranges(bearing.x, left_ray_bound, right_ray_bound, 0, 1);
+		float v_eye = math_map_ranges(bearing.y, down_ray_bound, up_ray_bound, 0, 1);
+
+		results[i].r.x = u_eye;
+		results[i].r.y = v_eye;
+		results[i].g.x = u_eye;
+		results[i].g.y = v_eye;
+		results[i].b.x = u_eye;
+		results[i].b.y = v_eye;
+	}
+
+	return true;
+}
+
 
 bool
 u_compute_distortion_none(float u, float v, struct xrt_uv_triplet *result)
@@ -419,6 +695,104 @@ u_compute_distortion_none(float u, float v, struct xrt_uv_triplet *result)
 
 
 
+/*
+ *
+ * Batch evaluation.
+ *
+ */
+
+struct batch_task
+{
+	struct xrt_device *xdev;
+	uint32_t view;
+	uint32_t count;
+	const float *u;
+	const float *v;
+	struct xrt_uv_triplet *results;
+	bool ret;
+};
+
+static void
+batch_task_func(void *ptr)
+{
+	XRT_TRACE_MARKER();
+
+	struct batch_task *task = (struct batch_task *)ptr;
+
+	task->ret = xrt_device_compute_distortion_batch( //
+	    task->xdev,                                  //
+	    task->view,                                  //
+	    task->count,                                 //
+	    task->u,                                     //
+	    task->v,                                     //
+	    task->results);                              //
+}
+
+struct u_worker_thread_pool *
+u_distortion_mesh_create_worker_pool(void)
+{
+	uint32_t thread_count = (uint32_t)debug_get_num_option_distortion_threads();
+	if (thread_count <= 1) {
+		return NULL;
+	}
+
+	// The calling thread is donated to the pool when waiting.
+	return u_worker_thread_pool_create(thread_count - 1, thread_count, "Distortion");
+}
+
+bool
+u_distortion_mesh_compute_batch(struct u_worker_thread_pool *pool,
+                                struct xrt_device *xdev,
+                                uint32_t view,
+                                uint32_t count,
+                                const float *u,
+                                const float *v,
+                                struct xrt_uv_triplet *results)
+{
+	uint32_t thread_count = (uint32_t)debug_get_num_option_distortion_threads();
+	uint32_t task_count = MIN(thread_count, count / MIN_POINTS_PER_TASK);
+
+	/*
+	 * Only devices that implement the batch function have promised that
+	 * it is safe to call from multiple threads, everything else including
+	 * small batches is evaluated on this thread.
+	 */
+	if (pool == NULL || xdev->compute_distortion_batch == NULL || task_count <= 1) {
+		return xrt_device_compute_distortion_batch(xdev, view, count, u, v, results);
+	}
+
+	struct u_worker_group *group = u_worker_group_create(pool);
+	struct batch_task *tasks = U_TYPED_ARRAY_CALLOC(struct batch_task, task_count);
+
+	uint32_t chunk = (count + task_count - 1) / task_count;
+	for (uint32_t i = 0; i < task_count; i++) {
+		uint32_t start = i * chunk;
+		uint32_t end = MIN(start + chunk, count);
+
+		tasks[i].xdev = xdev;
+		tasks[i].view = view;
+		tasks[i].count = end - start;
+		tasks[i].u = &u[start];
+		tasks[i].v = &v[start];
+		tasks[i].results = &results[start];
+
+		u_worker_group_push(group, batch_task_func, &tasks[i]);
+	}
+
+	u_worker_group_wait_all(group);
+
+	bool ret = true;
+	for (uint32_t i = 0; i < task_count; i++) {
+		ret = ret && tasks[i].ret;
+	}
+
+	free(tasks);
+	u_worker_group_reference(&group, NULL);
+
+	return ret;
+}
+
+
 /*
  *
  * No distortion.
@@ -457,6 +831,7 @@ u_distortion_mesh_set_none(struct xrt_device *xdev)
 
 	// Make sure that the xdev implements the compute_distortion function.
 	xdev->compute_distortion = u_distortion_mesh_none;
+	xdev->compute_distortion_batch = NULL;
 
 	// Make the target completely usable.
 	target->distortion.models |= XRT_DISTORTION_MODEL_COMPUTE;
@@ -20,6 +20,8 @@
 extern "C" {
 #endif
 
+struct u_worker_thread_pool;
+
 
 /*
  *
@@ -54,6 +56,19 @@ struct u_panotools_values
 bool
 u_compute_distortion_panotools(struct u_panotools_values *values, float u, float v, struct xrt_uv_triplet *result);
 
+/*!
+ * Batched version of @ref u_compute_distortion_panotools, evaluates @p count
+ * points given as separate @p u and @p v arrays.
+ *
+ * @ingroup aux_distortion
+ */
+bool
+u_compute_distortion_panotools_batch(struct u_panotools_values *values,
+                                     uint32_t count,
+                                     const float *u,
+                                     const float *v,
+                                     struct xrt_uv_triplet *results);
+
 
 /*
  *
@@ -89,6 +104,16 @@ struct u_vive_values
 bool
 u_compute_distortion_vive(struct u_vive_values *values, float u, float v, struct xrt_uv_triplet *result);
 
+/*!
+ * Batched version of @ref u_compute_distortion_vive, evaluates @p count
+ * points given as separate @p u and @p v arrays.
+ *
+ * @ingroup aux_distortion
+ */
+bool
+u_compute_distortion_vive_batch(
+    struct u_vive_values *values, uint32_t count, const float *u, const float *v, struct xrt_uv_triplet *results);
+
 
 /*
  *
@@ -107,6 +132,19 @@ u_compute_distortion_cardboard(struct u_cardboard_distortion_values *values,
                                float v,
                                struct xrt_uv_triplet *result);
 
+/*!
+ * Batched version of @ref u_compute_distortion_cardboard, evaluates @p count
+ * points given as separate @p u and @p v arrays.
+ *
+ * @ingroup aux_distortion
+ */
+bool
+u_compute_distortion_cardboard_batch(struct u_cardboard_distortion_values *values,
+                                     uint32_t count,
+                                     const float *u,
+                                     const float *v,
+                                     struct xrt_uv_triplet *results);
+
 
 /*
  *
@@ -132,6 +170,20 @@ struct u_ns_p2d_values
 bool
 u_compute_distortion_ns_p2d(struct u_ns_p2d_values *values, int view, float u, float v, struct xrt_uv_triplet *result);
 
+/*!
+ * Batched version of @ref u_compute_distortion_ns_p2d, evaluates @p count
+ * points given as separate @p u and @p v arrays.
+ *
+ * @ingroup aux_distortion
+ */
+bool
+u_compute_distortion_ns_p2d_batch(struct u_ns_p2d_values *values,
+                                  int view,
+                                  uint32_t count,
+                                  const float *u,
+                                  const float *v,
+                                  struct xrt_uv_triplet *results);
+
 /*
  *
  * Values for Moshi Turner's North Star distortion correction.
@@ -157,6 +209,20 @@ bool
 u_compute_distortion_ns_meshgrid(
     struct u_ns_meshgrid_values *values, int view, float u, float v, struct xrt_uv_triplet *result);
 
+/*!
+ * Batched version of @ref u_compute_distortion_ns_meshgrid, evaluates @p count
+ * points given as separate @p u and @p v arrays.
+ *
+ * @ingroup aux_distortion
+ */
+bool
+u_compute_distortion_ns_meshgrid_batch(struct u_ns_meshgrid_values *values,
+                                       int view,
+                                       uint32_t count,
+                                       const float *u,
+                                       const float *v,
+                                       struct xrt_uv_triplet *results);
+
 
 /*
  *
@@ -219,6 +285,34 @@ u_distortion_mesh_fill_in_none(struct xrt_device *xdev);
 void
 u_distortion_mesh_set_none(struct xrt_device *xdev);
 
+/*!
+ * Creates a worker thread pool sized by `XRT_DISTORTION_THREADS` for use with
+ * @ref u_distortion_mesh_compute_batch, returns NULL if threading is disabled.
+ * Create it once and reuse it for all evaluations made by the caller.
+ *
+ * @ingroup aux_distortion
+ */
+struct u_worker_thread_pool *
+u_distortion_mesh_create_worker_pool(void);
+
+/*!
+ * Evaluates the distortion of @p xdev at @p count points. If the device
+ * implements @ref xrt_device::compute_distortion_batch and a @p pool is given
+ * the points are split into chunks that are evaluated on the pool, otherwise
+ * they are evaluated on the calling thread.
+ *
+ * @relatesalso xrt_device
+ * @ingroup aux_distortion
+ */
+bool
+u_distortion_mesh_compute_batch(struct u_worker_thread_pool *pool,
+                                struct xrt_device *xdev,
+                                uint32_t view,
+                                uint32_t count,
+                                const float *u,
+                                const float *v,
+                                struct xrt_uv_triplet *results);
+
 
 #ifdef __cplusplus
 }
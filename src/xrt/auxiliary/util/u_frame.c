@@ -143,3 +143,19 @@ u_frame_create_roi(struct xrt_frame *original, struct xrt_rect roi, struct xrt_f
 
 	xrt_frame_reference(out_frame, xf);
 }
+
+void
+u_frame_get_bundle_view(struct xrt_frame_bundle *bundle, int index, struct xrt_frame **out_frame)
+{
+	assert(index >= 0 && index < bundle->view_count);
+	struct xrt_frame *xf = bundle->frames[index];
+	struct xrt_rect roi = bundle->rois[index];
+
+	bool whole = roi.offset.w == 0 && roi.offset.h == 0 && //
+	             (uint32_t)roi.extent.w == xf->width && (uint32_t)roi.extent.h == xf->height;
+	if (whole) {
+		xrt_frame_reference(out_frame, xf);
+	} else {
+		u_frame_create_roi(xf, roi, out_frame);
+	}
+}
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "xrt/xrt_frame.h"
+#include "xrt/xrt_tracking.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,6 +38,13 @@ u_frame_clone(struct xrt_frame *to_copy, struct xrt_frame **out_frame);
 void
 u_frame_create_roi(struct xrt_frame *original, struct xrt_rect roi, struct xrt_frame **out_frame);
 
+/*!
+ * Gets view @p index of @p bundle as a frame of its own, references the frame
+ * directly if the view covers all of it and creates a ROI frame otherwise.
+ */
+void
+u_frame_get_bundle_view(struct xrt_frame_bundle *bundle, int index, struct xrt_frame **out_frame);
+
 #ifdef __cplusplus
 }
 #endif
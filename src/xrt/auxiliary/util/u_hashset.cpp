@@ -11,7 +11,7 @@
 #include "util/u_hashset.h"
 
 #include <cstring>
-#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
@@ -24,10 +24,28 @@
 
 struct u_hashset
 {
-	std::unordered_map<std::string, struct u_hashset_item *> map = {};
+	/*!
+	 * The keys point at the string stored after each item, so lookups
+	 * never allocate. Because of this items must be erased before they
+	 * are freed.
+	 */
+	std::unordered_map<std::string_view, struct u_hashset_item *> map = {};
 };
 
 
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static inline std::string_view
+item_key(struct u_hashset_item *item)
+{
+	return std::string_view(item->c_str(), item->length);
+}
+
+
 /*
  *
  * "Exported" functions.
@@ -50,11 +68,16 @@ u_hashset_destroy(struct u_hashset **hs)
 	return 0;
 }
 
+extern "C" void
+u_hashset_reserve(struct u_hashset *hs, size_t count)
+{
+	hs->map.reserve(count);
+}
+
 extern "C" int
 u_hashset_find_str(struct u_hashset *hs, const char *str, size_t length, struct u_hashset_item **out_item)
 {
-	std::string key = std::string(str, length);
-	auto search = hs->map.find(key);
+	auto search = hs->map.find(std::string_view(str, length));
 
 	if (search != hs->map.end()) {
 		*out_item = search->second;
@@ -73,8 +96,10 @@ u_hashset_find_c_str(struct u_hashset *hs, const char *c_str, struct u_hashset_i
 extern "C" int
 u_hashset_insert_item(struct u_hashset *hs, struct u_hashset_item *item)
 {
-	std::string key = std::string(item->c_str(), item->length);
-	hs->map[key] = item;
+	// The key of a replaced item points to its string, so replace it too.
+	std::string_view key = item_key(item);
+	hs->map.erase(key);
+	hs->map.emplace(key, item);
 	return 0;
 }
 
@@ -109,8 +134,7 @@ u_hashset_create_and_insert_str(struct u_hashset *hs, const char *str, size_t le
 	}
 	store[length] = '\0';
 
-	std::string key = std::string(item->c_str(), item->length);
-	hs->map[key] = item;
+	hs->map.emplace(item_key(item), item);
 
 	*out_item = item;
 
@@ -127,16 +151,14 @@ u_hashset_create_and_insert_str_c(struct u_hashset *hs, const char *c_str, struc
 extern "C" int
 u_hashset_erase_item(struct u_hashset *hs, struct u_hashset_item *item)
 {
-	std::string key = std::string(item->c_str(), item->length);
-	hs->map.erase(key);
+	hs->map.erase(item_key(item));
 	return 0;
 }
 
 extern "C" int
 u_hashset_erase_str(struct u_hashset *hs, const char *str, size_t length)
 {
-	std::string key = std::string(str, length);
-	hs->map.erase(key);
+	hs->map.erase(std::string_view(str, length));
 	return 0;
 }
 
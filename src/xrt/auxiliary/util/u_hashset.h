@@ -57,6 +57,14 @@ u_hashset_create(struct u_hashset **out_hashset);
 int
 u_hashset_destroy(struct u_hashset **hs);
 
+/*!
+ * Make room for at least @p count items without rehashing.
+ *
+ * @ingroup aux_util
+ */
+void
+u_hashset_reserve(struct u_hashset *hs, size_t count);
+
 int
 u_hashset_find_str(struct u_hashset *hs, const char *str, size_t length, struct u_hashset_item **out_item);
 
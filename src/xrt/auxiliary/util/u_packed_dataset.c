@@ -0,0 +1,808 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Single file container for recorded tracking sessions.
+ * @ingroup aux_util
+ */
+
+#include "xrt/xrt_config_os.h"
+
+#include "math/m_api.h"
+
+#include "util/u_misc.h"
+#include "util/u_format.h"
+#include "util/u_logging.h"
+#include "util/u_packed_dataset.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef XRT_OS_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+/*!
+ * Writes records to a file, keeps track of chunks for the index.
+ */
+struct u_pd_writer
+{
+	FILE *file;
+
+	struct u_pd_file_header header;
+
+	//! Offset in the file where the next record is written.
+	uint64_t offset;
+
+	//! The chunk currently being written, not yet in @ref chunks.
+	struct u_pd_chunk current;
+
+	//! Finished chunks.
+	struct u_pd_chunk *chunks;
+	uint32_t chunk_capacity;
+
+	//! Set when growing the chunk index failed, nothing more is written.
+	bool failed;
+
+	//! Used for compressing and for packing rows of frames.
+	uint8_t *scratch;
+	size_t scratch_size;
+	uint8_t *packed;
+	size_t packed_size;
+};
+
+static_assert(sizeof(struct u_pd_file_header) % U_PD_ALIGNMENT == 0, "Header must keep records aligned");
+static_assert(sizeof(struct u_pd_record_header) % U_PD_ALIGNMENT == 0, "Header must keep payloads aligned");
+static_assert(sizeof(struct u_pd_frame_header) % U_PD_ALIGNMENT == 0, "Header must keep pixels aligned");
+
+//! IMU record payload.
+struct u_pd_imu
+{
+	double accel_m_s2[3];
+	double gyro_rad_secs[3];
+};
+
+//! Ground truth record payload.
+struct u_pd_gt
+{
+	struct xrt_pose pose;
+};
+
+
+/*
+ *
+ * LZ4 block format.
+ *
+ * A small implementation of the LZ4 block format, compatible with the
+ * reference LZ4_compress_default and LZ4_decompress_safe. It uses a single
+ * pass greedy matcher which is plenty for camera frames, where most of the
+ * gain comes from long runs and repeated rows.
+ *
+ */
+
+#define LZ4_MIN_MATCH 4
+#define LZ4_HASH_LOG 12
+#define LZ4_MAX_OFFSET 65535
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MF_LIMIT 12
+#define LZ4_WILD_COPY 16
+
+static inline uint32_t
+lz4_read32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint32_t
+lz4_hash(uint32_t sequence)
+{
+	return (sequence * 2654435761U) >> (32 - LZ4_HASH_LOG);
+}
+
+static inline uint8_t *
+lz4_write_length(uint8_t *op, size_t length)
+{
+	while (length >= 255) {
+		*op++ = 255;
+		length -= 255;
+	}
+	*op++ = (uint8_t)length;
+	return op;
+}
+
+//! Worst case size of compressing @p size bytes.
+static inline size_t
+lz4_compress_bound(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+//! Returns the compressed size, @p dst must be @ref lz4_compress_bound bytes.
+static size_t
+lz4_compress(const uint8_t *src, size_t src_size, uint8_t *dst)
+{
+	uint32_t table[1 << LZ4_HASH_LOG] = {0};
+
+	const uint8_t *ip = src;
+	const uint8_t *anchor = src;
+	const uint8_t *end = src + src_size;
+	uint8_t *op = dst;
+
+	if (src_size >= LZ4_MF_LIMIT + 1) {
+		const uint8_t *mf_limit = end - LZ4_MF_LIMIT;
+		const uint8_t *match_limit = end - LZ4_LAST_LITERALS;
+		uint32_t misses = 0;
+
+		while (ip < mf_limit) {
+			uint32_t sequence = lz4_read32(ip);
+			uint32_t h = lz4_hash(sequence);
+			const uint8_t *ref = src + table[h];
+			table[h] = (uint32_t)(ip - src);
+
+			if (ref >= ip || ip - ref > LZ4_MAX_OFFSET || lz4_read32(ref) != sequence) {
+				// Skip ahead faster through data that doesn't compress.
+				ip += 1 + (misses++ >> 6);
+				continue;
+			}
+			misses = 0;
+
+			const uint8_t *m = ip + LZ4_MIN_MATCH;
+			const uint8_t *r = ref + LZ4_MIN_MATCH;
+			while (m < match_limit && *m == *r) {
+				m++;
+				r++;
+			}
+
+			size_t literals = (size_t)(ip - anchor);
+			size_t match = (size_t)(m - ip) - LZ4_MIN_MATCH;
+			uint16_t offset = (uint16_t)(ip - ref);
+
+			uint8_t *token = op++;
+			*token = (uint8_t)((MIN(literals, 15) << 4) | MIN(match, 15));
+			if (literals >= 15) {
+				op = lz4_write_length(op, literals - 15);
+			}
+			memcpy(op, anchor, literals);
+			op += literals;
+
+			*op++ = (uint8_t)(offset & 0xff);
+			*op++ = (uint8_t)(offset >> 8);
+			if (match >= 15) {
+				op = lz4_write_length(op, match - 15);
+			}
+
+			ip = m;
+			anchor = ip;
+		}
+	}
+
+	// Last literals, always at least the last five bytes.
+	size_t literals = (size_t)(end - anchor);
+	*op++ = (uint8_t)(MIN(literals, 15) << 4);
+	if (literals >= 15) {
+		op = lz4_write_length(op, literals - 15);
+	}
+	memcpy(op, anchor, literals);
+	op += literals;
+
+	return (size_t)(op - dst);
+}
+
+//! Bounds checked, so safe to use on data from a file.
+static int
+lz4_decompress(const uint8_t *src, size_t src_size, uint8_t *dst, size_t dst_size)
+{
+	const uint8_t *ip = src;
+	const uint8_t *iend = src + src_size;
+	uint8_t *op = dst;
+	uint8_t *oend = dst + dst_size;
+
+	while (ip < iend) {
+		uint8_t token = *ip++;
+
+		size_t literals = token >> 4;
+		if (literals == 15) {
+			uint8_t b;
+			do {
+				if (ip >= iend) {
+					return -1;
+				}
+				b = *ip++;
+				literals += b;
+			} while (b == 255);
+		}
+
+		if (literals > (size_t)(iend - ip) || literals > (size_t)(oend - op)) {
+			return -1;
+		}
+		if (literals <= LZ4_WILD_COPY && iend - ip >= LZ4_WILD_COPY && oend - op >= LZ4_WILD_COPY) {
+			// Most literal runs are short, a fixed size copy is much cheaper.
+			memcpy(op, ip, LZ4_WILD_COPY);
+		} else {
+			memcpy(op, ip, literals);
+		}
+		ip += literals;
+		op += literals;
+
+		// The last sequence only has literals.
+		if (ip >= iend) {
+			break;
+		}
+
+		if (iend - ip < 2) {
+			return -1;
+		}
+		size_t offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (size_t)(op - dst)) {
+			return -1;
+		}
+
+		size_t match = token & 15;
+		if (match == 15) {
+			uint8_t b;
+			do {
+				if (ip >= iend) {
+					return -1;
+				}
+				b = *ip++;
+				match += b;
+			} while (b == 255);
+		}
+		match += LZ4_MIN_MATCH;
+
+		if (match > (size_t)(oend - op)) {
+			return -1;
+		}
+
+		const uint8_t *ref = op - offset;
+		size_t rounded = (match + LZ4_WILD_COPY - 1) & ~(size_t)(LZ4_WILD_COPY - 1);
+		if (offset >= LZ4_WILD_COPY && rounded <= (size_t)(oend - op)) {
+			// Same as above, may write past the match but stays within the output.
+			for (size_t i = 0; i < match; i += LZ4_WILD_COPY) {
+				memcpy(op + i, ref + i, LZ4_WILD_COPY);
+			}
+		} else if (offset >= match) {
+			memcpy(op, ref, match);
+		} else {
+			// Overlapping match repeats the last offset bytes, copy byte by byte.
+			for (size_t i = 0; i < match; i++) {
+				op[i] = ref[i];
+			}
+		}
+		op += match;
+	}
+
+	return op == oend ? 0 : -1;
+}
+
+
+/*
+ *
+ * Writer helpers.
+ *
+ */
+
+static inline size_t
+padding_for(size_t size)
+{
+	return (U_PD_ALIGNMENT - (size % U_PD_ALIGNMENT)) % U_PD_ALIGNMENT;
+}
+
+static bool
+ensure_buffer(uint8_t **buffer, size_t *buffer_size, size_t size)
+{
+	if (*buffer_size >= size) {
+		return true;
+	}
+
+	uint8_t *ptr = U_TYPED_ARRAY_CALLOC(uint8_t, size);
+	if (ptr == NULL) {
+		return false;
+	}
+
+	free(*buffer);
+	*buffer = ptr;
+	*buffer_size = size;
+
+	return true;
+}
+
+static void
+finish_chunk(struct u_pd_writer *pdw)
+{
+	if (pdw->current.record_count == 0) {
+		return;
+	}
+
+	if (pdw->header.chunk_count >= pdw->chunk_capacity) {
+		uint32_t capacity = MAX(pdw->chunk_capacity * 2, 64);
+		U_ARRAY_REALLOC_OR_FREE(pdw->chunks, struct u_pd_chunk, capacity);
+		if (pdw->chunks == NULL) {
+			U_LOG_E("Failed to grow packed dataset index");
+			pdw->header.chunk_count = 0;
+			pdw->chunk_capacity = 0;
+			pdw->failed = true;
+			return;
+		}
+		pdw->chunk_capacity = capacity;
+	}
+
+	pdw->chunks[pdw->header.chunk_count++] = pdw->current;
+
+	U_ZERO(&pdw->current);
+	pdw->current.offset = pdw->offset;
+}
+
+static int
+write_record(struct u_pd_writer *pdw,
+             enum u_pd_record_type type,
+             int64_t timestamp_ns,
+             const void *payload_a,
+             size_t size_a,
+             const void *payload_b,
+             size_t size_b)
+{
+	static const uint8_t zeros[U_PD_ALIGNMENT] = {0};
+
+	if (pdw->failed) {
+		return -1;
+	}
+
+	struct u_pd_record_header rh = {
+	    .type = (uint32_t)type,
+	    .size = (uint32_t)(size_a + size_b),
+	    .timestamp_ns = timestamp_ns,
+	};
+	size_t padding = padding_for(size_a + size_b);
+
+	size_t written = 0;
+	written += fwrite(&rh, 1, sizeof(rh), pdw->file);
+	written += fwrite(payload_a, 1, size_a, pdw->file);
+	if (size_b > 0) {
+		written += fwrite(payload_b, 1, size_b, pdw->file);
+	}
+	written += fwrite(zeros, 1, padding, pdw->file);
+
+	size_t total = sizeof(rh) + size_a + size_b + padding;
+	if (written != total) {
+		U_LOG_E("Failed to write record to packed dataset");
+		return -1;
+	}
+
+	struct u_pd_chunk *c = &pdw->current;
+	if (c->record_count == 0) {
+		c->first_ts = timestamp_ns;
+		c->last_ts = timestamp_ns;
+	}
+	c->first_ts = MIN(c->first_ts, timestamp_ns);
+	c->last_ts = MAX(c->last_ts, timestamp_ns);
+	c->record_count++;
+	c->frame_count += type == U_PD_RECORD_FRAME ? 1 : 0;
+	c->size += total;
+	pdw->offset += total;
+
+	if (c->size >= pdw->header.chunk_size) {
+		finish_chunk(pdw);
+	}
+
+	return 0;
+}
+
+
+/*
+ *
+ * Writer functions.
+ *
+ */
+
+int
+u_pd_writer_create(const char *path, uint32_t cam_count, uint32_t chunk_size, struct u_pd_writer **out_writer)
+{
+	FILE *file = fopen(path, "wb");
+	if (file == NULL) {
+		U_LOG_E("Could not create packed dataset '%s'", path);
+		return -1;
+	}
+
+	// Frames are large, fewer bigger writes help.
+	(void)setvbuf(file, NULL, _IOFBF, 1024 * 1024);
+
+	struct u_pd_writer *pdw = U_TYPED_CALLOC(struct u_pd_writer);
+	pdw->file = file;
+
+	memcpy(pdw->header.magic, U_PD_MAGIC, sizeof(U_PD_MAGIC));
+	pdw->header.version = U_PD_VERSION;
+	pdw->header.cam_count = cam_count;
+	pdw->header.chunk_size = chunk_size > 0 ? chunk_size : U_PD_DEFAULT_CHUNK_SIZE;
+
+	// Written again with the index offset on close.
+	if (fwrite(&pdw->header, sizeof(pdw->header), 1, file) != 1) {
+		U_LOG_E("Could not write packed dataset header '%s'", path);
+		fclose(file);
+		free(pdw);
+		return -1;
+	}
+
+	pdw->offset = sizeof(pdw->header);
+	pdw->current.offset = pdw->offset;
+
+	*out_writer = pdw;
+
+	return 0;
+}
+
+int
+u_pd_writer_push_imu(struct u_pd_writer *pdw, const struct xrt_imu_sample *sample)
+{
+	struct u_pd_imu imu = {
+	    .accel_m_s2 = {sample->accel_m_s2.x, sample->accel_m_s2.y, sample->accel_m_s2.z},
+	    .gyro_rad_secs = {sample->gyro_rad_secs.x, sample->gyro_rad_secs.y, sample->gyro_rad_secs.z},
+	};
+
+	return write_record(pdw, U_PD_RECORD_IMU, sample->timestamp_ns, &imu, sizeof(imu), NULL, 0);
+}
+
+int
+u_pd_writer_push_gt(struct u_pd_writer *pdw, const struct xrt_pose_sample *sample)
+{
+	struct u_pd_gt gt = {.pose = sample->pose};
+
+	return write_record(pdw, U_PD_RECORD_GT, sample->timestamp_ns, &gt, sizeof(gt), NULL, 0);
+}
+
+int
+u_pd_writer_push_frame(struct u_pd_writer *pdw, uint32_t cam_index, struct xrt_frame *xf, enum u_pd_codec codec)
+{
+	size_t row_size = 0;
+	size_t size = 0;
+	u_format_size_for_dimensions(xf->format, xf->width, xf->height, &row_size, &size);
+
+	// Rows are stored tightly packed.
+	const uint8_t *pixels = xf->data;
+	if (xf->stride != row_size) {
+		if (!ensure_buffer(&pdw->packed, &pdw->packed_size, size)) {
+			return -1;
+		}
+		for (uint32_t y = 0; y < xf->height; y++) {
+			memcpy(pdw->packed + y * row_size, xf->data + y * xf->stride, row_size);
+		}
+		pixels = pdw->packed;
+	}
+
+	const uint8_t *data = pixels;
+	size_t data_size = size;
+	if (codec == U_PD_CODEC_LZ4) {
+		if (!ensure_buffer(&pdw->scratch, &pdw->scratch_size, lz4_compress_bound(size))) {
+			return -1;
+		}
+
+		size_t compressed = lz4_compress(pixels, size, pdw->scratch);
+		if (compressed < size) {
+			data = pdw->scratch;
+			data_size = compressed;
+		} else {
+			codec = U_PD_CODEC_RAW;
+		}
+	}
+
+	struct u_pd_frame_header fh = {
+	    .cam_index = cam_index,
+	    .codec = (uint32_t)codec,
+	    .format = (uint32_t)xf->format,
+	    .width = xf->width,
+	    .height = xf->height,
+	    .stride = (uint32_t)row_size,
+	    .data_size = (uint32_t)data_size,
+	};
+
+	return write_record(pdw, U_PD_RECORD_FRAME, (int64_t)xf->timestamp, &fh, sizeof(fh), data, data_size);
+}
+
+int
+u_pd_writer_close(struct u_pd_writer **pdw_ptr)
+{
+	struct u_pd_writer *pdw = *pdw_ptr;
+	if (pdw == NULL) {
+		return 0;
+	}
+
+	finish_chunk(pdw);
+
+	int ret = 0;
+	// Without an index the file can still be read from start to end.
+	size_t index_size = sizeof(struct u_pd_chunk) * pdw->header.chunk_count;
+	if (!pdw->failed && pdw->header.chunk_count > 0) {
+		if (fwrite(pdw->chunks, 1, index_size, pdw->file) == index_size) {
+			pdw->header.index_offset = pdw->offset;
+		} else {
+			U_LOG_E("Failed to write packed dataset index");
+			pdw->header.chunk_count = 0;
+			ret = -1;
+		}
+	}
+
+	if (fseek(pdw->file, 0, SEEK_SET) != 0 || fwrite(&pdw->header, sizeof(pdw->header), 1, pdw->file) != 1) {
+		U_LOG_E("Failed to update packed dataset header");
+		ret = -1;
+	}
+
+	if (fclose(pdw->file) != 0) {
+		ret = -1;
+	}
+
+	free(pdw->chunks);
+	free(pdw->scratch);
+	free(pdw->packed);
+	free(pdw);
+	*pdw_ptr = NULL;
+
+	return ret;
+}
+
+
+/*
+ *
+ * Reader functions.
+ *
+ */
+
+static int
+map_file(struct u_pd_reader *pdr, const char *path)
+{
+#ifdef XRT_OS_UNIX
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return -1;
+	}
+
+	void *ptr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (ptr == MAP_FAILED) {
+		return -1;
+	}
+
+	// Mostly read front to back during playback.
+	(void)madvise(ptr, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+	pdr->data = (const uint8_t *)ptr;
+	pdr->size = (size_t)st.st_size;
+	pdr->mapped = true;
+
+	return 0;
+#else
+	// No mapping, read the whole file instead.
+	FILE *file = fopen(path, "rb");
+	if (file == NULL) {
+		return -1;
+	}
+
+	long size = 0;
+	if (fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) <= 0 || fseek(file, 0, SEEK_SET) != 0) {
+		fclose(file);
+		return -1;
+	}
+
+	uint8_t *data = U_TYPED_ARRAY_CALLOC(uint8_t, (size_t)size);
+	if (data == NULL || fread(data, 1, (size_t)size, file) != (size_t)size) {
+		free(data);
+		fclose(file);
+		return -1;
+	}
+	fclose(file);
+
+	pdr->data = data;
+	pdr->size = (size_t)size;
+	pdr->mapped = false;
+
+	return 0;
+#endif
+}
+
+//! Every chunk must start at an aligned record inside the records, in file order.
+static bool
+chunks_are_valid(const struct u_pd_chunk *chunks, uint32_t chunk_count, size_t records_end)
+{
+	uint64_t last_offset = sizeof(struct u_pd_file_header);
+
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		const struct u_pd_chunk *c = &chunks[i];
+		if (c->offset < last_offset || c->offset >= records_end || c->offset % U_PD_ALIGNMENT != 0 ||
+		    c->size > records_end - c->offset) {
+			return false;
+		}
+		last_offset = c->offset;
+	}
+
+	return true;
+}
+
+int
+u_pd_reader_open(struct u_pd_reader *pdr, const char *path)
+{
+	U_ZERO(pdr);
+
+	if (map_file(pdr, path) != 0) {
+		U_LOG_E("Could not open packed dataset '%s'", path);
+		return -1;
+	}
+
+	struct u_pd_file_header *h = &pdr->header;
+	if (pdr->size < sizeof(*h)) {
+		U_LOG_E("Packed dataset '%s' is too small", path);
+		u_pd_reader_close(pdr);
+		return -1;
+	}
+
+	memcpy(h, pdr->data, sizeof(*h));
+	if (memcmp(h->magic, U_PD_MAGIC, sizeof(U_PD_MAGIC)) != 0 || h->version != U_PD_VERSION) {
+		U_LOG_E("'%s' is not a packed dataset, or of an unsupported version", path);
+		u_pd_reader_close(pdr);
+		return -1;
+	}
+
+	pdr->records_end = pdr->size;
+
+	size_t index_size = sizeof(struct u_pd_chunk) * (size_t)h->chunk_count;
+	if (h->index_offset != 0 && h->index_offset <= pdr->size && index_size <= pdr->size - h->index_offset &&
+	    h->index_offset % U_PD_ALIGNMENT == 0 && h->index_offset >= sizeof(*h)) {
+		const struct u_pd_chunk *chunks = (const struct u_pd_chunk *)(pdr->data + h->index_offset);
+		pdr->records_end = (size_t)h->index_offset;
+
+		// Seeking uses the offsets as the cursor, without the index it falls back to reading from the start.
+		if (chunks_are_valid(chunks, h->chunk_count, pdr->records_end)) {
+			pdr->chunks = chunks;
+			pdr->chunk_count = h->chunk_count;
+		} else {
+			U_LOG_W("Packed dataset '%s' has a damaged index, seeking will be slow", path);
+		}
+	} else {
+		U_LOG_W("Packed dataset '%s' has no index, was the recording cut short?", path);
+	}
+
+	pdr->cursor = sizeof(*h);
+
+	return 0;
+}
+
+bool
+u_pd_reader_next(struct u_pd_reader *pdr, struct u_pd_record *out_record)
+{
+	while (pdr->cursor < pdr->records_end) {
+		size_t remaining = pdr->records_end - pdr->cursor;
+		if (remaining < sizeof(struct u_pd_record_header)) {
+			return false;
+		}
+
+		const uint8_t *ptr = pdr->data + pdr->cursor;
+		const struct u_pd_record_header *rh = (const struct u_pd_record_header *)ptr;
+		const uint8_t *payload = ptr + sizeof(*rh);
+
+		size_t total = sizeof(*rh) + (size_t)rh->size + padding_for(rh->size);
+		if (total > remaining) {
+			return false;
+		}
+
+		U_ZERO(out_record);
+		out_record->type = (enum u_pd_record_type)rh->type;
+		out_record->timestamp_ns = rh->timestamp_ns;
+
+		switch (rh->type) {
+		case U_PD_RECORD_IMU: {
+			if (rh->size < sizeof(struct u_pd_imu)) {
+				return false;
+			}
+			const struct u_pd_imu *imu = (const struct u_pd_imu *)payload;
+			const double *a = imu->accel_m_s2;
+			const double *w = imu->gyro_rad_secs;
+			out_record->imu.timestamp_ns = rh->timestamp_ns;
+			out_record->imu.accel_m_s2 = (struct xrt_vec3_f64){a[0], a[1], a[2]};
+			out_record->imu.gyro_rad_secs = (struct xrt_vec3_f64){w[0], w[1], w[2]};
+		} break;
+		case U_PD_RECORD_GT: {
+			if (rh->size < sizeof(struct u_pd_gt)) {
+				return false;
+			}
+			const struct u_pd_gt *gt = (const struct u_pd_gt *)payload;
+			out_record->gt.timestamp_ns = rh->timestamp_ns;
+			out_record->gt.pose = gt->pose;
+		} break;
+		case U_PD_RECORD_FRAME: {
+			if (rh->size < sizeof(struct u_pd_frame_header)) {
+				return false;
+			}
+			const struct u_pd_frame_header *fh = (const struct u_pd_frame_header *)payload;
+			if (fh->data_size > rh->size - sizeof(*fh)) {
+				return false;
+			}
+			out_record->frame.header = fh;
+			out_record->frame.data = payload + sizeof(*fh);
+		} break;
+		default:
+			// Skip unknown records, allows adding new types later.
+			pdr->cursor += total;
+			continue;
+		}
+
+		pdr->cursor += total;
+		return true;
+	}
+
+	return false;
+}
+
+void
+u_pd_reader_seek(struct u_pd_reader *pdr, int64_t timestamp_ns)
+{
+	pdr->cursor = sizeof(pdr->header);
+
+	// Chunks are in file order, and samples are pushed mostly in order.
+	uint32_t low = 0;
+	uint32_t high = pdr->chunk_count;
+	while (low < high) {
+		uint32_t mid = low + (high - low) / 2;
+		if (pdr->chunks[mid].last_ts < timestamp_ns) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+
+	if (low < pdr->chunk_count) {
+		pdr->cursor = (size_t)pdr->chunks[low].offset;
+	} else if (pdr->chunk_count > 0) {
+		pdr->cursor = pdr->records_end;
+	}
+}
+
+int
+u_pd_frame_decode(const struct u_pd_record *record, uint8_t *dst, size_t dst_size)
+{
+	assert(record->type == U_PD_RECORD_FRAME);
+
+	const struct u_pd_frame_header *fh = record->frame.header;
+	size_t size = u_pd_frame_size(record);
+	if (dst_size < size) {
+		return -1;
+	}
+
+	switch (fh->codec) {
+	case U_PD_CODEC_RAW:
+		if (fh->data_size != size) {
+			return -1;
+		}
+		memcpy(dst, record->frame.data, size);
+		return 0;
+	case U_PD_CODEC_LZ4: return lz4_decompress(record->frame.data, fh->data_size, dst, size);
+	default: return -1;
+	}
+}
+
+void
+u_pd_reader_close(struct u_pd_reader *pdr)
+{
+#ifdef XRT_OS_UNIX
+	if (pdr->mapped) {
+		munmap((void *)pdr->data, pdr->size);
+	}
+#endif
+	if (!pdr->mapped) {
+		free((void *)pdr->data);
+	}
+
+	U_ZERO(pdr);
+}
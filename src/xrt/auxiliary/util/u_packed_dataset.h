@@ -0,0 +1,301 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Single file container for recorded tracking sessions.
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+#include "xrt/xrt_defines.h"
+#include "xrt/xrt_frame.h"
+#include "xrt/xrt_tracking.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*!
+ * @defgroup aux_packed_dataset Packed dataset
+ * @ingroup aux_util
+ *
+ * @brief Records camera frames, IMU and ground truth samples of a tracking
+ * session into a single file, and reads them back without copying.
+ *
+ * The file starts with a @ref u_pd_file_header, followed by records in the
+ * order they were pushed. Each record is a @ref u_pd_record_header followed by
+ * its payload, payloads are padded so every record and frame data starts 16
+ * byte aligned in the file. Records are grouped into chunks of roughly
+ * @ref u_pd_file_header::chunk_size bytes, and the chunk index is written at
+ * the end of the file when the writer is closed. A file without an index, from
+ * a recording that was cut short, can still be read from start to end.
+ *
+ * Frames are stored either raw or compressed with the LZ4 block format. All
+ * values are stored in the byte order of the machine that wrote the file.
+ */
+
+#define U_PD_MAGIC "MNDPACK"
+#define U_PD_VERSION 1
+#define U_PD_ALIGNMENT 16
+#define U_PD_DEFAULT_CHUNK_SIZE (4 * 1024 * 1024)
+
+/*!
+ * Type of a record.
+ *
+ * @ingroup aux_packed_dataset
+ */
+enum u_pd_record_type
+{
+	U_PD_RECORD_IMU = 1,
+	U_PD_RECORD_GT = 2,
+	U_PD_RECORD_FRAME = 3,
+};
+
+/*!
+ * How the pixels of a frame are stored.
+ *
+ * @ingroup aux_packed_dataset
+ */
+enum u_pd_codec
+{
+	U_PD_CODEC_RAW = 0,
+	U_PD_CODEC_LZ4 = 1,
+};
+
+/*!
+ * First bytes of the file.
+ *
+ * @ingroup aux_packed_dataset
+ */
+struct u_pd_file_header
+{
+	char magic[8];         //!< @ref U_PD_MAGIC, zero terminated
+	uint32_t version;      //!< @ref U_PD_VERSION
+	uint32_t cam_count;    //!< Number of cameras recorded
+	uint32_t chunk_size;   //!< Target size of a chunk in bytes
+	uint32_t chunk_count;  //!< Number of entries in the index
+	uint64_t index_offset; //!< Offset of the chunk index, zero if the file was not closed
+};
+
+/*!
+ * Header before each record payload.
+ *
+ * @ingroup aux_packed_dataset
+ */
+struct u_pd_record_header
+{
+	uint32_t type;        //!< @ref u_pd_record_type
+	uint32_t size;        //!< Payload size in bytes, excluding padding
+	int64_t timestamp_ns; //!< Timestamp of the sample
+};
+
+/*!
+ * Payload of a @ref U_PD_RECORD_FRAME record, the pixels follow directly.
+ *
+ * @ingroup aux_packed_dataset
+ */
+struct u_pd_frame_header
+{
+	uint32_t cam_index; //!< Which camera the frame is from
+	uint32_t codec;     //!< @ref u_pd_codec
+	uint32_t format;    //!< @ref xrt_format of the pixels
+	uint32_t width;
+	uint32_t height;
+	uint32_t stride;    //!< Bytes per row of the decoded pixels, rows are tightly packed
+	uint32_t data_size; //!< Size of the stored, possibly compressed, pixels
+	uint32_t padding;
+};
+
+/*!
+ * Entry in the chunk index at the end of the file.
+ *
+ * @ingroup aux_packed_dataset
+ */
+struct u_pd_chunk
+{
+	uint64_t offset;       //!< Offset of the first record
+	uint64_t size;         //!< Size in bytes of all records in the chunk
+	int64_t first_ts;      //!< Lowest timestamp of any record in the chunk
+	int64_t last_ts;       //!< Highest timestamp of any record in the chunk
+	uint32_t record_count; //!< Total number of records
+	uint32_t frame_count;  //!< Number of frame records
+};
+
+
+/*
+ *
+ * Writer.
+ *
+ */
+
+struct u_pd_writer;
+
+/*!
+ * Create a new packed dataset file at @p path, replacing any existing file.
+ *
+ * @param path       File to write.
+ * @param cam_count  Number of cameras that will be recorded.
+ * @param chunk_size Target chunk size in bytes, zero picks a default.
+ * @param out_writer The created writer.
+ *
+ * @return Zero on success, negative on failure to create the file.
+ *
+ * @ingroup aux_packed_dataset
+ */
+int
+u_pd_writer_create(const char *path, uint32_t cam_count, uint32_t chunk_size, struct u_pd_writer **out_writer);
+
+/*!
+ * Append an IMU sample.
+ *
+ * @public @memberof u_pd_writer
+ */
+int
+u_pd_writer_push_imu(struct u_pd_writer *pdw, const struct xrt_imu_sample *sample);
+
+/*!
+ * Append a ground truth sample.
+ *
+ * @public @memberof u_pd_writer
+ */
+int
+u_pd_writer_push_gt(struct u_pd_writer *pdw, const struct xrt_pose_sample *sample);
+
+/*!
+ * Append a frame, uses @ref xrt_frame::timestamp as the record timestamp. With
+ * @ref U_PD_CODEC_LZ4 frames that do not compress are stored raw.
+ *
+ * @public @memberof u_pd_writer
+ */
+int
+u_pd_writer_push_frame(struct u_pd_writer *pdw, uint32_t cam_index, struct xrt_frame *xf, enum u_pd_codec codec);
+
+/*!
+ * Writes the index, closes the file and frees the writer. @p pdw_ptr may point
+ * at NULL.
+ *
+ * @public @memberof u_pd_writer
+ */
+int
+u_pd_writer_close(struct u_pd_writer **pdw_ptr);
+
+
+/*
+ *
+ * Reader.
+ *
+ */
+
+/*!
+ * A record read from the file, pointers point into the file mapping and are
+ * valid until the reader is closed.
+ *
+ * @ingroup aux_packed_dataset
+ */
+struct u_pd_record
+{
+	enum u_pd_record_type type;
+	int64_t timestamp_ns;
+
+	union {
+		struct xrt_imu_sample imu;
+		struct xrt_pose_sample gt;
+		struct
+		{
+			const struct u_pd_frame_header *header;
+			const uint8_t *data; //!< Stored pixels, 16 byte aligned
+		} frame;
+	};
+};
+
+/*!
+ * Reads a packed dataset, the file is memory mapped where supported.
+ *
+ * @ingroup aux_packed_dataset
+ */
+struct u_pd_reader
+{
+	const uint8_t *data;
+	size_t size;
+	bool mapped;
+
+	struct u_pd_file_header header;
+
+	//! Chunk index, NULL if the file has none.
+	const struct u_pd_chunk *chunks;
+	uint32_t chunk_count;
+
+	//! Offset where records stop, the index or the end of the file.
+	size_t records_end;
+
+	//! Offset of the next record to read.
+	size_t cursor;
+};
+
+/*!
+ * Open the file at @p path for reading.
+ *
+ * @return Zero on success, negative if the file can't be read or isn't valid.
+ *
+ * @public @memberof u_pd_reader
+ */
+int
+u_pd_reader_open(struct u_pd_reader *pdr, const char *path);
+
+/*!
+ * Read the next record, returns false at the end of the file or if the
+ * remaining data is truncated or invalid.
+ *
+ * @public @memberof u_pd_reader
+ */
+bool
+u_pd_reader_next(struct u_pd_reader *pdr, struct u_pd_record *out_record);
+
+/*!
+ * Move the cursor to the start of the first chunk that might contain records
+ * at or after @p timestamp_ns, records before it in that chunk will still be
+ * returned. Without an index this rewinds to the first record.
+ *
+ * @public @memberof u_pd_reader
+ */
+void
+u_pd_reader_seek(struct u_pd_reader *pdr, int64_t timestamp_ns);
+
+/*!
+ * Size in bytes of the decoded pixels of a frame record.
+ *
+ * @relates u_pd_record
+ */
+static inline size_t
+u_pd_frame_size(const struct u_pd_record *record)
+{
+	return (size_t)record->frame.header->stride * record->frame.header->height;
+}
+
+/*!
+ * Decode the pixels of a frame record into @p dst, which must be at least
+ * @ref u_pd_frame_size bytes. Raw frames can be used in place instead.
+ *
+ * @return Zero on success, negative if the data is corrupt.
+ *
+ * @relates u_pd_record
+ */
+int
+u_pd_frame_decode(const struct u_pd_record *record, uint8_t *dst, size_t dst_size);
+
+/*!
+ * Unmap and close the file.
+ *
+ * @public @memberof u_pd_reader
+ */
+void
+u_pd_reader_close(struct u_pd_reader *pdr);
+
+
+#ifdef __cplusplus
+}
+#endif
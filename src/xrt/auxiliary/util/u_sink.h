@@ -151,6 +151,14 @@ u_sink_stereo_sbs_to_slam_sbs_create(struct xrt_frame_context *xfctx,
                                      struct xrt_frame_sink *downstream_right,
                                      struct xrt_frame_sink **out_xfs);
 
+/*!
+ * Splits Stereo SBS frames into a two view bundle, without creating new frames.
+ */
+void
+u_sink_stereo_sbs_to_slam_bundle_create(struct xrt_frame_context *xfctx,
+                                        struct xrt_frame_bundle_sink *downstream,
+                                        struct xrt_frame_sink **out_xfs);
+
 /*!
  * Combines stereo frames.
  * Opposite of u_sink_stereo_sbs_to_slam_sbs_create
@@ -12,6 +12,7 @@
 #include "util/u_trace_marker.h"
 #include "util/u_frame.h"
 #include "xrt/xrt_frame.h"
+#include "xrt/xrt_tracking.h"
 
 //!@todo Extend this to over-and-under frames!
 
@@ -27,6 +28,9 @@ struct u_sink_stereo_sbs_to_slam_sbs
 
 	struct xrt_frame_sink *downstream_left;
 	struct xrt_frame_sink *downstream_right;
+
+	//! If set, views are pushed together instead of as two new frames.
+	struct xrt_frame_bundle_sink *downstream_bundle;
 };
 
 static void
@@ -52,6 +56,18 @@ split_frame(struct xrt_frame_sink *xfs, struct xrt_frame *xf)
 	right.offset.w = one_frame_width;
 	right.extent.h = xf->height;
 	right.extent.w = one_frame_width;
+
+	if (s->downstream_bundle != NULL) {
+		struct xrt_frame_bundle bundle = {
+		    .timestamp = (timepoint_ns)xf->timestamp,
+		    .view_count = 2,
+		    .frames = {xf, xf},
+		    .rois = {left, right},
+		};
+		xrt_sink_push_bundle(s->downstream_bundle, &bundle);
+		return;
+	}
+
 	struct xrt_frame *xf_left = NULL;
 	struct xrt_frame *xf_right = NULL;
 	u_frame_create_roi(xf, left, &xf_left);
@@ -103,3 +119,20 @@ u_sink_stereo_sbs_to_slam_sbs_create(struct xrt_frame_context *xfctx,
 
 	*out_xfs = &s->base;
 }
+
+void
+u_sink_stereo_sbs_to_slam_bundle_create(struct xrt_frame_context *xfctx,
+                                        struct xrt_frame_bundle_sink *downstream,
+                                        struct xrt_frame_sink **out_xfs)
+{
+	struct u_sink_stereo_sbs_to_slam_sbs *s = U_TYPED_CALLOC(struct u_sink_stereo_sbs_to_slam_sbs);
+
+	s->base.push_frame = split_frame;
+	s->node.break_apart = split_break_apart;
+	s->node.destroy = split_destroy;
+	s->downstream_bundle = downstream;
+
+	xrt_frame_context_add(xfctx, &s->node);
+
+	*out_xfs = &s->base;
+}
@@ -0,0 +1,157 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Fixed size object slab allocator.
+ * @ingroup aux_util
+ */
+
+#include "util/u_misc.h"
+#include "util/u_slab.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define U_SLAB_DEFAULT_OBJECTS_PER_CHUNK (32)
+#define U_SLAB_ALIGNMENT (16)
+
+/*!
+ * A chunk header, the objects follows directly after it.
+ */
+struct u_slab_chunk
+{
+	struct u_slab_chunk *next;
+
+	// Keeps the objects after the header aligned.
+	uint8_t padding[U_SLAB_ALIGNMENT - sizeof(struct u_slab_chunk *)];
+};
+
+
+/*
+ *
+ * Helpers.
+ *
+ */
+
+static inline uint8_t *
+chunk_objects(struct u_slab_chunk *chunk)
+{
+	return (uint8_t *)&chunk[1];
+}
+
+static bool
+add_chunk(struct u_slab *slab)
+{
+	size_t size = sizeof(struct u_slab_chunk) + slab->object_size * slab->objects_per_chunk;
+
+	struct u_slab_chunk *chunk = U_CALLOC_WITH_CAST(struct u_slab_chunk, size);
+	if (chunk == NULL) {
+		return false;
+	}
+
+	chunk->next = slab->chunks;
+	slab->chunks = chunk;
+	slab->chunk_remaining = slab->objects_per_chunk;
+	slab->chunk_count++;
+
+	return true;
+}
+
+
+/*
+ *
+ * 'Exported' functions.
+ *
+ */
+
+int
+u_slab_init(struct u_slab *slab, size_t object_size, uint32_t objects_per_chunk)
+{
+	assert(object_size > 0);
+
+	U_ZERO(slab);
+
+	// Free objects store the free list pointer in themselves.
+	if (object_size < sizeof(void *)) {
+		object_size = sizeof(void *);
+	}
+
+	slab->object_size = (object_size + U_SLAB_ALIGNMENT - 1) & ~((size_t)U_SLAB_ALIGNMENT - 1);
+	slab->objects_per_chunk = objects_per_chunk > 0 ? objects_per_chunk : U_SLAB_DEFAULT_OBJECTS_PER_CHUNK;
+
+	int ret = os_mutex_init(&slab->mutex);
+	if (ret != 0) {
+		// Leave it zeroed so that fini is a no-op.
+		U_ZERO(slab);
+	}
+
+	return ret;
+}
+
+void *
+u_slab_alloc(struct u_slab *slab)
+{
+	void *ptr = NULL;
+
+	os_mutex_lock(&slab->mutex);
+
+	if (slab->free_list != NULL) {
+		ptr = slab->free_list;
+		slab->free_list = *(void **)ptr;
+
+		// Freed objects are dirty, chunks start zeroed.
+		memset(ptr, 0, slab->object_size);
+	} else if (slab->chunk_remaining > 0 || add_chunk(slab)) {
+		uint32_t index = slab->objects_per_chunk - slab->chunk_remaining;
+		ptr = chunk_objects(slab->chunks) + index * slab->object_size;
+		slab->chunk_remaining--;
+	}
+
+	if (ptr != NULL) {
+		slab->live_count++;
+	}
+
+	os_mutex_unlock(&slab->mutex);
+
+	return ptr;
+}
+
+void
+u_slab_free(struct u_slab *slab, void *ptr)
+{
+	if (ptr == NULL) {
+		return;
+	}
+
+	os_mutex_lock(&slab->mutex);
+
+	assert(slab->live_count > 0);
+	slab->live_count--;
+
+	*(void **)ptr = slab->free_list;
+	slab->free_list = ptr;
+
+	os_mutex_unlock(&slab->mutex);
+}
+
+void
+u_slab_fini(struct u_slab *slab)
+{
+	// Never initialised or init failed.
+	if (slab->object_size == 0) {
+		return;
+	}
+
+	struct u_slab_chunk *chunk = slab->chunks;
+	while (chunk != NULL) {
+		struct u_slab_chunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+
+	os_mutex_destroy(&slab->mutex);
+
+	U_ZERO(slab);
+}
@@ -0,0 +1,101 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Fixed size object slab allocator.
+ * @ingroup aux_util
+ */
+
+#pragma once
+
+#include "xrt/xrt_compiler.h"
+
+#include "os/os_threading.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+struct u_slab_chunk;
+
+/*!
+ * Allocates objects of a single size out of larger chunks, freed objects are
+ * put on a free list and reused by later allocations. Objects never move, and
+ * all chunks are released at once in @ref u_slab_fini, so any objects still
+ * allocated at that point are freed with it.
+ *
+ * Thread safe, meant to be embedded in the object that owns the allocations.
+ *
+ * @ingroup aux_util
+ */
+struct u_slab
+{
+	struct os_mutex mutex;
+
+	//! Size of each object, rounded up to keep objects aligned.
+	size_t object_size;
+
+	//! Number of objects in each chunk.
+	uint32_t objects_per_chunk;
+
+	//! All chunks, newest first.
+	struct u_slab_chunk *chunks;
+
+	//! Freed objects, reused before carving new ones out of a chunk.
+	void *free_list;
+
+	//! Objects not yet handed out in the newest chunk.
+	uint32_t chunk_remaining;
+
+	//! Number of chunks allocated, same as number of calls to calloc.
+	uint32_t chunk_count;
+
+	//! Number of currently allocated objects.
+	uint32_t live_count;
+};
+
+/*!
+ * Initialise the slab, @p objects_per_chunk of zero picks a default. Returns
+ * non-zero on failure, the slab is then left zeroed.
+ *
+ * @public @memberof u_slab
+ */
+int
+u_slab_init(struct u_slab *slab, size_t object_size, uint32_t objects_per_chunk);
+
+/*!
+ * Allocate a zeroed object, returns NULL on allocation failure.
+ *
+ * @public @memberof u_slab
+ */
+void *
+u_slab_alloc(struct u_slab *slab);
+
+/*!
+ * Return an object to the slab, @p ptr may be NULL.
+ *
+ * @public @memberof u_slab
+ */
+void
+u_slab_free(struct u_slab *slab, void *ptr);
+
+/*!
+ * Releases all memory of the slab, including any objects still allocated.
+ *
+ * @public @memberof u_slab
+ */
+void
+u_slab_fini(struct u_slab *slab);
+
+/*!
+ * Helper to initialise a slab for objects of @p TYPE.
+ *
+ * @relates u_slab
+ */
+#define U_SLAB_INIT_TYPED(SLAB, TYPE, COUNT) u_slab_init((SLAB), sizeof(TYPE), (COUNT))
+
+
+#ifdef __cplusplus
+}
+#endif
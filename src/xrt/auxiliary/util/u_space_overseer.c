@@ -14,7 +14,11 @@
 
 #include "math/m_space.h"
 
+#include "os/os_threading.h"
+
+#include "util/u_var.h"
 #include "util/u_misc.h"
+#include "util/u_debug.h"
 #include "util/u_hashmap.h"
 #include "util/u_logging.h"
 #include "util/u_space_overseer.h"
@@ -29,6 +33,8 @@
  *
  */
 
+DEBUG_GET_ONCE_BOOL_OPTION(pose_memo, "XRT_SPACE_POSE_MEMO", true)
+
 /*!
  * Keeps track of what kind of space it is.
  */
@@ -72,6 +78,66 @@ struct u_space
 	};
 };
 
+/*!
+ * Max number of device poses remembered during a single locate call.
+ */
+#define U_SPACE_POSE_CACHE_SIZE (16)
+
+/*!
+ * Device poses queried during a single locate call, makes sure that each
+ * device input is only queried once when locating several spaces.
+ */
+struct u_space_pose_cache
+{
+	struct
+	{
+		struct xrt_device *xdev;
+		enum xrt_input_name xname;
+		struct xrt_space_relation relation;
+	} entries[U_SPACE_POSE_CACHE_SIZE];
+
+	uint32_t entry_count;
+};
+
+/*!
+ * Number of poses remembered per device.
+ */
+#define U_SPACE_POSE_MEMO_SIZE (8)
+
+/*!
+ * Remembers the last poses returned by a device, keyed on input, timestamp and
+ * @ref xrt_device::tracking_generation. The compositor, space and action code
+ * tends to ask the same device for the same timestamp several times a frame,
+ * this turns those into a lookup until the device gets new tracking data.
+ *
+ * Only used for devices that keep a tracking generation, can be turned off
+ * with the `XRT_SPACE_POSE_MEMO` option.
+ */
+struct u_space_pose_memo
+{
+	//! Protects all fields below, taken while holding the graph read lock.
+	struct os_mutex mutex;
+
+	struct
+	{
+		enum xrt_input_name xname;
+		uint64_t at_timestamp_ns;
+		//! Tracking generation of the device when the pose was queried.
+		uint64_t generation;
+		struct xrt_space_relation relation;
+	} entries[U_SPACE_POSE_MEMO_SIZE];
+
+	//! Number of valid entries.
+	uint32_t entry_count;
+
+	//! Entry to overwrite next.
+	uint32_t next;
+
+	uint64_t hit_count;
+	uint64_t miss_count;
+	float hit_rate;
+};
+
 /*!
  * Default implementation of the xrt_space_overseer object.
  */
@@ -84,6 +150,12 @@ struct u_space_overseer
 
 	//! Map from xdev to space, each entry holds a reference.
 	struct u_hashmap_int *xdev_map;
+
+	//! Map from xdev to @ref u_space_pose_memo, owned by the overseer.
+	struct u_hashmap_int *memo_map;
+
+	//! Are poses memoised at all.
+	bool memo_enabled;
 };
 
 
@@ -157,6 +229,152 @@ find_xdev_space_read_locked(struct u_space_overseer *uso, struct xrt_device *xde
 }
 
 
+static struct u_space_pose_memo *
+memo_create(struct xrt_device *xdev)
+{
+	struct u_space_pose_memo *memo = U_TYPED_CALLOC(struct u_space_pose_memo);
+
+	XRT_MAYBE_UNUSED int ret = os_mutex_init(&memo->mutex);
+	assert(ret == 0);
+
+	u_var_add_root(memo, "Pose memo", true);
+	u_var_add_ro_text(memo, xdev->str, "Device");
+	u_var_add_ro_u64(memo, &memo->hit_count, "Hits");
+	u_var_add_ro_u64(memo, &memo->miss_count, "Misses");
+	u_var_add_ro_f32(memo, &memo->hit_rate, "Hit rate");
+
+	return memo;
+}
+
+/*!
+ * Helper function when clearing the memo hashmap.
+ */
+static void
+hashmap_destroy_memo_items(void *item, void *priv)
+{
+	struct u_space_pose_memo *memo = (struct u_space_pose_memo *)item;
+
+	u_var_remove_root(memo);
+	os_mutex_destroy(&memo->mutex);
+	free(memo);
+}
+
+static struct u_space_pose_memo *
+find_xdev_memo_read_locked(struct u_space_overseer *uso, struct xrt_device *xdev)
+{
+	void *ptr = NULL;
+	uint64_t key = (uint64_t)(intptr_t)xdev;
+	u_hashmap_int_find(uso->memo_map, key, &ptr);
+
+	return (struct u_space_pose_memo *)ptr;
+}
+
+/*!
+ * Get the pose of a device input, going through the per device memo.
+ */
+static void
+memo_get_tracked_pose(struct u_space_overseer *uso,
+                      struct xrt_device *xdev,
+                      enum xrt_input_name xname,
+                      uint64_t at_timestamp_ns,
+                      struct xrt_space_relation *out_relation)
+{
+	/*
+	 * Loaded before querying the device, if new data arrives during the
+	 * query the entry is stored with the old generation and not reused.
+	 */
+	uint64_t generation = xrt_atomic_u64_load(&xdev->tracking_generation);
+
+	struct u_space_pose_memo *memo = NULL;
+	if (uso->memo_enabled && generation != 0) {
+		memo = find_xdev_memo_read_locked(uso, xdev);
+	}
+
+	if (memo == NULL) {
+		xrt_device_get_tracked_pose(xdev, xname, at_timestamp_ns, out_relation);
+		return;
+	}
+
+	os_mutex_lock(&memo->mutex);
+
+	for (uint32_t i = 0; i < memo->entry_count; i++) {
+		if (memo->entries[i].xname != xname ||                     //
+		    memo->entries[i].at_timestamp_ns != at_timestamp_ns || //
+		    memo->entries[i].generation != generation) {
+			continue;
+		}
+
+		*out_relation = memo->entries[i].relation;
+		memo->hit_count++;
+		memo->hit_rate = (float)memo->hit_count / (float)(memo->hit_count + memo->miss_count);
+
+		os_mutex_unlock(&memo->mutex);
+		return;
+	}
+
+	memo->miss_count++;
+	memo->hit_rate = (float)memo->hit_count / (float)(memo->hit_count + memo->miss_count);
+
+	/*
+	 * Don't hold the mutex over the device call, two threads missing on the
+	 * same pose at the same time will both call the device, that is fine.
+	 */
+	os_mutex_unlock(&memo->mutex);
+
+	xrt_device_get_tracked_pose(xdev, xname, at_timestamp_ns, out_relation);
+
+	os_mutex_lock(&memo->mutex);
+
+	uint32_t index = memo->next;
+	memo->entries[index].xname = xname;
+	memo->entries[index].at_timestamp_ns = at_timestamp_ns;
+	memo->entries[index].generation = generation;
+	memo->entries[index].relation = *out_relation;
+	memo->next = (index + 1) % U_SPACE_POSE_MEMO_SIZE;
+	if (memo->entry_count < U_SPACE_POSE_MEMO_SIZE) {
+		memo->entry_count++;
+	}
+
+	os_mutex_unlock(&memo->mutex);
+}
+
+/*!
+ * Get the pose of a pose space, if @p cache is not NULL it is used to avoid
+ * querying the same device input several times.
+ */
+static void
+get_pose_space_relation(struct u_space_overseer *uso,
+                        struct u_space_pose_cache *cache,
+                        struct u_space *space,
+                        uint64_t at_timestamp_ns,
+                        struct xrt_space_relation *out_relation)
+{
+	struct xrt_device *xdev = space->pose.xdev;
+	enum xrt_input_name xname = space->pose.xname;
+
+	if (cache == NULL) {
+		memo_get_tracked_pose(uso, xdev, xname, at_timestamp_ns, out_relation);
+		return;
+	}
+
+	for (uint32_t i = 0; i < cache->entry_count; i++) {
+		if (cache->entries[i].xdev == xdev && cache->entries[i].xname == xname) {
+			*out_relation = cache->entries[i].relation;
+			return;
+		}
+	}
+
+	memo_get_tracked_pose(uso, xdev, xname, at_timestamp_ns, out_relation);
+
+	if (cache->entry_count < U_SPACE_POSE_CACHE_SIZE) {
+		cache->entries[cache->entry_count].xdev = xdev;
+		cache->entries[cache->entry_count].xname = xname;
+		cache->entries[cache->entry_count].relation = *out_relation;
+		cache->entry_count++;
+	}
+}
+
+
 /*
  *
  * Graph traversing functions.
@@ -170,7 +388,11 @@ find_xdev_space_read_locked(struct u_space_overseer *uso, struct xrt_device *xde
  * order.
  */
 static void
-push_then_traverse(struct xrt_relation_chain *xrc, struct u_space *space, uint64_t at_timestamp_ns)
+push_then_traverse(struct u_space_overseer *uso,
+                   struct xrt_relation_chain *xrc,
+                   struct u_space *space,
+                   uint64_t at_timestamp_ns,
+                   struct u_space_pose_cache *cache)
 {
 	switch (space->type) {
 	case U_SPACE_TYPE_NULL: break; // No-op
@@ -179,7 +401,7 @@ push_then_traverse(struct xrt_relation_chain *xrc, struct u_space *space, uint64
 		assert(space->pose.xname != 0);
 
 		struct xrt_space_relation xsr;
-		xrt_device_get_tracked_pose(space->pose.xdev, space->pose.xname, at_timestamp_ns, &xsr);
+		get_pose_space_relation(uso, cache, space, at_timestamp_ns, &xsr);
 		m_relation_chain_push_relation(xrc, &xsr);
 	} break;
 	case U_SPACE_TYPE_OFFSET: m_relation_chain_push_pose_if_not_identity(xrc, &space->offset.pose); break;
@@ -188,7 +410,7 @@ push_then_traverse(struct xrt_relation_chain *xrc, struct u_space *space, uint64
 
 	// Please tail-call optimise this miss compiler.
 	assert(space->next != NULL);
-	push_then_traverse(xrc, space->next, at_timestamp_ns);
+	push_then_traverse(uso, xrc, space->next, at_timestamp_ns, cache);
 }
 
 /*!
@@ -198,7 +420,11 @@ push_then_traverse(struct xrt_relation_chain *xrc, struct u_space *space, uint64
  * the reversed order.
  */
 static void
-traverse_then_push_inverse(struct xrt_relation_chain *xrc, struct u_space *space, uint64_t at_timestamp_ns)
+traverse_then_push_inverse(struct u_space_overseer *uso,
+                           struct xrt_relation_chain *xrc,
+                           struct u_space *space,
+                           uint64_t at_timestamp_ns,
+                           struct u_space_pose_cache *cache)
 {
 	// Done traversing.
 	switch (space->type) {
@@ -210,7 +436,7 @@ traverse_then_push_inverse(struct xrt_relation_chain *xrc, struct u_space *space
 
 	// Can't tail-call optimise this one :(
 	assert(space->next != NULL);
-	traverse_then_push_inverse(xrc, space->next, at_timestamp_ns);
+	traverse_then_push_inverse(uso, xrc, space->next, at_timestamp_ns, cache);
 
 	switch (space->type) {
 	case U_SPACE_TYPE_NULL: break; // No-op
@@ -219,7 +445,7 @@ traverse_then_push_inverse(struct xrt_relation_chain *xrc, struct u_space *space
 		assert(space->pose.xname != 0);
 
 		struct xrt_space_relation xsr;
-		xrt_device_get_tracked_pose(space->pose.xdev, space->pose.xname, at_timestamp_ns, &xsr);
+		get_pose_space_relation(uso, cache, space, at_timestamp_ns, &xsr);
 		m_relation_chain_push_inverted_relation(xrc, &xsr);
 	} break;
 	case U_SPACE_TYPE_OFFSET: m_relation_chain_push_inverted_pose_if_not_identity(xrc, &space->offset.pose); break;
@@ -238,8 +464,8 @@ build_relation_chain_read_locked(struct u_space_overseer *uso,
 	assert(base != NULL);
 	assert(target != NULL);
 
-	push_then_traverse(xrc, target, at_timestamp_ns);
-	traverse_then_push_inverse(xrc, base, at_timestamp_ns);
+	push_then_traverse(uso, xrc, target, at_timestamp_ns, NULL);
+	traverse_then_push_inverse(uso, xrc, base, at_timestamp_ns, NULL);
 }
 
 static void
@@ -405,6 +631,56 @@ locate_space(struct xrt_space_overseer *xso,
 	return XRT_SUCCESS;
 }
 
+static xrt_result_t
+locate_spaces(struct xrt_space_overseer *xso,
+              struct xrt_space *base_space,
+              const struct xrt_pose *base_offset,
+              uint64_t at_timestamp_ns,
+              struct xrt_space **spaces,
+              uint32_t space_count,
+              const struct xrt_pose *offsets,
+              struct xrt_space_relation *out_relations)
+{
+	struct u_space_overseer *uso = u_space_overseer(xso);
+
+	struct u_space *ubase_space = u_space(base_space);
+
+	// Each device input is only queried once for all of the spaces.
+	struct u_space_pose_cache cache = {0};
+
+	// The base part of the chain is the same for all spaces, build it once.
+	struct xrt_relation_chain base_xrc = {0};
+
+	// Only need the read lock.
+	pthread_rwlock_rdlock(&uso->lock);
+
+	traverse_then_push_inverse(uso, &base_xrc, ubase_space, at_timestamp_ns, &cache);
+
+	for (uint32_t i = 0; i < space_count; i++) {
+		// Spaces that are not available can't be located.
+		if (spaces[i] == NULL) {
+			out_relations[i] = (struct xrt_space_relation)XRT_SPACE_RELATION_ZERO;
+			continue;
+		}
+
+		struct xrt_relation_chain xrc = {0};
+
+		m_relation_chain_push_pose_if_not_identity(&xrc, &offsets[i]);
+		push_then_traverse(uso, &xrc, u_space(spaces[i]), at_timestamp_ns, &cache);
+		for (uint32_t k = 0; k < base_xrc.step_count; k++) {
+			m_relation_chain_push_relation(&xrc, &base_xrc.steps[k]);
+		}
+		m_relation_chain_push_inverted_pose_if_not_identity(&xrc, base_offset);
+
+		// For base_space =~= space (approx equals).
+		special_resolve(&xrc, &out_relations[i]);
+	}
+
+	pthread_rwlock_unlock(&uso->lock);
+
+	return XRT_SUCCESS;
+}
+
 static xrt_result_t
 locate_device(struct xrt_space_overseer *xso,
               struct xrt_space *base_space,
@@ -450,6 +726,9 @@ destroy(struct xrt_space_overseer *xso)
 	u_hashmap_int_clear_and_call_for_each(uso->xdev_map, hashmap_unreference_space_items, uso);
 	u_hashmap_int_destroy(&uso->xdev_map);
 
+	u_hashmap_int_clear_and_call_for_each(uso->memo_map, hashmap_destroy_memo_items, uso);
+	u_hashmap_int_destroy(&uso->memo_map);
+
 	pthread_rwlock_destroy(&uso->lock);
 
 	free(uso);
@@ -469,6 +748,7 @@ u_space_overseer_create(void)
 	uso->base.create_offset_space = create_offset_space;
 	uso->base.create_pose_space = create_pose_space;
 	uso->base.locate_space = locate_space;
+	uso->base.locate_spaces = locate_spaces;
 	uso->base.locate_device = locate_device;
 	uso->base.destroy = destroy;
 
@@ -480,6 +760,11 @@ u_space_overseer_create(void)
 	ret = u_hashmap_int_create(&uso->xdev_map);
 	assert(ret == 0);
 
+	ret = u_hashmap_int_create(&uso->memo_map);
+	assert(ret == 0);
+
+	uso->memo_enabled = debug_get_bool_option_pose_memo();
+
 	create_and_set_root_space(uso);
 
 	return uso;
@@ -567,6 +852,11 @@ u_space_overseer_link_space_to_device(struct u_space_overseer *uso, struct xrt_s
 
 	u_hashmap_int_insert(uso->xdev_map, (uint64_t)(intptr_t)xdev, new_space);
 
+	// Each device gets a pose memo, kept if the device is relinked.
+	if (find_xdev_memo_read_locked(uso, xdev) == NULL) {
+		u_hashmap_int_insert(uso->memo_map, key, memo_create(xdev));
+	}
+
 	pthread_rwlock_unlock(&uso->lock);
 
 	// Dereferrence old space outside of lock.
@@ -198,6 +198,7 @@ vk_get_device_functions(struct vk_bundle *vk)
 	vk->vkCmdSetScissor                             = GET_DEV_PROC(vk, vkCmdSetScissor);
 	vk->vkCmdSetViewport                            = GET_DEV_PROC(vk, vkCmdSetViewport);
 	vk->vkCmdClearColorImage                        = GET_DEV_PROC(vk, vkCmdClearColorImage);
+	vk->vkCmdClearDepthStencilImage                 = GET_DEV_PROC(vk, vkCmdClearDepthStencilImage);
 	vk->vkCmdEndRenderPass                          = GET_DEV_PROC(vk, vkCmdEndRenderPass);
 	vk->vkCmdBindDescriptorSets                     = GET_DEV_PROC(vk, vkCmdBindDescriptorSets);
 	vk->vkCmdBindPipeline                           = GET_DEV_PROC(vk, vkCmdBindPipeline);
@@ -315,6 +315,7 @@ struct vk_bundle
 	PFN_vkCmdSetScissor vkCmdSetScissor;
 	PFN_vkCmdSetViewport vkCmdSetViewport;
 	PFN_vkCmdClearColorImage vkCmdClearColorImage;
+	PFN_vkCmdClearDepthStencilImage vkCmdClearDepthStencilImage;
 	PFN_vkCmdEndRenderPass vkCmdEndRenderPass;
 	PFN_vkCmdBindDescriptorSets vkCmdBindDescriptorSets;
 	PFN_vkCmdBindPipeline vkCmdBindPipeline;
@@ -278,9 +278,12 @@ do_graphics_layers(struct comp_compositor *c)
 	// Always zero for now.
 	uint32_t layer_count = c->base.slot.layer_count;
 
-	comp_renderer_destroy_layers(c->r);
-
+	/*
+	 * The layers are kept between frames, they are only (re)created when
+	 * the number of layers grows. The fast path doesn't use any of them.
+	 */
 	if (c->base.slot.one_projection_layer_fast_path) {
+		comp_renderer_allocate_layers(c->r, 0);
 		return;
 	}
 
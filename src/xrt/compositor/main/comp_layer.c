@@ -455,6 +455,13 @@ _calculate_unit_cylinder_segment_vertices(float central_angle)
 bool
 comp_layer_update_cylinder_vertex_buffer(struct comp_render_layer *self, float central_angle)
 {
+	// Layers are reused between frames, only regenerate when the angle changes.
+	if (self->cylinder.central_angle == central_angle) {
+		return true;
+	}
+
+	self->cylinder.central_angle = central_angle;
+
 	_calculate_unit_cylinder_segment_vertices(central_angle);
 
 	struct vk_bundle *vk = self->vk;
@@ -483,6 +490,9 @@ _init_cylinder_vertex_buffer(struct comp_render_layer *self)
 
 	self->cylinder.vertex_buffer.size = CYLINDER_VERTICES;
 
+	// Not a valid angle, forces the first update to fill in the buffer.
+	self->cylinder.central_angle = -1.0f;
+
 	return true;
 }
 
@@ -70,6 +70,9 @@ struct comp_render_layer
 	struct
 	{
 		struct vk_buffer vertex_buffer;
+
+		//! Central angle the vertex buffer was last generated for.
+		float central_angle;
 	} cylinder;
 
 	uint32_t transformation_ubo_binding;
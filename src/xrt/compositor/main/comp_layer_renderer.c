@@ -452,24 +452,30 @@ comp_layer_renderer_allocate_layers(struct comp_layer_renderer *self, uint32_t l
 {
 	struct vk_bundle *vk = self->vk;
 
-	self->layer_count = layer_count;
-	self->layers = U_TYPED_ARRAY_CALLOC(struct comp_render_layer *, self->layer_count);
+	if (layer_count > self->layer_capacity) {
+		U_ARRAY_REALLOC_OR_FREE(self->layers, struct comp_render_layer *, layer_count);
 
-	for (uint32_t i = 0; i < self->layer_count; i++) {
-		self->layers[i] =
-		    comp_layer_create(vk, &self->descriptor_set_layout, &self->descriptor_set_layout_equirect);
+		for (uint32_t i = self->layer_capacity; i < layer_count; i++) {
+			self->layers[i] =
+			    comp_layer_create(vk, &self->descriptor_set_layout, &self->descriptor_set_layout_equirect);
+		}
+
+		self->layer_capacity = layer_count;
 	}
+
+	self->layer_count = layer_count;
 }
 
 void
 comp_layer_renderer_destroy_layers(struct comp_layer_renderer *self)
 {
-	for (uint32_t i = 0; i < self->layer_count; i++)
+	for (uint32_t i = 0; i < self->layer_capacity; i++)
 		comp_layer_destroy(self->layers[i]);
 	if (self->layers != NULL)
 		free(self->layers);
 	self->layers = NULL;
 	self->layer_count = 0;
+	self->layer_capacity = 0;
 }
 
 static bool
@@ -60,6 +60,9 @@ struct comp_layer_renderer
 	struct comp_render_layer **layers;
 	uint32_t layer_count;
 
+	//! Number of allocated layers, layers are reused between frames.
+	uint32_t layer_capacity;
+
 	uint32_t transformation_ubo_binding;
 	uint32_t texture_binding;
 };
@@ -119,7 +122,10 @@ comp_layer_renderer_set_pose(struct comp_layer_renderer *self,
                              uint32_t eye);
 
 /*!
- * Allocate the array comp_layer_renderer::layers with the given number of elements.
+ * Make sure the array comp_layer_renderer::layers holds at least the given
+ * number of elements and set it as the number of layers to draw. Already
+ * allocated layers are kept and reused, so calling this every frame only
+ * creates Vulkan objects when the number of layers grows.
  *
  * @param self Self pointer.
  * @param layer_count The number of layers to support
@@ -130,7 +136,8 @@ void
 comp_layer_renderer_allocate_layers(struct comp_layer_renderer *self, uint32_t layer_count);
 
 /*!
- * De-initialize and free comp_layer_renderer::layers array.
+ * De-initialize and free comp_layer_renderer::layers array, including all
+ * layers kept around for reuse.
  *
  * @param self Self pointer.
  *
@@ -1100,6 +1100,7 @@ do_layers(struct comp_renderer *r,
 		case XRT_LAYER_STEREO_PROJECTION: required_image_samplers = 2; break;
 		case XRT_LAYER_STEREO_PROJECTION_DEPTH: required_image_samplers = 4; break;
 		case XRT_LAYER_QUAD: required_image_samplers = 1; break;
+		case XRT_LAYER_CYLINDER: required_image_samplers = 1; break;
 		default: required_image_samplers = 0;
 		}
 		//! Exit loop if shader cannot receive more image samplers
@@ -1289,6 +1290,67 @@ do_layers(struct comp_renderer *r,
 			case XRT_LAYER_EYE_VISIBILITY_BOTH: break;
 			}
 
+		} break;
+		case XRT_LAYER_CYLINDER: {
+			const struct xrt_layer_cylinder_data *cyl = &layer->data.cylinder;
+
+			// Skip "infinite cylinder", same as the graphics path.
+			if (cyl->radius == 0.f || cyl->aspect_ratio == INFINITY) {
+				ubo_data->layer_type[layer_i].val = UINT32_MAX;
+				break;
+			}
+
+			const struct comp_swapchain_image *image = &layer->sc_array[0]->images[cyl->sub.image_index];
+			uint32_t array_index = cyl->sub.array_index;
+
+			// Same image for both views
+			src_samplers[cur_image] = clamp_to_edge;
+			src_image_views[cur_image] = get_image_view(image, layer->data.flags, array_index);
+			ubo_data->images_samplers[view_index_for_layer + 0].images[0] = cur_image;
+			ubo_data->images_samplers[view_index_for_layer + 1].images[0] = cur_image;
+			cur_image++;
+
+			struct xrt_normalized_rect *post_transforms = &ubo_data->post_transforms[view_index_for_layer];
+
+			// Same image for both views, same y flip logic as quad layers.
+			post_transforms[0] = cyl->sub.norm_rect;
+			post_transforms[1] = cyl->sub.norm_rect;
+			if (!data->flip_y) {
+				post_transforms[0].h = -post_transforms[0].h;
+				post_transforms[0].y = post_transforms[0].y - post_transforms[0].h;
+				post_transforms[1].h = -post_transforms[1].h;
+				post_transforms[1].y = post_transforms[1].y - post_transforms[1].h;
+			}
+
+			uint32_t visibility = 0;
+			if ((cyl->visibility & XRT_LAYER_EYE_VISIBILITY_LEFT_BIT) != 0) {
+				visibility |= 1;
+			}
+			if ((cyl->visibility & XRT_LAYER_EYE_VISIBILITY_RIGHT_BIT) != 0) {
+				visibility |= 2;
+			}
+
+			ubo_data->cylinder_data[layer_i].radius = cyl->radius;
+			ubo_data->cylinder_data[layer_i].central_angle = cyl->central_angle;
+			ubo_data->cylinder_data[layer_i].aspect_ratio = cyl->aspect_ratio;
+			ubo_data->cylinder_data[layer_i].visibility = (float)visibility;
+
+			// Is this layer viewspace or not.
+			const struct xrt_matrix_4x4 *view_mats =
+			    (layer->data.flags & XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT) ? eye_view_mats
+			                                                               : world_view_mats;
+
+			for (uint32_t view_i = 0; view_i < 2; view_i++) {
+				struct xrt_vec3 scale = {1.f, 1.f, 1.f};
+				struct xrt_matrix_4x4 cylinder_transform_view_space;
+				math_matrix_4x4_model(&cyl->pose, &scale, &cylinder_transform_view_space);
+				math_matrix_4x4_multiply(&view_mats[view_i], &cylinder_transform_view_space,
+				                         &cylinder_transform_view_space);
+				math_matrix_4x4_inverse(
+				    &cylinder_transform_view_space,
+				    &ubo_data->inverse_quad_transform[view_index_for_layer + view_i]);
+			}
+
 		} break;
 		default:
 			COMP_ERROR(r->c, "Layer type %d not supported by compute shader, skipping", data->type);
@@ -1633,6 +1695,8 @@ comp_renderer_set_projection_layer(struct comp_renderer *r,
 	l->type = XRT_LAYER_STEREO_PROJECTION;
 	l->flags = data->flags;
 	l->view_space = (data->flags & XRT_LAYER_COMPOSITION_VIEW_SPACE_BIT) != 0;
+	// Layers are reused, don't keep the visibility of the previous one.
+	l->visibility = XRT_LAYER_EYE_VISIBILITY_BOTH;
 
 	l->transformation[0].offset = data->stereo.l.sub.rect.offset;
 	l->transformation[0].extent = data->stereo.l.sub.rect.extent;
@@ -123,7 +123,8 @@ comp_renderer_set_cube_layer(struct comp_renderer *r,
 #endif
 
 /*!
- * Allocate an internal array of per-layer data with the given number of elements.
+ * Allocate an internal array of per-layer data with the given number of elements,
+ * per-layer data from previous frames is reused and only grown when needed.
  *
  * @public @memberof comp_renderer
  * @ingroup comp_main
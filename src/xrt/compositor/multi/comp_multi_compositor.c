@@ -58,7 +58,11 @@ slot_clear_locked(struct multi_compositor *mc, struct multi_layer_slot *slot)
 		}
 	}
 
-	U_ZERO(slot);
+	// Layers past layer_count are always zero, only clear the used ones.
+	memset(slot->layers, 0, sizeof(slot->layers[0]) * slot->layer_count);
+	U_ZERO(&slot->data);
+	slot->layer_count = 0;
+	slot->active = false;
 	slot->data.frame_id = -1;
 }
 
@@ -66,25 +70,24 @@ slot_clear_locked(struct multi_compositor *mc, struct multi_layer_slot *slot)
  * Clear a slot, need to have the list_and_timing_lock held.
  */
 static void
-slot_move_into_cleared(struct multi_layer_slot *dst, struct multi_layer_slot *src)
+slot_move_into_cleared(struct multi_layer_slot **dst, struct multi_layer_slot **src)
 {
-	assert(!dst->active);
-	assert(dst->data.frame_id == -1);
+	assert(!(*dst)->active);
+	assert((*dst)->data.frame_id == -1);
 
-	// All references are kept.
+	// All references are kept, src gets the cleared slot.
+	struct multi_layer_slot *tmp = *dst;
 	*dst = *src;
-
-	U_ZERO(src);
-	src->data.frame_id = -1;
+	*src = tmp;
 }
 
 /*!
  * Move a slot into a cleared slot, must be cleared before.
  */
 static void
-slot_move_and_clear_locked(struct multi_compositor *mc, struct multi_layer_slot *dst, struct multi_layer_slot *src)
+slot_move_and_clear_locked(struct multi_compositor *mc, struct multi_layer_slot **dst, struct multi_layer_slot **src)
 {
-	slot_clear_locked(mc, dst);
+	slot_clear_locked(mc, *dst);
 	slot_move_into_cleared(dst, src);
 }
 
@@ -216,18 +219,18 @@ wait_for_scheduled_free(struct multi_compositor *mc)
 	struct multi_compositor volatile *v_mc = mc;
 
 	// Block here if the scheduled slot is not clear.
-	while (v_mc->scheduled.active) {
+	while (v_mc->scheduled->active) {
 		uint64_t now_ns = os_monotonic_get_ns();
 
 		// This frame is for the next frame, drop the old one no matter what.
-		if (time_is_within_half_ms(mc->progress.data.display_time_ns, mc->slot_next_frame_display)) {
+		if (time_is_within_half_ms(mc->progress->data.display_time_ns, mc->slot_next_frame_display)) {
 			//U_LOG_W("%.3fms: Dropping old missed frame in favour for completed new frame",
 			//        time_ns_to_ms_f(now_ns));
 			break;
 		}
 
 		// Replace the scheduled frame if it's in the past.
-		if (v_mc->scheduled.data.display_time_ns < now_ns) {
+		if (v_mc->scheduled->data.display_time_ns < now_ns) {
 			U_LOG_T("%.3fms: Replacing frame for time in past in favour of completed new frame",
 			        time_ns_to_ms_f(now_ns));
 			break;
@@ -242,10 +245,10 @@ wait_for_scheduled_free(struct multi_compositor *mc)
 		    "\n\tscheduled: %fms (%" PRIu64 ") (oldest waiting frame)",
 		    time_ns_to_ms_f((int64_t)v_mc->slot_next_frame_display - now_ns),        //
 		    v_mc->slot_next_frame_display,                                           //
-		    time_ns_to_ms_f((int64_t)v_mc->progress.data.display_time_ns - now_ns),  //
-		    v_mc->progress.data.display_time_ns,                                     //
-		    time_ns_to_ms_f((int64_t)v_mc->scheduled.data.display_time_ns - now_ns), //
-		    v_mc->scheduled.data.display_time_ns);                                   //
+		    time_ns_to_ms_f((int64_t)v_mc->progress->data.display_time_ns - now_ns),  //
+		    v_mc->progress->data.display_time_ns,                                     //
+		    time_ns_to_ms_f((int64_t)v_mc->scheduled->data.display_time_ns - now_ns), //
+		    v_mc->scheduled->data.display_time_ns);                                   //
 
 		os_mutex_unlock(&mc->slot_lock);
 
@@ -457,7 +460,7 @@ multi_compositor_create_swapchain(struct xrt_compositor *xc,
 
 	struct multi_compositor *mc = multi_compositor(xc);
 
-	return xrt_comp_create_swapchain(&mc->msc->xcn->base, info, out_xsc);
+	return xrt_comp_native_create_swapchain_for_client(mc->msc->xcn, mc->client_id, info, out_xsc);
 }
 
 static xrt_result_t
@@ -672,11 +675,11 @@ multi_compositor_layer_begin(struct xrt_compositor *xc, const struct xrt_layer_f
 	 */
 	wait_for_wait_thread(mc);
 
-	assert(mc->progress.layer_count == 0);
-	U_ZERO(&mc->progress);
+	// The slot has been cleared, so the layers are already zeroed.
+	assert(mc->progress->layer_count == 0);
 
-	mc->progress.active = true;
-	mc->progress.data = *data;
+	mc->progress->active = true;
+	mc->progress->data = *data;
 
 	return XRT_SUCCESS;
 }
@@ -691,11 +694,11 @@ multi_compositor_layer_stereo_projection(struct xrt_compositor *xc,
 	struct multi_compositor *mc = multi_compositor(xc);
 	(void)mc;
 
-	size_t index = mc->progress.layer_count++;
-	mc->progress.layers[index].xdev = xdev;
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], l_xsc);
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[1], r_xsc);
-	mc->progress.layers[index].data = *data;
+	size_t index = mc->progress->layer_count++;
+	mc->progress->layers[index].xdev = xdev;
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[0], l_xsc);
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[1], r_xsc);
+	mc->progress->layers[index].data = *data;
 
 	return XRT_SUCCESS;
 }
@@ -711,13 +714,13 @@ multi_compositor_layer_stereo_projection_depth(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
-	size_t index = mc->progress.layer_count++;
-	mc->progress.layers[index].xdev = xdev;
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], l_xsc);
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[1], r_xsc);
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[2], l_d_xsc);
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[3], r_d_xsc);
-	mc->progress.layers[index].data = *data;
+	size_t index = mc->progress->layer_count++;
+	mc->progress->layers[index].xdev = xdev;
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[0], l_xsc);
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[1], r_xsc);
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[2], l_d_xsc);
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[3], r_d_xsc);
+	mc->progress->layers[index].data = *data;
 
 	return XRT_SUCCESS;
 }
@@ -730,10 +733,10 @@ multi_compositor_layer_quad(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
-	size_t index = mc->progress.layer_count++;
-	mc->progress.layers[index].xdev = xdev;
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
-	mc->progress.layers[index].data = *data;
+	size_t index = mc->progress->layer_count++;
+	mc->progress->layers[index].xdev = xdev;
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[0], xsc);
+	mc->progress->layers[index].data = *data;
 
 	return XRT_SUCCESS;
 }
@@ -746,10 +749,10 @@ multi_compositor_layer_cube(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
-	size_t index = mc->progress.layer_count++;
-	mc->progress.layers[index].xdev = xdev;
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
-	mc->progress.layers[index].data = *data;
+	size_t index = mc->progress->layer_count++;
+	mc->progress->layers[index].xdev = xdev;
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[0], xsc);
+	mc->progress->layers[index].data = *data;
 
 	return XRT_SUCCESS;
 }
@@ -762,10 +765,10 @@ multi_compositor_layer_cylinder(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
-	size_t index = mc->progress.layer_count++;
-	mc->progress.layers[index].xdev = xdev;
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
-	mc->progress.layers[index].data = *data;
+	size_t index = mc->progress->layer_count++;
+	mc->progress->layers[index].xdev = xdev;
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[0], xsc);
+	mc->progress->layers[index].data = *data;
 
 	return XRT_SUCCESS;
 }
@@ -778,10 +781,10 @@ multi_compositor_layer_equirect1(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
-	size_t index = mc->progress.layer_count++;
-	mc->progress.layers[index].xdev = xdev;
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
-	mc->progress.layers[index].data = *data;
+	size_t index = mc->progress->layer_count++;
+	mc->progress->layers[index].xdev = xdev;
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[0], xsc);
+	mc->progress->layers[index].data = *data;
 
 	return XRT_SUCCESS;
 }
@@ -794,10 +797,10 @@ multi_compositor_layer_equirect2(struct xrt_compositor *xc,
 {
 	struct multi_compositor *mc = multi_compositor(xc);
 
-	size_t index = mc->progress.layer_count++;
-	mc->progress.layers[index].xdev = xdev;
-	xrt_swapchain_reference(&mc->progress.layers[index].xscs[0], xsc);
-	mc->progress.layers[index].data = *data;
+	size_t index = mc->progress->layer_count++;
+	mc->progress->layers[index].xdev = xdev;
+	xrt_swapchain_reference(&mc->progress->layers[index].xscs[0], xsc);
+	mc->progress->layers[index].data = *data;
 
 	return XRT_SUCCESS;
 }
@@ -809,7 +812,7 @@ multi_compositor_layer_commit(struct xrt_compositor *xc, xrt_graphics_sync_handl
 
 	struct multi_compositor *mc = multi_compositor(xc);
 	struct xrt_compositor_fence *xcf = NULL;
-	int64_t frame_id = mc->progress.data.frame_id;
+	int64_t frame_id = mc->progress->data.frame_id;
 
 	do {
 		if (!xrt_graphics_sync_handle_is_valid(sync_handle)) {
@@ -856,7 +859,7 @@ multi_compositor_layer_commit_with_semaphore(struct xrt_compositor *xc,
 	COMP_TRACE_MARKER();
 
 	struct multi_compositor *mc = multi_compositor(xc);
-	int64_t frame_id = mc->progress.data.frame_id;
+	int64_t frame_id = mc->progress->data.frame_id;
 
 	push_semaphore_to_wait_thread(mc, frame_id, xcsem, value);
 
@@ -905,11 +908,14 @@ multi_compositor_destroy(struct xrt_compositor *xc)
 
 	// We are now off the rendering list, clear slots for any swapchains.
 	os_mutex_lock(&mc->msc->list_and_timing_lock);
-	slot_clear_locked(mc, &mc->progress);
-	slot_clear_locked(mc, &mc->scheduled);
-	slot_clear_locked(mc, &mc->delivered);
+	slot_clear_locked(mc, mc->progress);
+	slot_clear_locked(mc, mc->scheduled);
+	slot_clear_locked(mc, mc->delivered);
 	os_mutex_unlock(&mc->msc->list_and_timing_lock);
 
+	// All of our swapchains are released, nothing more to keep for us.
+	xrt_comp_native_release_client(mc->msc->xcn, mc->client_id);
+
 	// Does null checking.
 	u_pa_destroy(&mc->upa);
 
@@ -940,15 +946,15 @@ multi_compositor_deliver_any_frames(struct multi_compositor *mc, uint64_t displa
 {
 	os_mutex_lock(&mc->slot_lock);
 
-	if (!mc->scheduled.active) {
+	if (!mc->scheduled->active) {
 		os_mutex_unlock(&mc->slot_lock);
 		return;
 	}
 
-	if (time_is_greater_then_or_within_half_ms(display_time_ns, mc->scheduled.data.display_time_ns)) {
+	if (time_is_greater_then_or_within_half_ms(display_time_ns, mc->scheduled->data.display_time_ns)) {
 		slot_move_and_clear_locked(mc, &mc->delivered, &mc->scheduled);
 
-		uint64_t frame_time_ns = mc->delivered.data.display_time_ns;
+		uint64_t frame_time_ns = mc->delivered->data.display_time_ns;
 		if (!time_is_within_half_ms(frame_time_ns, display_time_ns)) {
 			log_frame_time_diff(frame_time_ns, display_time_ns);
 		}
@@ -960,13 +966,13 @@ multi_compositor_deliver_any_frames(struct multi_compositor *mc, uint64_t displa
 void
 multi_compositor_latch_frame_locked(struct multi_compositor *mc, uint64_t when_ns, int64_t system_frame_id)
 {
-	u_pa_latched(mc->upa, mc->delivered.data.frame_id, when_ns, system_frame_id);
+	u_pa_latched(mc->upa, mc->delivered->data.frame_id, when_ns, system_frame_id);
 }
 
 void
 multi_compositor_retire_delivered_locked(struct multi_compositor *mc, uint64_t when_ns)
 {
-	slot_clear_locked(mc, &mc->delivered);
+	slot_clear_locked(mc, mc->delivered);
 }
 
 xrt_result_t
@@ -1005,6 +1011,10 @@ multi_compositor_create(struct multi_system_compositor *msc,
 	mc->msc = msc;
 	mc->xsi = *xsi;
 
+	mc->progress = &mc->slots[0];
+	mc->scheduled = &mc->slots[1];
+	mc->delivered = &mc->slots[2];
+
 	os_mutex_init(&mc->event.mutex);
 	os_mutex_init(&mc->slot_lock);
 	os_thread_helper_init(&mc->wait_thread.oth);
@@ -1023,6 +1033,8 @@ multi_compositor_create(struct multi_system_compositor *msc,
 
 	os_mutex_lock(&msc->list_and_timing_lock);
 
+	mc->client_id = ++msc->last_client_id;
+
 	// If we have too many clients, just ignore it.
 	for (size_t i = 0; i < MULTI_MAX_CLIENTS; i++) {
 		if (mc->msc->clients[i] != NULL) {
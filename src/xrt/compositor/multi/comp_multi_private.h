@@ -101,6 +101,9 @@ struct multi_compositor
 	//! Owning system compositor.
 	struct multi_system_compositor *msc;
 
+	//! Identifies this client to the native compositor, never reused.
+	uint64_t client_id;
+
 	//! Used to implement wait frame, only used for in process.
 	struct os_precise_sleeper frame_sleeper;
 
@@ -163,20 +166,26 @@ struct multi_compositor
 	 */
 	uint64_t slot_next_frame_display;
 
+	/*!
+	 * Storage for the slots below, frames move between them by swapping
+	 * the pointers so the layers are never copied.
+	 */
+	struct multi_layer_slot slots[3];
+
 	/*!
 	 * Currently being transferred or waited on.
 	 * Not protected by the slot lock as it is only touched by the client thread.
 	 */
-	struct multi_layer_slot progress;
+	struct multi_layer_slot *progress;
 
 	//! Scheduled frames for a future timepoint.
-	struct multi_layer_slot scheduled;
+	struct multi_layer_slot *scheduled;
 
 	/*!
 	 * Fully ready to be used.
 	 * Not protected by the slot lock as it is only touched by the main render loop thread.
 	 */
-	struct multi_layer_slot delivered;
+	struct multi_layer_slot *delivered;
 
 	struct u_pacing_app *upa;
 };
@@ -343,6 +352,22 @@ struct multi_system_compositor
 	} last_timings;
 
 	struct multi_compositor *clients[MULTI_MAX_CLIENTS];
+
+	//! Last client id handed out, protected by list_and_timing_lock.
+	uint64_t last_client_id;
+
+	//! Layer culling, protected by list_and_timing_lock.
+	struct
+	{
+		//! Drop layers hidden below an opaque full field of view projection layer.
+		bool enabled;
+
+		//! Number of layers dropped in the last frame.
+		uint32_t culled_count;
+
+		//! Number of layers forwarded to the native compositor in the last frame.
+		uint32_t submitted_count;
+	} cull;
 };
 
 /*!
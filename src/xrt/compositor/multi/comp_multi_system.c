@@ -8,6 +8,8 @@
  * @ingroup comp_multi
  */
 
+#include "xrt/xrt_device.h"
+
 #include "os/os_time.h"
 #include "os/os_threading.h"
 
@@ -34,6 +36,21 @@
 #endif
 
 
+/*
+ *
+ * Defines and helpers.
+ *
+ */
+
+DEBUG_GET_ONCE_BOOL_OPTION(cull_layers, "XRT_COMPOSITOR_MULTI_CULL_LAYERS", true)
+
+/*!
+ * Slack in radians when comparing field of views, apps often round trip the
+ * values through other representations.
+ */
+#define FOV_EPSILON (0.001f)
+
+
 /*
  *
  * Render thread.
@@ -211,6 +228,79 @@ overlay_sort_func(const void *a, const void *b)
 	return 0;
 }
 
+static bool
+fov_covers(const struct xrt_fov *layer_fov, const struct xrt_fov *view_fov)
+{
+	return layer_fov->angle_left <= view_fov->angle_left + FOV_EPSILON &&   //
+	       layer_fov->angle_right >= view_fov->angle_right - FOV_EPSILON && //
+	       layer_fov->angle_up >= view_fov->angle_up - FOV_EPSILON &&       //
+	       layer_fov->angle_down <= view_fov->angle_down + FOV_EPSILON;
+}
+
+/*!
+ * Is this an opaque projection layer that covers the full field of view of
+ * the head device, if so nothing below it can be seen.
+ */
+static bool
+is_layer_occluding(const struct multi_layer_entry *layer)
+{
+	const struct xrt_layer_projection_view_data *l = NULL;
+	const struct xrt_layer_projection_view_data *r = NULL;
+
+	switch (layer->data.type) {
+	case XRT_LAYER_STEREO_PROJECTION:
+		l = &layer->data.stereo.l;
+		r = &layer->data.stereo.r;
+		break;
+	case XRT_LAYER_STEREO_PROJECTION_DEPTH:
+		l = &layer->data.stereo_depth.l;
+		r = &layer->data.stereo_depth.r;
+		break;
+	default: return false;
+	}
+
+	// Blended with whatever is below it.
+	if ((layer->data.flags & XRT_LAYER_COMPOSITION_BLEND_TEXTURE_SOURCE_ALPHA_BIT) != 0) {
+		return false;
+	}
+
+	// Need the field of view of the device to know if everything is covered.
+	struct xrt_device *xdev = layer->xdev;
+	if (xdev == NULL || xdev->hmd == NULL) {
+		return false;
+	}
+
+	return fov_covers(&l->fov, &xdev->hmd->distortion.fov[0]) && //
+	       fov_covers(&r->fov, &xdev->hmd->distortion.fov[1]);
+}
+
+/*!
+ * Find the top most layer that hides everything below it, the array is sorted
+ * on z-order and layers within a client are ordered back to front. If no such
+ * layer is found the first layer of the first client is returned.
+ */
+static void
+find_first_visible_layer(struct multi_compositor **array,
+                         size_t count,
+                         size_t *out_client_index,
+                         uint32_t *out_layer_index)
+{
+	for (size_t k = count; k-- > 0;) {
+		struct multi_compositor *mc = array[k];
+
+		for (uint32_t i = mc->delivered->layer_count; i-- > 0;) {
+			if (is_layer_occluding(&mc->delivered->layers[i])) {
+				*out_client_index = k;
+				*out_layer_index = i;
+				return;
+			}
+		}
+	}
+
+	*out_client_index = 0;
+	*out_layer_index = 0;
+}
+
 static void
 transfer_layers_locked(struct multi_system_compositor *msc, uint64_t display_time_ns, int64_t system_frame_id)
 {
@@ -236,7 +326,7 @@ transfer_layers_locked(struct multi_system_compositor *msc, uint64_t display_tim
 		multi_compositor_deliver_any_frames(mc, display_time_ns);
 
 		// None of the data in this slot is valid, don't check access it.
-		if (!mc->delivered.active) {
+		if (!mc->delivered->active) {
 			continue;
 		}
 
@@ -265,13 +355,30 @@ transfer_layers_locked(struct multi_system_compositor *msc, uint64_t display_tim
 	// Sort the stack array
 	qsort(array, count, sizeof(struct multi_compositor *), overlay_sort_func);
 
+	// Everything below this layer is hidden, so don't submit it.
+	size_t first_client = 0;
+	uint32_t first_layer = 0;
+	if (msc->cull.enabled) {
+		find_first_visible_layer(array, count, &first_client, &first_layer);
+	}
+
+	uint32_t culled_count = 0;
+	uint32_t submitted_count = 0;
+
 	// Copy all active layers.
 	for (size_t k = 0; k < count; k++) {
 		struct multi_compositor *mc = array[k];
 		assert(mc != NULL);
 
-		for (uint32_t i = 0; i < mc->delivered.layer_count; i++) {
-			struct multi_layer_entry *layer = &mc->delivered.layers[i];
+		for (uint32_t i = 0; i < mc->delivered->layer_count; i++) {
+			struct multi_layer_entry *layer = &mc->delivered->layers[i];
+
+			if (k < first_client || (k == first_client && i < first_layer)) {
+				culled_count++;
+				continue;
+			}
+
+			submitted_count++;
 
 			switch (layer->data.type) {
 			case XRT_LAYER_STEREO_PROJECTION: do_projection_layer(xc, mc, layer, i); break;
@@ -285,6 +392,9 @@ transfer_layers_locked(struct multi_system_compositor *msc, uint64_t display_tim
 			}
 		}
 	}
+
+	msc->cull.culled_count = culled_count;
+	msc->cull.submitted_count = submitted_count;
 }
 
 static void
@@ -639,6 +749,8 @@ system_compositor_destroy(struct xrt_system_compositor *xsc)
 	// Destroy the render thread first, destroy also stops the thread.
 	os_thread_helper_destroy(&msc->oth);
 
+	u_var_remove_root(msc);
+
 	u_paf_destroy(&msc->upaf);
 
 	xrt_comp_native_destroy(&msc->xcn);
@@ -695,6 +807,7 @@ comp_multi_create_system_compositor(struct xrt_compositor_native *xcn,
 	msc->xcn = xcn;
 	msc->sessions.active_count = 0;
 	msc->sessions.state = do_warm_start ? MULTI_SYSTEM_STATE_INIT_WARM_START : MULTI_SYSTEM_STATE_STOPPED;
+	msc->cull.enabled = debug_get_bool_option_cull_layers();
 
 	os_mutex_init(&msc->list_and_timing_lock);
 
@@ -709,6 +822,11 @@ comp_multi_create_system_compositor(struct xrt_compositor_native *xcn,
 		return XRT_ERROR_THREADING_INIT_FAILURE;
 	}
 
+	u_var_add_root(msc, "Multi-client compositor", false);
+	u_var_add_bool(msc, &msc->cull.enabled, "Cull hidden layers");
+	u_var_add_ro_u32(msc, &msc->cull.culled_count, "Culled layers");
+	u_var_add_ro_u32(msc, &msc->cull.submitted_count, "Submitted layers");
+
 	os_thread_helper_start(&msc->oth, thread_func, msc);
 
 	*out_xsysc = &msc->base;
@@ -13,6 +13,10 @@
 #include "math/m_matrix_2x2.h"
 #include "math/m_vec2.h"
 
+#include "util/u_misc.h"
+#include "util/u_worker.h"
+#include "util/u_distortion_mesh.h"
+
 #include "render/render_interface.h"
 
 
@@ -265,6 +269,7 @@ calc_uv_to_tanangle(struct xrt_device *xdev, uint32_t view, struct xrt_normalize
 
 static XRT_CHECK_RESULT VkResult
 create_and_fill_in_distortion_buffer_for_view(struct vk_bundle *vk,
+                                              struct u_worker_thread_pool *workers,
                                               struct xrt_device *xdev,
                                               struct render_buffer *r_buffer,
                                               struct render_buffer *g_buffer,
@@ -311,7 +316,13 @@ create_and_fill_in_distortion_buffer_for_view(struct vk_bundle *vk,
 	struct texture *b = b_buffer->mapped;
 
 	const double dim_minus_one_f64 = COMP_DISTORTION_IMAGE_DIMENSIONS - 1;
+	const uint32_t count = COMP_DISTORTION_IMAGE_DIMENSIONS * COMP_DISTORTION_IMAGE_DIMENSIONS;
+
+	float *us = U_TYPED_ARRAY_CALLOC(float, count);
+	float *vs = U_TYPED_ARRAY_CALLOC(float, count);
+	struct xrt_uv_triplet *results = U_TYPED_ARRAY_CALLOC(struct xrt_uv_triplet, count);
 
+	uint32_t i = 0;
 	for (int row = 0; row < COMP_DISTORTION_IMAGE_DIMENSIONS; row++) {
 		// This goes from 0 to 1.0 inclusive.
 		float v = (float)(row / dim_minus_one_f64);
@@ -323,18 +334,30 @@ create_and_fill_in_distortion_buffer_for_view(struct vk_bundle *vk,
 			// These need to go from -0.5 to 0.5 for the rotation
 			struct xrt_vec2 uv = {u - 0.5f, v - 0.5f};
 			m_mat2x2_transform_vec2(&rot, &uv, &uv);
-			uv.x += 0.5f;
-			uv.y += 0.5f;
 
-			struct xrt_uv_triplet result;
-			xrt_device_compute_distortion(xdev, view, uv.x, uv.y, &result);
+			us[i] = uv.x + 0.5f;
+			vs[i] = uv.y + 0.5f;
+			i++;
+		}
+	}
+
+	// Evaluates all of the points, on multiple threads if the device supports it.
+	u_distortion_mesh_compute_batch(workers, xdev, view, count, us, vs, results);
 
-			r->pixels[row][col] = result.r;
-			g->pixels[row][col] = result.g;
-			b->pixels[row][col] = result.b;
+	i = 0;
+	for (int row = 0; row < COMP_DISTORTION_IMAGE_DIMENSIONS; row++) {
+		for (int col = 0; col < COMP_DISTORTION_IMAGE_DIMENSIONS; col++) {
+			r->pixels[row][col] = results[i].r;
+			g->pixels[row][col] = results[i].g;
+			b->pixels[row][col] = results[i].b;
+			i++;
 		}
 	}
 
+	free(us);
+	free(vs);
+	free(results);
+
 	render_buffer_unmap(vk, r_buffer);
 	render_buffer_unmap(vk, g_buffer);
 	render_buffer_unmap(vk, b_buffer);
@@ -377,10 +400,17 @@ render_distortion_buffer_init(struct render_resources *r,
 	 * Buffers with data to upload.
 	 */
 
-	ret = create_and_fill_in_distortion_buffer_for_view(vk, xdev, &bufs[0], &bufs[2], &bufs[4], 0, pre_rotate);
-	CG(vk, ret, "create_and_fill_in_distortion_buffer_for_view", err_resources);
+	// Used to evaluate the distortion of both views, NULL if single threaded.
+	struct u_worker_thread_pool *workers = u_distortion_mesh_create_worker_pool();
+
+	ret = create_and_fill_in_distortion_buffer_for_view( //
+	    vk, workers, xdev, &bufs[0], &bufs[2], &bufs[4], 0, pre_rotate);
+	if (ret == VK_SUCCESS) {
+		ret = create_and_fill_in_distortion_buffer_for_view( //
+		    vk, workers, xdev, &bufs[1], &bufs[3], &bufs[5], 1, pre_rotate);
+	}
 
-	ret = create_and_fill_in_distortion_buffer_for_view(vk, xdev, &bufs[1], &bufs[3], &bufs[5], 1, pre_rotate);
+	u_worker_thread_pool_reference(&workers, NULL);
 	CG(vk, ret, "create_and_fill_in_distortion_buffer_for_view", err_resources);
 
 
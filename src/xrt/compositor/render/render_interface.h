@@ -810,6 +810,21 @@ struct render_compute_layer_ubo_data
 		struct xrt_vec2 val;
 		float padding[2];
 	} quad_extent[COMP_MAX_LAYERS];
+
+
+	/*!
+	 * For cylinder layers, uses inverse_quad_transform for the inverse
+	 * of the cylinder pose in view space.
+	 */
+
+	//! Radius, central angle, aspect ratio and view visibility bits.
+	struct
+	{
+		float radius;
+		float central_angle;
+		float aspect_ratio;
+		float visibility;
+	} cylinder_data[COMP_MAX_LAYERS];
 };
 
 /*!
@@ -53,7 +53,22 @@ base_get_swapchain_create_properties(struct xrt_compositor *xc,
                                      const struct xrt_swapchain_create_info *info,
                                      struct xrt_swapchain_create_properties *xsccp)
 {
-	return comp_swapchain_get_create_properties(info, xsccp);
+	struct comp_base *cb = comp_base(xc);
+	struct vk_bundle *vk = &cb->vk;
+
+	xrt_result_t xret = comp_swapchain_get_create_properties(info, xsccp);
+	if (xret != XRT_SUCCESS || cb->cscs.image_pool.budget_bytes == 0) {
+		return xret;
+	}
+
+	// Pooled images are cleared before being reused, only possible if they are transfer destinations.
+	VkFormatProperties prop;
+	vk->vkGetPhysicalDeviceFormatProperties(vk->physical_device, (VkFormat)info->format, &prop);
+	if ((prop.optimalTilingFeatures & VK_FORMAT_FEATURE_TRANSFER_DST_BIT) != 0) {
+		xsccp->extra_bits |= XRT_SWAPCHAIN_USAGE_TRANSFER_DST;
+	}
+
+	return XRT_SUCCESS;
 }
 
 static xrt_result_t
@@ -73,6 +88,29 @@ base_create_swapchain(struct xrt_compositor *xc,
 	return comp_swapchain_create(&cb->vk, &cb->cscs, info, &xsccp, out_xsc);
 }
 
+static xrt_result_t
+base_create_swapchain_for_client(struct xrt_compositor_native *xcn,
+                                 uint64_t client_id,
+                                 const struct xrt_swapchain_create_info *info,
+                                 struct xrt_swapchain **out_xsc)
+{
+	struct comp_base *cb = comp_base(&xcn->base);
+
+	// Same as above.
+	struct xrt_swapchain_create_properties xsccp = {0};
+	xrt_comp_get_swapchain_create_properties(&xcn->base, info, &xsccp);
+
+	return comp_swapchain_create_for_client(&cb->vk, &cb->cscs, client_id, info, &xsccp, out_xsc);
+}
+
+static void
+base_release_client(struct xrt_compositor_native *xcn, uint64_t client_id)
+{
+	struct comp_base *cb = comp_base(&xcn->base);
+
+	comp_swapchain_shared_release_client(&cb->cscs, &cb->vk, client_id);
+}
+
 static xrt_result_t
 base_import_swapchain(struct xrt_compositor *xc,
                       const struct xrt_swapchain_create_info *info,
@@ -264,6 +302,8 @@ comp_base_init(struct comp_base *cb)
 	cb->base.base.layer_equirect1 = base_layer_equirect1;
 	cb->base.base.layer_equirect2 = base_layer_equirect2;
 	cb->base.base.wait_frame = base_wait_frame;
+	cb->base.create_swapchain_for_client = base_create_swapchain_for_client;
+	cb->base.release_client = base_release_client;
 
 	u_threading_stack_init(&cb->cscs.destroy_swapchains);
 
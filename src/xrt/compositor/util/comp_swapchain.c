@@ -10,7 +10,9 @@
 #include "xrt/xrt_handles.h"
 #include "xrt/xrt_config_os.h"
 
+#include "util/u_var.h"
 #include "util/u_misc.h"
+#include "util/u_debug.h"
 #include "util/u_handles.h"
 
 #include "util/comp_swapchain.h"
@@ -21,6 +23,9 @@
 #include <inttypes.h>
 
 
+DEBUG_GET_ONCE_NUM_OPTION(pool_budget_mb, "XRT_COMPOSITOR_SWAPCHAIN_POOL_MB", 256)
+
+
 /*
  *
  * Swapchain member functions.
@@ -105,6 +110,7 @@ set_common_fields(struct comp_swapchain *sc,
 	sc->real_destroy = destroy_func;
 	sc->vk = vk;
 	sc->cscs = cscs;
+	sc->client_id = 0;
 
 	// Make sure the handles are invalid.
 	for (uint32_t i = 0; i < ARRAY_SIZE(sc->base.images); i++) {
@@ -114,10 +120,46 @@ set_common_fields(struct comp_swapchain *sc,
 	return sc;
 }
 
+/*!
+ * Clear the images, they are in the transfer destination layout. Reused images
+ * still hold whatever the client last rendered into them.
+ */
+static void
+clear_images_locked(struct vk_bundle *vk,
+                    VkCommandBuffer cmd_buffer,
+                    struct comp_swapchain *sc,
+                    VkImageSubresourceRange subresource_range)
+{
+	for (uint32_t i = 0; i < sc->vkic.image_count; i++) {
+		VkImage image = sc->vkic.images[i].handle;
+
+		if ((subresource_range.aspectMask & VK_IMAGE_ASPECT_COLOR_BIT) != 0) {
+			VkClearColorValue color = {0};
+			vk->vkCmdClearColorImage(                 //
+			    cmd_buffer,                           // commandBuffer
+			    image,                                // image
+			    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // imageLayout
+			    &color,                               // pColor
+			    1,                                    // rangeCount
+			    &subresource_range);                  // pRanges
+		} else {
+			VkClearDepthStencilValue depth_stencil = {.depth = 1.0f, .stencil = 0};
+			vk->vkCmdClearDepthStencilImage(          //
+			    cmd_buffer,                           // commandBuffer
+			    image,                                // image
+			    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // imageLayout
+			    &depth_stencil,                       // pDepthStencil
+			    1,                                    // rangeCount
+			    &subresource_range);                  // pRanges
+		}
+	}
+}
+
 static void
 do_post_create_vulkan_setup(struct vk_bundle *vk,
                             const struct xrt_swapchain_create_info *info,
-                            struct comp_swapchain *sc)
+                            struct comp_swapchain *sc,
+                            bool clear)
 {
 	uint32_t image_count = sc->vkic.image_count;
 	VkCommandBuffer cmd_buffer;
@@ -205,14 +247,37 @@ do_post_create_vulkan_setup(struct vk_bundle *vk,
 	    .layerCount = info->array_size * info->face_count,
 	};
 
+	if (clear) {
+		// All of the mip levels, none of the old contents may be left.
+		subresource_range.levelCount = info->mip_count;
+
+		for (uint32_t i = 0; i < image_count; i++) {
+			vk_cmd_image_barrier_gpu_locked(          //
+			    vk,                                   //
+			    cmd_buffer,                           //
+			    sc->vkic.images[i].handle,            //
+			    0,                                    //
+			    VK_ACCESS_TRANSFER_WRITE_BIT,         //
+			    VK_IMAGE_LAYOUT_UNDEFINED,            //
+			    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, //
+			    subresource_range);                   //
+		}
+
+		clear_images_locked(vk, cmd_buffer, sc, subresource_range);
+	}
+
+	// Cleared images are already in the transfer layout.
+	VkAccessFlags src_access_mask = clear ? VK_ACCESS_TRANSFER_WRITE_BIT : 0;
+	VkImageLayout old_layout = clear ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+
 	for (uint32_t i = 0; i < image_count; i++) {
 		vk_cmd_image_barrier_gpu_locked(              //
 		    vk,                                       //
 		    cmd_buffer,                               //
 		    sc->vkic.images[i].handle,                //
-		    0,                                        //
+		    src_access_mask,                          //
 		    VK_ACCESS_SHADER_READ_BIT,                //
-		    VK_IMAGE_LAYOUT_UNDEFINED,                //
+		    old_layout,                               //
 		    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, //
 		    subresource_range);                       //
 	}
@@ -273,6 +338,170 @@ image_cleanup(struct vk_bundle *vk, struct comp_swapchain_image *image)
 	clean_image_views(vk, image->array_size, &image->views.no_alpha);
 }
 
+
+/*
+ *
+ * Image pool functions.
+ *
+ */
+
+static uint64_t
+collection_size(const struct vk_image_collection *vkic)
+{
+	uint64_t size = 0;
+	for (uint32_t i = 0; i < vkic->image_count; i++) {
+		size += vkic->images[i].size;
+	}
+	return size;
+}
+
+static bool
+create_info_equal(const struct xrt_swapchain_create_info *a, const struct xrt_swapchain_create_info *b)
+{
+	return a->create == b->create &&             //
+	       a->bits == b->bits &&                 //
+	       a->format == b->format &&             //
+	       a->sample_count == b->sample_count && //
+	       a->width == b->width &&               //
+	       a->height == b->height &&             //
+	       a->face_count == b->face_count &&     //
+	       a->array_size == b->array_size &&     //
+	       a->mip_count == b->mip_count;
+}
+
+/*!
+ * Images can only be pooled if they can be cleared before being reused.
+ */
+static bool
+can_pool(uint64_t client_id, const struct xrt_swapchain_create_info *info)
+{
+	return client_id != 0 && (info->bits & XRT_SWAPCHAIN_USAGE_TRANSFER_DST) != 0;
+}
+
+static bool
+client_released_locked(struct comp_swapchain_shared *cscs, uint64_t client_id)
+{
+	for (uint32_t i = 0; i < ARRAY_SIZE(cscs->image_pool.released_clients); i++) {
+		if (cscs->image_pool.released_clients[i] == client_id) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*!
+ * Remove the entry at the given index, keeping the oldest first order.
+ */
+static struct vk_image_collection *
+pool_remove_locked(struct comp_swapchain_shared *cscs, uint32_t index)
+{
+	struct vk_image_collection *vkic = cscs->image_pool.entries[index].vkic;
+
+	for (uint32_t i = index + 1; i < cscs->image_pool.entry_count; i++) {
+		cscs->image_pool.entries[i - 1] = cscs->image_pool.entries[i];
+	}
+	U_ZERO(&cscs->image_pool.entries[--cscs->image_pool.entry_count]);
+	cscs->image_pool.resident_bytes -= collection_size(vkic);
+
+	return vkic;
+}
+
+/*!
+ * Try to get images of the client matching the create info and image count
+ * from the pool, returns true and fills in @p out_vkic on success.
+ */
+static bool
+pool_take(struct comp_swapchain_shared *cscs,
+          uint64_t client_id,
+          const struct xrt_swapchain_create_info *info,
+          uint32_t image_count,
+          struct vk_image_collection *out_vkic)
+{
+	struct vk_image_collection *found = NULL;
+
+	os_mutex_lock(&cscs->image_pool.mutex);
+
+	// Newest first, the most likely to be asked for again.
+	for (uint32_t i = cscs->image_pool.entry_count; i-- > 0;) {
+		struct vk_image_collection *vkic = cscs->image_pool.entries[i].vkic;
+		if (cscs->image_pool.entries[i].client_id == client_id && //
+		    vkic->image_count == image_count &&                   //
+		    create_info_equal(&vkic->info, info)) {
+			found = pool_remove_locked(cscs, i);
+			break;
+		}
+	}
+
+	if (found != NULL) {
+		cscs->image_pool.hit_count++;
+	} else {
+		cscs->image_pool.miss_count++;
+	}
+
+	uint64_t total = cscs->image_pool.hit_count + cscs->image_pool.miss_count;
+	cscs->image_pool.hit_rate = (float)((double)cscs->image_pool.hit_count / (double)total);
+
+	os_mutex_unlock(&cscs->image_pool.mutex);
+
+	if (found == NULL) {
+		return false;
+	}
+
+	*out_vkic = *found;
+	free(found);
+
+	return true;
+}
+
+/*!
+ * Give the images to the pool for the client, evicting the oldest entries to
+ * stay within the budget. Destroys the images if they can not be kept.
+ */
+static void
+pool_give(struct comp_swapchain_shared *cscs,
+          struct vk_bundle *vk,
+          uint64_t client_id,
+          struct vk_image_collection *vkic)
+{
+	uint64_t size = collection_size(vkic);
+	struct vk_image_collection *evicted[COMP_SWAPCHAIN_POOL_MAX_ENTRIES];
+	uint32_t evicted_count = 0;
+	bool kept = false;
+
+	os_mutex_lock(&cscs->image_pool.mutex);
+
+	if (size <= cscs->image_pool.budget_bytes && !client_released_locked(cscs, client_id)) {
+		while (cscs->image_pool.entry_count > 0 &&
+		       (cscs->image_pool.entry_count >= COMP_SWAPCHAIN_POOL_MAX_ENTRIES ||
+		        cscs->image_pool.resident_bytes + size > cscs->image_pool.budget_bytes)) {
+			evicted[evicted_count++] = pool_remove_locked(cscs, 0);
+		}
+
+		struct vk_image_collection *entry = U_TYPED_CALLOC(struct vk_image_collection);
+		*entry = *vkic;
+
+		cscs->image_pool.entries[cscs->image_pool.entry_count].client_id = client_id;
+		cscs->image_pool.entries[cscs->image_pool.entry_count].vkic = entry;
+		cscs->image_pool.entry_count++;
+		cscs->image_pool.resident_bytes += size;
+		kept = true;
+	}
+
+	os_mutex_unlock(&cscs->image_pool.mutex);
+
+	for (uint32_t i = 0; i < evicted_count; i++) {
+		vk_ic_destroy(vk, evicted[i]);
+		free(evicted[i]);
+	}
+
+	if (kept) {
+		// Now owned by the pool.
+		U_ZERO(vkic);
+	} else {
+		vk_ic_destroy(vk, vkic);
+	}
+}
+
 /*!
  * Swapchain destruct is delayed until it is safe to destroy them, this function
  * does the actual destruction and is called from @ref
@@ -289,20 +518,14 @@ really_destroy(struct comp_swapchain *sc)
 	free(sc);
 }
 
-
-/*
- *
- * 'Exported' parent-class functions.
- *
- */
-
-xrt_result_t
-comp_swapchain_create_init(struct comp_swapchain *sc,
-                           comp_swapchain_destroy_func_t destroy_func,
-                           struct vk_bundle *vk,
-                           struct comp_swapchain_shared *cscs,
-                           const struct xrt_swapchain_create_info *info,
-                           const struct xrt_swapchain_create_properties *xsccp)
+static xrt_result_t
+do_create_init(struct comp_swapchain *sc,
+               comp_swapchain_destroy_func_t destroy_func,
+               struct vk_bundle *vk,
+               struct comp_swapchain_shared *cscs,
+               uint64_t client_id,
+               const struct xrt_swapchain_create_info *info,
+               const struct xrt_swapchain_create_properties *xsccp)
 {
 	VkResult ret;
 
@@ -320,16 +543,23 @@ comp_swapchain_create_init(struct comp_swapchain *sc,
 
 	set_common_fields(sc, destroy_func, vk, cscs, xsccp->image_count);
 
-	// Use the image helper to allocate the images.
-	ret = vk_ic_allocate(vk, info, xsccp->image_count, &sc->vkic);
-	if (ret == VK_ERROR_FEATURE_NOT_PRESENT) {
-		return XRT_ERROR_SWAPCHAIN_FLAG_VALID_BUT_UNSUPPORTED;
-	} else if (ret == VK_ERROR_FORMAT_NOT_SUPPORTED) {
-		return XRT_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
-	} else if (ret != VK_SUCCESS) {
-		return XRT_ERROR_VULKAN;
+	// Reuse images from a destroyed swapchain of the client, otherwise allocate new ones.
+	bool reused = can_pool(client_id, info) && pool_take(cscs, client_id, info, xsccp->image_count, &sc->vkic);
+	if (!reused) {
+		// Use the image helper to allocate the images.
+		ret = vk_ic_allocate(vk, info, xsccp->image_count, &sc->vkic);
+		if (ret == VK_ERROR_FEATURE_NOT_PRESENT) {
+			return XRT_ERROR_SWAPCHAIN_FLAG_VALID_BUT_UNSUPPORTED;
+		} else if (ret == VK_ERROR_FORMAT_NOT_SUPPORTED) {
+			return XRT_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+		} else if (ret != VK_SUCCESS) {
+			return XRT_ERROR_VULKAN;
+		}
 	}
 
+	// Imported images belong to someone else, only these can be pooled.
+	sc->client_id = can_pool(client_id, info) ? client_id : 0;
+
 	xrt_graphics_buffer_handle_t handles[ARRAY_SIZE(sc->vkic.images)];
 
 	vk_ic_get_handles(vk, &sc->vkic, ARRAY_SIZE(handles), handles);
@@ -339,11 +569,30 @@ comp_swapchain_create_init(struct comp_swapchain *sc,
 		sc->base.images[i].use_dedicated_allocation = sc->vkic.images[i].use_dedicated_allocation;
 	}
 
-	do_post_create_vulkan_setup(vk, info, sc);
+	do_post_create_vulkan_setup(vk, info, sc, reused);
 
 	return XRT_SUCCESS;
 }
 
+
+/*
+ *
+ * 'Exported' parent-class functions.
+ *
+ */
+
+xrt_result_t
+comp_swapchain_create_init(struct comp_swapchain *sc,
+                           comp_swapchain_destroy_func_t destroy_func,
+                           struct vk_bundle *vk,
+                           struct comp_swapchain_shared *cscs,
+                           const struct xrt_swapchain_create_info *info,
+                           const struct xrt_swapchain_create_properties *xsccp)
+{
+	// Not created for any client, never pooled.
+	return do_create_init(sc, destroy_func, vk, cscs, 0, info, xsccp);
+}
+
 xrt_result_t
 comp_swapchain_import_init(struct comp_swapchain *sc,
                            comp_swapchain_destroy_func_t destroy_func,
@@ -368,7 +617,7 @@ comp_swapchain_import_init(struct comp_swapchain *sc,
 		return XRT_ERROR_VULKAN;
 	}
 
-	do_post_create_vulkan_setup(vk, info, sc);
+	do_post_create_vulkan_setup(vk, info, sc, false);
 
 	return XRT_SUCCESS;
 }
@@ -388,7 +637,11 @@ comp_swapchain_teardown(struct comp_swapchain *sc)
 		u_graphics_buffer_unref(&sc->base.images[i].handle);
 	}
 
-	vk_ic_destroy(vk, &sc->vkic);
+	if (sc->client_id != 0) {
+		pool_give(sc->cscs, vk, sc->client_id, &sc->vkic);
+	} else {
+		vk_ic_destroy(vk, &sc->vkic);
+	}
 }
 
 
@@ -407,15 +660,69 @@ comp_swapchain_shared_init(struct comp_swapchain_shared *cscs, struct vk_bundle
 		return XRT_ERROR_VULKAN;
 	}
 
+	int iret = os_mutex_init(&cscs->image_pool.mutex);
+	if (iret != 0) {
+		vk_cmd_pool_destroy(vk, &cscs->pool);
+		return XRT_ERROR_THREADING_INIT_FAILURE;
+	}
+
+	cscs->image_pool.budget_bytes = (uint64_t)debug_get_num_option_pool_budget_mb() * 1024 * 1024;
+
+	u_var_add_root(cscs, "Swapchain image pool", true);
+	u_var_add_ro_u64(cscs, &cscs->image_pool.budget_bytes, "Budget (bytes)");
+	u_var_add_ro_u64(cscs, &cscs->image_pool.resident_bytes, "Resident (bytes)");
+	u_var_add_ro_u32(cscs, &cscs->image_pool.entry_count, "Entries");
+	u_var_add_ro_u64(cscs, &cscs->image_pool.hit_count, "Hits");
+	u_var_add_ro_u64(cscs, &cscs->image_pool.miss_count, "Misses");
+	u_var_add_ro_f32(cscs, &cscs->image_pool.hit_rate, "Hit rate");
+
 	return XRT_SUCCESS;
 }
 
 void
 comp_swapchain_shared_destroy(struct comp_swapchain_shared *cscs, struct vk_bundle *vk)
 {
+	u_var_remove_root(cscs);
+
+	for (uint32_t i = 0; i < cscs->image_pool.entry_count; i++) {
+		vk_ic_destroy(vk, cscs->image_pool.entries[i].vkic);
+		free(cscs->image_pool.entries[i].vkic);
+		U_ZERO(&cscs->image_pool.entries[i]);
+	}
+	cscs->image_pool.entry_count = 0;
+	cscs->image_pool.resident_bytes = 0;
+
+	os_mutex_destroy(&cscs->image_pool.mutex);
+
 	vk_cmd_pool_destroy(vk, &cscs->pool);
 }
 
+void
+comp_swapchain_shared_release_client(struct comp_swapchain_shared *cscs, struct vk_bundle *vk, uint64_t client_id)
+{
+	struct vk_image_collection *evicted[COMP_SWAPCHAIN_POOL_MAX_ENTRIES];
+	uint32_t evicted_count = 0;
+
+	os_mutex_lock(&cscs->image_pool.mutex);
+
+	for (uint32_t i = cscs->image_pool.entry_count; i-- > 0;) {
+		if (cscs->image_pool.entries[i].client_id == client_id) {
+			evicted[evicted_count++] = pool_remove_locked(cscs, i);
+		}
+	}
+
+	// Its swapchains might still be waiting to be garbage collected.
+	uint32_t index = cscs->image_pool.released_next++ % ARRAY_SIZE(cscs->image_pool.released_clients);
+	cscs->image_pool.released_clients[index] = client_id;
+
+	os_mutex_unlock(&cscs->image_pool.mutex);
+
+	for (uint32_t i = 0; i < evicted_count; i++) {
+		vk_ic_destroy(vk, evicted[i]);
+		free(evicted[i]);
+	}
+}
+
 void
 comp_swapchain_shared_garbage_collect(struct comp_swapchain_shared *cscs)
 {
@@ -456,17 +763,30 @@ comp_swapchain_create(struct vk_bundle *vk,
                       const struct xrt_swapchain_create_info *info,
                       const struct xrt_swapchain_create_properties *xsccp,
                       struct xrt_swapchain **out_xsc)
+{
+	// Not created for any client, never pooled.
+	return comp_swapchain_create_for_client(vk, cscs, 0, info, xsccp, out_xsc);
+}
+
+xrt_result_t
+comp_swapchain_create_for_client(struct vk_bundle *vk,
+                                 struct comp_swapchain_shared *cscs,
+                                 uint64_t client_id,
+                                 const struct xrt_swapchain_create_info *info,
+                                 const struct xrt_swapchain_create_properties *xsccp,
+                                 struct xrt_swapchain **out_xsc)
 {
 	struct comp_swapchain *sc = U_TYPED_CALLOC(struct comp_swapchain);
 	xrt_result_t xret;
 
-	xret = comp_swapchain_create_init( //
-	    sc,                            //
-	    really_destroy,                //
-	    vk,                            //
-	    cscs,                          //
-	    info,                          //
-	    xsccp);                        //
+	xret = do_create_init( //
+	    sc,                //
+	    really_destroy,    //
+	    vk,                //
+	    cscs,              //
+	    client_id,         //
+	    info,              //
+	    xsccp);            //
 	if (xret != XRT_SUCCESS) {
 		free(sc);
 		return xret;
@@ -24,6 +24,13 @@ extern "C" {
 
 struct comp_swapchain;
 
+/*!
+ * Max number of image collections kept in the pool of freed swapchain images.
+ *
+ * @ingroup comp_util
+ */
+#define COMP_SWAPCHAIN_POOL_MAX_ENTRIES (16)
+
 /*!
  * Callback for implementing own destroy function, should call
  * @ref comp_swapchain_teardown and is responsible for memory.
@@ -46,6 +53,43 @@ struct comp_swapchain_shared
 	struct u_threading_stack destroy_swapchains;
 
 	struct vk_cmd_pool pool;
+
+	/*!
+	 * Images from destroyed swapchains, kept around so that a later create
+	 * call from the same client with the same create info and image count
+	 * can reuse them instead of allocating new ones. Images are only ever
+	 * handed back to the client they were created for, and are cleared
+	 * before being reused. Ordered oldest first, the oldest entries are
+	 * evicted when the memory budget is exceeded. Protected by the mutex.
+	 */
+	struct
+	{
+		struct os_mutex mutex;
+
+		struct
+		{
+			uint64_t client_id;
+			struct vk_image_collection *vkic;
+		} entries[COMP_SWAPCHAIN_POOL_MAX_ENTRIES];
+		uint32_t entry_count;
+
+		/*!
+		 * Recently released clients, swapchains can be destroyed after
+		 * their client is released and their images must not be kept.
+		 */
+		uint64_t released_clients[COMP_SWAPCHAIN_POOL_MAX_ENTRIES];
+		uint32_t released_next;
+
+		//! Max amount of memory held by the pool, zero disables the pool.
+		uint64_t budget_bytes;
+
+		//! Amount of memory currently held by the pool.
+		uint64_t resident_bytes;
+
+		uint64_t hit_count;
+		uint64_t miss_count;
+		float hit_rate;
+	} image_pool;
 };
 
 /*!
@@ -97,6 +141,12 @@ struct comp_swapchain
 
 	//! Virtual real destroy function.
 	comp_swapchain_destroy_func_t real_destroy;
+
+	/*!
+	 * The client the images are kept for in the pool when this swapchain
+	 * is destroyed, zero if they are not to be pooled.
+	 */
+	uint64_t client_id;
 };
 
 
@@ -180,13 +230,22 @@ XRT_CHECK_RESULT xrt_result_t
 comp_swapchain_shared_init(struct comp_swapchain_shared *cscs, struct vk_bundle *vk);
 
 /*!
- * Destroy the shared struct.
+ * Destroy the shared struct, also frees any images held by the pool.
  *
  * @ingroup comp_util
  */
 void
 comp_swapchain_shared_destroy(struct comp_swapchain_shared *cscs, struct vk_bundle *vk);
 
+/*!
+ * Free any pooled images kept for the given client, also makes sure that the
+ * images of its swapchains that are destroyed later are not kept.
+ *
+ * @ingroup comp_util
+ */
+void
+comp_swapchain_shared_release_client(struct comp_swapchain_shared *cscs, struct vk_bundle *vk, uint64_t client_id);
+
 /*!
  * Do garbage collection, destroying any resources that has been scheduled for
  * destruction from other threads.
@@ -224,6 +283,21 @@ comp_swapchain_create(struct vk_bundle *vk,
                       const struct xrt_swapchain_create_properties *xsccp,
                       struct xrt_swapchain **out_xsc);
 
+/*!
+ * A compositor function that is implemented in the swapchain code, like
+ * @ref comp_swapchain_create but lets the images be reused by later
+ * swapchains of the same client.
+ *
+ * @ingroup comp_util
+ */
+xrt_result_t
+comp_swapchain_create_for_client(struct vk_bundle *vk,
+                                 struct comp_swapchain_shared *cscs,
+                                 uint64_t client_id,
+                                 const struct xrt_swapchain_create_info *info,
+                                 const struct xrt_swapchain_create_properties *xsccp,
+                                 struct xrt_swapchain **out_xsc);
+
 /*!
  * A compositor function that is implemented in the swapchain code.
  *
@@ -205,6 +205,18 @@ android_device_compute_distortion(
 	return u_compute_distortion_cardboard(&d->cardboard.values[view], u, v, result);
 }
 
+static bool
+android_device_compute_distortion_batch(struct xrt_device *xdev,
+                                        uint32_t view,
+                                        uint32_t count,
+                                        const float *u,
+                                        const float *v,
+                                        struct xrt_uv_triplet *results)
+{
+	struct android_device *d = android_device(xdev);
+	return u_compute_distortion_cardboard_batch(&d->cardboard.values[view], count, u, v, results);
+}
+
 
 struct android_device *
 android_device_create()
@@ -219,6 +231,7 @@ android_device_create()
 	d->base.get_tracked_pose = android_device_get_tracked_pose;
 	d->base.get_view_poses = android_device_get_view_poses;
 	d->base.compute_distortion = android_device_compute_distortion;
+	d->base.compute_distortion_batch = android_device_compute_distortion_batch;
 	d->base.inputs[0].name = XRT_INPUT_GENERIC_HEAD_POSE;
 	d->base.device_type = XRT_DEVICE_TYPE_HMD;
 	snprintf(d->base.str, XRT_DEVICE_NAME_LEN, "Android Sensors");
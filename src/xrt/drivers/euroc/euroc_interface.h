@@ -12,6 +12,8 @@
 #include "util/u_logging.h"
 #include "xrt/xrt_frameserver.h"
 
+struct t_slam_metrics;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -47,6 +49,9 @@ struct euroc_player_playback_config
 	bool use_source_ts;       //!< If true, use the original timestamps from the dataset
 	bool play_from_start;     //!< If set, the euroc player does not wait for user input to start
 	bool print_progress;      //!< Whether to print progress to stdout (useful for CLI runs)
+	int prefetch_frames;      //!< Frames to decode ahead of playback, 0 decodes on the streaming thread
+	int prefetch_threads;     //!< Number of decoding threads, 0 picks one based on the core count
+	int prefetch_max_mb;      //!< Cap in MiB for decoded frames waiting to be pushed
 };
 
 /*!
@@ -57,6 +62,7 @@ struct euroc_player_playback_config
 struct euroc_player_dataset_info
 {
 	char path[256];
+	bool is_packed; //!< Whether `path` is a packed dataset file, see @ref aux_packed_dataset
 	int cam_count;
 	bool is_colored;
 	bool has_gt; //!< Whether this dataset has groundtruth data available
@@ -108,6 +114,8 @@ euroc_create_auto_prober(void);
  * @param euroc_path Dataset path
  * @param slam_config Path to config file for the SLAM system
  * @param output_path Path to write resulting tracking data to
+ * @param print_progress Whether to print playback progress, unless EUROC_PRINT_PROGRESS is set
+ * @param out_metrics If not NULL, filled with the accuracy and latency of the run
  *
  * @ingroup drv_euroc
  */
@@ -115,8 +123,53 @@ void
 euroc_run_dataset(const char *euroc_path,
                   const char *slam_config,
                   const char *output_path,
+                  bool print_progress,
+                  struct t_slam_metrics *out_metrics,
                   const volatile bool *should_exit);
 
+/*!
+ * Statistics from converting a dataset with @ref euroc_dataset_pack.
+ *
+ * @ingroup drv_euroc
+ */
+struct euroc_pack_stats
+{
+	uint64_t frame_count;  //!< Number of frames converted
+	uint64_t png_bytes;    //!< Size of all source image files
+	uint64_t packed_bytes; //!< Size of the packed dataset file
+	double png_read_s;     //!< Time spent reading and decoding the source images
+	double png_write_s;    //!< Time spent encoding the images as PNG again, zero if not measured
+	double packed_write_s; //!< Time spent writing the frames to the packed dataset
+	double packed_read_s;  //!< Time spent reading back and decoding all frames of the packed dataset
+};
+
+/*!
+ * Convert the EuRoC dataset at @p euroc_path into a single packed dataset file,
+ * see @ref aux_packed_dataset. Samples are written in timestamp order.
+ *
+ * @param euroc_path  Dataset directory
+ * @param packed_path File to write
+ * @param lz4         Whether to compress frames
+ * @param measure_png Also time encoding every frame as PNG, for comparisons
+ * @param out_stats   Optional, filled with timings and sizes
+ *
+ * @ingroup drv_euroc
+ */
+bool
+euroc_dataset_pack(const char *euroc_path,
+                   const char *packed_path,
+                   bool lz4,
+                   bool measure_png,
+                   struct euroc_pack_stats *out_stats);
+
+/*!
+ * Convert a packed dataset back into a EuRoC dataset directory with PNG images.
+ *
+ * @ingroup drv_euroc
+ */
+bool
+euroc_dataset_unpack(const char *packed_path, const char *euroc_path);
+
 /*!
  * @dir drivers/euroc
  *
@@ -16,8 +16,9 @@
 #include "util/u_time.h"
 #include "util/u_var.h"
 #include "util/u_sink.h"
+#include "util/u_packed_dataset.h"
 #include "tracking/t_frame_cv_mat_wrapper.hpp"
-#include "math/m_api.h"
+#include "tracking/t_euroc_recorder.h"
 #include "math/m_filter_fifo.h"
 
 #include "euroc_driver.h"
@@ -25,11 +26,16 @@
 
 #include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
+#include <filesystem>
 #include <stdint.h>
 #include <stdio.h>
 #include <fstream>
 #include <future>
+#include <iomanip>
+#include <mutex>
 #include <thread>
 #include <inttypes.h>
 
@@ -48,6 +54,9 @@ DEBUG_GET_ONCE_BOOL_OPTION(send_all_imus_first, "EUROC_SEND_ALL_IMUS_FIRST", fal
 DEBUG_GET_ONCE_BOOL_OPTION(use_source_ts, "EUROC_USE_SOURCE_TS", false)
 DEBUG_GET_ONCE_BOOL_OPTION(play_from_start, "EUROC_PLAY_FROM_START", false)
 DEBUG_GET_ONCE_BOOL_OPTION(print_progress, "EUROC_PRINT_PROGRESS", false)
+DEBUG_GET_ONCE_NUM_OPTION(prefetch_frames, "EUROC_PREFETCH_FRAMES", 16)
+DEBUG_GET_ONCE_NUM_OPTION(prefetch_threads, "EUROC_PREFETCH_THREADS", 0)
+DEBUG_GET_ONCE_NUM_OPTION(prefetch_max_mb, "EUROC_PREFETCH_MAX_MB", 256)
 
 #define EUROC_PLAYER_STR "Euroc Player"
 
@@ -55,15 +64,21 @@ DEBUG_GET_ONCE_BOOL_OPTION(print_progress, "EUROC_PRINT_PROGRESS", false)
 #define EUROC_MAX_CAMS XRT_TRACKING_MAX_SLAM_CAMS
 
 using std::async;
+using std::condition_variable;
+using std::deque;
 using std::find_if;
 using std::ifstream;
 using std::is_same_v;
 using std::launch;
 using std::max_element;
+using std::ofstream;
+using std::mutex;
 using std::pair;
 using std::stof;
 using std::string;
+using std::thread;
 using std::to_string;
+using std::unique_lock;
 using std::vector;
 
 using img_sample = pair<timepoint_ns, string>;
@@ -71,6 +86,44 @@ using img_sample = pair<timepoint_ns, string>;
 using imu_samples = vector<xrt_imu_sample>;
 using img_samples = vector<img_sample>;
 using gt_trajectory = vector<xrt_pose_sample>;
+using pd_records = vector<u_pd_record>;
+
+/*!
+ * Decodes the images of upcoming frames for all cameras on a pool of worker
+ * threads, the image streaming thread then takes them strictly in sequence
+ * order. Read-ahead is bounded by both a frame count and a byte budget.
+ */
+struct euroc_prefetcher
+{
+	//! A frame being decoded or waiting to be pushed, images for all cameras.
+	struct frame
+	{
+		cv::Mat imgs[EUROC_MAX_CAMS];
+		int pending; //!< Cameras not yet decoded
+	};
+
+	mutex mtx;
+	condition_variable ready_cv; //!< A frame finished decoding
+	condition_variable space_cv; //!< A frame was taken or we are stopping
+	vector<thread> workers;
+
+	deque<frame> window; //!< Frames from `take_seq` onwards
+	uint64_t take_seq;   //!< Next frame the streaming thread takes
+	uint64_t claim_seq;  //!< Next frame to hand out to a worker
+	int claim_cam;       //!< Next camera of `claim_seq` to hand out
+	uint64_t end_seq;    //!< One past the last frame to decode
+	int cam_count;       //!< Cameras decoded per frame
+	size_t max_frames;   //!< Read-ahead depth, from the frame and byte limits
+	bool stop;           //!< Set to make the workers exit early
+
+	// Stats, protected by `mtx`
+	size_t bytes;              //!< Bytes of decoded images in `window`
+	uint64_t decoded_count;    //!< Total images decoded
+	uint64_t decoded_bytes;    //!< Total bytes of images decoded
+	uint64_t stall_count;      //!< Times the streaming thread had to wait for a frame
+	time_duration_ns stall_ns; //!< Total time the streaming thread spent waiting
+	timepoint_ns start_ts;     //!< When the workers started
+};
 
 enum euroc_player_ui_state
 {
@@ -101,6 +154,8 @@ struct euroc_player
 	enum u_logging_level log_level;               //!< Log messages with this priority and onwards
 	struct euroc_player_dataset_info dataset;     //!< Contains information about the source dataset
 	struct euroc_player_playback_config playback; //!< Playback information. Prefer to fill it before stream start
+	bool decode_color;                            //!< Snapshot of `playback.color` taken at stream start
+	float decode_scale;                           //!< Clamped snapshot of `playback.scale` taken at stream start
 	struct xrt_fs_mode mode;                      //!< The only fs mode the euroc dataset provides
 	bool is_running;                              //!< Set only at start, stop and end of frameserver stream
 	timepoint_ns last_pause_ts;                   //!< Last time the stream was paused
@@ -109,11 +164,16 @@ struct euroc_player
 	//! Next frame number to use, index in `imgs[i]`.
 	//! Note that this expects that both cameras provide the same amount of frames.
 	//! Furthermore, it is also expected that their timestamps match.
-	uint64_t img_seq;          //!< Next frame number to use, index in `imgs[i]`
-	uint64_t imu_seq;          //!< Next imu sample number to use, index in `imus`
-	imu_samples *imus;         //!< List of all IMU samples read from the dataset
-	vector<img_samples> *imgs; //!< List of all image names to read from the dataset per camera
-	gt_trajectory *gt;         //!< List of all groundtruth poses read from the dataset
+	uint64_t img_seq;             //!< Next frame number to use, index in `imgs[i]`
+	uint64_t imu_seq;             //!< Next imu sample number to use, index in `imus`
+	imu_samples *imus;            //!< List of all IMU samples read from the dataset
+	vector<img_samples> *imgs;    //!< List of all image names to read from the dataset per camera
+	gt_trajectory *gt;            //!< List of all groundtruth poses read from the dataset
+	euroc_prefetcher *prefetcher; //!< Decodes frames ahead of time, null if disabled
+
+	// Packed dataset fields, only used if `dataset.is_packed`
+	struct u_pd_reader packed;         //!< Reader of the mapped dataset file
+	vector<pd_records> *packed_frames; //!< Frame records per camera, matches `imgs`
 
 	// Timestamp correction fields (can be disabled through `use_source_ts`)
 	timepoint_ns base_ts;   //!< First sample timestamp, stream timestamps are relative to this
@@ -296,17 +356,70 @@ euroc_player_match_cams_seqs(struct euroc_player *ep)
 	auto is_first = [first_ts](const img_sample &s) { return s.first == first_ts; };
 	auto is_last = [last_ts](const img_sample &s) { return s.first == last_ts; };
 
-	for (img_samples &imgs : *ep->imgs) {
+	for (size_t i = 0; i < ep->imgs->size(); i++) {
+		img_samples &imgs = ep->imgs->at(i);
 		img_samples::iterator new_first = find_if(imgs.begin(), imgs.end(), is_first);
 		img_samples::iterator new_last = find_if(imgs.begin(), imgs.end(), is_last);
 		EUROC_ASSERT_(new_first != imgs.end() && new_last != imgs.end());
+
+		// Keep the frame records lined up with the samples
+		if (ep->dataset.is_packed) {
+			pd_records &frames = ep->packed_frames->at(i);
+			pd_records::iterator begin = frames.begin();
+			frames.assign(begin + (new_first - imgs.begin()), begin + (new_last - imgs.begin()) + 1);
+		}
+
 		imgs.assign(new_first, new_last + 1);
 	}
 }
 
+//! Read all samples from a packed dataset, frames are kept as records pointing into the mapped file.
+static void
+euroc_player_preload_packed(struct euroc_player *ep)
+{
+	ep->imus->clear();
+	ep->gt->clear();
+	for (size_t i = 0; i < ep->imgs->size(); i++) {
+		ep->imgs->at(i).clear();
+		ep->packed_frames->at(i).clear();
+	}
+
+	if (ep->packed.data == nullptr) {
+		int ret = u_pd_reader_open(&ep->packed, ep->dataset.path);
+		EUROC_ASSERT(ret == 0, "Unable to open packed dataset %s", ep->dataset.path);
+	}
+	u_pd_reader_seek(&ep->packed, INT64_MIN);
+
+	u_pd_record rec;
+	while (u_pd_reader_next(&ep->packed, &rec)) {
+		if (rec.type == U_PD_RECORD_IMU) {
+			ep->imus->push_back(rec.imu);
+		} else if (rec.type == U_PD_RECORD_GT) {
+			ep->gt->push_back(rec.gt);
+		} else if (rec.type == U_PD_RECORD_FRAME && rec.frame.header->cam_index < ep->imgs->size()) {
+			uint32_t cam_index = rec.frame.header->cam_index;
+			ep->imgs->at(cam_index).push_back({rec.timestamp_ns, string{}});
+			ep->packed_frames->at(cam_index).push_back(rec);
+		}
+	}
+
+	// Samples are written as they arrive, so they might be slightly out of order
+	auto imu_cmp = [](const xrt_imu_sample &a, const xrt_imu_sample &b) { return a.timestamp_ns < b.timestamp_ns; };
+	auto gt_cmp = [](const xrt_pose_sample &a, const xrt_pose_sample &b) { return a.timestamp_ns < b.timestamp_ns; };
+	std::stable_sort(ep->imus->begin(), ep->imus->end(), imu_cmp);
+	std::stable_sort(ep->gt->begin(), ep->gt->end(), gt_cmp);
+
+	euroc_player_match_cams_seqs(ep);
+}
+
 static void
 euroc_player_preload(struct euroc_player *ep)
 {
+	if (ep->dataset.is_packed) {
+		euroc_player_preload_packed(ep);
+		return;
+	}
+
 	ep->imus->clear();
 	euroc_player_preload_imu_data(ep->dataset.path, ep->imus);
 
@@ -352,12 +465,56 @@ euroc_player_user_skip(struct euroc_player *ep)
 	ep->offset_ts -= skip_first_ns / ep->playback.speed;
 }
 
+//! Same as @ref euroc_player_fill_dataset_info but for packed datasets
+static void
+euroc_player_fill_packed_dataset_info(const char *path, euroc_player_dataset_info *dataset)
+{
+	u_pd_reader pdr;
+	int ret = u_pd_reader_open(&pdr, path);
+	EUROC_ASSERT(ret == 0, "Invalid packed dataset %s", path);
+
+	// Find the first frame and whether there is any groundtruth.
+	const u_pd_frame_header *first_frame = nullptr;
+	bool has_imu = false;
+	bool has_gt = false;
+	u_pd_record rec;
+	while ((first_frame == nullptr || !has_imu || !has_gt) && u_pd_reader_next(&pdr, &rec)) {
+		has_imu |= rec.type == U_PD_RECORD_IMU;
+		has_gt |= rec.type == U_PD_RECORD_GT;
+		if (first_frame == nullptr && rec.type == U_PD_RECORD_FRAME) {
+			first_frame = rec.frame.header;
+		}
+	}
+
+	uint32_t cam_count = pdr.header.cam_count;
+	EUROC_ASSERT(cam_count <= EUROC_MAX_CAMS, "Increase EUROC_MAX_CAMS (dataset with %u cams)", cam_count);
+	bool is_valid_dataset = cam_count > 0 && first_frame != nullptr && has_imu;
+	EUROC_ASSERT(is_valid_dataset, "Invalid dataset %s", path);
+
+	dataset->is_packed = true;
+	dataset->cam_count = (int)cam_count;
+	dataset->is_colored = first_frame->format == XRT_FORMAT_R8G8B8;
+	dataset->has_gt = has_gt;
+	dataset->gt_device_name = "packed";
+	dataset->width = first_frame->width;
+	dataset->height = first_frame->height;
+
+	u_pd_reader_close(&pdr);
+}
+
 //! Determine and fill attributes of the dataset pointed by `path`
 //! Assertion fails if `path` does not point to an euroc dataset
 static void
 euroc_player_fill_dataset_info(const char *path, euroc_player_dataset_info *dataset)
 {
 	(void)snprintf(dataset->path, sizeof(dataset->path), "%s", path);
+
+	// A single file instead of a directory is a packed dataset
+	if (std::filesystem::is_regular_file(path)) {
+		euroc_player_fill_packed_dataset_info(path, dataset);
+		return;
+	}
+
 	img_samples samples;
 	imu_samples _1;
 	gt_trajectory _2;
@@ -422,23 +579,96 @@ euroc_player_mapped_playback_ts(struct euroc_player *ep, timepoint_ns ts)
 	return euroc_player_mapped_ts(ep, ts);
 }
 
-static void
-euroc_player_load_next_frame(struct euroc_player *ep, int cam_index, struct xrt_frame *&xf)
+/*!
+ * Get the pixels of a packed frame record, raw frames point into the reader's
+ * data and are not copied. Returns false if the record is corrupt.
+ */
+static bool
+euroc_packed_frame_to_mat(const u_pd_record &rec, cv::Mat &out_img)
 {
-	using xrt::auxiliary::tracking::FrameMat;
-	img_sample sample = ep->imgs->at(cam_index).at(ep->img_seq);
-	ep->playback.scale = CLAMP(ep->playback.scale, 1.0 / 16, 4);
+	const u_pd_frame_header *fh = rec.frame.header;
+	if (fh->format != XRT_FORMAT_R8G8B8 && fh->format != XRT_FORMAT_L8) {
+		return false;
+	}
 
-	// Load will be influenced by these playback options
-	bool allow_color = ep->playback.color;
-	float scale = ep->playback.scale;
+	int type = fh->format == XRT_FORMAT_R8G8B8 ? CV_8UC3 : CV_8UC1;
+	size_t row_size = (size_t)fh->width * CV_ELEM_SIZE(type);
+	if (fh->stride < row_size) {
+		return false;
+	}
 
-	// Load image from disk
-	timepoint_ns timestamp = euroc_player_mapped_playback_ts(ep, sample.first);
-	string img_name = sample.second;
-	EUROC_TRACE(ep, "cam%d img t = %ld filename = %s", cam_index, timestamp, img_name.c_str());
+	if (fh->codec == U_PD_CODEC_RAW) {
+		// The reader checked that data_size bytes are in the file, they must cover all rows.
+		if (fh->data_size < u_pd_frame_size(&rec)) {
+			return false;
+		}
+		out_img = cv::Mat{(int)fh->height, (int)fh->width, type, (void *)rec.frame.data, fh->stride};
+		return true;
+	}
+
+	// Decoded rows keep the stored stride.
+	cv::Mat rows{(int)fh->height, (int)fh->stride, CV_8UC1};
+	if (u_pd_frame_decode(&rec, rows.data, rows.total()) != 0) {
+		return false;
+	}
+
+	if (fh->stride == row_size) {
+		out_img = rows.reshape(CV_MAT_CN(type));
+	} else {
+		out_img = cv::Mat{(int)fh->height, (int)fh->width, type, rows.data, fh->stride}.clone();
+	}
+	return true;
+}
+
+//! Get image `seq` of camera `cam_index` from the packed dataset, raw frames are not copied.
+static cv::Mat
+euroc_player_read_packed_img(struct euroc_player *ep, int cam_index, uint64_t seq, bool allow_color)
+{
+	const u_pd_record &rec = ep->packed_frames->at(cam_index).at(seq);
+	EUROC_TRACE(ep, "cam%d img seq = %" PRIu64 " packed codec = %u", cam_index, seq, rec.frame.header->codec);
+
+	// Raw frames point into the read-only mapping, which lives until the player is destroyed.
+	cv::Mat img;
+	bool ok = euroc_packed_frame_to_mat(rec, img);
+	EUROC_ASSERT(ok, "Corrupt frame %" PRIu64 " for cam%d in packed dataset", seq, cam_index);
+
+	// Packed frames are stored in RGB order.
+	if (!allow_color && img.channels() == 3) {
+		cv::Mat tmp;
+		cv::cvtColor(img, tmp, cv::COLOR_RGB2GRAY);
+		img = tmp;
+	}
+
+	return img;
+}
+
+//! Read image `seq` of camera `cam_index` from disk, can be called from any thread.
+static cv::Mat
+euroc_player_read_img(struct euroc_player *ep, int cam_index, uint64_t seq)
+{
+	// Load will be influenced by these playback options, fixed at stream start
+	bool allow_color = ep->decode_color;
+	float scale = ep->decode_scale;
+
+	if (ep->dataset.is_packed) {
+		cv::Mat img = euroc_player_read_packed_img(ep, cam_index, seq, allow_color);
+		if (scale != 1.0) {
+			cv::Mat tmp;
+			cv::resize(img, tmp, cv::Size(), scale, scale);
+			img = tmp;
+		}
+		return img;
+	}
+
+	const string &img_name = ep->imgs->at(cam_index).at(seq).second;
+	EUROC_TRACE(ep, "cam%d img seq = %" PRIu64 " filename = %s", cam_index, seq, img_name.c_str());
 	cv::ImreadModes read_mode = allow_color ? cv::IMREAD_ANYCOLOR : cv::IMREAD_GRAYSCALE;
-	cv::Mat img = cv::imread(img_name, read_mode); // If colored, reads in BGR order
+	cv::Mat img = cv::imread(img_name, read_mode);
+
+	// Colored images are read in BGR order but pushed as R8G8B8.
+	if (img.channels() == 3) {
+		cv::cvtColor(img, img, cv::COLOR_BGR2RGB);
+	}
 
 	if (scale != 1.0) {
 		cv::Mat tmp;
@@ -446,6 +676,176 @@ euroc_player_load_next_frame(struct euroc_player *ep, int cam_index, struct xrt_
 		img = tmp;
 	}
 
+	return img;
+}
+
+
+// Prefetching functionality
+
+static void
+euroc_prefetcher_run(struct euroc_player *ep, euroc_prefetcher *pf)
+{
+	unique_lock<mutex> lock(pf->mtx);
+
+	while (true) {
+		// Wait for room in the read-ahead window.
+		while (!pf->stop && pf->claim_seq < pf->end_seq && pf->claim_cam == 0 &&
+		       pf->claim_seq - pf->take_seq >= pf->max_frames) {
+			pf->space_cv.wait(lock);
+		}
+
+		if (pf->stop || pf->claim_seq >= pf->end_seq) {
+			return;
+		}
+
+		// Claim the next image, frames are claimed in order.
+		uint64_t seq = pf->claim_seq;
+		int cam_index = pf->claim_cam;
+		if (cam_index == 0) {
+			euroc_prefetcher::frame f = {};
+			f.pending = pf->cam_count;
+			pf->window.push_back(f);
+		}
+		if (++pf->claim_cam == pf->cam_count) {
+			pf->claim_cam = 0;
+			pf->claim_seq++;
+		}
+
+		lock.unlock();
+		cv::Mat img = euroc_player_read_img(ep, cam_index, seq);
+		size_t img_bytes = img.total() * img.elemSize();
+		lock.lock();
+
+		// The frame can't have been taken as it still has a pending camera.
+		euroc_prefetcher::frame &f = pf->window.at(seq - pf->take_seq);
+		f.imgs[cam_index] = img;
+		f.pending--;
+		pf->bytes += img_bytes;
+		pf->decoded_count++;
+		pf->decoded_bytes += img_bytes;
+
+		if (f.pending == 0) {
+			pf->ready_cv.notify_all();
+		}
+	}
+}
+
+//! Start decoding frames from the current `img_seq` onwards, if enabled.
+static void
+euroc_prefetcher_start(struct euroc_player *ep)
+{
+	int cam_count = ep->playback.cam_count;
+	if (ep->playback.prefetch_frames <= 0 || cam_count <= 0) {
+		return;
+	}
+
+	// Estimate the frame size from the dataset, all images are the same size.
+	bool is_colored = ep->dataset.is_colored && ep->decode_color;
+	double scale = ep->decode_scale;
+	double img_bytes = ep->dataset.width * scale * ep->dataset.height * scale * (is_colored ? 3 : 1);
+	double frame_bytes = MAX(img_bytes * cam_count, 1.0);
+	double max_bytes = MAX(ep->playback.prefetch_max_mb, 1) * 1024.0 * 1024.0;
+	size_t frames_in_budget = MAX((size_t)(max_bytes / frame_bytes), (size_t)1);
+
+	int thread_count = ep->playback.prefetch_threads;
+	if (thread_count <= 0) {
+		thread_count = (int)CLAMP(thread::hardware_concurrency() / 2, 1u, 8u);
+	}
+
+	euroc_prefetcher *pf = new euroc_prefetcher{};
+	pf->take_seq = ep->img_seq;
+	pf->claim_seq = ep->img_seq;
+	pf->end_seq = ep->imgs->at(0).size();
+	pf->cam_count = cam_count;
+	pf->max_frames = MIN((size_t)ep->playback.prefetch_frames, frames_in_budget);
+	pf->start_ts = os_monotonic_get_ts();
+
+	EUROC_INFO(ep, "Prefetching %zu frames (%.1f MiB) with %d threads", pf->max_frames,
+	           pf->max_frames * frame_bytes / (1024.0 * 1024.0), thread_count);
+
+	for (int i = 0; i < thread_count; i++) {
+		pf->workers.emplace_back(euroc_prefetcher_run, ep, pf);
+	}
+
+	ep->prefetcher = pf;
+}
+
+//! Take the decoded images of frame `seq`, waits for them if needed.
+static void
+euroc_prefetcher_take(struct euroc_player *ep, uint64_t seq, cv::Mat imgs[EUROC_MAX_CAMS])
+{
+	euroc_prefetcher *pf = ep->prefetcher;
+	unique_lock<mutex> lock(pf->mtx);
+
+	EUROC_ASSERT(seq == pf->take_seq, "Frames must be taken in order (%" PRIu64 " != %" PRIu64 ")", seq,
+	             pf->take_seq);
+
+	if (pf->window.empty() || pf->window.front().pending > 0) {
+		timepoint_ns stall_start_ts = os_monotonic_get_ts();
+		while (pf->window.empty() || pf->window.front().pending > 0) {
+			pf->ready_cv.wait(lock);
+		}
+		pf->stall_count++;
+		pf->stall_ns += os_monotonic_get_ts() - stall_start_ts;
+	}
+
+	euroc_prefetcher::frame &f = pf->window.front();
+	for (int i = 0; i < pf->cam_count; i++) {
+		pf->bytes -= f.imgs[i].total() * f.imgs[i].elemSize();
+		imgs[i] = f.imgs[i];
+	}
+	pf->window.pop_front();
+	pf->take_seq++;
+
+	pf->space_cv.notify_all();
+}
+
+//! Stop and join the workers, and report how decoding kept up with playback.
+static void
+euroc_prefetcher_destroy(struct euroc_player *ep)
+{
+	euroc_prefetcher *pf = ep->prefetcher;
+	if (pf == nullptr) {
+		return;
+	}
+
+	{
+		unique_lock<mutex> lock(pf->mtx);
+		pf->stop = true;
+		pf->space_cv.notify_all();
+	}
+
+	for (thread &t : pf->workers) {
+		t.join();
+	}
+
+	double elapsed_s = (os_monotonic_get_ts() - pf->start_ts) / (double)U_TIME_1S_IN_NS;
+	double stall_ms = pf->stall_ns / (double)U_TIME_1MS_IN_NS;
+	double mib = pf->decoded_bytes / (1024.0 * 1024.0);
+	EUROC_INFO(ep, "Prefetch: decoded %" PRIu64 " images (%.1f MiB) in %.2fs, %.1f img/s, %.1f MiB/s",
+	           pf->decoded_count, mib, elapsed_s, pf->decoded_count / elapsed_s, mib / elapsed_s);
+	EUROC_INFO(ep, "Prefetch: playback stalled %" PRIu64 " times for a total of %.1fms", pf->stall_count,
+	           stall_ms);
+
+	if (ep->playback.print_progress) {
+		printf("\nDecoded %" PRIu64 " images at %.1f img/s, playback stalled %" PRIu64 " times (%.1fms)\n",
+		       pf->decoded_count, pf->decoded_count / elapsed_s, pf->stall_count, stall_ms);
+	}
+
+	delete pf;
+	ep->prefetcher = nullptr;
+}
+
+
+// Streaming functionality
+
+static void
+euroc_player_load_next_frame(struct euroc_player *ep, int cam_index, const cv::Mat &img, struct xrt_frame *&xf)
+{
+	using xrt::auxiliary::tracking::FrameMat;
+	img_sample sample = ep->imgs->at(cam_index).at(ep->img_seq);
+	timepoint_ns timestamp = euroc_player_mapped_playback_ts(ep, sample.first);
+
 	// Create xrt_frame, it will be freed by FrameMat destructor
 	EUROC_ASSERT(xf == NULL || xf->reference.count > 0, "Must be given a valid or NULL frame ptr");
 	EUROC_ASSERT(timestamp >= 0, "Unexpected negative timestamp");
@@ -467,9 +867,18 @@ euroc_player_push_next_frame(struct euroc_player *ep)
 {
 	int cam_count = ep->playback.cam_count;
 
+	cv::Mat imgs[EUROC_MAX_CAMS];
+	if (ep->prefetcher != nullptr) {
+		euroc_prefetcher_take(ep, ep->img_seq, imgs);
+	} else {
+		for (int i = 0; i < cam_count; i++) {
+			imgs[i] = euroc_player_read_img(ep, i, ep->img_seq);
+		}
+	}
+
 	vector<xrt_frame *> xfs(cam_count, nullptr);
 	for (int i = 0; i < cam_count; i++) {
-		euroc_player_load_next_frame(ep, i, xfs[i]);
+		euroc_player_load_next_frame(ep, i, imgs[i], xfs[i]);
 	}
 
 	// TODO: Some SLAM systems expect synced frames, but that's not an
@@ -480,8 +889,22 @@ euroc_player_push_next_frame(struct euroc_player *ep)
 
 	ep->img_seq++;
 
-	for (int i = 0; i < cam_count; i++) {
-		xrt_sink_push_frame(ep->in_sinks.cams[i], xfs[i]);
+	if (ep->out_sinks.bundle != nullptr) {
+		// Frames are synced, send them as a single capture
+		xrt_frame_bundle bundle{};
+		bundle.timestamp = xfs[0]->timestamp;
+		bundle.view_count = cam_count;
+		for (int i = 0; i < cam_count; i++) {
+			bundle.frames[i] = xfs[i];
+			bundle.rois[i] = {{0, 0}, {(int)xfs[i]->width, (int)xfs[i]->height}};
+			u_sink_debug_push_frame(&ep->ui_cam_sinks[i], xfs[i]);
+		}
+		EUROC_TRACE(ep, "bundle of %d imgs t=%ld", cam_count, bundle.timestamp);
+		xrt_sink_push_bundle(ep->out_sinks.bundle, &bundle);
+	} else {
+		for (int i = 0; i < cam_count; i++) {
+			xrt_sink_push_frame(ep->in_sinks.cams[i], xfs[i]);
+		}
 	}
 
 	for (int i = 0; i < cam_count; i++) {
@@ -610,6 +1033,11 @@ euroc_player_stream(void *ptr)
 	ep->start_ts = os_monotonic_get_ts();
 	euroc_player_user_skip(ep);
 
+	// Decoding options can't change once images start being decoded, the UI still edits `playback`
+	ep->decode_color = ep->playback.color;
+	ep->decode_scale = CLAMP(ep->playback.scale, 1.0 / 16, 4);
+	euroc_prefetcher_start(ep);
+
 	// Push all IMU samples now if requested
 	if (ep->playback.send_all_imus_first) {
 		while (ep->imu_seq < ep->imus->size()) {
@@ -632,6 +1060,8 @@ euroc_player_stream(void *ptr)
 	serve_imgs.get();
 	serve_imus.get();
 
+	euroc_prefetcher_destroy(ep);
+
 	ep->is_running = false;
 
 	EUROC_INFO(ep, "Euroc dataset playback finished");
@@ -737,7 +1167,7 @@ euroc_player_stream_start(struct xrt_fs *xfs,
 
 	if (xs == NULL && capture_type == XRT_FS_CAPTURE_TYPE_TRACKING) {
 		EUROC_INFO(ep, "Starting Euroc Player in tracking mode");
-		if (ep->out_sinks.cams[0] == NULL) {
+		if (ep->out_sinks.cams[0] == NULL && ep->out_sinks.bundle == NULL) {
 			EUROC_WARN(ep, "No cam0 sink provided, will keep running but tracking is unlikely to work");
 		}
 		if (ep->playback.play_from_start) {
@@ -746,6 +1176,7 @@ euroc_player_stream_start(struct xrt_fs *xfs,
 	} else if (xs != NULL && capture_type == XRT_FS_CAPTURE_TYPE_CALIBRATION) {
 		EUROC_INFO(ep, "Starting Euroc Player in calibration mode, will stream only cam0 frames right away");
 		ep->out_sinks.cams[0] = xs;
+		ep->out_sinks.bundle = nullptr;
 		euroc_player_start_btn_cb(ep);
 	} else {
 		EUROC_ASSERT(false, "Unsupported stream configuration xs=%p capture_type=%d", (void *)xs, capture_type);
@@ -801,6 +1232,8 @@ euroc_player_destroy(struct xrt_frame_node *node)
 	delete ep->gt;
 	delete ep->imus;
 	delete ep->imgs;
+	delete ep->packed_frames;
+	u_pd_reader_close(&ep->packed);
 
 	u_var_remove_root(ep);
 	for (int i = 0; i < ep->dataset.cam_count; i++) {
@@ -910,6 +1343,9 @@ euroc_player_setup_gui(struct euroc_player *ep)
 	u_var_add_f64(ep, &ep->playback.speed, "Speed");
 	u_var_add_bool(ep, &ep->playback.send_all_imus_first, "Send all IMU samples first");
 	u_var_add_bool(ep, &ep->playback.use_source_ts, "Use original timestamps");
+	u_var_add_ro_i32(ep, &ep->playback.prefetch_frames, "Prefetch N frames (0 to disable)");
+	u_var_add_ro_i32(ep, &ep->playback.prefetch_threads, "Prefetch threads (0 for auto)");
+	u_var_add_ro_i32(ep, &ep->playback.prefetch_max_mb, "Prefetch memory cap (MiB)");
 
 	u_var_add_gui_header(ep, NULL, "Streams");
 	u_var_add_ro_ff_vec3_f32(ep, ep->gyro_ff, "Gyroscope");
@@ -946,12 +1382,231 @@ euroc_player_fill_default_config_for(struct euroc_player_config *config, const c
 	playback.use_source_ts = debug_get_bool_option_use_source_ts();
 	playback.play_from_start = debug_get_bool_option_play_from_start();
 	playback.print_progress = debug_get_bool_option_print_progress();
+	playback.prefetch_frames = (int)debug_get_num_option_prefetch_frames();
+	playback.prefetch_threads = (int)debug_get_num_option_prefetch_threads();
+	playback.prefetch_max_mb = (int)debug_get_num_option_prefetch_max_mb();
 
 	config->log_level = debug_get_log_option_euroc_log();
 	config->dataset = dataset;
 	config->playback = playback;
 }
 
+// Packed dataset conversion
+
+static double
+seconds_since(timepoint_ns start_ts)
+{
+	return (os_monotonic_get_ts() - start_ts) / (double)U_TIME_1S_IN_NS;
+}
+
+extern "C" bool
+euroc_dataset_pack(const char *euroc_path,
+                   const char *packed_path,
+                   bool lz4,
+                   bool measure_png,
+                   struct euroc_pack_stats *out_stats)
+{
+	struct euroc_pack_stats stats = {};
+
+	euroc_player_dataset_info dataset = {};
+	euroc_player_fill_dataset_info(euroc_path, &dataset);
+	if (dataset.is_packed) {
+		U_LOG_E("%s is already a packed dataset", euroc_path);
+		return false;
+	}
+
+	imu_samples imus;
+	gt_trajectory gt;
+	vector<img_samples> imgs(dataset.cam_count);
+	euroc_player_preload_imu_data(euroc_path, &imus);
+	if (dataset.has_gt) {
+		euroc_player_preload_gt_data(euroc_path, &dataset.gt_device_name, &gt);
+	}
+
+	// All frames of all cameras in timestamp order, as (timestamp, cam, index)
+	vector<std::tuple<timepoint_ns, int, size_t>> frames;
+	for (int i = 0; i < dataset.cam_count; i++) {
+		euroc_player_preload_img_data(euroc_path, imgs[i], i);
+		for (size_t j = 0; j < imgs[i].size(); j++) {
+			frames.emplace_back(imgs[i][j].first, i, j);
+		}
+	}
+	std::stable_sort(frames.begin(), frames.end());
+
+	struct u_pd_writer *pdw = nullptr;
+	if (u_pd_writer_create(packed_path, dataset.cam_count, 0, &pdw) != 0) {
+		return false;
+	}
+
+	enum u_pd_codec codec = lz4 ? U_PD_CODEC_LZ4 : U_PD_CODEC_RAW;
+	size_t imu_seq = 0;
+	size_t gt_seq = 0;
+	int ret = 0;
+
+	for (const auto &[ts, cam_index, index] : frames) {
+		// Interleave samples so the file can be played back front to back
+		while (imu_seq < imus.size() && imus[imu_seq].timestamp_ns <= ts) {
+			ret |= u_pd_writer_push_imu(pdw, &imus[imu_seq++]);
+		}
+		while (gt_seq < gt.size() && gt[gt_seq].timestamp_ns <= ts) {
+			ret |= u_pd_writer_push_gt(pdw, &gt[gt_seq++]);
+		}
+
+		const string &img_name = imgs[cam_index][index].second;
+		timepoint_ns start_ts = os_monotonic_get_ts();
+		cv::Mat img = cv::imread(img_name, cv::IMREAD_ANYCOLOR);
+		stats.png_read_s += seconds_since(start_ts);
+		stats.png_bytes += std::filesystem::file_size(img_name);
+
+		if (img.empty()) {
+			U_LOG_E("Could not read %s", img_name.c_str());
+			ret = -1;
+			break;
+		}
+
+		if (measure_png) {
+			vector<uint8_t> png;
+			start_ts = os_monotonic_get_ts();
+			cv::imencode(".png", img, png);
+			stats.png_write_s += seconds_since(start_ts);
+		}
+
+		// Read in BGR order, but stored as R8G8B8 like recorded frames.
+		if (img.channels() == 3) {
+			cv::cvtColor(img, img, cv::COLOR_BGR2RGB);
+		}
+
+		struct xrt_frame xf = {};
+		xf.width = img.cols;
+		xf.height = img.rows;
+		xf.stride = img.step;
+		xf.data = img.data;
+		xf.format = img.channels() == 3 ? XRT_FORMAT_R8G8B8 : XRT_FORMAT_L8;
+		xf.timestamp = ts;
+
+		start_ts = os_monotonic_get_ts();
+		ret |= u_pd_writer_push_frame(pdw, cam_index, &xf, codec);
+		stats.packed_write_s += seconds_since(start_ts);
+		stats.frame_count++;
+	}
+
+	while (ret == 0 && imu_seq < imus.size()) {
+		ret |= u_pd_writer_push_imu(pdw, &imus[imu_seq++]);
+	}
+	while (ret == 0 && gt_seq < gt.size()) {
+		ret |= u_pd_writer_push_gt(pdw, &gt[gt_seq++]);
+	}
+
+	timepoint_ns start_ts = os_monotonic_get_ts();
+	ret |= u_pd_writer_close(&pdw);
+	stats.packed_write_s += seconds_since(start_ts);
+
+	if (ret != 0) {
+		U_LOG_E("Failed to write packed dataset %s", packed_path);
+		return false;
+	}
+
+	// Measure how long playback takes to get all frames from the new file
+	start_ts = os_monotonic_get_ts();
+	u_pd_reader pdr;
+	if (u_pd_reader_open(&pdr, packed_path) == 0) {
+		vector<uint8_t> pixels;
+		u_pd_record rec;
+		while (u_pd_reader_next(&pdr, &rec)) {
+			if (rec.type != U_PD_RECORD_FRAME || rec.frame.header->codec == U_PD_CODEC_RAW) {
+				continue;
+			}
+			pixels.resize(u_pd_frame_size(&rec));
+			u_pd_frame_decode(&rec, pixels.data(), pixels.size());
+		}
+		stats.packed_bytes = pdr.size;
+		u_pd_reader_close(&pdr);
+	}
+	stats.packed_read_s = seconds_since(start_ts);
+
+	if (out_stats != nullptr) {
+		*out_stats = stats;
+	}
+
+	return true;
+}
+
+extern "C" bool
+euroc_dataset_unpack(const char *packed_path, const char *euroc_path)
+{
+	using std::filesystem::create_directories;
+
+	u_pd_reader pdr;
+	if (u_pd_reader_open(&pdr, packed_path) != 0) {
+		return false;
+	}
+
+	// Same layout as the EuRoC recorder
+	string path = euroc_path;
+	create_directories(path + "/mav0/imu0");
+	ofstream imu_csv{path + "/mav0/imu0/data.csv"};
+	imu_csv << std::fixed << std::setprecision(CSV_PRECISION);
+	imu_csv << "#timestamp [ns],w_RS_S_x [rad s^-1],w_RS_S_y [rad s^-1],w_RS_S_z [rad s^-1],"
+	           "a_RS_S_x [m s^-2],a_RS_S_y [m s^-2],a_RS_S_z [m s^-2]" CSV_EOL;
+
+	create_directories(path + "/mav0/gt");
+	ofstream gt_csv{path + "/mav0/gt/data.csv"};
+	gt_csv << std::fixed << std::setprecision(CSV_PRECISION);
+	gt_csv << "#timestamp [ns],p_RS_R_x [m],p_RS_R_y [m],p_RS_R_z [m],"
+	          "q_RS_w [],q_RS_x [],q_RS_y [],q_RS_z []" CSV_EOL;
+
+	vector<ofstream> cams_csv(pdr.header.cam_count);
+	for (uint32_t i = 0; i < pdr.header.cam_count; i++) {
+		string data_path = path + "/mav0/cam" + to_string(i) + "/data";
+		create_directories(data_path);
+		cams_csv[i].open(data_path + ".csv");
+		cams_csv[i] << "#timestamp [ns],filename" CSV_EOL;
+	}
+
+	bool ok = true;
+	u_pd_record rec;
+	while (ok && u_pd_reader_next(&pdr, &rec)) {
+		if (rec.type == U_PD_RECORD_IMU) {
+			const xrt_vec3_f64 &a = rec.imu.accel_m_s2;
+			const xrt_vec3_f64 &w = rec.imu.gyro_rad_secs;
+			imu_csv << rec.timestamp_ns << ",";
+			imu_csv << w.x << "," << w.y << "," << w.z << ",";
+			imu_csv << a.x << "," << a.y << "," << a.z << CSV_EOL;
+		} else if (rec.type == U_PD_RECORD_GT) {
+			const xrt_vec3 &p = rec.gt.pose.position;
+			const xrt_quat &o = rec.gt.pose.orientation;
+			gt_csv << rec.timestamp_ns << ",";
+			gt_csv << p.x << "," << p.y << "," << p.z << ",";
+			gt_csv << o.w << "," << o.x << "," << o.y << "," << o.z << CSV_EOL;
+		} else if (rec.type == U_PD_RECORD_FRAME && rec.frame.header->cam_index < pdr.header.cam_count) {
+			const u_pd_frame_header *fh = rec.frame.header;
+			cv::Mat img;
+			ok = euroc_packed_frame_to_mat(rec, img);
+
+			// Stored in RGB order, written in BGR order.
+			if (ok && img.channels() == 3) {
+				cv::Mat tmp;
+				cv::cvtColor(img, tmp, cv::COLOR_RGB2BGR);
+				img = tmp;
+			}
+
+			string filename = to_string(rec.timestamp_ns) + ".png";
+			string cam_name = "cam" + to_string(fh->cam_index);
+			ok = ok && cv::imwrite(path + "/mav0/" + cam_name + "/data/" + filename, img);
+			cams_csv[fh->cam_index] << rec.timestamp_ns << "," << filename << CSV_EOL;
+		}
+	}
+
+	u_pd_reader_close(&pdr);
+
+	if (!ok) {
+		U_LOG_E("Failed to unpack %s into %s", packed_path, euroc_path);
+	}
+
+	return ok;
+}
+
+
 // Euroc driver creation
 
 extern "C" struct xrt_fs *
@@ -990,6 +1645,7 @@ euroc_player_create(struct xrt_frame_context *xfctx, const char *path, struct eu
 	ep->gt = new gt_trajectory{};
 	ep->imus = new imu_samples{};
 	ep->imgs = new vector<img_samples>(ep->dataset.cam_count);
+	ep->packed_frames = new vector<pd_records>(ep->dataset.cam_count);
 
 	euroc_player_setup_gui(ep);
 
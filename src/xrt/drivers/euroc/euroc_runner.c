@@ -27,13 +27,15 @@ void
 euroc_run_dataset(const char *euroc_path,
                   const char *slam_config,
                   const char *output_path,
+                  bool print_progress,
+                  struct t_slam_metrics *out_metrics,
                   const volatile bool *should_exit)
 {}
 
 #else
 
 static struct euroc_player_config *
-make_euroc_player_config(const char *euroc_path)
+make_euroc_player_config(const char *euroc_path, bool print_progress)
 {
 	struct euroc_player_config *ep_config = U_TYPED_CALLOC(struct euroc_player_config);
 	euroc_player_fill_default_config_for(ep_config, euroc_path);
@@ -46,7 +48,7 @@ make_euroc_player_config(const char *euroc_path)
 		ep_config->playback.play_from_start = true;
 	}
 	if (getenv("EUROC_PRINT_PROGRESS") == NULL) {
-		ep_config->playback.print_progress = true;
+		ep_config->playback.print_progress = print_progress;
 	}
 	if (getenv("EUROC_USE_SOURCE_TS") == NULL) {
 		ep_config->playback.use_source_ts = true;
@@ -59,7 +61,7 @@ make_euroc_player_config(const char *euroc_path)
 }
 
 static struct t_slam_tracker_config *
-make_slam_tracker_config(const char *slam_config, const char *output_path)
+make_slam_tracker_config(const char *slam_config, const char *output_path, bool metrics)
 {
 	struct t_slam_tracker_config *st_config = U_TYPED_CALLOC(struct t_slam_tracker_config);
 	t_slam_fill_default_config(st_config);
@@ -80,6 +82,7 @@ make_slam_tracker_config(const char *slam_config, const char *output_path)
 
 	st_config->slam_config = slam_config;
 	st_config->csv_path = output_path;
+	st_config->metrics = metrics;
 
 	return st_config;
 }
@@ -88,10 +91,13 @@ void
 euroc_run_dataset(const char *euroc_path,
                   const char *slam_config,
                   const char *output_path,
+                  bool print_progress,
+                  struct t_slam_metrics *out_metrics,
                   const volatile bool *should_exit)
 {
-	struct euroc_player_config *ep_config = make_euroc_player_config(euroc_path);
-	struct t_slam_tracker_config *st_config = make_slam_tracker_config(slam_config, output_path);
+	struct euroc_player_config *ep_config = make_euroc_player_config(euroc_path, print_progress);
+	struct t_slam_tracker_config *st_config =
+	    make_slam_tracker_config(slam_config, output_path, out_metrics != NULL);
 	st_config->cam_count = ep_config->dataset.cam_count;
 
 	// Frame context that will manage SLAM tracker and euroc player lifetimes
@@ -125,6 +131,11 @@ euroc_run_dataset(const char *euroc_path,
 		streaming = xrt_fs_is_running(xfs);
 	}
 
+	if (out_metrics != NULL) {
+		// Also waits for the tracker to finish the last frames of the dataset
+		t_slam_get_metrics(xts, out_metrics);
+	}
+
 	xrt_frame_context_destroy_nodes(&xfctx);
 	free(st_config);
 	free(ep_config);
@@ -447,6 +447,34 @@ ns_mesh_calc(struct xrt_device *xdev, uint32_t view, float u, float v, struct xr
 	}
 }
 
+static bool
+ns_mesh_calc_batch(struct xrt_device *xdev,
+                   uint32_t view,
+                   uint32_t count,
+                   const float *u,
+                   const float *v,
+                   struct xrt_uv_triplet *results)
+{
+	struct ns_hmd *ns = ns_hmd(xdev);
+
+	switch (ns->config.distortion_type) {
+	case NS_DISTORTION_TYPE_POLYNOMIAL_2D: {
+		return u_compute_distortion_ns_p2d_batch(&ns->config.dist_p2d, view, count, u, v, results);
+	}
+	case NS_DISTORTION_TYPE_MOSHI_MESHGRID: {
+		return u_compute_distortion_ns_meshgrid_batch(&ns->config.dist_meshgrid, view, count, u, v, results);
+	}
+	default: {
+		for (uint32_t i = 0; i < count; i++) {
+			if (!ns_mesh_calc(xdev, view, u[i], v[i], &results[i])) {
+				return false;
+			}
+		}
+		return true;
+	}
+	}
+}
+
 /*
  *
  * Create function.
@@ -471,6 +499,7 @@ ns_hmd_create(const cJSON *config_json)
 
 
 	ns->base.compute_distortion = ns_mesh_calc;
+	ns->base.compute_distortion_batch = ns_mesh_calc_batch;
 	ns->base.update_inputs = ns_hmd_update_inputs;
 	ns->base.get_tracked_pose = ns_hmd_get_tracked_pose;
 	ns->base.get_view_poses = ns_hmd_get_view_poses;
@@ -716,6 +716,18 @@ compute_distortion_vive(struct xrt_device *xdev, uint32_t view, float u, float v
 	return u_compute_distortion_vive(&ohd->distortion.vive[view], u, v, result);
 }
 
+static bool
+compute_distortion_vive_batch(struct xrt_device *xdev,
+                              uint32_t view,
+                              uint32_t count,
+                              const float *u,
+                              const float *v,
+                              struct xrt_uv_triplet *results)
+{
+	struct oh_device *ohd = oh_device(xdev);
+	return u_compute_distortion_vive_batch(&ohd->distortion.vive[view], count, u, v, results);
+}
+
 static inline void
 swap(int *a, int *b)
 {
@@ -910,6 +922,7 @@ create_hmd(ohmd_context *ctx, int device_idx, int device_flags)
 		// clang-format on
 
 		ohd->base.compute_distortion = compute_distortion_vive;
+		ohd->base.compute_distortion_batch = compute_distortion_vive_batch;
 	}
 
 	if (info.quirks.video_distortion_none) {
@@ -113,6 +113,8 @@ qwerty_update_inputs(struct xrt_device *xd)
 	struct qwerty_controller *qc = qwerty_controller(xd);
 	struct qwerty_device *qd = &qc->base;
 
+	bool clicked = qc->select_clicked || qc->menu_clicked;
+
 	xd->inputs[QWERTY_SELECT].value.boolean = qc->select_clicked;
 	if (qc->select_clicked) {
 		QWERTY_INFO(qd, "[%s] Select click", xd->str);
@@ -124,6 +126,11 @@ qwerty_update_inputs(struct xrt_device *xd)
 		QWERTY_INFO(qd, "[%s] Menu click", xd->str);
 		qc->menu_clicked = false;
 	}
+
+	// Clicks only last one update, the next one releases them.
+	if (clicked) {
+		xrt_atomic_u64_inc_return(&xd->input_generation);
+	}
 }
 
 static void
@@ -276,6 +283,9 @@ qwerty_hmd_create(void)
 
 	xd->inputs[0].name = XRT_INPUT_GENERIC_HEAD_POSE;
 
+	// Only has a pose input, nothing to update.
+	xd->input_generation = 1;
+
 	xd->update_inputs = qwerty_update_inputs;
 	xd->get_tracked_pose = qwerty_get_tracked_pose;
 	xd->get_view_poses = qwerty_get_view_poses;
@@ -319,6 +329,9 @@ qwerty_controller_create(bool is_left, struct qwerty_hmd *qhmd)
 	xd->inputs[QWERTY_AIM].name = XRT_INPUT_SIMPLE_AIM_POSE; //!< @todo: aim input not implemented
 	xd->outputs[QWERTY_VIBRATION].name = XRT_OUTPUT_NAME_SIMPLE_VIBRATION;
 
+	// Inputs only change on clicks, see qwerty_update_inputs.
+	xd->input_generation = 1;
+
 	xd->update_inputs = qwerty_update_inputs;
 	xd->get_tracked_pose = qwerty_get_tracked_pose;
 	xd->set_output = qwerty_set_output;
@@ -509,8 +522,8 @@ qwerty_release_all(struct qwerty_device *qd)
 // Controller methods
 
 // clang-format off
-void qwerty_select_click(struct qwerty_controller *qc) { qc->select_clicked = true; }
-void qwerty_menu_click(struct qwerty_controller *qc) { qc->menu_clicked = true; }
+void qwerty_select_click(struct qwerty_controller *qc) { qc->select_clicked = true; xrt_atomic_u64_inc_return(&qc->base.base.input_generation); }
+void qwerty_menu_click(struct qwerty_controller *qc) { qc->menu_clicked = true; xrt_atomic_u64_inc_return(&qc->base.base.input_generation); }
 // clang-format on
 
 void
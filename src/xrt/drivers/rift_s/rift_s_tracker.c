@@ -421,6 +421,7 @@ rift_s_tracker_create(struct xrt_tracking_origin *origin,
 		entry_sinks = *slam_sinks;
 		entry_sinks.cams[0] = entry_cam0_sink;
 		entry_sinks.cams[1] = entry_cam1_sink;
+		entry_sinks.bundle = NULL; // Captures must go through the splits
 	} else if (slam_enabled) {
 		entry_sinks = *slam_sinks;
 	} else if (hand_enabled) {
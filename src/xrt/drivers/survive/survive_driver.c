@@ -798,6 +798,9 @@ _process_pose_event(struct survive_device *survive, const struct SurviveSimplePo
 	ts = survive_timecode_to_monotonic(survive, e->time);
 	m_relation_history_push(survive->relation_hist, &rel, ts);
 
+	// Poses only depend on the history, let them be reused until the next push.
+	xrt_atomic_u64_inc_return(&survive->base.tracking_generation);
+
 	SURVIVE_TRACE(survive, "Process pose event for %s", survive->base.str);
 }
 
@@ -873,6 +876,18 @@ compute_distortion(struct xrt_device *xdev, uint32_t view, float u, float v, str
 	return u_compute_distortion_vive(&d->hmd.config.distortion.values[view], u, v, result);
 }
 
+static bool
+compute_distortion_batch(struct xrt_device *xdev,
+                         uint32_t view,
+                         uint32_t count,
+                         const float *u,
+                         const float *v,
+                         struct xrt_uv_triplet *results)
+{
+	struct survive_device *d = (struct survive_device *)xdev;
+	return u_compute_distortion_vive_batch(&d->hmd.config.distortion.values[view], count, u, v, results);
+}
+
 static bool
 _create_hmd_device(struct survive_system *sys, const struct SurviveSimpleObject *sso, char *conf_str)
 {
@@ -951,6 +966,7 @@ _create_hmd_device(struct survive_system *sys, const struct SurviveSimpleObject
 	survive->base.hmd->distortion.models = XRT_DISTORTION_MODEL_COMPUTE;
 	survive->base.hmd->distortion.preferred = XRT_DISTORTION_MODEL_COMPUTE;
 	survive->base.compute_distortion = compute_distortion;
+	survive->base.compute_distortion_batch = compute_distortion_batch;
 
 	survive->base.orientation_tracking_supported = true;
 	survive->base.position_tracking_supported = true;
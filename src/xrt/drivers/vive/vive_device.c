@@ -885,6 +885,20 @@ compute_distortion(struct xrt_device *xdev, uint32_t view, float u, float v, str
 	return u_compute_distortion_vive(&d->config.distortion.values[view], u, v, result);
 }
 
+static bool
+compute_distortion_batch(struct xrt_device *xdev,
+                         uint32_t view,
+                         uint32_t count,
+                         const float *u,
+                         const float *v,
+                         struct xrt_uv_triplet *results)
+{
+	XRT_TRACE_MARKER();
+
+	struct vive_device *d = vive_device(xdev);
+	return u_compute_distortion_vive_batch(&d->config.distortion.values[view], count, u, v, results);
+}
+
 void
 vive_set_trackers_status(struct vive_device *d, struct vive_tracking_status status)
 {
@@ -996,6 +1010,7 @@ vive_device_create(struct os_hid_device *mainboard_dev,
 	d->base.hmd->distortion.models = XRT_DISTORTION_MODEL_COMPUTE;
 	d->base.hmd->distortion.preferred = XRT_DISTORTION_MODEL_COMPUTE;
 	d->base.compute_distortion = compute_distortion;
+	d->base.compute_distortion_batch = compute_distortion_batch;
 
 	if (d->mainboard_dev) {
 		vive_mainboard_power_on(d);
@@ -1755,6 +1755,7 @@ wmr_hmd_setup_trackers(struct wmr_hmd *wh, struct xrt_slam_sinks *out_sinks, str
 		entry_sinks = *slam_sinks;
 		entry_sinks.cams[0] = entry_cam0_sink;
 		entry_sinks.cams[1] = entry_cam1_sink;
+		entry_sinks.bundle = NULL; // Captures must go through the splits
 	} else if (slam_enabled) {
 		entry_sinks = *slam_sinks;
 	} else if (hand_enabled) {
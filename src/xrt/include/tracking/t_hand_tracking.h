@@ -119,6 +119,31 @@ struct t_hand_tracking_sync
 	                struct xrt_hand_joint_set *out_right_hand,
 	                uint64_t *out_timestamp_ns);
 
+	/*!
+	 * Optional: the first half of @ref process, runs the detection and
+	 * keypoint models on the left and right view. The results are kept for
+	 * the next call to @ref optimize.
+	 *
+	 * Calling @ref optimize for one frame pair while this function runs on
+	 * the next one is allowed, so the two halves can be pipelined on two
+	 * threads. If the results of the previous call haven't been picked up
+	 * by @ref optimize yet, this blocks until they are.
+	 */
+	void (*infer)(struct t_hand_tracking_sync *ht_sync,
+	              struct xrt_frame *left_frame,
+	              struct xrt_frame *right_frame);
+
+	/*!
+	 * Optional: the second half of @ref process, turns the results of the
+	 * oldest call to @ref infer into hands. Must only be called once for
+	 * each call to @ref infer that has returned. The timestamp is that of
+	 * the frames given to that call.
+	 */
+	void (*optimize)(struct t_hand_tracking_sync *ht_sync,
+	                 struct xrt_hand_joint_set *out_left_hand,
+	                 struct xrt_hand_joint_set *out_right_hand,
+	                 uint64_t *out_timestamp_ns);
+
 	/*!
 	 * Destroy this hand tracker sync object.
 	 */
@@ -141,6 +166,43 @@ t_ht_sync_process(struct t_hand_tracking_sync *ht_sync,
 	ht_sync->process(ht_sync, left_frame, right_frame, out_left_hand, out_right_hand, out_timestamp_ns);
 }
 
+/*!
+ * Whether @ref t_hand_tracking_sync::infer and @ref
+ * t_hand_tracking_sync::optimize are implemented.
+ *
+ * @public @memberof t_hand_tracking_sync
+ */
+static inline bool
+t_ht_sync_can_pipeline(struct t_hand_tracking_sync *ht_sync)
+{
+	return ht_sync->infer != NULL && ht_sync->optimize != NULL;
+}
+
+/*!
+ * @copydoc t_hand_tracking_sync::infer
+ *
+ * @public @memberof t_hand_tracking_sync
+ */
+static inline void
+t_ht_sync_infer(struct t_hand_tracking_sync *ht_sync, struct xrt_frame *left_frame, struct xrt_frame *right_frame)
+{
+	ht_sync->infer(ht_sync, left_frame, right_frame);
+}
+
+/*!
+ * @copydoc t_hand_tracking_sync::optimize
+ *
+ * @public @memberof t_hand_tracking_sync
+ */
+static inline void
+t_ht_sync_optimize(struct t_hand_tracking_sync *ht_sync,
+                   struct xrt_hand_joint_set *out_left_hand,
+                   struct xrt_hand_joint_set *out_right_hand,
+                   uint64_t *out_timestamp_ns)
+{
+	ht_sync->optimize(ht_sync, out_left_hand, out_right_hand, out_timestamp_ns);
+}
+
 /*!
  * @copydoc t_hand_tracking_sync::destroy
  *
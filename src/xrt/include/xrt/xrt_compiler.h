@@ -134,6 +134,40 @@ xrt_atomic_s32_cmpxchg(xrt_atomic_s32_t *p, int32_t old_, int32_t new_)
 #endif
 }
 
+typedef volatile uint64_t xrt_atomic_u64_t;
+
+/*!
+ * Increments and returns the new value, acts as a full memory barrier so
+ * writes done before it are visible to anybody that loads the new value.
+ */
+static inline uint64_t
+xrt_atomic_u64_inc_return(xrt_atomic_u64_t *p)
+{
+#if defined(__GNUC__)
+	return __sync_add_and_fetch(p, 1);
+#elif defined(_MSC_VER)
+	return (uint64_t)InterlockedIncrement64((volatile LONG64 *)p);
+#else
+#error "compiler not supported"
+#endif
+}
+
+/*!
+ * Loads the value, acts as a full memory barrier so reads done after it see
+ * at least the writes done before the increment that produced the value.
+ */
+static inline uint64_t
+xrt_atomic_u64_load(xrt_atomic_u64_t *p)
+{
+#if defined(__GNUC__)
+	return __sync_add_and_fetch(p, 0);
+#elif defined(_MSC_VER)
+	return (uint64_t)InterlockedCompareExchange64((volatile LONG64 *)p, 0, 0);
+#else
+#error "compiler not supported"
+#endif
+}
+
 #ifdef _MSC_VER
 typedef intptr_t ssize_t;
 #define _SSIZE_T_
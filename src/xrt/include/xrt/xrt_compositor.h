@@ -1880,6 +1880,31 @@ struct xrt_compositor_native
 {
 	//! @public Base
 	struct xrt_compositor base;
+
+	/*!
+	 * Optional, create a swapchain on behalf of a client, used by
+	 * compositors that multiplex several clients onto this one. Lets the
+	 * native compositor recycle the images of a client's destroyed
+	 * swapchains for that same client, never for any other client.
+	 *
+	 * @param xcn       Self pointer
+	 * @param client_id Non-zero id, unique for the lifetime of the compositor.
+	 * @param info      Creation info.
+	 * @param out_xsc   Output swapchain.
+	 */
+	xrt_result_t (*create_swapchain_for_client)(struct xrt_compositor_native *xcn,
+	                                            uint64_t client_id,
+	                                            const struct xrt_swapchain_create_info *info,
+	                                            struct xrt_swapchain **out_xsc);
+
+	/*!
+	 * Optional, the client is gone and anything kept around for it can be
+	 * freed, called after the client has released all of its swapchains.
+	 *
+	 * @param xcn       Self pointer
+	 * @param client_id Id previously given to @ref create_swapchain_for_client.
+	 */
+	void (*release_client)(struct xrt_compositor_native *xcn, uint64_t client_id);
 };
 
 /*!
@@ -1916,6 +1941,44 @@ xrt_comp_native_create_swapchain(struct xrt_compositor_native *xcn,
 	return ret;
 }
 
+/*!
+ * @copydoc xrt_compositor_native::create_swapchain_for_client
+ *
+ * Helper for calling through the function pointer, falls back to a regular
+ * @ref xrt_comp_create_swapchain if the compositor doesn't implement it.
+ *
+ * @public @memberof xrt_compositor_native
+ */
+static inline xrt_result_t
+xrt_comp_native_create_swapchain_for_client(struct xrt_compositor_native *xcn,
+                                            uint64_t client_id,
+                                            const struct xrt_swapchain_create_info *info,
+                                            struct xrt_swapchain **out_xsc)
+{
+	if (xcn->create_swapchain_for_client == NULL) {
+		return xrt_comp_create_swapchain(&xcn->base, info, out_xsc);
+	}
+
+	return xcn->create_swapchain_for_client(xcn, client_id, info, out_xsc);
+}
+
+/*!
+ * @copydoc xrt_compositor_native::release_client
+ *
+ * Helper for calling through the function pointer: does a null check.
+ *
+ * @public @memberof xrt_compositor_native
+ */
+static inline void
+xrt_comp_native_release_client(struct xrt_compositor_native *xcn, uint64_t client_id)
+{
+	if (xcn->release_client == NULL) {
+		return;
+	}
+
+	xcn->release_client(xcn, client_id);
+}
+
 /*!
  * @copydoc xrt_compositor::destroy
  *
@@ -272,6 +272,31 @@ struct xrt_device
 	//! Array of input structs.
 	struct xrt_input *inputs;
 
+	/*!
+	 * Optional input generation counter. Drivers that support it increment
+	 * it whenever calling @ref update_inputs would change any of the
+	 * @ref inputs, letting callers skip the update when nothing changed.
+	 * Zero means the driver doesn't track this and @ref update_inputs must
+	 * always be called.
+	 *
+	 * Can be changed from any thread, only access it with the xrt_atomic_u64
+	 * functions. Drivers make the state change first and then increment,
+	 * callers load it before calling @ref update_inputs, so an update done
+	 * after seeing a value always sees the changes behind that value.
+	 */
+	xrt_atomic_u64_t input_generation;
+
+	/*!
+	 * Optional tracking generation counter. Drivers that support it
+	 * increment it whenever new tracking data arrives, that is whenever
+	 * @ref get_tracked_pose could return something different for the same
+	 * input and timestamp, letting callers reuse poses in between. Zero
+	 * means the driver doesn't track this and poses must not be reused.
+	 *
+	 * Same threading and ordering rules as @ref input_generation.
+	 */
+	xrt_atomic_u64_t tracking_generation;
+
 	//! Number of outputs.
 	size_t output_count;
 	//! Array of output structs.
@@ -419,6 +444,29 @@ struct xrt_device
 	bool (*compute_distortion)(
 	    struct xrt_device *xdev, uint32_t view, float u, float v, struct xrt_uv_triplet *out_result);
 
+	/*!
+	 * Compute the distortion at @p count points, optional. Same semantics as
+	 * @ref xrt_device::compute_distortion but lets the driver evaluate a
+	 * whole batch without going through a function pointer per point.
+	 *
+	 * The function must be safe to call from multiple threads at the same
+	 * time with disjoint output arrays, the compositor splits the lookup
+	 * generation across worker threads when this is implemented.
+	 *
+	 * @param xdev             the device
+	 * @param view             the view index
+	 * @param count            number of points
+	 * @param u                array of @p count horizontal texture coordinates
+	 * @param v                array of @p count vertical texture coordinates
+	 * @param[out] out_results array of @p count u,v triplets.
+	 */
+	bool (*compute_distortion_batch)(struct xrt_device *xdev,
+	                                 uint32_t view,
+	                                 uint32_t count,
+	                                 const float *u,
+	                                 const float *v,
+	                                 struct xrt_uv_triplet *out_results);
+
 	/*!
 	 * Destroy device.
 	 */
@@ -545,6 +593,36 @@ xrt_device_compute_distortion(
 	return xdev->compute_distortion(xdev, view, u, v, out_result);
 }
 
+/*!
+ * Helper function for @ref xrt_device::compute_distortion_batch, falls back
+ * to calling @ref xrt_device::compute_distortion for each point if the device
+ * doesn't implement the batch function.
+ *
+ * @copydoc xrt_device::compute_distortion_batch
+ *
+ * @public @memberof xrt_device
+ */
+static inline bool
+xrt_device_compute_distortion_batch(struct xrt_device *xdev,
+                                    uint32_t view,
+                                    uint32_t count,
+                                    const float *u,
+                                    const float *v,
+                                    struct xrt_uv_triplet *out_results)
+{
+	if (xdev->compute_distortion_batch != NULL) {
+		return xdev->compute_distortion_batch(xdev, view, count, u, v, out_results);
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (!xdev->compute_distortion(xdev, view, u[i], v[i], &out_results[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 /*!
  * Helper function for @ref xrt_device::destroy.
  *
@@ -167,6 +167,36 @@ struct xrt_pose_sink
 	void (*push_pose)(struct xrt_pose_sink *, struct xrt_pose_sample *sample);
 };
 
+/*!
+ * Synchronised images of all cameras from a single capture.
+ *
+ * Views may share a frame, e.g. both halves of a side-by-side stereo frame,
+ * so splitting a capture needs no new frames. The frames are not owned by the
+ * bundle, sinks must reference the ones they keep like with
+ * @ref xrt_frame_sink.
+ */
+struct xrt_frame_bundle
+{
+	timepoint_ns timestamp; //!< Capture timestamp shared by all views
+	int view_count;
+
+	//! Frame holding each view, one per camera.
+	struct xrt_frame *frames[XRT_TRACKING_MAX_SLAM_CAMS];
+
+	//! Area of the frame covered by each view.
+	struct xrt_rect rois[XRT_TRACKING_MAX_SLAM_CAMS];
+};
+
+/*!
+ * @interface xrt_frame_bundle_sink
+ *
+ * An object to send synchronised multi-camera captures to. @see xrt_imu_sink.
+ */
+struct xrt_frame_bundle_sink
+{
+	void (*push_bundle)(struct xrt_frame_bundle_sink *, struct xrt_frame_bundle *bundle);
+};
+
 /*!
  * Container of pointers to sinks that could be used for a SLAM system. Sinks
  * are considered disabled if they are null.
@@ -177,6 +207,10 @@ struct xrt_slam_sinks
 	struct xrt_frame_sink *cams[XRT_TRACKING_MAX_SLAM_CAMS];
 	struct xrt_imu_sink *imu;
 	struct xrt_pose_sink *gt; //!< Can receive ground truth poses if available
+
+	//! If not null, sources with synchronised cameras can push whole captures
+	//! here instead of pushing each camera to @ref cams.
+	struct xrt_frame_bundle_sink *bundle;
 };
 
 /*!
@@ -293,6 +327,13 @@ xrt_sink_push_pose(struct xrt_pose_sink *sink, struct xrt_pose_sample *sample)
 	sink->push_pose(sink, sample);
 }
 
+//! @public @memberof xrt_frame_bundle_sink
+static inline void
+xrt_sink_push_bundle(struct xrt_frame_bundle_sink *sink, struct xrt_frame_bundle *bundle)
+{
+	sink->push_bundle(sink, bundle);
+}
+
 //! @public @memberof xrt_tracked_psmv
 static inline void
 xrt_tracked_psmv_get_tracked_pose(struct xrt_tracked_psmv *psmv,
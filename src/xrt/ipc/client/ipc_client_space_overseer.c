@@ -149,6 +149,77 @@ locate_space(struct xrt_space_overseer *xso,
 	    out_relation);                  //
 }
 
+static xrt_result_t
+locate_spaces(struct xrt_space_overseer *xso,
+              struct xrt_space *base_space,
+              const struct xrt_pose *base_offset,
+              uint64_t at_timestamp_ns,
+              struct xrt_space **spaces,
+              uint32_t space_count,
+              const struct xrt_pose *offsets,
+              struct xrt_space_relation *out_relations)
+{
+	struct ipc_client_space_overseer *icspo = ipc_client_space_overseer(xso);
+
+	struct ipc_client_space *icsp_base_space = ipc_client_space(base_space);
+
+	struct ipc_connection *ipc_c = icspo->ipc_c;
+	struct ipc_result_reply reply = {0};
+	xrt_result_t xret;
+
+	if (space_count > IPC_MAX_LOCATE_SPACES) {
+		IPC_ERROR(ipc_c, "Too many spaces %u (max %u)!", space_count, IPC_MAX_LOCATE_SPACES);
+		return XRT_ERROR_IPC_FAILURE;
+	}
+
+	// A space id of UINT32_MAX marks a space that isn't available.
+	uint32_t space_ids[IPC_MAX_LOCATE_SPACES];
+	for (uint32_t i = 0; i < space_count; i++) {
+		space_ids[i] = spaces[i] != NULL ? ipc_client_space(spaces[i])->id : UINT32_MAX;
+	}
+
+	// The whole batch is one call, so other threads must not read/write the fd until we are done.
+	os_mutex_lock(&ipc_c->mutex);
+
+	xret = ipc_send_space_locate_spaces_locked( //
+	    ipc_c,                                  //
+	    icsp_base_space->id,                    //
+	    base_offset,                            //
+	    at_timestamp_ns,                        //
+	    space_count);                           //
+	if (xret != XRT_SUCCESS) {
+		goto out;
+	}
+
+	xret = ipc_send(&ipc_c->imc, space_ids, sizeof(*space_ids) * space_count);
+	if (xret != XRT_SUCCESS) {
+		goto out;
+	}
+
+	xret = ipc_send(&ipc_c->imc, offsets, sizeof(*offsets) * space_count);
+	if (xret != XRT_SUCCESS) {
+		goto out;
+	}
+
+	xret = ipc_receive(&ipc_c->imc, &reply, sizeof(reply));
+	if (xret != XRT_SUCCESS) {
+		goto out;
+	}
+
+	// The relations are only sent if the spaces could be located.
+	xret = reply.result;
+	if (xret != XRT_SUCCESS) {
+		goto out;
+	}
+
+	xret = ipc_receive(&ipc_c->imc, out_relations, sizeof(*out_relations) * space_count);
+
+out:
+	os_mutex_unlock(&ipc_c->mutex);
+
+	return xret;
+}
+
 static xrt_result_t
 locate_device(struct xrt_space_overseer *xso,
               struct xrt_space *base_space,
@@ -199,6 +270,7 @@ ipc_client_space_overseer_create(struct ipc_connection *ipc_c)
 	icspo->base.create_offset_space = create_offset_space;
 	icspo->base.create_pose_space = create_pose_space;
 	icspo->base.locate_space = locate_space;
+	icspo->base.locate_spaces = locate_spaces;
 	icspo->base.locate_device = locate_device;
 	icspo->base.destroy = destroy;
 	icspo->ipc_c = ipc_c;
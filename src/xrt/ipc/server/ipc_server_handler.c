@@ -393,6 +393,78 @@ ipc_handle_space_locate_space(volatile struct ipc_client_state *ics,
 	    out_relation);                      //
 }
 
+xrt_result_t
+ipc_handle_space_locate_spaces(volatile struct ipc_client_state *ics,
+                               uint32_t base_space_id,
+                               const struct xrt_pose *base_offset,
+                               uint64_t at_timestamp,
+                               uint32_t space_count)
+{
+	IPC_TRACE_MARKER();
+
+	struct ipc_message_channel *imc = (struct ipc_message_channel *)&ics->imc;
+	struct xrt_space_overseer *xso = ics->server->xso;
+	struct xrt_space *base_space = NULL;
+	struct xrt_space *spaces[IPC_MAX_LOCATE_SPACES] = {0};
+	uint32_t space_ids[IPC_MAX_LOCATE_SPACES];
+	struct xrt_pose offsets[IPC_MAX_LOCATE_SPACES];
+	struct xrt_space_relation relations[IPC_MAX_LOCATE_SPACES];
+	struct ipc_result_reply reply = {0};
+	xrt_result_t xret;
+
+	// The client checks this before sending, we can't know how much data follows.
+	if (space_count > IPC_MAX_LOCATE_SPACES) {
+		U_LOG_E("Too many spaces!");
+		return XRT_ERROR_IPC_FAILURE;
+	}
+
+	xret = ipc_receive(imc, space_ids, sizeof(*space_ids) * space_count);
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	xret = ipc_receive(imc, offsets, sizeof(*offsets) * space_count);
+	if (xret != XRT_SUCCESS) {
+		return xret;
+	}
+
+	reply.result = validate_space_id(ics, base_space_id, &base_space);
+	if (reply.result != XRT_SUCCESS) {
+		U_LOG_E("Invalid base_space_id!");
+	}
+
+	for (uint32_t i = 0; i < space_count && reply.result == XRT_SUCCESS; i++) {
+		// Not available on the client side, gets a zeroed relation.
+		if (space_ids[i] == UINT32_MAX) {
+			continue;
+		}
+
+		reply.result = validate_space_id(ics, space_ids[i], &spaces[i]);
+		if (reply.result != XRT_SUCCESS) {
+			U_LOG_E("Invalid space_id!");
+		}
+	}
+
+	if (reply.result == XRT_SUCCESS) {
+		reply.result = xrt_space_overseer_locate_spaces( //
+		    xso,                                         //
+		    base_space,                                  //
+		    base_offset,                                 //
+		    at_timestamp,                                //
+		    spaces,                                      //
+		    space_count,                                 //
+		    offsets,                                     //
+		    relations);                                  //
+	}
+
+	xret = ipc_send(imc, &reply, sizeof(reply));
+	if (xret != XRT_SUCCESS || reply.result != XRT_SUCCESS) {
+		return xret;
+	}
+
+	return ipc_send(imc, relations, sizeof(*relations) * space_count);
+}
+
 xrt_result_t
 ipc_handle_space_locate_device(volatile struct ipc_client_state *ics,
                                uint32_t base_space_id,
@@ -737,6 +809,24 @@ _update_equirect2_layer(struct xrt_compositor *xc,
 	return true;
 }
 
+/*!
+ * Copies the slot out of shared memory so the client can not change it while
+ * the server uses it, only the used layers are copied.
+ */
+static void
+copy_layer_slot(struct ipc_layer_slot *dst, const struct ipc_layer_slot *src)
+{
+	uint32_t layer_count = src->layer_count;
+	if (layer_count > IPC_MAX_LAYERS) {
+		U_LOG_E("Too many layers '%u' in slot, clamping!", layer_count);
+		layer_count = IPC_MAX_LAYERS;
+	}
+
+	dst->data = src->data;
+	dst->layer_count = layer_count;
+	memcpy(dst->layers, src->layers, sizeof(dst->layers[0]) * layer_count);
+}
+
 static bool
 _update_layers(volatile struct ipc_client_state *ics, struct xrt_compositor *xc, struct ipc_layer_slot *slot)
 {
@@ -818,7 +908,8 @@ ipc_handle_compositor_layer_sync(volatile struct ipc_client_state *ics,
 	}
 
 	// Copy current slot data.
-	struct ipc_layer_slot copy = *slot;
+	struct ipc_layer_slot copy;
+	copy_layer_slot(&copy, slot);
 
 
 	/*
@@ -873,7 +964,8 @@ ipc_handle_compositor_layer_sync_with_semaphore(volatile struct ipc_client_state
 	struct ipc_layer_slot *slot = &ism->slots[slot_id];
 
 	// Copy current slot data.
-	struct ipc_layer_slot copy = *slot;
+	struct ipc_layer_slot copy;
+	copy_layer_slot(&copy, slot);
 
 
 
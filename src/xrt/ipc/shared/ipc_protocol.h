@@ -34,6 +34,7 @@
 #define IPC_MAX_SLOTS 128
 #define IPC_MAX_CLIENTS 8
 #define IPC_EVENT_QUEUE_SIZE 32
+#define IPC_MAX_LOCATE_SPACES 256 // max spaces located in one call
 
 #define IPC_SHARED_MAX_INPUTS 1024
 #define IPC_SHARED_MAX_OUTPUTS 128
@@ -202,8 +202,15 @@ class Call:
             for arg in self.out_args:
                 arg.dump()
 
+    @property
+    def call_function_name(self):
+        """Get the name of the client proxy function."""
+        if self.varlen:
+            return 'ipc_send_' + self.name + '_locked'
+        return 'ipc_call_' + self.name
+
     def write_call_decl(self, f):
-        """Write declaration of ipc_call_CALLNAME."""
+        """Write declaration of ipc_call_CALLNAME or ipc_send_CALLNAME_locked."""
         args = ["struct ipc_connection *ipc_c"]
         args.extend(arg.get_func_argument_in() for arg in self.in_args)
         if self.in_handles:
@@ -211,7 +218,7 @@ class Call:
         args.extend(arg.get_func_argument_out() for arg in self.out_args)
         if self.out_handles:
             args.extend(self.out_handles.arg_decls)
-        write_decl(f, 'xrt_result_t', 'ipc_call_' + self.name, args)
+        write_decl(f, 'xrt_result_t', self.call_function_name, args)
 
     def write_handler_decl(self, f):
         """Write declaration of ipc_handle_CALLNAME."""
@@ -237,6 +244,7 @@ class Call:
         self.out_args = []
         self.in_handles = None
         self.out_handles = None
+        self.varlen = False
         for key, val in data.items():
             if key == 'id':
                 self.id = val
@@ -248,10 +256,14 @@ class Call:
                 self.out_handles = HandleType(val)
             elif key == 'in_handles':
                 self.in_handles = HandleType(val)
+            elif key == 'varlen':
+                self.varlen = val
             else:
                 raise RuntimeError("Unrecognized key")
         if not self.id:
             self.id = "IPC_" + name.upper()
+        if self.varlen and (self.out_args or self.in_handles or self.out_handles):
+            raise RuntimeError("Variable length call can not have out args or handles: " + name)
 
 
 class Proto:
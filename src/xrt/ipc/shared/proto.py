@@ -137,11 +137,16 @@ def generate_client_c(file, p):
         if call.in_handles:
             f.write("\tstruct ipc_result_reply _sync = {0};\n")
 
-        f.write("""
+        if call.varlen:
+            # The caller holds the mutex while it sends and receives the
+            # rest of the data.
+            cleanup = ""
+        else:
+            f.write("""
 \t// Other threads must not read/write the fd while we wait for reply
 \tos_mutex_lock(&ipc_c->mutex);
 """)
-        cleanup = "os_mutex_unlock(&ipc_c->mutex);"
+            cleanup = "os_mutex_unlock(&ipc_c->mutex);"
 
         # Prepare initial sending
         func = 'ipc_send'
@@ -191,7 +196,10 @@ def generate_client_c(file, p):
             f.write(';')
             write_result_handler(f, 'ret', cleanup, indent="\t")
 
-        f.write("\n\t// Await the reply")
+        if call.varlen:
+            f.write("\n\t// Wait for the server to be ready for the rest of the data")
+        else:
+            f.write("\n\t// Await the reply")
         func = 'ipc_receive'
         args = ['&ipc_c->imc', '&_reply', 'sizeof(_reply)']
         if call.out_handles:
@@ -203,7 +211,8 @@ def generate_client_c(file, p):
 
         for arg in call.out_args:
             f.write("\t*out_" + arg.name + " = _reply." + arg.name + ";\n")
-        f.write("\n\t" + cleanup)
+        if cleanup:
+            f.write("\n\t" + cleanup)
         f.write("\n\treturn _reply.result;\n}\n")
     f.close()
 
@@ -327,6 +336,24 @@ ipc_dispatch(volatile struct ipc_client_state *ics, ipc_command_t *ipc_command)
             f.write("\t\t\treturn XRT_ERROR_IPC_FAILURE;\n")
             f.write("\t\t}\n")
 
+        if call.varlen:
+            # Let the client know we are ready for the rest of the data,
+            # the handler receives it and sends its own replies.
+            write_invocation(
+                f,
+                'xrt_result_t sync_result',
+                'ipc_send',
+                (
+                    "(struct ipc_message_channel *)&ics->imc",
+                    "&reply",
+                    "sizeof(reply)"
+                ),
+                indent="\t\t"
+            )
+            f.write(";")
+            write_result_handler(f, "sync_result",
+                                 indent="\t\t")
+
         # Write call to ipc_handle_CALLNAME
         args = ["ics"]
         for arg in call.in_args:
@@ -342,6 +369,15 @@ ipc_dispatch(volatile struct ipc_client_state *ics, ipc_command_t *ipc_command)
         if call.in_handles:
             args.extend(("&in_%s[0]" % call.in_handles.arg_name,
                          "msg->"+call.in_handles.count_arg_name))
+        if call.varlen:
+            # Only transport errors are returned, they disconnect the client.
+            write_invocation(f, 'xrt_result_t ret', 'ipc_handle_' +
+                             call.name, args, indent="\t\t")
+            f.write(";")
+            f.write("\n\t\treturn ret;\n")
+            f.write("\t}\n")
+            continue
+
         write_invocation(f, 'reply.result', 'ipc_handle_' +
                          call.name, args, indent="\t\t")
         f.write(";\n")
@@ -353,7 +353,7 @@ scene_render_select(struct gui_scene *scene, struct gui_program *p)
 
 	if (cs->settings->camera_type == XRT_SETTINGS_CAMERA_TYPE_SLAM) {
 		struct xrt_frame_sink *tmp = cali;
-		struct xrt_slam_sinks sinks;
+		struct xrt_slam_sinks sinks = {0};
 		sinks.cam_count = 2;
 		u_sink_combiner_create(cs->xfctx, tmp, &sinks.cams[0], &sinks.cams[1]);
 
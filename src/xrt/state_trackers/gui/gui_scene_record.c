@@ -223,7 +223,8 @@ create_depthai_stereo(struct camera_window *cw)
 	// First grab the window sink.
 	struct xrt_frame_sink *tmp = &cw->base.sink;
 
-	struct xrt_slam_sinks sinks;
+	struct xrt_slam_sinks sinks = {0};
+	sinks.cam_count = 2;
 	u_sink_combiner_create(&cw->camera.xfctx, tmp, &sinks.cams[0], &sinks.cams[1]);
 
 	// Now that we have setup a node graph, start it.
@@ -18,29 +18,103 @@
 #include "oxr_subaction.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 
+static XrResult
+ensure_template_paths(struct oxr_logger *log, struct oxr_instance *inst)
+{
+	if (inst->template_paths != NULL) {
+		return XR_SUCCESS;
+	}
+
+	XrPath *paths = U_TYPED_ARRAY_CALLOC(XrPath, NUM_BINDING_PATHS);
+	for (size_t x = 0; x < NUM_BINDING_PATHS; x++) {
+		const struct binding_path *bp = &binding_paths[x];
+		XrResult ret = oxr_path_get_or_create(log, inst, bp->str, bp->length, &paths[x]);
+		if (ret != XR_SUCCESS) {
+			free(paths);
+			return ret;
+		}
+	}
+
+	inst->template_paths = paths;
+
+	return XR_SUCCESS;
+}
+
 static void
-setup_paths(struct oxr_logger *log,
-            struct oxr_instance *inst,
-            const char **src_paths,
+setup_paths(struct oxr_instance *inst,
+            const uint32_t *path_indices,
+            uint32_t path_count,
             XrPath **dest_paths,
             uint32_t *dest_path_count)
 {
-	uint32_t count = 0;
-	while (src_paths[count] != NULL) {
-		assert(count != UINT32_MAX);
-		count++;
+	*dest_path_count = path_count;
+	*dest_paths = U_TYPED_ARRAY_CALLOC(XrPath, path_count);
+
+	for (uint32_t x = 0; x < path_count; x++) {
+		(*dest_paths)[x] = inst->template_paths[path_indices[x]];
 	}
+}
 
-	*dest_path_count = count;
-	*dest_paths = U_TYPED_ARRAY_CALLOC(XrPath, count);
+static bool
+get_subaction_path_from_template(struct oxr_instance *inst,
+                                 uint32_t path_index,
+                                 enum oxr_subaction_path *out_subaction_path)
+{
+	XrPath path = inst->template_paths[path_index];
 
-	for (size_t x = 0; x < *dest_path_count; x++) {
-		const char *str = src_paths[x];
-		size_t len = strlen(str);
-		oxr_path_get_or_create(log, inst, str, len, &(*dest_paths)[x]);
+#define CHECK_SUBACTION_PATH(X, CAP, _)                                                                                \
+	if (path == inst->path_cache.X) {                                                                              \
+		*out_subaction_path = OXR_SUB_ACTION_PATH_##CAP;                                                       \
+		return true;                                                                                           \
 	}
+
+	OXR_FOR_EACH_VALID_SUBACTION_PATH_DETAILED(CHECK_SUBACTION_PATH)
+#undef CHECK_SUBACTION_PATH
+
+	return false;
+}
+
+static int
+compare_path_lookup(const void *a, const void *b)
+{
+	const struct oxr_binding_path_lookup *l = a;
+	const struct oxr_binding_path_lookup *r = b;
+
+	if (l->path != r->path) {
+		return l->path < r->path ? -1 : 1;
+	}
+	if (l->binding_index != r->binding_index) {
+		return l->binding_index < r->binding_index ? -1 : 1;
+	}
+	return 0;
+}
+
+static void
+setup_path_lookup(struct oxr_interaction_profile *p)
+{
+	size_t count = 0;
+	for (size_t x = 0; x < p->binding_count; x++) {
+		count += p->bindings[x].path_count;
+	}
+
+	p->path_lookup = U_TYPED_ARRAY_CALLOC(struct oxr_binding_path_lookup, count);
+	p->path_lookup_count = count;
+
+	size_t i = 0;
+	for (size_t x = 0; x < p->binding_count; x++) {
+		struct oxr_binding *b = &p->bindings[x];
+		for (uint32_t y = 0; y < b->path_count; y++) {
+			p->path_lookup[i].path = b->paths[y];
+			p->path_lookup[i].binding_index = (uint32_t)x;
+			p->path_lookup[i].path_index = y;
+			i++;
+		}
+	}
+
+	qsort(p->path_lookup, count, sizeof(*p->path_lookup), compare_path_lookup);
 }
 
 static bool
@@ -62,12 +136,6 @@ interaction_profile_find(struct oxr_logger *log,
 	return false;
 }
 
-static bool
-get_subaction_path_from_path(struct oxr_logger *log,
-                             struct oxr_instance *inst,
-                             XrPath path,
-                             enum oxr_subaction_path *out_subaction_path);
-
 static bool
 interaction_profile_find_or_create(struct oxr_logger *log,
                                    struct oxr_instance *inst,
@@ -78,14 +146,15 @@ interaction_profile_find_or_create(struct oxr_logger *log,
 		return true;
 	}
 
+	if (ensure_template_paths(log, inst) != XR_SUCCESS) {
+		*out_p = NULL;
+		return false;
+	}
+
 	struct profile_template *templ = NULL;
 
 	for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
-		XrPath t_path = XR_NULL_PATH;
-
-		oxr_path_get_or_create(log, inst, profile_templates[x].path, strlen(profile_templates[x].path),
-		                       &t_path);
-		if (t_path == path) {
+		if (inst->template_paths[profile_templates[x].path_index] == path) {
 			templ = &profile_templates[x];
 			break;
 		}
@@ -110,19 +179,12 @@ interaction_profile_find_or_create(struct oxr_logger *log,
 		struct binding_template *t = &templ->bindings[x];
 		struct oxr_binding *b = &p->bindings[x];
 
-		XrPath subaction_path;
-		XrResult r =
-		    oxr_path_get_or_create(log, inst, t->subaction_path, strlen(t->subaction_path), &subaction_path);
-		if (r != XR_SUCCESS) {
-			oxr_log(log, "Couldn't get subaction path %s\n", t->subaction_path);
-		}
-
-		if (!get_subaction_path_from_path(log, inst, subaction_path, &b->subaction_path)) {
+		if (!get_subaction_path_from_template(inst, t->subaction_path_index, &b->subaction_path)) {
 			oxr_log(log, "Invalid subaction path %s\n", t->subaction_path);
 		}
 
 		b->localized_name = t->localized_name;
-		setup_paths(log, inst, t->paths, &b->paths, &b->path_count);
+		setup_paths(inst, t->path_indices, t->path_count, &b->paths, &b->path_count);
 		b->input = t->input;
 		b->dpad_activate = t->dpad_activate;
 		b->output = t->output;
@@ -132,22 +194,17 @@ interaction_profile_find_or_create(struct oxr_logger *log,
 		struct dpad_emulation *t = &templ->dpads[x];
 		struct oxr_dpad_emulation *d = &p->dpads[x];
 
-		XrPath subaction_path;
-		XrResult r =
-		    oxr_path_get_or_create(log, inst, t->subaction_path, strlen(t->subaction_path), &subaction_path);
-		if (r != XR_SUCCESS) {
-			oxr_log(log, "Couldn't get subaction path %s\n", t->subaction_path);
-		}
-
-		if (!get_subaction_path_from_path(log, inst, subaction_path, &d->subaction_path)) {
+		if (!get_subaction_path_from_template(inst, t->subaction_path_index, &d->subaction_path)) {
 			oxr_log(log, "Invalid subaction path %s\n", t->subaction_path);
 		}
 
-		setup_paths(log, inst, t->paths, &d->paths, &d->path_count);
+		setup_paths(inst, t->path_indices, t->path_count, &d->paths, &d->path_count);
 		d->position = t->position;
 		d->activate = t->activate;
 	}
 
+	setup_path_lookup(p);
+
 	// Add to the list of currently created interaction profiles.
 	U_ARRAY_REALLOC_OR_FREE(inst->profiles, struct oxr_interaction_profile *, (inst->profile_count + 1));
 	inst->profiles[inst->profile_count++] = p;
@@ -176,28 +233,27 @@ reset_all_keys(struct oxr_binding *bindings, size_t binding_count)
 }
 
 static void
-add_key_to_matching_bindings(struct oxr_binding *bindings, size_t binding_count, XrPath path, uint32_t key)
+add_key_to_matching_bindings(struct oxr_interaction_profile *p, XrPath path, uint32_t key)
 {
-	for (size_t x = 0; x < binding_count; x++) {
-		struct oxr_binding *b = &bindings[x];
-
-		bool found = false;
-		uint32_t preferred_path_index;
-		for (uint32_t y = 0; y < b->path_count; y++) {
-			if (b->paths[y] == path) {
-				found = true;
-				preferred_path_index = y;
-				break;
-			}
+	// Find the first entry with the path, entries are sorted by path.
+	size_t lo = 0;
+	size_t hi = p->path_lookup_count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (p->path_lookup[mid].path < path) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
 		}
+	}
 
-		if (!found) {
-			continue;
-		}
+	// Then all bindings with that path, in binding order.
+	for (size_t x = lo; x < p->path_lookup_count && p->path_lookup[x].path == path; x++) {
+		struct oxr_binding *b = &p->bindings[p->path_lookup[x].binding_index];
 
 		U_ARRAY_REALLOC_OR_FREE(b->keys, uint32_t, (b->key_count + 1));
 		U_ARRAY_REALLOC_OR_FREE(b->preferred_binding_path_index, uint32_t, (b->key_count + 1));
-		b->preferred_binding_path_index[b->key_count] = preferred_path_index;
+		b->preferred_binding_path_index[b->key_count] = p->path_lookup[x].path_index;
 		b->keys[b->key_count++] = key;
 	}
 }
@@ -436,6 +492,10 @@ oxr_binding_destroy_all(struct oxr_logger *log, struct oxr_instance *inst)
 		p->bindings = NULL;
 		p->binding_count = 0;
 
+		free(p->path_lookup);
+		p->path_lookup = NULL;
+		p->path_lookup_count = 0;
+
 		oxr_dpad_state_deinit(&p->dpad_state);
 
 		free(p);
@@ -444,6 +504,9 @@ oxr_binding_destroy_all(struct oxr_logger *log, struct oxr_instance *inst)
 	free(inst->profiles);
 	inst->profiles = NULL;
 	inst->profile_count = 0;
+
+	free(inst->template_paths);
+	inst->template_paths = NULL;
 }
 
 
@@ -470,11 +533,8 @@ oxr_action_suggest_interaction_profile_bindings(struct oxr_logger *log,
 		goto out;
 	}
 
-	struct oxr_binding *bindings = p->bindings;
-	size_t binding_count = p->binding_count;
-
 	// Everything is now valid, reset the keys.
-	reset_all_keys(bindings, binding_count);
+	reset_all_keys(p->bindings, p->binding_count);
 	// Transfer ownership of dpad state to profile
 	oxr_dpad_state_deinit(&p->dpad_state);
 	p->dpad_state = *dpad_state;
@@ -484,7 +544,7 @@ oxr_action_suggest_interaction_profile_bindings(struct oxr_logger *log,
 		const XrActionSuggestedBinding *s = &suggestedBindings->suggestedBindings[i];
 		struct oxr_action *act = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_action *, s->action);
 
-		add_key_to_matching_bindings(bindings, binding_count, s->binding, act->act_key);
+		add_key_to_matching_bindings(p, s->binding, act->act_key);
 	}
 
 out:
@@ -51,6 +51,25 @@ oxr_handle_allocate_and_init(struct oxr_logger *log,
                              oxr_handle_destroyer destroy,
                              struct oxr_handle_base *parent,
                              void **out);
+
+/*!
+ * Allocate memory for use as a handle from @p slab, and initialize it as a
+ * handle. The destroy function must give the memory back to the same slab.
+ *
+ * Mainly for internal use - use OXR_ALLOCATE_HANDLE_FROM_SLAB instead which
+ * wraps this.
+ *
+ * @relates oxr_handle_base
+ */
+XrResult
+oxr_handle_allocate_from_slab_and_init(struct oxr_logger *log,
+                                       struct u_slab *slab,
+                                       size_t size,
+                                       uint64_t debug,
+                                       oxr_handle_destroyer destroy,
+                                       struct oxr_handle_base *parent,
+                                       void **out);
+
 /*!
  * Allocates memory for a handle and evaluates to an XrResult.
  *
@@ -90,6 +109,29 @@ oxr_handle_allocate_and_init(struct oxr_logger *log,
 		}                                                                                                      \
 	} while (0)
 
+/*!
+ * Allocate memory for a handle from a slab, returning in case of failure.
+ *
+ * @param LOG pointer to struct oxr_logger
+ * @param SLAB the @ref u_slab to allocate from, created for the handle type.
+ * @param OUT the pointer to handle struct type you already created.
+ * @param DEBUG Magic per-type debugging constant
+ * @param DESTROY Handle destructor function, must free to @p SLAB.
+ * @param PARENT a parent handle, if any
+ *
+ * Will return an XrResult from the current function if something fails.
+ *
+ * @relates oxr_handle_base
+ */
+#define OXR_ALLOCATE_HANDLE_FROM_SLAB_OR_RETURN(LOG, SLAB, OUT, DEBUG, DESTROY, PARENT)                                 \
+	do {                                                                                                           \
+		XrResult allocResult = oxr_handle_allocate_from_slab_and_init(LOG, SLAB, sizeof(*OUT), DEBUG, DESTROY, \
+		                                                              PARENT, (void **)&OUT);                  \
+		if (allocResult != XR_SUCCESS) {                                                                       \
+			return allocResult;                                                                            \
+		}                                                                                                      \
+	} while (0)
+
 #ifdef __cplusplus
 }
 #endif
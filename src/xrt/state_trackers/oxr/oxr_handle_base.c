@@ -10,6 +10,7 @@
 
 #include "util/u_debug.h"
 #include "util/u_misc.h"
+#include "util/u_slab.h"
 
 #include "oxr_objects.h"
 #include "oxr_logger.h"
@@ -122,6 +123,31 @@ oxr_handle_allocate_and_init(struct oxr_logger *log,
 	return result;
 }
 
+XrResult
+oxr_handle_allocate_from_slab_and_init(struct oxr_logger *log,
+                                       struct u_slab *slab,
+                                       size_t size,
+                                       uint64_t debug,
+                                       oxr_handle_destroyer destroy,
+                                       struct oxr_handle_base *parent,
+                                       void **out)
+{
+	assert(size <= slab->object_size);
+
+	struct oxr_handle_base *hb = (struct oxr_handle_base *)u_slab_alloc(slab);
+	if (hb == NULL) {
+		return oxr_error(log, XR_ERROR_OUT_OF_MEMORY, "Failed to allocate handle");
+	}
+
+	XrResult result = oxr_handle_init(log, hb, debug, destroy, parent);
+	if (result != XR_SUCCESS) {
+		u_slab_free(slab, hb);
+		return result;
+	}
+	*out = (void *)hb;
+	return result;
+}
+
 /*!
  * This is the actual recursive call that destroys handles.
  *
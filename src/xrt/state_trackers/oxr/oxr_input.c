@@ -47,19 +47,16 @@ oxr_session_get_action_attachment(struct oxr_session *sess,
 static void
 oxr_action_cache_update(struct oxr_logger *log,
                         struct oxr_session *sess,
-                        uint32_t countActionSets,
-                        const XrActiveActionSet *actionSets,
+                        struct oxr_action_sync_plan *plan,
                         struct oxr_action_attachment *act_attached,
                         struct oxr_action_cache *cache,
                         int64_t time,
-                        struct oxr_subaction_paths *subaction_path,
                         bool select);
 
 static void
 oxr_action_attachment_update(struct oxr_logger *log,
                              struct oxr_session *sess,
-                             uint32_t countActionSets,
-                             const XrActiveActionSet *actionSets,
+                             struct oxr_action_sync_plan *plan,
                              struct oxr_action_attachment *act_attached,
                              int64_t time,
                              struct oxr_subaction_paths subaction_paths);
@@ -227,7 +224,7 @@ oxr_action_set_destroy_cb(struct oxr_logger *log, struct oxr_handle_base *hb)
 		act_set->loc_item = NULL;
 	}
 
-	free(act_set);
+	u_slab_free(&act_set->inst->slabs.action_sets, act_set);
 
 	return XR_SUCCESS;
 }
@@ -243,7 +240,8 @@ oxr_action_set_create(struct oxr_logger *log,
 	int h_ret;
 
 	struct oxr_action_set *act_set = NULL;
-	OXR_ALLOCATE_HANDLE_OR_RETURN(log, act_set, OXR_XR_DEBUG_ACTIONSET, oxr_action_set_destroy_cb, &inst->handle);
+	OXR_ALLOCATE_HANDLE_FROM_SLAB_OR_RETURN(log, &inst->slabs.action_sets, act_set, OXR_XR_DEBUG_ACTIONSET,
+	                                        oxr_action_set_destroy_cb, &inst->handle);
 
 	struct oxr_action_set_ref *act_set_ref = U_TYPED_CALLOC(struct oxr_action_set_ref);
 	act_set_ref->base.destroy = oxr_action_set_ref_destroy_cb;
@@ -313,7 +311,7 @@ oxr_action_destroy_cb(struct oxr_logger *log, struct oxr_handle_base *hb)
 		act->loc_item = NULL;
 	}
 
-	free(act);
+	u_slab_free(&act->act_set->inst->slabs.actions, act);
 
 	return XR_SUCCESS;
 }
@@ -336,7 +334,8 @@ oxr_action_create(struct oxr_logger *log,
 	}
 
 	struct oxr_action *act = NULL;
-	OXR_ALLOCATE_HANDLE_OR_RETURN(log, act, OXR_XR_DEBUG_ACTION, oxr_action_destroy_cb, &act_set->handle);
+	OXR_ALLOCATE_HANDLE_FROM_SLAB_OR_RETURN(log, &inst->slabs.actions, act, OXR_XR_DEBUG_ACTION,
+	                                        oxr_action_destroy_cb, &act_set->handle);
 
 
 	struct oxr_action_ref *act_ref = U_TYPED_CALLOC(struct oxr_action_ref);
@@ -894,40 +893,154 @@ oxr_input_supressed(struct oxr_session *sess,
 	return false;
 }
 
+/*!
+ * Returns the bit of the system device @p xdev, or all bits if the device isn't
+ * a system device, those are then treated as always changing.
+ */
+static uint32_t
+oxr_action_sync_plan_device_bit(struct oxr_session *sess, struct xrt_device *xdev)
+{
+	struct xrt_system_devices *xsysd = sess->sys->xsysd;
+
+	for (size_t i = 0; i < xsysd->xdev_count; i++) {
+		if (xdev != NULL && xsysd->xdevs[i] == xdev) {
+			return 1u << i;
+		}
+	}
+
+	return UINT32_MAX;
+}
+
+static void
+oxr_action_sync_plan_add_cache(struct oxr_session *sess,
+                               struct oxr_action_sync_plan *plan,
+                               uint32_t countActionSets,
+                               const XrActiveActionSet *actionSets,
+                               struct oxr_action_attachment *act_attached,
+                               struct oxr_action_cache *cache,
+                               struct oxr_subaction_paths *subaction_path)
+{
+	cache->plan_first_input = plan->input_count;
+	cache->plan_input_count = 0;
+	cache->plan_device_mask = 0;
+
+	for (size_t i = 0; i < cache->input_count; i++) {
+		struct oxr_action_input *action_input = &cache->inputs[i];
+
+		// suppress input if it is also bound to action in set with
+		// higher priority
+		if (oxr_input_supressed(sess, countActionSets, actionSets, subaction_path, act_attached,
+		                        action_input)) {
+			continue;
+		}
+
+		plan->inputs[plan->input_count++] = action_input;
+		cache->plan_input_count++;
+		cache->plan_device_mask |= oxr_action_sync_plan_device_bit(sess, action_input->xdev);
+	}
+}
+
 static bool
-oxr_input_combine_input(struct oxr_session *sess,
-                        uint32_t countActionSets,
-                        const XrActiveActionSet *actionSets,
-                        struct oxr_action_attachment *act_attached,
-                        struct oxr_subaction_paths *subaction_path,
+oxr_action_sync_plan_matches(struct oxr_action_sync_plan *plan,
+                             uint32_t countActionSets,
+                             const XrActiveActionSet *actionSets)
+{
+	if (!plan->valid || plan->active_set_count != countActionSets) {
+		return false;
+	}
+
+	for (uint32_t i = 0; i < countActionSets; i++) {
+		if (plan->active_sets[i].actionSet != actionSets[i].actionSet ||
+		    plan->active_sets[i].subactionPath != actionSets[i].subactionPath) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*!
+ * Resolves input suppression for the given active action sets, storing the
+ * remaining inputs of each action cache in @p plan. Requires the requested
+ * subaction paths of the action set attachments to be updated.
+ *
+ * @private @memberof oxr_session
+ */
+static void
+oxr_action_sync_plan_compile(struct oxr_session *sess,
+                             struct oxr_action_sync_plan *plan,
+                             uint32_t countActionSets,
+                             const XrActiveActionSet *actionSets)
+{
+	// Inputs can't change after attaching, count all of them for the size.
+	uint32_t total_input_count = 0;
+	for (size_t i = 0; i < sess->action_set_attachment_count; i++) {
+		struct oxr_action_set_attachment *act_set_attached = &sess->act_set_attachments[i];
+
+		for (size_t k = 0; k < act_set_attached->action_attachment_count; k++) {
+			struct oxr_action_attachment *act_attached = &act_set_attached->act_attachments[k];
+
+#define COUNT_INPUTS(X) total_input_count += (uint32_t)act_attached->X.input_count;
+			OXR_FOR_EACH_VALID_SUBACTION_PATH(COUNT_INPUTS)
+#undef COUNT_INPUTS
+		}
+	}
+
+	U_ARRAY_REALLOC_OR_FREE(plan->inputs, struct oxr_action_input *, total_input_count + 1);
+	U_ARRAY_REALLOC_OR_FREE(plan->active_sets, XrActiveActionSet, countActionSets + 1);
+	for (uint32_t i = 0; i < countActionSets; i++) {
+		plan->active_sets[i] = actionSets[i];
+	}
+	plan->active_set_count = countActionSets;
+	plan->input_count = 0;
+
+	for (size_t i = 0; i < sess->action_set_attachment_count; i++) {
+		struct oxr_action_set_attachment *act_set_attached = &sess->act_set_attachments[i];
+
+		for (size_t k = 0; k < act_set_attached->action_attachment_count; k++) {
+			struct oxr_action_attachment *act_attached = &act_set_attached->act_attachments[k];
+
+#define ADD_CACHE(X)                                                                                                   \
+	{                                                                                                              \
+		struct oxr_subaction_paths subaction_paths_##X = {0};                                                  \
+		subaction_paths_##X.X = true;                                                                          \
+		oxr_action_sync_plan_add_cache(sess, plan, countActionSets, actionSets, act_attached,                  \
+		                               &act_attached->X, &subaction_paths_##X);                                \
+	}
+			OXR_FOR_EACH_VALID_SUBACTION_PATH(ADD_CACHE)
+#undef ADD_CACHE
+		}
+	}
+
+	assert(plan->input_count <= total_input_count);
+	plan->valid = true;
+	plan->reused = false;
+}
+
+static bool
+oxr_input_combine_input(struct oxr_action_sync_plan *plan,
                         struct oxr_action_cache *cache,
                         struct oxr_input_value_tagged *out_input,
                         int64_t *timestamp,
                         bool *is_active)
 {
-	struct oxr_action_input *inputs = cache->inputs;
-	size_t input_count = cache->input_count;
-
-	if (input_count == 0) {
+	if (cache->input_count == 0) {
 		*is_active = false;
 		return true;
 	}
 
+	// Inputs suppressed by higher priority action sets are not in the plan.
+	struct oxr_action_input **inputs = &plan->inputs[cache->plan_first_input];
+	size_t input_count = cache->plan_input_count;
+
 	bool any_active = false;
 	struct oxr_input_value_tagged res = {0};
-	int64_t res_timestamp = inputs[0].input->timestamp;
+	int64_t res_timestamp = cache->inputs[0].input->timestamp;
 
 	for (size_t i = 0; i < input_count; i++) {
-		struct oxr_action_input *action_input = &(inputs[i]);
+		struct oxr_action_input *action_input = inputs[i];
 		struct xrt_input *input = action_input->input;
 
-		// suppress input if it is also bound to action in set with
-		// higher priority
-		if (oxr_input_supressed(sess, countActionSets, actionSets, subaction_path, act_attached,
-		                        action_input)) {
-			continue;
-		}
-
 		if (input->active) {
 			any_active = true;
 		} else {
@@ -1009,12 +1122,10 @@ oxr_input_combine_input(struct oxr_session *sess,
 static void
 oxr_action_cache_update(struct oxr_logger *log,
                         struct oxr_session *sess,
-                        uint32_t countActionSets,
-                        const XrActiveActionSet *actionSets,
+                        struct oxr_action_sync_plan *plan,
                         struct oxr_action_attachment *act_attached,
                         struct oxr_action_cache *cache,
                         int64_t time,
-                        struct oxr_subaction_paths *subaction_path,
                         bool selected)
 {
 	struct oxr_action_state last = cache->current;
@@ -1027,6 +1138,15 @@ oxr_action_cache_update(struct oxr_logger *log,
 		return;
 	}
 
+	/*
+	 * Same plan as last sync and none of the devices has new inputs, this
+	 * would combine to the same values, so only clear the changed flag.
+	 */
+	if (cache->input_count > 0 && plan->reused && (cache->plan_device_mask & plan->changed_device_mask) == 0) {
+		cache->current.changed = false;
+		return;
+	}
+
 	struct oxr_input_value_tagged combined;
 	int64_t timestamp;
 	bool is_active;
@@ -1039,8 +1159,7 @@ oxr_action_cache_update(struct oxr_logger *log,
 		}
 	} else if (cache->input_count > 0) {
 
-		if (!oxr_input_combine_input(sess, countActionSets, actionSets, act_attached, subaction_path, cache,
-		                             &combined, &timestamp, &is_active)) {
+		if (!oxr_input_combine_input(plan, cache, &combined, &timestamp, &is_active)) {
 			oxr_log(log, "Failed to get/combine input values '%s'", act_attached->act_ref->name);
 			return;
 		}
@@ -1147,8 +1266,7 @@ oxr_action_cache_update(struct oxr_logger *log,
 static void
 oxr_action_attachment_update(struct oxr_logger *log,
                              struct oxr_session *sess,
-                             uint32_t countActionSets,
-                             const XrActiveActionSet *actionSets,
+                             struct oxr_action_sync_plan *plan,
                              struct oxr_action_attachment *act_attached,
                              int64_t time,
                              struct oxr_subaction_paths subaction_paths)
@@ -1161,11 +1279,8 @@ oxr_action_attachment_update(struct oxr_logger *log,
 	//! @todo "/user" sub-action path.
 
 #define UPDATE_SELECT(X)                                                                                               \
-	struct oxr_subaction_paths subaction_paths_##X = {0};                                                          \
-	subaction_paths_##X.X = true;                                                                                  \
 	bool select_##X = subaction_paths.X || subaction_paths.any;                                                    \
-	oxr_action_cache_update(log, sess, countActionSets, actionSets, act_attached, &act_attached->X, time,          \
-	                        &subaction_paths_##X, select_##X);
+	oxr_action_cache_update(log, sess, plan, act_attached, &act_attached->X, time, select_##X);
 
 	OXR_FOR_EACH_VALID_SUBACTION_PATH(UPDATE_SELECT)
 #undef UPDATE_SELECT
@@ -1505,6 +1620,9 @@ oxr_session_attach_action_sets(struct oxr_logger *log,
 	OXR_FOR_EACH_VALID_SUBACTION_PATH(FIND_PROFILE)
 #undef FIND_PROFILE
 
+	// Bindings are set up below, any compiled sync plan is out of date.
+	sess->sync_plan.valid = false;
+
 	// Allocate room for list. No need to check if anything has been
 	// attached the API function does that.
 	sess->action_set_attachment_count = bindInfo->countActionSets;
@@ -1573,9 +1691,23 @@ oxr_action_sync_data(struct oxr_logger *log,
 	// Synchronize outputs to this time.
 	int64_t now = time_state_get_now(sess->sys->inst->timekeeping);
 
-	// Loop over all xdev devices.
+	// Loop over all xdev devices, skipping those that says nothing changed.
+	uint32_t changed_device_mask = 0;
 	for (size_t i = 0; i < sess->sys->xsysd->xdev_count; i++) {
-		oxr_xdev_update(sess->sys->xsysd->xdevs[i]);
+		struct xrt_device *xdev = sess->sys->xsysd->xdevs[i];
+		if (xdev == NULL) {
+			continue;
+		}
+
+		// Loaded before updating, see xrt_device::input_generation.
+		uint64_t generation = xrt_atomic_u64_load(&xdev->input_generation);
+		if (generation != 0 && generation == sess->xdev_input_generations[i]) {
+			continue;
+		}
+
+		oxr_xdev_update(xdev);
+		sess->xdev_input_generations[i] = generation;
+		changed_device_mask |= 1u << i;
 	}
 
 	// Reset all action set attachments.
@@ -1625,6 +1757,15 @@ oxr_action_sync_data(struct oxr_logger *log,
 		}
 	}
 
+	// Suppression only changes with the active action sets, compile it once.
+	struct oxr_action_sync_plan *plan = &sess->sync_plan;
+	if (oxr_action_sync_plan_matches(plan, countActionSets, actionSets)) {
+		plan->reused = true;
+	} else {
+		oxr_action_sync_plan_compile(sess, plan, countActionSets, actionSets);
+	}
+	plan->changed_device_mask = changed_device_mask;
+
 	// Now, update all action attachments
 	for (size_t i = 0; i < sess->action_set_attachment_count; ++i) {
 		act_set_attached = &sess->act_set_attachments[i];
@@ -1638,8 +1779,7 @@ oxr_action_sync_data(struct oxr_logger *log,
 				continue;
 			}
 
-			oxr_action_attachment_update(log, sess, countActionSets, actionSets, act_attached, now,
-			                             subaction_paths);
+			oxr_action_attachment_update(log, sess, plan, act_attached, now, subaction_paths);
 		}
 	}
 
@@ -67,6 +67,10 @@ oxr_instance_destroy(struct oxr_logger *log, struct oxr_handle_base *hb)
 	u_hashset_destroy(&inst->action_sets.name_store);
 	u_hashset_destroy(&inst->action_sets.loc_store);
 
+	// All action sets and actions has been destroyed as child handles.
+	u_slab_fini(&inst->slabs.action_sets);
+	u_slab_fini(&inst->slabs.actions);
+
 	xrt_space_overseer_destroy(&inst->system.xso);
 	xrt_system_devices_destroy(&inst->system.xsysd);
 
@@ -179,6 +183,16 @@ oxr_instance_create(struct oxr_logger *log,
 
 	OXR_ALLOCATE_HANDLE_OR_RETURN(log, inst, OXR_XR_DEBUG_INSTANCE, oxr_instance_destroy, NULL);
 
+	// Needs to be done first, destroy always cleans these up.
+	if (U_SLAB_INIT_TYPED(&inst->slabs.action_sets, struct oxr_action_set, 0) != 0 ||
+	    U_SLAB_INIT_TYPED(&inst->slabs.actions, struct oxr_action, 0) != 0) {
+		// Nothing else is set up yet, fini is safe on a failed slab.
+		u_slab_fini(&inst->slabs.action_sets);
+		u_slab_fini(&inst->slabs.actions);
+		free(inst);
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to init action slabs");
+	}
+
 	inst->extensions = *extensions; // Sets the enabled extensions.
 	inst->lifecycle_verbose = debug_get_bool_option_lifecycle_verbose();
 	inst->debug_spaces = debug_get_bool_option_debug_spaces();
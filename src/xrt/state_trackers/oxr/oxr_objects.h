@@ -25,6 +25,7 @@
 #include "util/u_index_fifo.h"
 #include "util/u_hashset.h"
 #include "util/u_hashmap.h"
+#include "util/u_slab.h"
 #include "util/u_device.h"
 
 #include "oxr_extension_support.h"
@@ -119,6 +120,7 @@ struct oxr_interaction_profile;
 struct oxr_action_set_ref;
 struct oxr_action_ref;
 struct oxr_hand_tracker;
+struct oxr_path_chunk;
 
 #define XRT_MAX_HANDLE_CHILDREN 256
 #define OXR_MAX_BINDINGS_PER_ACTION 16
@@ -1316,6 +1318,13 @@ struct oxr_instance
 		struct u_hashset *loc_store;
 	} action_sets;
 
+	//! Memory for action set and action handles, freed with the instance.
+	struct
+	{
+		struct u_slab action_sets;
+		struct u_slab actions;
+	} slabs;
+
 	//! Path store, for looking up paths.
 	struct u_hashset *path_store;
 	//! Mapping from ID to path.
@@ -1324,6 +1333,8 @@ struct oxr_instance
 	size_t path_array_length;
 	//! Number of paths in the array (0 is always null).
 	size_t path_num;
+	//! Arena chunks that all paths are allocated from.
+	struct oxr_path_chunk *path_chunks;
 
 	// Event queue.
 	struct
@@ -1337,6 +1348,13 @@ struct oxr_instance
 	struct oxr_interaction_profile **profiles;
 	size_t profile_count;
 
+	/*!
+	 * Interned paths of all strings used by the generated profile
+	 * templates, indexed the same as the generated path table. Created
+	 * the first time bindings are suggested.
+	 */
+	XrPath *template_paths;
+
 	struct oxr_session *sessions;
 
 	struct
@@ -1399,6 +1417,76 @@ struct oxr_instance
 #endif
 };
 
+/*!
+ * The inputs that xrSyncActions reads for a given list of active action sets,
+ * with the inputs suppressed by higher priority action sets already removed.
+ * Inputs are stored contiguously per @ref oxr_action_cache. The plan is only
+ * rebuilt when the list of active action sets changes; bindings can not change
+ * once the action sets have been attached.
+ *
+ * @ingroup oxr_input
+ */
+struct oxr_action_sync_plan
+{
+	//! Has the plan been compiled.
+	bool valid;
+
+	//! The active action sets the plan was compiled for.
+	XrActiveActionSet *active_sets;
+	uint32_t active_set_count;
+
+	//! Not suppressed inputs, referenced by @ref oxr_action_cache.
+	struct oxr_action_input **inputs;
+	uint32_t input_count;
+
+	//! Was the plan also used for the previous sync.
+	bool reused;
+
+	//! Devices that had their inputs updated during this sync.
+	uint32_t changed_device_mask;
+};
+
+#define OXR_LAYER_CACHE_SIZE (16)
+
+/*!
+ * Copy of a layer that passed validation, including the projection views.
+ */
+struct oxr_layer_cache_entry
+{
+	bool valid;
+
+	union {
+		XrCompositionLayerBaseHeader base;
+		XrCompositionLayerProjection proj;
+		XrCompositionLayerQuad quad;
+		XrCompositionLayerCubeKHR cube;
+		XrCompositionLayerCylinderKHR cylinder;
+		XrCompositionLayerEquirectKHR equirect1;
+		XrCompositionLayerEquirect2KHR equirect2;
+	} layer;
+
+	XrCompositionLayerProjectionView views[2];
+};
+
+/*!
+ * State kept between calls to xrEndFrame, so layers that are the same as in
+ * the previous frame only need their swapchain state checked. Cleared when a
+ * swapchain is destroyed, as a new one could reuse the handle.
+ */
+struct oxr_layer_cache
+{
+	//! Layers from the previous frame, by layer index.
+	struct oxr_layer_cache_entry layers[OXR_LAYER_CACHE_SIZE];
+
+	//! Spaces located relative to the head during this frame.
+	struct
+	{
+		struct oxr_space *spc;
+		struct xrt_space_relation T_space_xdev;
+	} spaces[OXR_LAYER_CACHE_SIZE];
+	uint32_t space_count;
+};
+
 /*!
  * Object that client program interact with.
  *
@@ -1486,6 +1574,20 @@ struct oxr_session
 	 */
 	struct u_hashmap_int *act_attachments_by_key;
 
+	//! Compiled inputs for the last list of action sets synced.
+	struct oxr_action_sync_plan sync_plan;
+
+	//! Memory for space handles, freed with the session.
+	struct
+	{
+		struct u_slab spaces;
+	} slabs;
+
+	//! Last seen @ref xrt_device::input_generation, per system device.
+	uint64_t xdev_input_generations[XRT_SYSTEM_MAX_DEVICES];
+
+	//! Validated layers and located spaces used by xrEndFrame.
+	struct oxr_layer_cache layer_cache;
 
 	/*!
 	 * Currently bound interaction profile.
@@ -1621,6 +1723,20 @@ struct oxr_dpad_emulation
 /*!
  * A single interaction profile.
  */
+/*!
+ * Entry in the sorted path lookup table of a @ref oxr_interaction_profile.
+ */
+struct oxr_binding_path_lookup
+{
+	XrPath path;
+
+	//! Index of the binding that has this path.
+	uint32_t binding_index;
+
+	//! Index of this path in the bindings paths array.
+	uint32_t path_index;
+};
+
 struct oxr_interaction_profile
 {
 	XrPath path;
@@ -1637,6 +1753,10 @@ struct oxr_interaction_profile
 	struct oxr_dpad_emulation *dpads;
 	size_t dpad_count;
 
+	//! All paths of all bindings, sorted by path then binding index.
+	struct oxr_binding_path_lookup *path_lookup;
+	size_t path_lookup_count;
+
 	struct oxr_dpad_state dpad_state;
 };
 
@@ -1833,6 +1953,13 @@ struct oxr_action_cache
 	size_t input_count;
 	struct oxr_action_input *inputs;
 
+	//! Range of not suppressed inputs in @ref oxr_session::sync_plan.
+	uint32_t plan_first_input;
+	uint32_t plan_input_count;
+
+	//! Bit per index in xrt_system_devices::xdevs that the inputs come from.
+	uint32_t plan_device_mask;
+
 	int64_t stop_output_time;
 	size_t output_count;
 	struct oxr_action_output *outputs;
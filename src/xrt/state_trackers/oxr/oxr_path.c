@@ -31,6 +31,23 @@ struct oxr_path
 	void *attached;
 };
 
+/*!
+ * Paths are never freed individually, so they are bump allocated out of
+ * chunks that are all freed when the instance is destroyed.
+ *
+ * @ingroup oxr_main
+ */
+struct oxr_path_chunk
+{
+	struct oxr_path_chunk *next;
+	size_t used;
+	size_t size;
+};
+
+#define OXR_PATH_CHUNK_SIZE (64 * 1024)
+#define OXR_PATH_ALIGNMENT (8)
+#define OXR_PATH_INITIAL_COUNT (1024)
+
 
 /*
  *
@@ -56,6 +73,36 @@ from_item(struct u_hashset_item *item)
 	return &((struct oxr_path *)item)[-1];
 }
 
+static void *
+arena_alloc(struct oxr_instance *inst, size_t size)
+{
+	size = (size + OXR_PATH_ALIGNMENT - 1) & ~((size_t)OXR_PATH_ALIGNMENT - 1);
+
+	struct oxr_path_chunk *chunk = inst->path_chunks;
+	if (chunk == NULL || chunk->size - chunk->used < size) {
+		size_t chunk_size = OXR_PATH_CHUNK_SIZE;
+		if (chunk_size < sizeof(*chunk) + size) {
+			chunk_size = sizeof(*chunk) + size;
+		}
+
+		// Calloc so that the memory handed out is zeroed.
+		chunk = U_CALLOC_WITH_CAST(struct oxr_path_chunk, chunk_size);
+		if (chunk == NULL) {
+			return NULL;
+		}
+
+		chunk->next = inst->path_chunks;
+		chunk->used = sizeof(*chunk);
+		chunk->size = chunk_size;
+		inst->path_chunks = chunk;
+	}
+
+	void *ptr = (uint8_t *)chunk + chunk->used;
+	chunk->used += size;
+
+	return ptr;
+}
+
 
 /*
  *
@@ -74,8 +121,8 @@ oxr_ensure_array_length(struct oxr_logger *log, struct oxr_instance *inst, XrPat
 	}
 
 	size_t new_size = inst->path_array_length;
-	while (new_size < num) {
-		new_size += 64;
+	while (new_size <= num) {
+		new_size *= 2;
 	}
 
 	U_ARRAY_REALLOC_OR_FREE(inst->path_array, struct oxr_path *, new_size);
@@ -100,8 +147,8 @@ oxr_allocate_path(
 	size += length;                        // String.
 	size += 1;                             // Null terminate it.
 
-	// Now allocate and setup the path.
-	path = U_CALLOC_WITH_CAST(struct oxr_path, size);
+	// Now allocate and setup the path, memory comes zeroed.
+	path = (struct oxr_path *)arena_alloc(inst, size);
 	if (path == NULL) {
 		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to allocate path");
 	}
@@ -122,7 +169,7 @@ oxr_allocate_path(
 	// Insert and return.
 	ret = u_hashset_insert_item(inst->path_store, item);
 	if (ret) {
-		free(path);
+		// Stays in the arena until the instance is destroyed.
 		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to insert item");
 	}
 
@@ -137,7 +184,7 @@ oxr_allocate_path(
 struct oxr_path *
 get_path_or_null(struct oxr_logger *log, const struct oxr_instance *inst, XrPath xr_path)
 {
-	if (xr_path >= inst->path_array_length) {
+	if (xr_path >= inst->path_num) {
 		return NULL;
 	}
 
@@ -227,14 +274,6 @@ oxr_path_get_string(
 	return XR_SUCCESS;
 }
 
-void
-destroy_callback(struct u_hashset_item *item, void *priv)
-{
-	struct oxr_path *path = from_item(item);
-
-	free(path);
-}
-
 XrResult
 oxr_path_init(struct oxr_logger *log, struct oxr_instance *inst)
 {
@@ -243,7 +282,10 @@ oxr_path_init(struct oxr_logger *log, struct oxr_instance *inst)
 		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to create hashset");
 	}
 
-	size_t new_size = 64;
+	// Enough for all of the paths created by the bindings.
+	u_hashset_reserve(inst->path_store, OXR_PATH_INITIAL_COUNT);
+
+	size_t new_size = OXR_PATH_INITIAL_COUNT;
 	U_ARRAY_REALLOC_OR_FREE(inst->path_array, struct oxr_path *, new_size);
 	inst->path_array_length = new_size;
 	inst->path_num = 1; // Reserve space for XR_NULL_PATH
@@ -262,10 +304,16 @@ oxr_path_destroy(struct oxr_logger *log, struct oxr_instance *inst)
 	inst->path_num = 0;
 	inst->path_array_length = 0;
 
-	if (inst->path_store == NULL) {
-		return;
+	if (inst->path_store != NULL) {
+		u_hashset_destroy(&inst->path_store);
 	}
 
-	u_hashset_clear_and_call_for_each(inst->path_store, destroy_callback, inst);
-	u_hashset_destroy(&inst->path_store);
+	// Frees all paths, the hashset is gone so nothing points at them.
+	struct oxr_path_chunk *chunk = inst->path_chunks;
+	while (chunk != NULL) {
+		struct oxr_path_chunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	inst->path_chunks = NULL;
 }
@@ -647,6 +647,10 @@ oxr_session_destroy(struct oxr_logger *log, struct oxr_handle_base *hb)
 	sess->act_set_attachments = NULL;
 	sess->action_set_attachment_count = 0;
 
+	free(sess->sync_plan.active_sets);
+	free(sess->sync_plan.inputs);
+	U_ZERO(&sess->sync_plan);
+
 	// If we tore everything down correctly, these are empty now.
 	assert(sess->act_sets_attachments_by_key == NULL || u_hashmap_int_empty(sess->act_sets_attachments_by_key));
 	assert(sess->act_attachments_by_key == NULL || u_hashmap_int_empty(sess->act_attachments_by_key));
@@ -661,6 +665,9 @@ oxr_session_destroy(struct oxr_logger *log, struct oxr_handle_base *hb)
 	os_semaphore_destroy(&sess->sem);
 	os_mutex_destroy(&sess->active_wait_frames_lock);
 
+	// All spaces has been destroyed as child handles.
+	u_slab_fini(&sess->slabs.spaces);
+
 	free(sess);
 
 	return ret;
@@ -693,6 +700,12 @@ oxr_session_allocate_and_init(struct oxr_logger *log, struct oxr_system *sys, st
 	u_hashmap_int_create(&sess->act_sets_attachments_by_key);
 	u_hashmap_int_create(&sess->act_attachments_by_key);
 
+	// Last so destroy only sees fully initialised fields on failure.
+	if (U_SLAB_INIT_TYPED(&sess->slabs.spaces, struct oxr_space, 0) != 0) {
+		oxr_handle_destroy(log, &sess->handle);
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE, "Failed to init space slab");
+	}
+
 	// Done with basic init, set out variable.
 	*out_session = sess;
 
@@ -34,6 +34,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 #include <inttypes.h>
 
@@ -152,6 +153,24 @@ fill_in_sub_image(const struct oxr_swapchain *sc, const XrSwapchainSubImage *oxr
  *
  */
 
+static XrResult
+verify_swapchain_released(struct oxr_logger *log, uint32_t layer_index, XrSwapchain swapchain)
+{
+	struct oxr_swapchain *sc = XRT_CAST_OXR_HANDLE_TO_PTR(struct oxr_swapchain *, swapchain);
+
+	if (!sc->released.yes) {
+		return oxr_error(log, XR_ERROR_LAYER_INVALID,
+		                 "(frameEndInfo->layers[%u]) swapchain has not been released!", layer_index);
+	}
+
+	if (sc->released.index >= (int)sc->swapchain->image_count) {
+		return oxr_error(log, XR_ERROR_RUNTIME_FAILURE,
+		                 "(frameEndInfo->layers[%u]) swapchain internal image index out of bounds", layer_index);
+	}
+
+	return XR_SUCCESS;
+}
+
 static XrResult
 verify_space(struct oxr_logger *log, uint32_t layer_index, XrSpace space)
 {
@@ -821,6 +840,171 @@ verify_equirect2_layer(struct xrt_compositor *xc,
 }
 
 
+/*
+ *
+ * Layer cache functions.
+ *
+ */
+
+static size_t
+get_layer_size(XrStructureType type)
+{
+	switch (type) {
+	case XR_TYPE_COMPOSITION_LAYER_PROJECTION: return sizeof(XrCompositionLayerProjection);
+	case XR_TYPE_COMPOSITION_LAYER_QUAD: return sizeof(XrCompositionLayerQuad);
+	case XR_TYPE_COMPOSITION_LAYER_CUBE_KHR: return sizeof(XrCompositionLayerCubeKHR);
+	case XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR: return sizeof(XrCompositionLayerCylinderKHR);
+	case XR_TYPE_COMPOSITION_LAYER_EQUIRECT_KHR: return sizeof(XrCompositionLayerEquirectKHR);
+	case XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR: return sizeof(XrCompositionLayerEquirect2KHR);
+	default: return 0;
+	}
+}
+
+/*!
+ * Only layers without any chained structs are cached, the chain could have
+ * changed without the layer changing. This is called on layers that have not
+ * been verified yet, so check the views before touching them.
+ */
+static bool
+can_cache_layer(uint32_t layer_index, const XrCompositionLayerBaseHeader *layer)
+{
+	if (layer_index >= OXR_LAYER_CACHE_SIZE || layer->next != NULL) {
+		return false;
+	}
+
+	if (layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
+		const XrCompositionLayerProjection *proj = (const XrCompositionLayerProjection *)layer;
+		if (proj->viewCount != 2 || proj->views == NULL) {
+			return false;
+		}
+		return proj->views[0].next == NULL && proj->views[1].next == NULL;
+	}
+
+	return true;
+}
+
+static bool
+is_layer_cached(struct oxr_layer_cache *cache, uint32_t layer_index, const XrCompositionLayerBaseHeader *layer)
+{
+	if (!can_cache_layer(layer_index, layer)) {
+		return false;
+	}
+
+	struct oxr_layer_cache_entry *entry = &cache->layers[layer_index];
+	if (!entry->valid || entry->layer.base.type != layer->type) {
+		return false;
+	}
+
+	if (memcmp(&entry->layer, layer, get_layer_size(layer->type)) != 0) {
+		return false;
+	}
+
+	if (layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
+		const XrCompositionLayerProjection *proj = (const XrCompositionLayerProjection *)layer;
+		return memcmp(entry->views, proj->views, sizeof(entry->views)) == 0;
+	}
+
+	return true;
+}
+
+static void
+cache_layer(struct oxr_layer_cache *cache, uint32_t layer_index, const XrCompositionLayerBaseHeader *layer)
+{
+	if (!can_cache_layer(layer_index, layer)) {
+		return;
+	}
+
+	struct oxr_layer_cache_entry *entry = &cache->layers[layer_index];
+	memcpy(&entry->layer, layer, get_layer_size(layer->type));
+
+	if (layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
+		const XrCompositionLayerProjection *proj = (const XrCompositionLayerProjection *)layer;
+		memcpy(entry->views, proj->views, sizeof(entry->views));
+	}
+
+	entry->valid = true;
+}
+
+/*!
+ * The layer has already passed validation, only the swapchain state that
+ * changes every frame needs to be checked.
+ */
+static XrResult
+verify_cached_layer(struct oxr_logger *log, uint32_t layer_index, const XrCompositionLayerBaseHeader *layer)
+{
+	XrResult ret = XR_SUCCESS;
+
+	switch (layer->type) {
+	case XR_TYPE_COMPOSITION_LAYER_PROJECTION: {
+		const XrCompositionLayerProjection *proj = (const XrCompositionLayerProjection *)layer;
+		ret = verify_swapchain_released(log, layer_index, proj->views[0].subImage.swapchain);
+		if (ret == XR_SUCCESS) {
+			ret = verify_swapchain_released(log, layer_index, proj->views[1].subImage.swapchain);
+		}
+	} break;
+	case XR_TYPE_COMPOSITION_LAYER_QUAD:
+		ret = verify_swapchain_released(log, layer_index,
+		                                ((const XrCompositionLayerQuad *)layer)->subImage.swapchain);
+		break;
+	case XR_TYPE_COMPOSITION_LAYER_CUBE_KHR:
+		ret = verify_swapchain_released(log, layer_index, ((const XrCompositionLayerCubeKHR *)layer)->swapchain);
+		break;
+	case XR_TYPE_COMPOSITION_LAYER_CYLINDER_KHR:
+		ret = verify_swapchain_released(log, layer_index,
+		                                ((const XrCompositionLayerCylinderKHR *)layer)->subImage.swapchain);
+		break;
+	case XR_TYPE_COMPOSITION_LAYER_EQUIRECT_KHR:
+		ret = verify_swapchain_released(log, layer_index,
+		                                ((const XrCompositionLayerEquirectKHR *)layer)->subImage.swapchain);
+		break;
+	case XR_TYPE_COMPOSITION_LAYER_EQUIRECT2_KHR:
+		ret = verify_swapchain_released(log, layer_index,
+		                                ((const XrCompositionLayerEquirect2KHR *)layer)->subImage.swapchain);
+		break;
+	default: assert(false && "invalid layer type");
+	}
+
+	return ret;
+}
+
+/*!
+ * Locate the space relative to the head, each space is only located once per
+ * frame since all layers use the same display time.
+ */
+static bool
+locate_space_cached(struct oxr_logger *log,
+                    struct oxr_session *sess,
+                    struct oxr_space *spc,
+                    struct xrt_device *head_xdev,
+                    uint64_t timestamp,
+                    struct xrt_space_relation *out_T_space_xdev)
+{
+	struct oxr_layer_cache *cache = &sess->layer_cache;
+
+	for (uint32_t i = 0; i < cache->space_count; i++) {
+		if (cache->spaces[i].spc == spc) {
+			*out_T_space_xdev = cache->spaces[i].T_space_xdev;
+			return true;
+		}
+	}
+
+	XrResult ret = oxr_space_locate_device(log, head_xdev, spc, timestamp, out_T_space_xdev);
+	if (ret != XR_SUCCESS) {
+		return false;
+	}
+	if (out_T_space_xdev->relation_flags == 0) {
+		return false;
+	}
+
+	if (cache->space_count < ARRAY_SIZE(cache->spaces)) {
+		cache->spaces[cache->space_count].spc = spc;
+		cache->spaces[cache->space_count].T_space_xdev = *out_T_space_xdev;
+		cache->space_count++;
+	}
+
+	return true;
+}
+
 /*
  *
  * Submit functions.
@@ -873,11 +1057,7 @@ handle_space(struct oxr_logger *log,
 	struct xrt_device *head_xdev = GET_XDEV_BY_ROLE(sess->sys, head);
 	struct xrt_space_relation T_space_xdev = XRT_SPACE_RELATION_ZERO;
 
-	XrResult ret = oxr_space_locate_device(log, head_xdev, spc, timestamp, &T_space_xdev);
-	if (ret != XR_SUCCESS) {
-		return false;
-	}
-	if (T_space_xdev.relation_flags == 0) {
+	if (!locate_space_cached(log, sess, spc, head_xdev, timestamp, &T_space_xdev)) {
 		return false;
 	}
 
@@ -1355,6 +1535,15 @@ oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const Xr
 
 		XrResult res;
 
+		// Same as last frame, skip everything but the swapchain state.
+		if (is_layer_cached(&sess->layer_cache, i, layer)) {
+			res = verify_cached_layer(log, i, layer);
+			if (res != XR_SUCCESS) {
+				return res;
+			}
+			continue;
+		}
+
 		switch (layer->type) {
 		case XR_TYPE_COMPOSITION_LAYER_PROJECTION:
 			res = verify_projection_layer(xc, log, i, (XrCompositionLayerProjection *)layer, xdev,
@@ -1389,6 +1578,8 @@ oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const Xr
 		if (res != XR_SUCCESS) {
 			return res;
 		}
+
+		cache_layer(&sess->layer_cache, i, layer);
 	}
 
 
@@ -1412,6 +1603,9 @@ oxr_session_frame_end(struct oxr_logger *log, struct oxr_session *sess, const Xr
 	xret = xrt_comp_layer_begin(xc, &data);
 	OXR_CHECK_XRET(log, sess, xret, xrt_comp_layer_begin);
 
+	// Spaces are located again for every frame.
+	sess->layer_cache.space_count = 0;
+
 	for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
 		const XrCompositionLayerBaseHeader *layer = frameEndInfo->layers[i];
 		assert(layer != NULL);
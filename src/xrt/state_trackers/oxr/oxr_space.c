@@ -150,7 +150,7 @@ oxr_space_destroy(struct oxr_logger *log, struct oxr_handle_base *hb)
 	spc->action.xdev = NULL;
 	spc->action.name = 0;
 
-	free(spc);
+	u_slab_free(&spc->sess->slabs.spaces, spc);
 
 	return XR_SUCCESS;
 }
@@ -166,7 +166,8 @@ oxr_space_action_create(struct oxr_logger *log,
 	struct oxr_subaction_paths subaction_paths = {0};
 
 	struct oxr_space *spc = NULL;
-	OXR_ALLOCATE_HANDLE_OR_RETURN(log, spc, OXR_XR_DEBUG_SPACE, oxr_space_destroy, &sess->handle);
+	OXR_ALLOCATE_HANDLE_FROM_SLAB_OR_RETURN(log, &sess->slabs.spaces, spc, OXR_XR_DEBUG_SPACE, oxr_space_destroy,
+	                                        &sess->handle);
 
 	oxr_classify_subaction_paths(log, inst, 1, &createInfo->subactionPath, &subaction_paths);
 
@@ -199,7 +200,8 @@ oxr_space_reference_create(struct oxr_logger *log,
 	}
 
 	struct oxr_space *spc = NULL;
-	OXR_ALLOCATE_HANDLE_OR_RETURN(log, spc, OXR_XR_DEBUG_SPACE, oxr_space_destroy, &sess->handle);
+	OXR_ALLOCATE_HANDLE_FROM_SLAB_OR_RETURN(log, &sess->slabs.spaces, spc, OXR_XR_DEBUG_SPACE, oxr_space_destroy,
+	                                        &sess->handle);
 	spc->sess = sess;
 	spc->space_type = xr_ref_space_to_oxr(createInfo->referenceSpaceType);
 	memcpy(&spc->pose, &createInfo->poseInReferenceSpace, sizeof(spc->pose));
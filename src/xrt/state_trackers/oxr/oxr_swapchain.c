@@ -166,6 +166,9 @@ destroy_handle(struct oxr_logger *log, struct oxr_handle_base *hb)
 {
 	struct oxr_swapchain *sc = (struct oxr_swapchain *)hb;
 
+	// A new swapchain could get the same handle, so forget validated layers.
+	U_ZERO(&sc->sess->layer_cache.layers);
+
 	XrResult ret = sc->destroy(log, sc);
 	free(sc);
 	return ret;
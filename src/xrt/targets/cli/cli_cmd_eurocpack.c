@@ -0,0 +1,87 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Converts EuRoC datasets to and from packed single file datasets.
+ */
+
+#include "euroc/euroc_interface.h"
+#include "xrt/xrt_config_drivers.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define P(...) fprintf(stderr, __VA_ARGS__)
+
+#ifdef XRT_BUILD_DRIVER_EUROC
+static void
+print_stats(const struct euroc_pack_stats *s, bool measure_png)
+{
+	double n = s->frame_count > 0 ? (double)s->frame_count : 1.0;
+
+	printf("Frames:          %" PRIu64 "\n", s->frame_count);
+	printf("PNG size:        %.1f MiB\n", (double)s->png_bytes / (1024.0 * 1024.0));
+	printf("Packed size:     %.1f MiB\n", (double)s->packed_bytes / (1024.0 * 1024.0));
+	printf("PNG read:        %.3fs (%.3fms/frame)\n", s->png_read_s, s->png_read_s * 1000.0 / n);
+	printf("Packed read:     %.3fs (%.3fms/frame)\n", s->packed_read_s, s->packed_read_s * 1000.0 / n);
+	if (measure_png) {
+		printf("PNG write:       %.3fs (%.3fms/frame)\n", s->png_write_s, s->png_write_s * 1000.0 / n);
+	}
+	printf("Packed write:    %.3fs (%.3fms/frame)\n", s->packed_write_s, s->packed_write_s * 1000.0 / n);
+}
+#endif
+
+int
+cli_cmd_eurocpack(int argc, const char **argv)
+{
+#ifndef XRT_BUILD_DRIVER_EUROC
+	P("Euroc driver not built, can't convert datasets.\n");
+	return EXIT_FAILURE;
+#else
+	// Do not count "monado-cli" and "eurocpack" as args
+	int nof_args = argc - 2;
+	const char **args = &argv[2];
+
+	if (nof_args == 3 && strcmp(args[0], "--unpack") == 0) {
+		return euroc_dataset_unpack(args[1], args[2]) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	bool lz4 = false;
+	bool measure_png = false;
+	const char *paths[2] = {NULL, NULL};
+	int path_count = 0;
+
+	for (int i = 0; i < nof_args; i++) {
+		if (strcmp(args[i], "--lz4") == 0) {
+			lz4 = true;
+		} else if (strcmp(args[i], "--bench") == 0) {
+			measure_png = true;
+		} else if (path_count < 2) {
+			paths[path_count++] = args[i];
+		} else {
+			path_count++;
+		}
+	}
+
+	if (path_count != 2) {
+		P("Converts EuRoC datasets to and from packed single file datasets.\n");
+		P("Usage: %s %s <euroc_path> <packed_file> [--lz4] [--bench]\n", argv[0], argv[1]);
+		P("       %s %s --unpack <packed_file> <euroc_path>\n", argv[0], argv[1]);
+		P("\n");
+		P("  --lz4   - Compress frames with LZ4.\n");
+		P("  --bench - Also time encoding every frame as PNG.\n");
+		return EXIT_FAILURE;
+	}
+
+	struct euroc_pack_stats stats;
+	if (!euroc_dataset_pack(paths[0], paths[1], lz4, measure_png, &stats)) {
+		return EXIT_FAILURE;
+	}
+
+	print_stats(&stats, measure_png);
+
+	return EXIT_SUCCESS;
+#endif
+}
@@ -0,0 +1,536 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Replays a EuRoC dataset through Mercury hand tracking and reports its performance.
+ */
+
+#include "euroc/euroc_interface.h"
+#include "os/os_threading.h"
+#include "os/os_time.h"
+#include "math/m_api.h"
+#include "math/m_vec3.h"
+#include "util/u_file.h"
+#include "util/u_frame.h"
+#include "util/u_json.h"
+#include "util/u_logging.h"
+#include "util/u_misc.h"
+#include "xrt/xrt_config_drivers.h"
+#include "xrt/xrt_frameserver.h"
+#include "xrt/xrt_tracking.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define P(...) fprintf(stderr, __VA_ARGS__)
+#define I(...) U_LOG(U_LOGGING_INFO, __VA_ARGS__)
+
+#if defined(XRT_BUILD_DRIVER_HANDTRACKING) && defined(XRT_BUILD_DRIVER_EUROC)
+
+#include "tracking/t_tracking.h"
+#include "tracking/t_hand_tracking.h"
+#include "hg_interface.h"
+
+static bool should_exit = false;
+
+static void *
+wait_for_exit_key(void *ptr)
+{
+	getchar();
+	should_exit = true;
+	return NULL;
+}
+
+//! Per frame stage timings, in milliseconds
+enum stage
+{
+	STAGE_DETECTION,
+	STAGE_KEYPOINT,
+	STAGE_OPTIMIZE,
+	STAGE_TOTAL,
+	STAGE_COUNT,
+};
+
+static const char *stage_names[STAGE_COUNT] = {"detection_ms", "keypoint_ms", "optimize_ms", "total_ms"};
+
+//! A growable list of values to compute statistics of
+struct series
+{
+	float *values;
+	size_t count;
+	size_t capacity;
+};
+
+struct series_stats
+{
+	size_t count;
+	double mean;
+	double p50;
+	double p95;
+	double max;
+};
+
+//! Last two tracked joint positions of a hand, to tell jitter from motion
+struct hand_history
+{
+	struct xrt_vec3 joints[2][XRT_HAND_JOINT_COUNT];
+	uint64_t timestamps[2];
+	int count; //!< Consecutive processed frames the hand was tracked in, up to 2
+};
+
+struct htbench
+{
+	struct xrt_frame_bundle_sink bundle_sink;
+
+	struct t_hand_tracking_sync *sync;
+
+	//! If true frames are processed by the worker and dropped while it is busy, like the async wrapper does
+	bool realtime;
+
+	//! Only used when realtime, protects everything below it
+	struct os_thread_helper worker;
+	struct xrt_frame *frames[2];
+	bool busy;
+
+	uint64_t received;
+	uint64_t processed;
+	uint64_t dropped;
+	uint64_t first_ns;
+	uint64_t last_ns;
+
+	struct series stages[STAGE_COUNT];
+	struct series jitter_mm;
+	uint64_t tracked[2];
+	struct hand_history history[2];
+};
+
+static void
+series_push(struct series *s, float value)
+{
+	if (s->count == s->capacity) {
+		s->capacity = MAX(s->capacity * 2, 1024);
+		U_ARRAY_REALLOC_OR_FREE(s->values, float, s->capacity);
+	}
+	s->values[s->count++] = value;
+}
+
+static int
+compare_floats(const void *a, const void *b)
+{
+	float fa = *(const float *)a;
+	float fb = *(const float *)b;
+	return (fa > fb) - (fa < fb);
+}
+
+//! Sorts the values of @p s in place
+static struct series_stats
+series_get_stats(struct series *s)
+{
+	struct series_stats stats = {0};
+	stats.count = s->count;
+	if (s->count == 0) {
+		return stats;
+	}
+
+	qsort(s->values, s->count, sizeof(float), compare_floats);
+
+	double sum = 0;
+	for (size_t i = 0; i < s->count; i++) {
+		sum += s->values[i];
+	}
+
+	stats.mean = sum / (double)s->count;
+	stats.p50 = s->values[s->count / 2];
+	stats.p95 = s->values[MIN(s->count - 1, s->count * 95 / 100)];
+	stats.max = s->values[s->count - 1];
+	return stats;
+}
+
+/*!
+ * How far the joints of a hand are from where they would be if they had kept
+ * the velocity of the last two tracked frames, averaged over the joints. A
+ * still or smoothly moving hand scores zero, so this is mostly noise.
+ */
+static void
+record_hand(struct htbench *hb, int hand_idx, const struct xrt_hand_joint_set *set, uint64_t timestamp_ns)
+{
+	struct hand_history *h = &hb->history[hand_idx];
+
+	if (!set->is_active) {
+		h->count = 0;
+		return;
+	}
+
+	hb->tracked[hand_idx]++;
+
+	struct xrt_vec3 joints[XRT_HAND_JOINT_COUNT];
+	for (int i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+		joints[i] = set->values.hand_joint_set_default[i].relation.pose.position;
+	}
+
+	uint64_t dt_prev = h->timestamps[1] - h->timestamps[0];
+	uint64_t dt_now = timestamp_ns - h->timestamps[1];
+
+	if (h->count == 2 && dt_prev > 0 && dt_now > 0) {
+		float t = (float)((double)dt_now / (double)dt_prev);
+		float error = 0;
+		for (int i = 0; i < XRT_HAND_JOINT_COUNT; i++) {
+			struct xrt_vec3 velocity = m_vec3_sub(h->joints[1][i], h->joints[0][i]);
+			struct xrt_vec3 predicted = m_vec3_add(h->joints[1][i], m_vec3_mul_scalar(velocity, t));
+			error += m_vec3_len(m_vec3_sub(joints[i], predicted));
+		}
+		series_push(&hb->jitter_mm, error / XRT_HAND_JOINT_COUNT * 1000.0f);
+	}
+
+	memcpy(h->joints[0], h->joints[1], sizeof(h->joints[0]));
+	memcpy(h->joints[1], joints, sizeof(h->joints[1]));
+	h->timestamps[0] = h->timestamps[1];
+	h->timestamps[1] = timestamp_ns;
+	h->count = MIN(h->count + 1, 2);
+}
+
+static void
+process_frames(struct htbench *hb, struct xrt_frame *left, struct xrt_frame *right)
+{
+	struct xrt_hand_joint_set hands[2] = {0};
+	uint64_t timestamp_ns = 0;
+
+	uint64_t start_ns = os_monotonic_get_ns();
+	t_ht_sync_process(hb->sync, left, right, &hands[0], &hands[1], &timestamp_ns);
+	uint64_t end_ns = os_monotonic_get_ns();
+
+	if (timestamp_ns == 0) {
+		// The tracker gave up on these frames.
+		return;
+	}
+
+	struct t_hand_tracking_mercury_timings timings;
+	t_hand_tracking_sync_mercury_get_timings(hb->sync, &timings);
+
+	series_push(&hb->stages[STAGE_DETECTION], timings.detection_ms);
+	series_push(&hb->stages[STAGE_KEYPOINT], timings.keypoint_ms);
+	series_push(&hb->stages[STAGE_OPTIMIZE], timings.optimize_ms);
+	series_push(&hb->stages[STAGE_TOTAL], (float)time_ns_to_ms_f(end_ns - start_ns));
+
+	record_hand(hb, 0, &hands[0], timestamp_ns);
+	record_hand(hb, 1, &hands[1], timestamp_ns);
+
+	if (hb->processed == 0) {
+		hb->first_ns = start_ns;
+	}
+	hb->last_ns = end_ns;
+	hb->processed++;
+}
+
+static void *
+run_worker(void *ptr)
+{
+	struct htbench *hb = (struct htbench *)ptr;
+
+	os_thread_helper_lock(&hb->worker);
+
+	while (os_thread_helper_is_running_locked(&hb->worker)) {
+		if (hb->frames[0] == NULL) {
+			os_thread_helper_wait_locked(&hb->worker);
+			continue;
+		}
+
+		struct xrt_frame *frames[2] = {hb->frames[0], hb->frames[1]};
+		hb->frames[0] = NULL;
+		hb->frames[1] = NULL;
+		os_thread_helper_unlock(&hb->worker);
+
+		process_frames(hb, frames[0], frames[1]);
+		xrt_frame_reference(&frames[0], NULL);
+		xrt_frame_reference(&frames[1], NULL);
+
+		os_thread_helper_lock(&hb->worker);
+		hb->busy = false;
+		os_thread_helper_signal_locked(&hb->worker);
+	}
+
+	os_thread_helper_unlock(&hb->worker);
+
+	return NULL;
+}
+
+//! Waits for the worker to finish the frames it was given
+static void
+wait_for_worker(struct htbench *hb)
+{
+	os_thread_helper_lock(&hb->worker);
+	while (hb->busy && os_thread_helper_is_running_locked(&hb->worker)) {
+		os_thread_helper_wait_locked(&hb->worker);
+	}
+	os_thread_helper_unlock(&hb->worker);
+}
+
+static void
+receive_bundle(struct xrt_frame_bundle_sink *sink, struct xrt_frame_bundle *bundle)
+{
+	struct htbench *hb = container_of(sink, struct htbench, bundle_sink);
+
+	if (bundle->view_count < 2) {
+		return;
+	}
+
+	struct xrt_frame *frames[2] = {NULL, NULL};
+	u_frame_get_bundle_view(bundle, 0, &frames[0]);
+	u_frame_get_bundle_view(bundle, 1, &frames[1]);
+
+	if (!hb->realtime) {
+		// The player waits for us, so nothing is ever dropped.
+		hb->received++;
+		process_frames(hb, frames[0], frames[1]);
+		xrt_frame_reference(&frames[0], NULL);
+		xrt_frame_reference(&frames[1], NULL);
+		return;
+	}
+
+	os_thread_helper_lock(&hb->worker);
+	hb->received++;
+	if (hb->busy) {
+		hb->dropped++;
+	} else {
+		hb->busy = true;
+		hb->frames[0] = frames[0];
+		hb->frames[1] = frames[1];
+		frames[0] = NULL;
+		frames[1] = NULL;
+		os_thread_helper_signal_locked(&hb->worker);
+	}
+	os_thread_helper_unlock(&hb->worker);
+
+	xrt_frame_reference(&frames[0], NULL);
+	xrt_frame_reference(&frames[1], NULL);
+}
+
+static void
+add_stats(cJSON *parent, const char *name, const struct series_stats *stats)
+{
+	cJSON *o = cJSON_AddObjectToObject(parent, name);
+	cJSON_AddNumberToObject(o, "count", (double)stats->count);
+	cJSON_AddNumberToObject(o, "mean", stats->mean);
+	cJSON_AddNumberToObject(o, "p50", stats->p50);
+	cJSON_AddNumberToObject(o, "p95", stats->p95);
+	cJSON_AddNumberToObject(o, "max", stats->max);
+}
+
+static cJSON *
+make_summary(struct htbench *hb, const char *dataset_path, double fps, const struct series_stats *jitter)
+{
+	cJSON *root = cJSON_CreateObject();
+	cJSON_AddStringToObject(root, "dataset", dataset_path);
+	cJSON_AddStringToObject(root, "mode", hb->realtime ? "realtime" : "max_speed");
+	cJSON_AddNumberToObject(root, "frames_received", (double)hb->received);
+	cJSON_AddNumberToObject(root, "frames_processed", (double)hb->processed);
+	cJSON_AddNumberToObject(root, "frames_dropped", (double)hb->dropped);
+	cJSON_AddNumberToObject(root, "fps", fps);
+
+	cJSON *timing = cJSON_AddObjectToObject(root, "timing");
+	for (int i = 0; i < STAGE_COUNT; i++) {
+		struct series_stats stats = series_get_stats(&hb->stages[i]);
+		add_stats(timing, stage_names[i], &stats);
+	}
+
+	cJSON *tracked = cJSON_AddObjectToObject(root, "tracked_frames");
+	cJSON_AddNumberToObject(tracked, "left", (double)hb->tracked[0]);
+	cJSON_AddNumberToObject(tracked, "right", (double)hb->tracked[1]);
+
+	add_stats(root, "jitter_mm", jitter);
+
+	return root;
+}
+
+static void
+print_usage(const char **argv)
+{
+	P("Replays a stereo EuRoC dataset through Mercury hand tracking and reports its performance.\n");
+	P("Usage: %s %s [options] <euroc_path> <calibration_file>\n", argv[0], argv[1]);
+	P("\n");
+	P("Options:\n");
+	P("  --models <dir>      - Hand tracking models, found like the hand tracking driver does by default.\n");
+	P("  --realtime          - Play at the dataset's frame rate and drop frames while the tracker is busy.\n");
+	P("  --speed <x>         - Playback speed in realtime mode, 1 by default.\n");
+	P("  --summary <file>    - Write the JSON summary to a file instead of stdout.\n");
+	P("  --min-fps <fps>     - Fail if fewer frames per second than this were processed.\n");
+	P("  --max-jitter <mm>   - Fail if the p95 jitter of the hands is above this.\n");
+	P("\n");
+	P("Without --realtime frames are processed as fast as possible and none are dropped.\n");
+	P("Jitter is the mean distance of the joints from where they would be if they had kept\n");
+	P("the velocity they had over the previous two frames, in millimeters.\n");
+}
+
+#endif
+
+int
+cli_cmd_htbench(int argc, const char **argv)
+{
+#if !defined(XRT_BUILD_DRIVER_HANDTRACKING)
+	P("Hand tracking not built.\n");
+	return EXIT_FAILURE;
+#elif !defined(XRT_BUILD_DRIVER_EUROC)
+	P("Euroc driver not built, can't reproduce datasets.\n");
+	return EXIT_FAILURE;
+#else
+	// Do not count "monado-cli" and "htbench" as args
+	int nof_args = argc - 2;
+	const char **args = &argv[2];
+
+	const char *models_path = NULL;
+	const char *summary_path = NULL;
+	bool realtime = false;
+	double speed = 1.0;
+	double min_fps = -1;
+	double max_jitter = -1;
+
+	// Options go before the dataset
+	while (nof_args >= 1 && args[0][0] == '-') {
+		int used = 2;
+		if (strcmp(args[0], "--realtime") == 0) {
+			realtime = true;
+			used = 1;
+		} else if (nof_args < 2) {
+			break;
+		} else if (strcmp(args[0], "--models") == 0) {
+			models_path = args[1];
+		} else if (strcmp(args[0], "--speed") == 0) {
+			speed = atof(args[1]);
+		} else if (strcmp(args[0], "--summary") == 0) {
+			summary_path = args[1];
+		} else if (strcmp(args[0], "--min-fps") == 0) {
+			min_fps = atof(args[1]);
+		} else if (strcmp(args[0], "--max-jitter") == 0) {
+			max_jitter = atof(args[1]);
+		} else {
+			break;
+		}
+		nof_args -= used;
+		args += used;
+	}
+
+	if (nof_args != 2 || speed <= 0) {
+		print_usage(argv);
+		return EXIT_FAILURE;
+	}
+
+	const char *dataset_path = args[0];
+	const char *calibration_path = args[1];
+
+	char models[1024] = {0};
+	if (models_path != NULL) {
+		snprintf(models, sizeof(models), "%s", models_path);
+	} else if (u_file_get_hand_tracking_models_dir(models, sizeof(models)) < 0) {
+		P("Could not find any directory with hand-tracking models, use --models.\n");
+		return EXIT_FAILURE;
+	}
+
+	struct t_stereo_camera_calibration *calib = NULL;
+	if (!t_stereo_camera_calibration_load(calibration_path, &calib)) {
+		P("Could not load calibration from %s\n", calibration_path);
+		return EXIT_FAILURE;
+	}
+
+	struct euroc_player_config ep_config;
+	euroc_player_fill_default_config_for(&ep_config, dataset_path);
+	if (ep_config.dataset.cam_count < 2) {
+		P("Dataset %s has no second camera, hand tracking needs stereo.\n", dataset_path);
+		t_stereo_camera_calibration_reference(&calib, NULL);
+		return EXIT_FAILURE;
+	}
+
+	ep_config.log_level = U_LOGGING_INFO;
+	ep_config.playback.cam_count = 2;
+	ep_config.playback.color = false;
+	ep_config.playback.gt = false;
+	ep_config.playback.play_from_start = true;
+	ep_config.playback.use_source_ts = true;
+	ep_config.playback.max_speed = !realtime;
+	ep_config.playback.speed = speed;
+	ep_config.playback.print_progress = summary_path != NULL; // Keep stdout for the summary otherwise
+
+	struct htbench hb = {0};
+	hb.bundle_sink.push_bundle = receive_bundle;
+	hb.realtime = realtime;
+
+	// The dataset has no vignette information, and the cameras are assumed upright.
+	struct t_camera_extra_info extra_camera_info = {0};
+	hb.sync = t_hand_tracking_sync_mercury_create(calib, extra_camera_info, models);
+
+	// Mercury keeps its own reference.
+	t_stereo_camera_calibration_reference(&calib, NULL);
+
+	os_thread_helper_init(&hb.worker);
+	if (realtime) {
+		os_thread_helper_start(&hb.worker, run_worker, &hb);
+	}
+
+	// Allow pressing enter to quit the program by launching a new thread
+	struct os_thread_helper wfk_thread;
+	os_thread_helper_init(&wfk_thread);
+	os_thread_helper_start(&wfk_thread, wait_for_exit_key, NULL);
+
+	struct xrt_frame_context xfctx = {0};
+	struct xrt_fs *xfs = euroc_player_create(&xfctx, dataset_path, &ep_config);
+
+	struct xrt_slam_sinks sinks = {0};
+	sinks.cam_count = 2;
+	sinks.bundle = &hb.bundle_sink;
+	xrt_fs_slam_stream_start(xfs, &sinks);
+
+	while (xrt_fs_is_running(xfs) && !should_exit) {
+		os_nanosleep(0.1 * U_TIME_1S_IN_NS);
+	}
+
+	// Stops the player, then let the tracker finish what it was given.
+	xrt_frame_context_destroy_nodes(&xfctx);
+	if (realtime) {
+		wait_for_worker(&hb);
+	}
+	os_thread_helper_destroy(&hb.worker);
+
+	pthread_cancel(wfk_thread.thread);
+
+	// Destroy also stops the thread.
+	os_thread_helper_destroy(&wfk_thread);
+
+	double time_s = (double)(hb.last_ns - hb.first_ns) / U_TIME_1S_IN_NS;
+	double fps = time_s > 0 ? (double)hb.processed / time_s : 0;
+	struct series_stats jitter = series_get_stats(&hb.jitter_mm);
+
+	bool passed = !should_exit && hb.processed > 0;
+	passed = passed && (min_fps < 0 || fps >= min_fps);
+	passed = passed && (max_jitter < 0 || (jitter.count > 0 && jitter.p95 <= max_jitter));
+
+	cJSON *summary = make_summary(&hb, dataset_path, fps, &jitter);
+	cJSON_AddBoolToObject(summary, "passed", passed);
+	char *str = cJSON_Print(summary);
+
+	FILE *file = summary_path != NULL ? fopen(summary_path, "w") : stdout;
+	if (file != NULL) {
+		fprintf(file, "%s\n", str);
+		if (file != stdout) {
+			fclose(file);
+		}
+	} else {
+		P("Could not open %s\n", summary_path);
+		passed = false;
+	}
+
+	I("Processed %" PRIu64 " of %" PRIu64 " frames at %.1f fps, p95 jitter %.2fmm", hb.processed, hb.received, fps,
+	  jitter.p95);
+
+	free(str);
+	cJSON_Delete(summary);
+	t_ht_sync_destroy(&hb.sync);
+
+	for (int i = 0; i < STAGE_COUNT; i++) {
+		free(hb.stages[i].values);
+	}
+	free(hb.jitter_mm.values);
+
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+#endif
+}
@@ -8,12 +8,24 @@
 
 #include "euroc/euroc_interface.h"
 #include "os/os_threading.h"
+#include "os/os_time.h"
+#include "math/m_api.h"
+#include "tracking/t_tracking.h"
+#include "util/u_json.h"
 #include "util/u_logging.h"
+#include "util/u_misc.h"
 #include "xrt/xrt_config_build.h"
 #include "xrt/xrt_config_have.h"
 #include "xrt/xrt_config_drivers.h"
+#include "xrt/xrt_config_os.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef XRT_OS_LINUX
+#include <sched.h>
+#endif
 
 #define P(...) fprintf(stderr, __VA_ARGS__)
 #define I(...) U_LOG(U_LOGGING_INFO, __VA_ARGS__)
@@ -29,6 +41,184 @@ wait_for_exit_key(void *ptr)
 	should_exit = true;
 	return NULL;
 }
+
+//! A dataset to run and its results
+struct run
+{
+	const char *dataset_path;
+	const char *slam_config;
+	const char *output_path;
+
+	bool done;
+	double time_s;
+	struct t_slam_metrics metrics;
+};
+
+//! Shared by the worker threads that run datasets concurrently
+struct batch
+{
+	struct os_mutex lock;
+	struct run *runs;
+	int run_count;
+	int next_run; //!< Next run to hand out, protected by lock
+	int job_count;
+	bool print_progress;
+
+#ifdef XRT_OS_LINUX
+	cpu_set_t cpus; //!< CPUs available to the batch, split between jobs
+#endif
+};
+
+struct worker
+{
+	struct os_thread thread;
+	struct batch *batch;
+	int index;
+};
+
+//! Restrict the calling thread, and the threads it creates, to its share of the CPUs
+static void
+pin_to_cpu_partition(struct batch *b, int index)
+{
+#ifdef XRT_OS_LINUX
+	int cpu_count = CPU_COUNT(&b->cpus);
+	if (b->job_count <= 1 || cpu_count < b->job_count) {
+		return;
+	}
+
+	int first = index * cpu_count / b->job_count;
+	int last = (index + 1) * cpu_count / b->job_count;
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu = 0, n = 0; cpu < CPU_SETSIZE && n < last; cpu++) {
+		if (!CPU_ISSET(cpu, &b->cpus)) {
+			continue;
+		}
+		if (n >= first) {
+			CPU_SET(cpu, &set);
+		}
+		n++;
+	}
+
+	int ret = sched_setaffinity(0, sizeof(set), &set);
+	if (ret != 0) {
+		U_LOG_W("Could not set the CPU affinity of job %d", index);
+	}
+#endif
+}
+
+static void *
+run_datasets(void *ptr)
+{
+	struct worker *w = (struct worker *)ptr;
+	struct batch *b = w->batch;
+
+	pin_to_cpu_partition(b, w->index);
+
+	while (!should_exit) {
+		os_mutex_lock(&b->lock);
+		int i = b->next_run < b->run_count ? b->next_run++ : -1;
+		os_mutex_unlock(&b->lock);
+
+		if (i < 0) {
+			break;
+		}
+
+		struct run *r = &b->runs[i];
+		I("Running dataset %d out of %d", i + 1, b->run_count);
+		I("Dataset path: %s", r->dataset_path);
+		I("SLAM config path: %s", r->slam_config);
+		I("Output path: %s", r->output_path);
+
+		timepoint_ns start_time = os_monotonic_get_ns();
+		euroc_run_dataset(r->dataset_path, r->slam_config, r->output_path, b->print_progress, &r->metrics,
+		                  &should_exit);
+		r->time_s = (double)(os_monotonic_get_ns() - start_time) / U_TIME_1S_IN_NS;
+		r->done = !should_exit;
+
+		I("Dataset %d done in %.2fs, ATE %.4fm, RPE %.4fm %.3fdeg, latency p95 %.2fms", i + 1, r->time_s,
+		  r->metrics.ate_rmse_m, r->metrics.rpe_trans_rmse_m, r->metrics.rpe_rot_rmse_deg,
+		  r->metrics.latency_p95_ms);
+	}
+
+	return NULL;
+}
+
+//! Whether a run passes the thresholds, negative thresholds are ignored
+static bool
+run_passes(const struct run *r, double max_ate, double max_latency)
+{
+	const struct t_slam_metrics *m = &r->metrics;
+	bool ate_ok = max_ate < 0 || (m->ate_count > 0 && m->ate_rmse_m <= max_ate);
+	bool latency_ok = max_latency < 0 || (m->latency_count > 0 && m->latency_p95_ms <= max_latency);
+	return r->done && ate_ok && latency_ok;
+}
+
+static cJSON *
+make_summary(struct batch *b, double total_time_s, double max_ate, double max_latency, bool *out_passed)
+{
+	cJSON *root = cJSON_CreateObject();
+	cJSON *datasets = cJSON_AddArrayToObject(root, "datasets");
+	bool passed = true;
+
+	for (int i = 0; i < b->run_count; i++) {
+		const struct run *r = &b->runs[i];
+		const struct t_slam_metrics *m = &r->metrics;
+		bool run_passed = run_passes(r, max_ate, max_latency);
+		passed = passed && run_passed;
+
+		cJSON *d = cJSON_CreateObject();
+		cJSON_AddStringToObject(d, "dataset", r->dataset_path);
+		cJSON_AddStringToObject(d, "slam_config", r->slam_config);
+		cJSON_AddStringToObject(d, "output", r->output_path);
+		cJSON_AddBoolToObject(d, "completed", r->done);
+		cJSON_AddBoolToObject(d, "passed", run_passed);
+		cJSON_AddNumberToObject(d, "time_s", r->time_s);
+		cJSON_AddNumberToObject(d, "pose_count", m->pose_count);
+		cJSON_AddNumberToObject(d, "gt_pose_count", m->gt_pose_count);
+
+		cJSON *ate = cJSON_AddObjectToObject(d, "ate");
+		cJSON_AddNumberToObject(ate, "count", m->ate_count);
+		cJSON_AddNumberToObject(ate, "rmse_m", m->ate_rmse_m);
+		cJSON_AddNumberToObject(ate, "max_m", m->ate_max_m);
+
+		cJSON *rpe = cJSON_AddObjectToObject(d, "rpe");
+		cJSON_AddNumberToObject(rpe, "count", m->rpe_count);
+		cJSON_AddNumberToObject(rpe, "delta_s", (double)T_SLAM_METRICS_RPE_DELTA_NS / U_TIME_1S_IN_NS);
+		cJSON_AddNumberToObject(rpe, "trans_rmse_m", m->rpe_trans_rmse_m);
+		cJSON_AddNumberToObject(rpe, "rot_rmse_deg", m->rpe_rot_rmse_deg);
+
+		cJSON *latency = cJSON_AddObjectToObject(d, "latency_ms");
+		cJSON_AddNumberToObject(latency, "count", m->latency_count);
+		cJSON_AddNumberToObject(latency, "mean", m->latency_mean_ms);
+		cJSON_AddNumberToObject(latency, "p50", m->latency_p50_ms);
+		cJSON_AddNumberToObject(latency, "p95", m->latency_p95_ms);
+		cJSON_AddNumberToObject(latency, "max", m->latency_max_ms);
+
+		cJSON_AddItemToArray(datasets, d);
+	}
+
+	cJSON_AddNumberToObject(root, "jobs", b->job_count);
+	cJSON_AddNumberToObject(root, "time_s", total_time_s);
+	cJSON_AddBoolToObject(root, "passed", passed);
+
+	*out_passed = passed;
+	return root;
+}
+
+static void
+print_usage(const char **argv)
+{
+	P("Batch evaluator of SLAM datasets.\n");
+	P("Usage: %s %s [options] [<euroc_path> <slam_config> <output_path>]...\n", argv[0], argv[1]);
+	P("\n");
+	P("Options:\n");
+	P("  -j <jobs>           - Datasets to run concurrently, each on its own share of the CPUs.\n");
+	P("  --summary <file>    - Write the JSON summary to a file instead of stdout.\n");
+	P("  --max-ate <m>       - Fail if the ATE RMSE of any dataset is above this.\n");
+	P("  --max-latency <ms>  - Fail if the p95 tracking latency of any dataset is above this.\n");
+}
 #endif
 
 int
@@ -46,39 +236,100 @@ cli_cmd_slambatch(int argc, const char **argv)
 	int nof_args = argc - 2;
 	const char **args = &argv[2];
 
-	if (nof_args == 0 || nof_args % 3 != 0) {
-		P("Batch evaluator of SLAM datasets.\n");
-		P("Usage: %s %s [<euroc_path> <slam_config> <output_path>]...\n", argv[0], argv[1]);
+	int job_count = 1;
+	const char *summary_path = NULL;
+	double max_ate = -1;
+	double max_latency = -1;
+
+	// Options go before the datasets
+	while (nof_args >= 2 && args[0][0] == '-') {
+		if (strcmp(args[0], "-j") == 0) {
+			job_count = atoi(args[1]);
+		} else if (strcmp(args[0], "--summary") == 0) {
+			summary_path = args[1];
+		} else if (strcmp(args[0], "--max-ate") == 0) {
+			max_ate = atof(args[1]);
+		} else if (strcmp(args[0], "--max-latency") == 0) {
+			max_latency = atof(args[1]);
+		} else {
+			break;
+		}
+		nof_args -= 2;
+		args += 2;
+	}
+
+	if (nof_args == 0 || nof_args % 3 != 0 || job_count < 1) {
+		print_usage(argv);
 		return EXIT_FAILURE;
 	}
 
+	struct batch b = {0};
+	b.run_count = nof_args / 3;
+	b.runs = U_TYPED_ARRAY_CALLOC(struct run, b.run_count);
+	b.job_count = MIN(job_count, b.run_count);
+	b.print_progress = b.job_count == 1; // Progress lines of concurrent runs would overwrite each other
+	os_mutex_init(&b.lock);
+
+#ifdef XRT_OS_LINUX
+	sched_getaffinity(0, sizeof(b.cpus), &b.cpus);
+#endif
+
+	for (int i = 0; i < b.run_count; i++) {
+		b.runs[i].dataset_path = args[i * 3];
+		b.runs[i].slam_config = args[i * 3 + 1];
+		b.runs[i].output_path = args[i * 3 + 2];
+	}
+
 	// Allow pressing enter to quit the program by launching a new thread
 	struct os_thread_helper wfk_thread;
 	os_thread_helper_init(&wfk_thread);
 	os_thread_helper_start(&wfk_thread, wait_for_exit_key, NULL);
 
 	timepoint_ns start_time = os_monotonic_get_ns();
-	int nof_datasets = nof_args / 3;
-	for (int i = 0; i < nof_datasets && !should_exit; i++) {
-		const char *dataset_path = args[i * 3];
-		const char *slam_config = args[i * 3 + 1];
-		const char *output_path = args[i * 3 + 2];
-
-		I("Running dataset %d out of %d", i + 1, nof_datasets);
-		I("Dataset path: %s", dataset_path);
-		I("SLAM config path: %s", slam_config);
-		I("Output path: %s", output_path);
-
-		euroc_run_dataset(dataset_path, slam_config, output_path, &should_exit);
+
+	struct worker *workers = U_TYPED_ARRAY_CALLOC(struct worker, b.job_count);
+	for (int i = 0; i < b.job_count; i++) {
+		workers[i].batch = &b;
+		workers[i].index = i;
+		os_thread_init(&workers[i].thread);
+		os_thread_start(&workers[i].thread, run_datasets, &workers[i]);
+	}
+
+	for (int i = 0; i < b.job_count; i++) {
+		os_thread_join(&workers[i].thread);
+		os_thread_destroy(&workers[i].thread);
 	}
+
 	timepoint_ns end_time = os_monotonic_get_ns();
+	double total_time_s = (double)(end_time - start_time) / U_TIME_1S_IN_NS;
 
 	pthread_cancel(wfk_thread.thread);
 
 	// Destroy also stops the thread.
 	os_thread_helper_destroy(&wfk_thread);
 
-	printf("Done in %.2fs.\n", (double)(end_time - start_time) / U_TIME_1S_IN_NS);
+	bool passed = false;
+	cJSON *summary = make_summary(&b, total_time_s, max_ate, max_latency, &passed);
+	char *str = cJSON_Print(summary);
+
+	FILE *file = summary_path != NULL ? fopen(summary_path, "w") : stdout;
+	if (file != NULL) {
+		fprintf(file, "%s\n", str);
+		if (file != stdout) {
+			fclose(file);
+		}
+	} else {
+		P("Could not open %s\n", summary_path);
+		passed = false;
+	}
+
+	free(str);
+	cJSON_Delete(summary);
+	free(workers);
+	free(b.runs);
+	os_mutex_destroy(&b.lock);
+
+	P("Done in %.2fs.\n", total_time_s);
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
 #endif
-	return EXIT_SUCCESS;
 }
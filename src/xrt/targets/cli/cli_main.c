@@ -33,6 +33,8 @@ cli_print_help(int argc, const char **argv)
 	P("  calibrate  - Calibrate a camera and save config (not implemented yet).\n");
 	P("  calib-dumb - Load and dump a calibration to stdout.\n");
 	P("  slambatch  - Runs a sequence of EuRoC datasets with the SLAM tracker.\n");
+	P("  eurocpack  - Converts a EuRoC dataset to a packed single file dataset.\n");
+	P("  htbench    - Replays a EuRoC dataset through hand tracking and reports its performance.\n");
 
 	return 1;
 }
@@ -64,5 +66,11 @@ main(int argc, const char **argv)
 	if (strcmp(argv[1], "slambatch") == 0) {
 		return cli_cmd_slambatch(argc, argv);
 	}
+	if (strcmp(argv[1], "eurocpack") == 0) {
+		return cli_cmd_eurocpack(argc, argv);
+	}
+	if (strcmp(argv[1], "htbench") == 0) {
+		return cli_cmd_htbench(argc, argv);
+	}
 	return cli_print_help(argc, argv);
 }
@@ -430,6 +430,10 @@ valve_index_setup_visual_trackers(struct lighthouse_system *lhs,
 		u_sink_stereo_sbs_to_slam_sbs_create(&lhs->devices->xfctx, entry_left_sink, entry_right_sink,
 		                                     &entry_sbs_sink);
 		u_sink_create_format_converter(&lhs->devices->xfctx, XRT_FORMAT_L8, entry_sbs_sink, &entry_sbs_sink);
+	} else if (slam_enabled && slam_sinks->bundle != NULL) {
+		// Both views of each capture go to the tracker together, without new frames
+		u_sink_stereo_sbs_to_slam_bundle_create(&lhs->devices->xfctx, slam_sinks->bundle, &entry_sbs_sink);
+		u_sink_create_format_converter(&lhs->devices->xfctx, XRT_FORMAT_L8, entry_sbs_sink, &entry_sbs_sink);
 	} else if (slam_enabled) {
 		entry_left_sink = slam_sinks->cams[0];
 		entry_right_sink = slam_sinks->cams[1];
@@ -0,0 +1,737 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Headless compositor throughput benchmark.
+ *
+ * Drives the main compositor with the offscreen target and a simulated HMD for
+ * a number of frames with a configurable mix of layers, then prints the CPU
+ * and GPU time spent by the renderer as JSON. Select a software Vulkan device
+ * (for instance with VK_ICD_FILENAMES pointing at lavapipe) to run it on
+ * machines without a GPU.
+ */
+
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_compositor.h"
+#include "xrt/xrt_vulkan_includes.h"
+
+#include "os/os_time.h"
+
+#include "math/m_api.h"
+
+#include "util/u_misc.h"
+#include "util/u_time.h"
+#include "util/u_trace_marker.h"
+
+#include "main/comp_window.h"
+#include "main/comp_target.h"
+#include "main/comp_main_interface.h"
+
+#include "simulated/simulated_interface.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// Insert the on load constructor to init trace marker.
+U_TRACE_TARGET_SETUP(U_TRACE_WHICH_SERVICE)
+
+
+/*
+ *
+ * Defines and structs.
+ *
+ */
+
+//! Same as the max number of layers the compute path handles.
+#define MAX_LAYERS (16)
+
+//! Ring used to pair begin and submit timing points for a frame.
+#define BEGIN_RING_SIZE (64)
+
+//! Size of the quad and cylinder swapchains.
+#define SMALL_SWAPCHAIN_SIZE (512)
+
+struct bench_args
+{
+	uint32_t frames;
+	uint32_t warmup;
+	uint32_t projection_count;
+	uint32_t depth_count;
+	uint32_t quad_count;
+	uint32_t cylinder_count;
+	uint32_t width;
+	uint32_t height;
+	bool compute;
+	bool opaque;
+	double max_gpu_ms;
+	const char *output;
+};
+
+struct bench_samples
+{
+	uint64_t *values;
+	uint32_t count;
+	uint32_t capacity;
+};
+
+/*!
+ * Timings captured from the compositor target, only touched from the
+ * compositor thread while it is running.
+ */
+struct bench_timings
+{
+	void (*real_mark_timing_point)(struct comp_target *ct,
+	                               enum comp_target_timing_point point,
+	                               int64_t frame_id,
+	                               uint64_t when_ns);
+
+	void (*real_info_gpu)(
+	    struct comp_target *ct, int64_t frame_id, uint64_t gpu_start_ns, uint64_t gpu_end_ns, uint64_t when_ns);
+
+	uint64_t begin_ns[BEGIN_RING_SIZE];
+	uint64_t last_submit_ns;
+
+	struct bench_samples cpu;
+	struct bench_samples gpu;
+	struct bench_samples interval;
+};
+
+struct bench_layer
+{
+	enum xrt_layer_type type;
+	struct xrt_swapchain *xscs[4];
+};
+
+static struct bench_timings timings;
+static struct comp_target_factory bench_factory;
+
+
+/*
+ *
+ * Sample helpers.
+ *
+ */
+
+static void
+samples_init(struct bench_samples *s, uint32_t capacity)
+{
+	s->values = U_TYPED_ARRAY_CALLOC(uint64_t, capacity);
+	s->capacity = capacity;
+	s->count = 0;
+}
+
+static void
+samples_push(struct bench_samples *s, uint64_t value)
+{
+	if (s->count < s->capacity) {
+		s->values[s->count++] = value;
+	}
+}
+
+static void
+samples_fini(struct bench_samples *s)
+{
+	free(s->values);
+	U_ZERO(s);
+}
+
+static int
+compare_u64(const void *a, const void *b)
+{
+	uint64_t va = *(const uint64_t *)a;
+	uint64_t vb = *(const uint64_t *)b;
+	return (va > vb) - (va < vb);
+}
+
+static void
+print_stats_json(FILE *f, const char *name, struct bench_samples *s, uint32_t skip, bool last)
+{
+	uint32_t first = MIN(skip, s->count);
+	uint32_t count = s->count - first;
+	uint64_t *values = s->values + first;
+
+	if (count == 0) {
+		fprintf(f, "\t\"%s\": null%s\n", name, last ? "" : ",");
+		return;
+	}
+
+	double sum = 0.0;
+	for (uint32_t i = 0; i < count; i++) {
+		sum += (double)values[i];
+	}
+	double mean = sum / count;
+
+	double var = 0.0;
+	for (uint32_t i = 0; i < count; i++) {
+		double d = (double)values[i] - mean;
+		var += d * d;
+	}
+	var /= count;
+
+	qsort(values, count, sizeof(uint64_t), compare_u64);
+
+	fprintf(f, "\t\"%s\": {\n", name);
+	fprintf(f, "\t\t\"samples\": %u,\n", count);
+	fprintf(f, "\t\t\"mean_ms\": %f,\n", mean / 1e6);
+	fprintf(f, "\t\t\"stddev_ms\": %f,\n", sqrt(var) / 1e6);
+	fprintf(f, "\t\t\"variance_ms2\": %f,\n", var / 1e12);
+	fprintf(f, "\t\t\"min_ms\": %f,\n", values[0] / 1e6);
+	fprintf(f, "\t\t\"median_ms\": %f,\n", values[count / 2] / 1e6);
+	fprintf(f, "\t\t\"p99_ms\": %f,\n", values[(count * 99) / 100] / 1e6);
+	fprintf(f, "\t\t\"max_ms\": %f\n", values[count - 1] / 1e6);
+	fprintf(f, "\t}%s\n", last ? "" : ",");
+}
+
+static double
+samples_mean_ms(const struct bench_samples *s, uint32_t skip)
+{
+	uint32_t first = MIN(skip, s->count);
+	if (s->count == first) {
+		return 0.0;
+	}
+
+	double sum = 0.0;
+	for (uint32_t i = first; i < s->count; i++) {
+		sum += (double)s->values[i];
+	}
+	return sum / (s->count - first) / 1e6;
+}
+
+
+/*
+ *
+ * Target wrapping.
+ *
+ */
+
+static void
+bench_mark_timing_point(struct comp_target *ct,
+                        enum comp_target_timing_point point,
+                        int64_t frame_id,
+                        uint64_t when_ns)
+{
+	uint32_t slot = (uint32_t)((uint64_t)frame_id % BEGIN_RING_SIZE);
+
+	switch (point) {
+	case COMP_TARGET_TIMING_POINT_BEGIN: timings.begin_ns[slot] = when_ns; break;
+	case COMP_TARGET_TIMING_POINT_SUBMIT:
+		if (timings.begin_ns[slot] != 0) {
+			samples_push(&timings.cpu, when_ns - timings.begin_ns[slot]);
+			timings.begin_ns[slot] = 0;
+		}
+		if (timings.last_submit_ns != 0) {
+			samples_push(&timings.interval, when_ns - timings.last_submit_ns);
+		}
+		timings.last_submit_ns = when_ns;
+		break;
+	default: break;
+	}
+
+	timings.real_mark_timing_point(ct, point, frame_id, when_ns);
+}
+
+static void
+bench_info_gpu(
+    struct comp_target *ct, int64_t frame_id, uint64_t gpu_start_ns, uint64_t gpu_end_ns, uint64_t when_ns)
+{
+	samples_push(&timings.gpu, gpu_end_ns - gpu_start_ns);
+
+	timings.real_info_gpu(ct, frame_id, gpu_start_ns, gpu_end_ns, when_ns);
+}
+
+static bool
+bench_create_target(const struct comp_target_factory *ctf, struct comp_compositor *c, struct comp_target **out_ct)
+{
+	const struct comp_target_factory *real = &comp_target_factory_offscreen;
+
+	struct comp_target *ct = NULL;
+	if (!real->create_target(real, c, &ct)) {
+		return false;
+	}
+
+	timings.real_mark_timing_point = ct->mark_timing_point;
+	timings.real_info_gpu = ct->info_gpu;
+	ct->mark_timing_point = bench_mark_timing_point;
+	ct->info_gpu = bench_info_gpu;
+
+	*out_ct = ct;
+
+	return true;
+}
+
+
+/*
+ *
+ * Argument parsing.
+ *
+ */
+
+static void
+print_usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [options]\n", name);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "  --frames <n>       Number of frames to submit (default 600)\n");
+	fprintf(stderr, "  --warmup <n>       Frames left out of the statistics (default 30)\n");
+	fprintf(stderr, "  --projection <n>   Number of projection layers (default 1)\n");
+	fprintf(stderr, "  --depth <n>        Number of projection layers with depth (default 0)\n");
+	fprintf(stderr, "  --quad <n>         Number of quad layers (default 0)\n");
+	fprintf(stderr, "  --cylinder <n>     Number of cylinder layers (default 0)\n");
+	fprintf(stderr, "  --width <n>        Width of projection swapchains (default recommended)\n");
+	fprintf(stderr, "  --height <n>       Height of projection swapchains (default recommended)\n");
+	fprintf(stderr, "  --compute          Use the compute path\n");
+	fprintf(stderr, "  --graphics         Use the graphics path (default)\n");
+	fprintf(stderr, "  --opaque           Submit opaque layers, allows hidden layers to be culled\n");
+	fprintf(stderr, "  --max-gpu-ms <ms>  Fail if the mean GPU time is above this\n");
+	fprintf(stderr, "  --output <file>    Write the JSON to a file instead of stdout\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Run on a software Vulkan device by setting VK_ICD_FILENAMES.\n");
+}
+
+static bool
+parse_u32(const char *str, uint32_t *out_value)
+{
+	char *end = NULL;
+	unsigned long value = strtoul(str, &end, 10);
+	if (end == str || *end != '\0' || value > UINT32_MAX) {
+		return false;
+	}
+
+	*out_value = (uint32_t)value;
+	return true;
+}
+
+static bool
+parse_args(int argc, char *argv[], struct bench_args *args)
+{
+	for (int i = 1; i < argc; i++) {
+		const char *arg = argv[i];
+		const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+		uint32_t *u32_dst = NULL;
+
+		if (strcmp(arg, "--compute") == 0) {
+			args->compute = true;
+			continue;
+		}
+		if (strcmp(arg, "--graphics") == 0) {
+			args->compute = false;
+			continue;
+		}
+		if (strcmp(arg, "--opaque") == 0) {
+			args->opaque = true;
+			continue;
+		}
+
+		if (value == NULL) {
+			fprintf(stderr, "Unknown or incomplete argument '%s'\n", arg);
+			return false;
+		}
+
+		if (strcmp(arg, "--output") == 0) {
+			args->output = value;
+			i++;
+			continue;
+		}
+		if (strcmp(arg, "--max-gpu-ms") == 0) {
+			args->max_gpu_ms = atof(value);
+			i++;
+			continue;
+		}
+
+		if (strcmp(arg, "--frames") == 0) {
+			u32_dst = &args->frames;
+		} else if (strcmp(arg, "--warmup") == 0) {
+			u32_dst = &args->warmup;
+		} else if (strcmp(arg, "--projection") == 0) {
+			u32_dst = &args->projection_count;
+		} else if (strcmp(arg, "--depth") == 0) {
+			u32_dst = &args->depth_count;
+		} else if (strcmp(arg, "--quad") == 0) {
+			u32_dst = &args->quad_count;
+		} else if (strcmp(arg, "--cylinder") == 0) {
+			u32_dst = &args->cylinder_count;
+		} else if (strcmp(arg, "--width") == 0) {
+			u32_dst = &args->width;
+		} else if (strcmp(arg, "--height") == 0) {
+			u32_dst = &args->height;
+		}
+
+		if (u32_dst == NULL || !parse_u32(value, u32_dst)) {
+			fprintf(stderr, "Invalid argument '%s %s'\n", arg, value);
+			return false;
+		}
+		i++;
+	}
+
+	uint32_t total = args->projection_count + args->depth_count + args->quad_count + args->cylinder_count;
+	if (total == 0 || total > MAX_LAYERS) {
+		fprintf(stderr, "Need between 1 and %u layers, got %u\n", MAX_LAYERS, total);
+		return false;
+	}
+
+	return true;
+}
+
+
+/*
+ *
+ * Layer helpers.
+ *
+ */
+
+static bool
+has_format(const struct xrt_compositor_info *info, int64_t format)
+{
+	for (uint32_t i = 0; i < info->format_count; i++) {
+		if (info->formats[i] == format) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static xrt_result_t
+create_swapchain(struct xrt_compositor *xc,
+                 int64_t format,
+                 enum xrt_swapchain_usage_bits bits,
+                 uint32_t width,
+                 uint32_t height,
+                 struct xrt_swapchain **out_xsc)
+{
+	struct xrt_swapchain_create_info info = {
+	    .bits = bits | XRT_SWAPCHAIN_USAGE_SAMPLED,
+	    .format = format,
+	    .sample_count = 1,
+	    .width = width,
+	    .height = height,
+	    .face_count = 1,
+	    .array_size = 1,
+	    .mip_count = 1,
+	};
+
+	return xrt_comp_create_swapchain(xc, &info, out_xsc);
+}
+
+static void
+fill_sub_image(struct xrt_swapchain *xsc, uint32_t width, uint32_t height, struct xrt_sub_image *sub)
+{
+	// Same as an application would do, go through the acquire cycle.
+	uint32_t index = 0;
+	xrt_swapchain_acquire_image(xsc, &index);
+	xrt_swapchain_wait_image(xsc, U_TIME_1S_IN_NS, index);
+	xrt_swapchain_release_image(xsc, index);
+
+	sub->image_index = index;
+	sub->array_index = 0;
+	sub->rect.offset.w = 0;
+	sub->rect.offset.h = 0;
+	sub->rect.extent.w = (int)width;
+	sub->rect.extent.h = (int)height;
+	sub->norm_rect.x = 0.0f;
+	sub->norm_rect.y = 0.0f;
+	sub->norm_rect.w = 1.0f;
+	sub->norm_rect.h = 1.0f;
+}
+
+static void
+submit_layers(struct xrt_compositor *xc,
+              struct xrt_device *head,
+              const struct bench_args *args,
+              struct bench_layer *layers,
+              uint32_t layer_count)
+{
+	struct xrt_pose identity = XRT_POSE_IDENTITY;
+	enum xrt_layer_composition_flags flags = 0;
+	if (!args->opaque) {
+		// Blended layers can't be culled, so every layer is composited.
+		flags |= XRT_LAYER_COMPOSITION_BLEND_TEXTURE_SOURCE_ALPHA_BIT;
+	}
+
+	uint32_t quad_i = 0;
+	uint32_t cylinder_i = 0;
+
+	for (uint32_t i = 0; i < layer_count; i++) {
+		struct bench_layer *l = &layers[i];
+		struct xrt_layer_data data = {0};
+		data.type = l->type;
+		data.name = XRT_INPUT_GENERIC_HEAD_POSE;
+		data.flags = flags;
+		data.flip_y = false;
+
+		switch (l->type) {
+		case XRT_LAYER_STEREO_PROJECTION_DEPTH:
+			fill_sub_image(l->xscs[2], args->width, args->height, &data.stereo_depth.l_d.sub);
+			fill_sub_image(l->xscs[3], args->width, args->height, &data.stereo_depth.r_d.sub);
+			data.stereo_depth.l_d.min_depth = data.stereo_depth.r_d.min_depth = 0.0f;
+			data.stereo_depth.l_d.max_depth = data.stereo_depth.r_d.max_depth = 1.0f;
+			data.stereo_depth.l_d.near_z = data.stereo_depth.r_d.near_z = 0.1f;
+			data.stereo_depth.l_d.far_z = data.stereo_depth.r_d.far_z = 100.0f;
+			// Same layout for the views as a plain projection layer.
+			// fall through
+		case XRT_LAYER_STEREO_PROJECTION:
+			fill_sub_image(l->xscs[0], args->width, args->height, &data.stereo.l.sub);
+			fill_sub_image(l->xscs[1], args->width, args->height, &data.stereo.r.sub);
+			data.stereo.l.pose = identity;
+			data.stereo.r.pose = identity;
+			data.stereo.l.fov = head->hmd->distortion.fov[0];
+			data.stereo.r.fov = head->hmd->distortion.fov[1];
+
+			if (l->type == XRT_LAYER_STEREO_PROJECTION) {
+				xrt_comp_layer_stereo_projection(xc, head, l->xscs[0], l->xscs[1], &data);
+			} else {
+				xrt_comp_layer_stereo_projection_depth(xc, head, l->xscs[0], l->xscs[1], l->xscs[2],
+				                                       l->xscs[3], &data);
+			}
+			break;
+		case XRT_LAYER_QUAD:
+			fill_sub_image(l->xscs[0], SMALL_SWAPCHAIN_SIZE, SMALL_SWAPCHAIN_SIZE, &data.quad.sub);
+			data.quad.visibility = XRT_LAYER_EYE_VISIBILITY_BOTH;
+			data.quad.pose = identity;
+			data.quad.pose.position.x = -0.5f + 0.25f * (float)(quad_i % 5);
+			data.quad.pose.position.z = -1.0f - 0.1f * (float)quad_i;
+			data.quad.size.x = 0.5f;
+			data.quad.size.y = 0.5f;
+			quad_i++;
+
+			xrt_comp_layer_quad(xc, head, l->xscs[0], &data);
+			break;
+		case XRT_LAYER_CYLINDER:
+			fill_sub_image(l->xscs[0], SMALL_SWAPCHAIN_SIZE, SMALL_SWAPCHAIN_SIZE, &data.cylinder.sub);
+			data.cylinder.visibility = XRT_LAYER_EYE_VISIBILITY_BOTH;
+			data.cylinder.pose = identity;
+			data.cylinder.radius = 1.0f + 0.2f * (float)cylinder_i;
+			data.cylinder.central_angle = 1.0f;
+			data.cylinder.aspect_ratio = 2.0f;
+			cylinder_i++;
+
+			xrt_comp_layer_cylinder(xc, head, l->xscs[0], &data);
+			break;
+		default: break;
+		}
+	}
+}
+
+
+/*
+ *
+ * Main.
+ *
+ */
+
+int
+main(int argc, char *argv[])
+{
+	u_trace_marker_init();
+
+	struct bench_args args = {
+	    .frames = 600,
+	    .warmup = 30,
+	    .projection_count = 1,
+	    .compute = false,
+	};
+
+	if (!parse_args(argc, argv, &args)) {
+		print_usage(argv[0]);
+		return 1;
+	}
+
+	// Read once by the compositor settings.
+	setenv("XRT_COMPOSITOR_COMPUTE", args.compute ? "true" : "false", 1);
+
+	struct xrt_pose center = XRT_POSE_IDENTITY;
+	struct xrt_device *head = simulated_hmd_create(SIMULATED_MOVEMENT_STATIONARY, &center);
+	if (head == NULL) {
+		fprintf(stderr, "Failed to create simulated HMD\n");
+		return 1;
+	}
+
+	// Wrap the offscreen target to capture the renderer timings.
+	bench_factory = comp_target_factory_offscreen;
+	bench_factory.create_target = bench_create_target;
+
+	// Every frame gets at most one sample of each kind, leave room for repeated frames.
+	uint32_t capacity = args.frames * 2 + BEGIN_RING_SIZE;
+	samples_init(&timings.cpu, capacity);
+	samples_init(&timings.gpu, capacity);
+	samples_init(&timings.interval, capacity);
+
+	struct xrt_system_compositor *xsysc = NULL;
+	struct xrt_compositor_native *xcn = NULL;
+	struct bench_layer layers[MAX_LAYERS] = {0};
+	uint32_t layer_count = 0;
+	uint64_t wall_start_ns = 0;
+	uint64_t wall_end_ns = 0;
+	int ret = 1;
+
+	xrt_result_t xret = comp_main_create_system_compositor(head, &bench_factory, &xsysc);
+	if (xret != XRT_SUCCESS) {
+		fprintf(stderr, "Failed to create system compositor: %d\n", xret);
+		goto out;
+	}
+
+	if (args.width == 0) {
+		args.width = xsysc->info.views[0].recommended.width_pixels;
+	}
+	if (args.height == 0) {
+		args.height = xsysc->info.views[0].recommended.height_pixels;
+	}
+
+	struct xrt_session_info xsi = {0};
+	xret = xrt_syscomp_create_native_compositor(xsysc, &xsi, &xcn);
+	if (xret != XRT_SUCCESS) {
+		fprintf(stderr, "Failed to create native compositor: %d\n", xret);
+		goto out;
+	}
+
+	struct xrt_compositor *xc = &xcn->base;
+	int64_t color_format = xc->info.formats[0];
+	int64_t depth_format = VK_FORMAT_D32_SFLOAT;
+
+	if (args.depth_count > 0 && !has_format(&xc->info, depth_format)) {
+		fprintf(stderr, "Depth format not supported by the compositor\n");
+		goto out;
+	}
+
+	// Back to front: projection, depth, cylinder and then quad layers.
+	for (uint32_t i = 0; i < args.projection_count; i++) {
+		struct bench_layer *l = &layers[layer_count++];
+		l->type = XRT_LAYER_STEREO_PROJECTION;
+		xret = create_swapchain(xc, color_format, XRT_SWAPCHAIN_USAGE_COLOR, args.width, args.height,
+		                        &l->xscs[0]);
+		xret = xret == XRT_SUCCESS ? create_swapchain(xc, color_format, XRT_SWAPCHAIN_USAGE_COLOR, args.width,
+		                                              args.height, &l->xscs[1])
+		                           : xret;
+		if (xret != XRT_SUCCESS) {
+			goto err_swapchain;
+		}
+	}
+	for (uint32_t i = 0; i < args.depth_count; i++) {
+		struct bench_layer *l = &layers[layer_count++];
+		l->type = XRT_LAYER_STEREO_PROJECTION_DEPTH;
+		for (uint32_t k = 0; k < 4 && xret == XRT_SUCCESS; k++) {
+			bool is_depth = k >= 2;
+			xret = create_swapchain(xc, is_depth ? depth_format : color_format,
+			                        is_depth ? XRT_SWAPCHAIN_USAGE_DEPTH_STENCIL : XRT_SWAPCHAIN_USAGE_COLOR,
+			                        args.width, args.height, &l->xscs[k]);
+		}
+		if (xret != XRT_SUCCESS) {
+			goto err_swapchain;
+		}
+	}
+	for (uint32_t i = 0; i < args.cylinder_count; i++) {
+		struct bench_layer *l = &layers[layer_count++];
+		l->type = XRT_LAYER_CYLINDER;
+		xret = create_swapchain(xc, color_format, XRT_SWAPCHAIN_USAGE_COLOR, SMALL_SWAPCHAIN_SIZE,
+		                        SMALL_SWAPCHAIN_SIZE, &l->xscs[0]);
+		if (xret != XRT_SUCCESS) {
+			goto err_swapchain;
+		}
+	}
+	for (uint32_t i = 0; i < args.quad_count; i++) {
+		struct bench_layer *l = &layers[layer_count++];
+		l->type = XRT_LAYER_QUAD;
+		xret = create_swapchain(xc, color_format, XRT_SWAPCHAIN_USAGE_COLOR, SMALL_SWAPCHAIN_SIZE,
+		                        SMALL_SWAPCHAIN_SIZE, &l->xscs[0]);
+		if (xret != XRT_SUCCESS) {
+			goto err_swapchain;
+		}
+	}
+
+	xrt_comp_begin_session(xc, XRT_VIEW_TYPE_STEREO);
+	xrt_syscomp_set_state(xsysc, xc, true, true);
+
+	wall_start_ns = os_monotonic_get_ns();
+
+	for (uint32_t frame = 0; frame < args.frames; frame++) {
+		int64_t frame_id = -1;
+		uint64_t predicted_display_time_ns = 0;
+		uint64_t predicted_display_period_ns = 0;
+
+		xrt_comp_wait_frame(xc, &frame_id, &predicted_display_time_ns, &predicted_display_period_ns);
+		xrt_comp_begin_frame(xc, frame_id);
+
+		struct xrt_layer_frame_data data = {
+		    .frame_id = frame_id,
+		    .display_time_ns = predicted_display_time_ns,
+		    .env_blend_mode = XRT_BLEND_MODE_OPAQUE,
+		};
+		xrt_comp_layer_begin(xc, &data);
+		submit_layers(xc, head, &args, layers, layer_count);
+		xrt_comp_layer_commit(xc, XRT_GRAPHICS_SYNC_HANDLE_INVALID);
+	}
+
+	wall_end_ns = os_monotonic_get_ns();
+
+	xrt_comp_end_session(xc);
+	ret = 0;
+
+err_swapchain:
+	if (ret != 0) {
+		fprintf(stderr, "Failed to create swapchain: %d\n", xret);
+	}
+
+	for (uint32_t i = 0; i < layer_count; i++) {
+		for (uint32_t k = 0; k < ARRAY_SIZE(layers[i].xscs); k++) {
+			xrt_swapchain_reference(&layers[i].xscs[k], NULL);
+		}
+	}
+
+out:
+	// Stops the compositor thread, after this the timings can be read.
+	xrt_comp_native_destroy(&xcn);
+	xrt_syscomp_destroy(&xsysc);
+	xrt_device_destroy(&head);
+
+	if (ret == 0) {
+		FILE *f = stdout;
+		if (args.output != NULL) {
+			f = fopen(args.output, "w");
+			if (f == NULL) {
+				fprintf(stderr, "Failed to open '%s'\n", args.output);
+				f = stdout;
+			}
+		}
+
+		fprintf(f, "{\n");
+		fprintf(f, "\t\"config\": {\n");
+		fprintf(f, "\t\t\"path\": \"%s\",\n", args.compute ? "compute" : "graphics");
+		fprintf(f, "\t\t\"frames\": %u,\n", args.frames);
+		fprintf(f, "\t\t\"warmup\": %u,\n", args.warmup);
+		fprintf(f, "\t\t\"projection\": %u,\n", args.projection_count);
+		fprintf(f, "\t\t\"depth\": %u,\n", args.depth_count);
+		fprintf(f, "\t\t\"quad\": %u,\n", args.quad_count);
+		fprintf(f, "\t\t\"cylinder\": %u,\n", args.cylinder_count);
+		fprintf(f, "\t\t\"width\": %u,\n", args.width);
+		fprintf(f, "\t\t\"height\": %u,\n", args.height);
+		fprintf(f, "\t\t\"opaque\": %s\n", args.opaque ? "true" : "false");
+		fprintf(f, "\t},\n");
+		fprintf(f, "\t\"wall_time_ms\": %f,\n", (wall_end_ns - wall_start_ns) / 1e6);
+
+		// Read the means before the stats sort the samples.
+		double gpu_mean_ms = samples_mean_ms(&timings.gpu, args.warmup);
+
+		print_stats_json(f, "cpu_record_submit", &timings.cpu, args.warmup, false);
+		print_stats_json(f, "gpu", &timings.gpu, args.warmup, false);
+		print_stats_json(f, "frame_interval", &timings.interval, args.warmup, true);
+		fprintf(f, "}\n");
+
+		if (f != stdout) {
+			fclose(f);
+		}
+
+		if (args.max_gpu_ms > 0.0 && gpu_mean_ms > args.max_gpu_ms) {
+			fprintf(stderr, "Mean GPU time %f ms is above the limit of %f ms\n", gpu_mean_ms,
+			        args.max_gpu_ms);
+			ret = 2;
+		}
+	}
+
+	samples_fini(&timings.cpu);
+	samples_fini(&timings.gpu);
+	samples_fini(&timings.interval);
+
+	return ret;
+}
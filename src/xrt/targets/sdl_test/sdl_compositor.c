@@ -583,6 +583,9 @@ sdl_compositor_init(struct sdl_program *sp)
 	c->base.base.base.create_swapchain = sdl_swapchain_create;
 	c->base.base.base.import_swapchain = sdl_swapchain_import;
 
+	// Our swapchains are never pooled, use the create function above for all clients.
+	c->base.base.create_swapchain_for_client = NULL;
+
 
 	/*
 	 * Main init sequence.
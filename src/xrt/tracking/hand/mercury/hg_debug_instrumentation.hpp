@@ -33,6 +33,7 @@ struct hg_tuneable_values
 	struct u_var_draggable_f32 max_reprojection_error;
 	struct u_var_draggable_f32 opt_smooth_factor;
 	struct u_var_draggable_f32 max_hand_dist;
+	struct u_var_draggable_f32 crop_map_reuse_px;
 	bool scribble_predictions_into_next_frame = false;
 	bool scribble_keypoint_model_outputs = false;
 	bool scribble_optimizer_outputs = true;
@@ -42,6 +43,7 @@ struct hg_tuneable_values
 	size_t num_frames_before_display = 10;
 	bool enable_pose_predicted_input = true;
 	bool enable_framerate_based_smoothing = false;
+	bool batch_model_inference = true;
 
 	// Stuff that's only really useful for dataset playback:
 	bool detection_model_in_both_views = false;
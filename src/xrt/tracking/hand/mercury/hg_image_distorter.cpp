@@ -65,19 +65,15 @@ struct ArrayStack
 
 struct projection_state
 {
-	cv::Mat &input;
-	Eigen::Map<OutputSizedArray<uint8_t>> distorted_image_eigen;
 	t_camera_model_params dist;
 
 	const projection_instructions &instructions;
 
-	ArrayStack stack = {};
+	// Scratch space, only needed to make a new crop map.
+	ArrayStack *stack = nullptr;
 
-	OutputSizedArray<int16_t> image_x = {};
-	OutputSizedArray<int16_t> image_y = {};
-
-	projection_state(const projection_instructions &instructions, cv::Mat &input, cv::Mat &output)
-	    : input(input), distorted_image_eigen(output.data, 128, 128), instructions(instructions){};
+	projection_state(const t_camera_model_params &dist, const projection_instructions &instructions)
+	    : dist(dist), instructions(instructions){};
 };
 
 
@@ -91,8 +87,8 @@ project_kb4(projection_state &mi,
             OutputSizedFloatArray &out_y)
 {
 	const t_camera_model_params &dist = mi.dist;
-	OutputSizedFloatArray r2 = mi.stack.get();
-	OutputSizedFloatArray r = mi.stack.get();
+	OutputSizedFloatArray r2 = mi.stack->get();
+	OutputSizedFloatArray r = mi.stack->get();
 
 	r2 = x * x + y * y;
 	r = sqrt(r2);
@@ -109,11 +105,11 @@ project_kb4(projection_state &mi,
 	// If neither of these were true we'd definitely need atan2.
 	//
 	// Grrr, we really need a good library for fast approximations of trigonometric functions.
-	OutputSizedFloatArray theta = mi.stack.get();
+	OutputSizedFloatArray theta = mi.stack->get();
 	theta = atan(r / z);
 #endif
 
-	OutputSizedFloatArray theta2 = mi.stack.get();
+	OutputSizedFloatArray theta2 = mi.stack->get();
 	theta2 = theta * theta;
 
 
@@ -130,7 +126,7 @@ project_kb4(projection_state &mi,
 #else
 	// This version gives the compiler more options to do FMAs and avoid temporaries. Down to floating point
 	// precision this should give the same result as the above.
-	OutputSizedFloatArray r_theta = mi.stack.get();
+	OutputSizedFloatArray r_theta = mi.stack->get();
 	r_theta =
 	    (((((dist.fisheye.k4 * theta2) + dist.fisheye.k3) * theta2 + dist.fisheye.k2) * theta2 + dist.fisheye.k1) *
 	         theta2 +
@@ -138,9 +134,9 @@ project_kb4(projection_state &mi,
 	    theta;
 #endif
 
-	OutputSizedFloatArray mx = mi.stack.get();
+	OutputSizedFloatArray mx = mi.stack->get();
 	mx = x * r_theta / r;
-	OutputSizedFloatArray my = mi.stack.get();
+	OutputSizedFloatArray my = mi.stack->get();
 	my = y * r_theta / r;
 
 	out_x = dist.fx * mx + dist.cx;
@@ -154,29 +150,22 @@ map_ranges(T value, T from_low, T from_high, T to_low, T to_high)
 	return (value - from_low) * (to_high - to_low) / (from_high - from_low) + to_low;
 }
 
-void
-naive_remap(OutputSizedArray<int16_t> &image_x,
-            OutputSizedArray<int16_t> &image_y,
-            cv::Mat &input,
-            Eigen::Map<OutputSizedArray<uint8_t>> &output)
+// Turns the image coordinates of each crop pixel into offsets into the input image.
+static void
+make_offsets(const OutputSizedFloatArray &image_x_f,
+             const OutputSizedFloatArray &image_y_f,
+             const cv::Mat &input,
+             crop_map &map)
 {
-	output = 0;
+	map.offsets.resize(wsize * wsize);
 
 	for (int y = 0; y < wsize; y++) {
 		for (int x = 0; x < wsize; x++) {
-			if (image_y(y, x) < 0) {
-				continue;
-			}
-			if (image_y(y, x) >= input.rows) {
-				continue;
-			}
-			if (image_x(y, x) < 0) {
-				continue;
-			}
-			if (image_x(y, x) >= input.cols) {
-				continue;
-			}
-			output(y, x) = input.at<uint8_t>(image_y(y, x), image_x(y, x));
+			int16_t image_x = (int16_t)image_x_f(y, x);
+			int16_t image_y = (int16_t)image_y_f(y, x);
+
+			bool inside = image_x >= 0 && image_x < input.cols && image_y >= 0 && image_y < input.rows;
+			map.offsets[y * wsize + x] = inside ? (int32_t)(image_y * input.step[0] + image_x) : -1;
 		}
 	}
 }
@@ -184,12 +173,12 @@ naive_remap(OutputSizedArray<int16_t> &image_x,
 
 
 void
-StereographicDistort(projection_state &mi)
+StereographicDistort(projection_state &mi, const cv::Mat &input, crop_map &map)
 {
 	XRT_TRACE_MARKER();
 
-	OutputSizedFloatArray &sg_x = mi.stack.get();
-	OutputSizedFloatArray &sg_y = mi.stack.get();
+	OutputSizedFloatArray &sg_x = mi.stack->get();
+	OutputSizedFloatArray &sg_y = mi.stack->get();
 
 	// Please vectorize me?
 	if (mi.instructions.flip) {
@@ -216,9 +205,9 @@ StereographicDistort(projection_state &mi)
 	// STEREOGRAPHIC DIRECTION TO 3D DIRECTION
 	// Note: we do not normalize the direction, because we don't need to. :)
 
-	OutputSizedFloatArray &dir_x = mi.stack.get();
-	OutputSizedFloatArray &dir_y = mi.stack.get();
-	OutputSizedFloatArray &dir_z = mi.stack.get();
+	OutputSizedFloatArray &dir_x = mi.stack->get();
+	OutputSizedFloatArray &dir_y = mi.stack->get();
+	OutputSizedFloatArray &dir_z = mi.stack->get();
 
 
 #if 0
@@ -235,13 +224,13 @@ StereographicDistort(projection_state &mi)
 	// END STEREOGRAPHIC DIRECTION TO 3D DIRECTION
 
 	// QUATERNION ROTATING VECTOR
-	OutputSizedFloatArray &rot_dir_x = mi.stack.get();
-	OutputSizedFloatArray &rot_dir_y = mi.stack.get();
-	OutputSizedFloatArray &rot_dir_z = mi.stack.get();
+	OutputSizedFloatArray &rot_dir_x = mi.stack->get();
+	OutputSizedFloatArray &rot_dir_y = mi.stack->get();
+	OutputSizedFloatArray &rot_dir_z = mi.stack->get();
 
-	OutputSizedFloatArray &uv0 = mi.stack.get();
-	OutputSizedFloatArray &uv1 = mi.stack.get();
-	OutputSizedFloatArray &uv2 = mi.stack.get();
+	OutputSizedFloatArray &uv0 = mi.stack->get();
+	OutputSizedFloatArray &uv1 = mi.stack->get();
+	OutputSizedFloatArray &uv2 = mi.stack->get();
 
 	const Eigen::Quaternionf &q = mi.instructions.rot_quat;
 
@@ -264,8 +253,8 @@ StereographicDistort(projection_state &mi)
 
 
 
-	OutputSizedFloatArray &image_x_f = mi.stack.get();
-	OutputSizedFloatArray &image_y_f = mi.stack.get();
+	OutputSizedFloatArray &image_x_f = mi.stack->get();
+	OutputSizedFloatArray &image_y_f = mi.stack->get();
 
 
 	//!@todo optimize
@@ -293,10 +282,7 @@ StereographicDistort(projection_state &mi)
 		}
 	}
 
-	mi.image_x = image_x_f.cast<int16_t>();
-	mi.image_y = image_y_f.cast<int16_t>();
-
-	naive_remap(mi.image_x, mi.image_y, mi.input, mi.distorted_image_eigen);
+	make_offsets(image_x_f, image_y_f, input, map);
 }
 
 
@@ -598,26 +584,164 @@ make_projection_instructions_angular(xrt_vec3 direction_3d,
 }
 
 
+// How far, in crop pixels, any pixel of a crop made for @p want would be from where it is in @p map.
+static float
+crop_map_error_px(const crop_map &map, const projection_instructions &want)
+{
+	float r = map.stereographic_radius;
+
+	// A rotation by some angle moves every direction by at most that angle, which moves a point at stereographic
+	// radius p by up to (1 + p^2) / 2 times it. The corners of the crop are at p = r * sqrt(2).
+	float angle = map.rot_quat.angularDistance(want.rot_quat);
+	float rotation_px = angle * ((1.0f + 2.0f * r * r) / 2.0f) * (wsize / (2.0f * r));
+
+	// Changing the radius moves the corners the most.
+	float scale_px = (fabsf(want.stereographic_radius - r) / r) * wsize * (float)M_SQRT1_2;
+
+	return rotation_px + scale_px;
+}
+
+bool
+stereographic_crop_map(const t_camera_model_params &dist,
+                       projection_instructions &instructions,
+                       const cv::Mat &input_image,
+                       float reuse_tolerance_px,
+                       crop_map &map)
+{
+	XRT_TRACE_MARKER();
+
+	bool same_image = map.rows == input_image.rows && //
+	                  map.cols == input_image.cols && //
+	                  map.step == input_image.step[0];
+
+	if (map.valid && same_image && map.flip == instructions.flip && reuse_tolerance_px > 0 &&
+	    map.stereographic_radius > 0 && crop_map_error_px(map, instructions) <= reuse_tolerance_px) {
+		instructions.rot_quat = map.rot_quat;
+		instructions.stereographic_radius = map.stereographic_radius;
+		return true;
+	}
+
+	projection_state mi(dist, instructions);
+
+	// Too big for the stack of the calling thread.
+	ArrayStack *stack = new ArrayStack;
+	mi.stack = stack;
+
+	StereographicDistort(mi, input_image, map);
+
+	delete stack;
+
+	map.valid = true;
+	map.rot_quat = instructions.rot_quat;
+	map.stereographic_radius = instructions.stereographic_radius;
+	map.flip = instructions.flip;
+	map.rows = input_image.rows;
+	map.cols = input_image.cols;
+	map.step = input_image.step[0];
+
+	return false;
+}
+
 void
-stereographic_project_image(const t_camera_model_params &dist,
-                            const projection_instructions &instructions,
-                            cv::Mat &input_image,
-                            cv::Mat *debug_image,
-                            const cv::Scalar boundary_color,
-                            cv::Mat &out)
+draw_stereographic_crop_boundary(const t_camera_model_params &dist,
+                                 const projection_instructions &instructions,
+                                 const cv::Scalar boundary_color,
+                                 cv::Mat &debug_image)
+{
+	projection_state mi(dist, instructions);
+
+	draw_boundary(mi, boundary_color, debug_image);
+}
 
+// Writes the image, given its sum and sum of squares, with a mean of 0.5 and a standard deviation of 0.25.
+static bool
+normalize_from_sums(const uint8_t *in, int count, uint64_t sum, uint64_t sum_sq, float *out_float)
 {
-	out = cv::Mat(cv::Size(wsize, wsize), CV_8U);
-	projection_state *mi_ptr = new projection_state(instructions, input_image, out);
-	projection_state &mi = *mi_ptr;
+	// count^2 times the variance, exact so a flat image is caught for sure.
+	uint64_t n2_variance = count * sum_sq - sum * sum;
 
-	mi.dist = dist;
+	if (n2_variance == 0) {
+		U_LOG_W("Got image with zero standard deviation!");
+		return false;
+	}
+
+	double std_dev = sqrt((double)n2_variance) / count;
+	double mean = (double)sum / count;
 
-	StereographicDistort(mi);
+	float scale = (float)(0.25 / std_dev);
+	float offset = (float)(0.5 - mean * (0.25 / std_dev));
 
-	if (debug_image) {
-		draw_boundary(mi, boundary_color, *debug_image);
+	for (int i = 0; i < count; i++) {
+		out_float[i] = in[i] * scale + offset;
 	}
-	delete mi_ptr;
+
+	return true;
+}
+
+bool
+sample_crop_and_normalize(const crop_map &map, const cv::Mat &input_image, cv::Mat &out_uint8, float *out_float)
+{
+	XRT_TRACE_MARKER();
+
+	assert(map.valid);
+	assert(map.rows == input_image.rows && map.cols == input_image.cols && map.step == input_image.step[0]);
+
+	out_uint8.create(wsize, wsize, CV_8U);
+
+	const uint8_t *src = input_image.data;
+	const int32_t *offsets = map.offsets.data();
+	uint8_t *dst = out_uint8.data;
+
+	uint64_t sum = 0;
+	uint64_t sum_sq = 0;
+
+	for (int i = 0; i < wsize * wsize; i++) {
+		int32_t o = offsets[i];
+
+		// All ones if the pixel is inside of the image, zero if not. Reads the first pixel for the outside ones
+		// rather than branching on every pixel.
+		int32_t inside = ~(o >> 31);
+		uint8_t px = src[o & inside] & (uint8_t)inside;
+
+		dst[i] = px;
+		sum += px;
+		sum_sq += px * px;
+	}
+
+	return normalize_from_sums(dst, wsize * wsize, sum, sum_sq, out_float);
 }
+
+bool
+normalize_grayscale_image(const cv::Mat &in, float *out_float)
+{
+	XRT_TRACE_MARKER();
+
+	assert(in.type() == CV_8U);
+	assert(in.isContinuous());
+
+	const uint8_t *data = in.data;
+	int count = in.rows * in.cols;
+
+	uint64_t sum = 0;
+	uint64_t sum_sq = 0;
+
+	for (int y = 0; y < in.rows; y++) {
+		const uint8_t *row = data + y * in.cols;
+
+		// Fits easily, even for rows far wider than any camera.
+		uint32_t row_sum = 0;
+		uint32_t row_sum_sq = 0;
+
+		for (int x = 0; x < in.cols; x++) {
+			row_sum += row[x];
+			row_sum_sq += row[x] * row[x];
+		}
+
+		sum += row_sum;
+		sum_sq += row_sum_sq;
+	}
+
+	return normalize_from_sums(data, count, sum, sum_sq, out_float);
+}
+
 } // namespace xrt::tracking::hand::mercury
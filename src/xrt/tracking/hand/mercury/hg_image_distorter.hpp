@@ -0,0 +1,117 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief  Stereographic projections of camera images into keypoint model inputs.
+ * @ingroup tracking
+ */
+
+#pragma once
+
+#include "xrt/xrt_defines.h"
+#include "tracking/t_camera_models.h"
+
+#include "kine_common.hpp"
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <opencv2/core.hpp>
+
+#include <array>
+#include <stdint.h>
+#include <vector>
+
+
+namespace xrt::tracking::hand::mercury {
+
+using hand21_2d = std::array<vec2_5, 21>;
+
+struct projection_instructions
+{
+	Eigen::Quaternionf rot_quat = Eigen::Quaternionf::Identity();
+	float stereographic_radius = 0;
+	bool flip = false;
+	const t_camera_model_params &dist;
+
+	projection_instructions(const t_camera_model_params &dist) : dist(dist) {}
+};
+
+// For each pixel of a 128x128 crop, the offset of the nearest pixel in the input image, or -1 if it falls outside of
+// it. Kept per view and hand, so it can be reused while the region of interest barely moves between frames.
+struct crop_map
+{
+	bool valid = false;
+
+	// What the map was made for.
+	Eigen::Quaternionf rot_quat = Eigen::Quaternionf::Identity();
+	float stereographic_radius = 0;
+	bool flip = false;
+	int rows = 0;
+	int cols = 0;
+	size_t step = 0;
+
+	std::vector<int32_t> offsets = {};
+};
+
+
+void
+make_projection_instructions(t_camera_model_params &dist,
+                             bool flip_after,
+                             float expand_val,
+                             float twist,
+                             Eigen::Array<float, 3, 21> &joints,
+                             projection_instructions &out_instructions,
+                             hand21_2d &out_hand);
+
+
+void
+make_projection_instructions_angular(xrt_vec3 direction_3d,
+                                     bool flip_after,
+                                     float angular_radius,
+                                     float expand_val,
+                                     float twist,
+                                     projection_instructions &out_instructions);
+
+/*!
+ * Makes @p map for sampling a crop out of @p input_image as described by @p instructions.
+ *
+ * If the map already made for the previous frame is off by at most @p reuse_tolerance_px pixels anywhere in the crop,
+ * it is kept and @p instructions is changed to what the map was made for, so keypoints are read back with the same
+ * projection the crop was made with. Zero tolerance always makes a new map.
+ *
+ * @return true if the map was reused.
+ */
+bool
+stereographic_crop_map(const t_camera_model_params &dist,
+                       projection_instructions &instructions,
+                       const cv::Mat &input_image,
+                       float reuse_tolerance_px,
+                       crop_map &map);
+
+// Draws the outline of the crop into the debug image.
+void
+draw_stereographic_crop_boundary(const t_camera_model_params &dist,
+                                 const projection_instructions &instructions,
+                                 const cv::Scalar boundary_color,
+                                 cv::Mat &debug_image);
+
+/*!
+ * Samples the crop in @p map out of @p input_image into @p out_uint8, and writes it normalized to a mean of 0.5 and a
+ * standard deviation of 0.25 into the 128x128 float tensor @p out_float. The statistics are gathered while sampling,
+ * so the input image is only read once.
+ *
+ * @return false if the crop is a single flat colour, @p out_float is not written then.
+ */
+bool
+sample_crop_and_normalize(const crop_map &map, const cv::Mat &input_image, cv::Mat &out_uint8, float *out_float);
+
+/*!
+ * Writes @p in normalized to a mean of 0.5 and a standard deviation of 0.25 into the tightly packed float tensor
+ * @p out_float.
+ *
+ * @return false if the image is a single flat colour, @p out_float is not written then.
+ */
+bool
+normalize_grayscale_image(const cv::Mat &in, float *out_float);
+
+} // namespace xrt::tracking::hand::mercury
@@ -26,6 +26,29 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
                                     struct t_camera_extra_info extra_camera_info,
                                     const char *models_folder);
 
+/*!
+ * How long each stage of Mercury hand tracking took for the last frame.
+ *
+ * @ingroup aux_tracking
+ */
+struct t_hand_tracking_mercury_timings
+{
+	float detection_ms; //!< Hand detection model, zero if it didn't run this frame
+	float keypoint_ms;  //!< Cropping and the keypoint model
+	float infer_ms;     //!< Everything before the optimizer, including the two above
+	float optimize_ms;  //!< Kinematic optimizer and region of interest prediction
+};
+
+/*!
+ * Get the stage timings of the last frame a Mercury pipeline processed. Only
+ * consistent if nothing is being processed while this is called.
+ *
+ * @ingroup aux_tracking
+ */
+void
+t_hand_tracking_sync_mercury_get_timings(struct t_hand_tracking_sync *ht_sync,
+                                         struct t_hand_tracking_mercury_timings *out_timings);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
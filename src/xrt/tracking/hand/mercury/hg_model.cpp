@@ -240,143 +240,261 @@ refine_center_of_distribution(struct HandTracking *hgt, //
 	return true;
 }
 
-static bool
-normalizeGrayscaleImage(cv::Mat &data_in, cv::Mat &data_out)
+static void
+setup_ort_api(HandTracking *hgt, onnx_wrap *wrap, std::filesystem::path path, int num_threads, int max_batch)
 {
-	data_in.convertTo(data_out, CV_32FC1, 1 / 255.0);
+	wrap->api = OrtGetApiBase()->GetApi(ORT_API_VERSION);
+	OrtSessionOptions *opts = nullptr;
 
-	cv::Mat mean;
-	cv::Mat stddev;
-	cv::meanStdDev(data_out, mean, stddev);
+	ORT(CreateEnv(ORT_LOGGING_LEVEL_FATAL, "monado_ht", &wrap->env));
 
-	if (stddev.at<double>(0, 0) == 0) {
-		U_LOG_W("Got image with zero standard deviation!");
-		return false;
-	}
+	ORT(CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &wrap->meminfo));
 
-	data_out *= 0.25 / stddev.at<double>(0, 0);
+	ORT(CreateSessionOptions(&opts));
 
-	// Calculate it again; mean has changed. Yes we don't need to but it's easy
-	//! @todo optimize
-	cv::meanStdDev(data_out, mean, stddev);
-	data_out += (0.5 - mean.at<double>(0, 0));
-	return true;
-}
+	ORT(SetSessionGraphOptimizationLevel(opts, ORT_ENABLE_ALL));
+	// One session serves all views and hands, so a batch gets the threads that per-crop runs used to be spread
+	// over. Don't let them spin between runs, we only run each model once or twice per frame.
+	ORT(SetIntraOpNumThreads(opts, num_threads));
+	ORT(AddSessionConfigEntry(opts, "session.intra_op.allow_spinning", "0"));
 
-void
-setup_ort_api(HandTracking *hgt, onnx_wrap *wrap, std::filesystem::path path)
-{
-	wrap->api = OrtGetApiBase()->GetApi(ORT_API_VERSION);
-	OrtSessionOptions *opts = nullptr;
+	ORT(CreateSession(wrap->env, path.c_str(), opts, &wrap->session));
+	assert(wrap->session != NULL);
+	wrap->api->ReleaseSessionOptions(opts);
 
+	// Same settings as the per-crop path, the worker group provides the parallelism.
 	ORT(CreateSessionOptions(&opts));
 
 	ORT(SetSessionGraphOptimizationLevel(opts, ORT_ENABLE_ALL));
 	ORT(SetIntraOpNumThreads(opts, 1));
 
-	ORT(CreateEnv(ORT_LOGGING_LEVEL_FATAL, "monado_ht", &wrap->env));
+	for (int i = 0; i < max_batch; i++) {
+		ORT(CreateSession(wrap->env, path.c_str(), opts, &wrap->item_sessions[i]));
+		assert(wrap->item_sessions[i] != NULL);
+	}
+	wrap->api->ReleaseSessionOptions(opts);
+}
 
-	ORT(CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &wrap->meminfo));
+// Gets the shape of a model input or output from the model itself and allocates room for max_batch items.
+static void
+setup_model_io(HandTracking *hgt, onnx_wrap *wrap, bool is_output, const char *name)
+{
+	OrtAllocator *allocator = nullptr;
+	ORT(GetAllocatorWithDefaultOptions(&allocator));
 
-	ORT(CreateSession(wrap->env, path.c_str(), opts, &wrap->session));
-	assert(wrap->session != NULL);
-	wrap->api->ReleaseSessionOptions(opts);
+	size_t count = 0;
+	if (is_output) {
+		ORT(SessionGetOutputCount(wrap->session, &count));
+	} else {
+		ORT(SessionGetInputCount(wrap->session, &count));
+	}
+
+	OrtTypeInfo *type_info = nullptr;
+	for (size_t i = 0; i < count && type_info == nullptr; i++) {
+		char *model_name = nullptr;
+		if (is_output) {
+			ORT(SessionGetOutputName(wrap->session, i, allocator, &model_name));
+		} else {
+			ORT(SessionGetInputName(wrap->session, i, allocator, &model_name));
+		}
+
+		bool match = strcmp(model_name, name) == 0;
+		ORT(AllocatorFree(allocator, model_name));
+		if (!match) {
+			continue;
+		}
+
+		if (is_output) {
+			ORT(SessionGetOutputTypeInfo(wrap->session, i, &type_info));
+		} else {
+			ORT(SessionGetInputTypeInfo(wrap->session, i, &type_info));
+		}
+	}
+
+	if (type_info == nullptr) {
+		HG_ERROR(hgt, "Model has no %s named '%s'", is_output ? "output" : "input", name);
+		assert(false);
+		return;
+	}
+
+	model_io_wrap io = {};
+	io.name = name;
+
+	const OrtTensorTypeAndShapeInfo *tensor_info = nullptr;
+	ORT(CastTypeInfoToTensorInfo(type_info, &tensor_info));
+	ORT(GetDimensionsCount(tensor_info, &io.num_dimensions));
+	assert(io.num_dimensions > 0 && io.num_dimensions <= ARRAY_SIZE(io.dimensions));
+	ORT(GetDimensions(tensor_info, io.dimensions, io.num_dimensions));
+	wrap->api->ReleaseTypeInfo(type_info);
+
+	// Models exported with a fixed batch size of one can still be run, one item at a time.
+	bool dynamic_batch = io.dimensions[0] < 0;
+	wrap->can_batch = wrap->can_batch && dynamic_batch;
+	if (dynamic_batch) {
+		io.dimensions[0] = 1;
+	}
+
+	io.item_size = 1;
+	for (size_t i = 0; i < io.num_dimensions; i++) {
+		// We need to know how much memory to bind, only the batch dimension can be dynamic.
+		assert(io.dimensions[i] > 0);
+		io.item_size *= io.dimensions[i];
+	}
+
+	io.data = (float *)calloc(io.item_size * wrap->max_batch, sizeof(float));
+
+	if (is_output) {
+		wrap->outputs.push_back(io);
+	} else {
+		wrap->inputs.push_back(io);
+	}
 }
 
-void
-setup_model_image_input(HandTracking *hgt, onnx_wrap *wrap, const char *name, int64_t w, int64_t h)
+// Binds count items starting at first_slot to all inputs and outputs of session.
+static OrtIoBinding *
+make_binding(HandTracking *hgt, onnx_wrap *wrap, OrtSession *session, int first_slot, int count)
 {
-	model_input_wrap inputimg = {};
-	inputimg.name = name;
-	inputimg.dimensions[0] = 1;
-	inputimg.dimensions[1] = 1;
-	inputimg.dimensions[2] = h;
-	inputimg.dimensions[3] = w;
-	inputimg.num_dimensions = 4;
-	size_t data_size = w * h * sizeof(float);
-	inputimg.data = (float *)malloc(data_size);
-
-	ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                       //
-	                                   inputimg.data,                       //
-	                                   data_size,                           //
-	                                   inputimg.dimensions,                 //
-	                                   inputimg.num_dimensions,             //
-	                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, //
-	                                   &inputimg.tensor));
-
-	assert(inputimg.tensor);
-	int is_tensor;
-	ORT(IsTensor(inputimg.tensor, &is_tensor));
-	assert(is_tensor);
-
-	wrap->wraps.push_back(inputimg);
+	OrtIoBinding *binding = nullptr;
+	ORT(CreateIoBinding(session, &binding));
+
+	auto bind = [&](model_io_wrap &io, bool is_output) {
+		int64_t dimensions[4];
+		memcpy(dimensions, io.dimensions, sizeof(dimensions));
+		dimensions[0] *= count;
+
+		OrtValue *value = nullptr;
+		ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                        //
+		                                   io.item(first_slot),                  //
+		                                   io.item_size * count * sizeof(float), //
+		                                   dimensions,                           //
+		                                   io.num_dimensions,                    //
+		                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT,  //
+		                                   &value));
+		assert(value);
+		wrap->values.push_back(value);
+
+		if (is_output) {
+			ORT(BindOutput(binding, io.name, value));
+		} else {
+			ORT(BindInput(binding, io.name, value));
+		}
+	};
+
+	for (model_io_wrap &io : wrap->inputs) {
+		bind(io, false);
+	}
+	for (model_io_wrap &io : wrap->outputs) {
+		bind(io, true);
+	}
+
+	return binding;
 }
 
-void
-init_hand_detection(HandTracking *hgt, onnx_wrap *wrap)
+static void
+init_model(HandTracking *hgt,
+           onnx_wrap *wrap,
+           const char *filename,
+           const std::vector<const char *> &input_names,
+           const std::vector<const char *> &output_names,
+           int max_batch,
+           int num_threads)
 {
+	assert(max_batch <= kMaxModelBatch);
+
 	std::filesystem::path path = hgt->models_folder;
+	path /= filename;
 
-	path /= "grayscale_detection_160x160.onnx";
+	setup_ort_api(hgt, wrap, path, num_threads, max_batch);
 
-	wrap->wraps.clear();
+	wrap->max_batch = max_batch;
+	wrap->can_batch = true;
+	wrap->inputs.clear();
+	wrap->outputs.clear();
 
-	setup_ort_api(hgt, wrap, path);
+	for (const char *name : input_names) {
+		setup_model_io(hgt, wrap, false, name);
+	}
+	for (const char *name : output_names) {
+		setup_model_io(hgt, wrap, true, name);
+	}
+
+	for (int i = 0; i < max_batch; i++) {
+		wrap->item_bindings[i] = make_binding(hgt, wrap, wrap->item_sessions[i], i, 1);
+		if (wrap->can_batch) {
+			wrap->batch_bindings[i] = make_binding(hgt, wrap, wrap->session, 0, i + 1);
+		}
+	}
 
-	setup_model_image_input(hgt, wrap, "inputImg", kDetectionInputSize, kDetectionInputSize);
+	if (!wrap->can_batch) {
+		HG_INFO(hgt, "Model '%s' has a fixed batch size, will run it once per item", filename);
+	}
 }
 
+static void
+run_model(HandTracking *hgt, onnx_wrap *wrap, OrtSession *session, OrtIoBinding *binding)
+{
+	XRT_TRACE_IDENT(model);
+	ORT(RunWithBinding(session, nullptr, binding));
+}
+
+static bool
+should_batch(HandTracking *hgt, onnx_wrap *wrap)
+{
+	return wrap->can_batch && hgt->tuneable_values.batch_model_inference;
+}
 
 void
-run_hand_detection(void *ptr)
+init_hand_detection(HandTracking *hgt, onnx_wrap *wrap, int num_threads)
+{
+	init_model(hgt, wrap, "grayscale_detection_160x160.onnx", //
+	           {"inputImg"},                                  //
+	           {"hand_exists", "cx", "cy", "size"},           //
+	           2, num_threads);
+}
+
+static void
+prepare_hand_detection(void *ptr)
 {
 	XRT_TRACE_MARKER();
 
 	hand_detection_run_info *info = (hand_detection_run_info *)ptr;
 	ht_view *view = info->view;
-	HandTracking *hgt = view->hgt;
-	onnx_wrap *wrap = &view->detection;
+	onnx_wrap *wrap = &view->hgt->detection_model;
 
 	cv::Mat &orig_data = view->run_model_on_this;
 
-	cv::Mat binned_uint8;
-
 	xrt_size desired_bin_size;
 	desired_bin_size.h = kDetectionInputSize;
 	desired_bin_size.w = kDetectionInputSize;
 
-	cv::Matx23f go_back = blackbar(orig_data, view->camera_info.camera_orientation, binned_uint8, desired_bin_size);
-
-	cv::Mat binned_float_wrapper_mat(cv::Size(kDetectionInputSize, kDetectionInputSize),
-	                                 CV_32FC1,            //
-	                                 wrap->wraps[0].data, //
-	                                 kDetectionInputSize * sizeof(float));
+	info->go_back = blackbar(orig_data, view->camera_info.camera_orientation, info->binned_uint8, desired_bin_size);
 
-	normalizeGrayscaleImage(binned_uint8, binned_float_wrapper_mat);
+	float *input = wrap->inputs[0].item(info->slot);
 
-	const OrtValue *inputs[] = {wrap->wraps[0].tensor};
-	const char *input_names[] = {wrap->wraps[0].name};
+	if (!normalize_grayscale_image(info->binned_uint8, input)) {
+		// A flat image, nothing will be detected in it but the input still needs to be written.
+		cv::Mat binned_float_wrapper_mat(cv::Size(kDetectionInputSize, kDetectionInputSize), CV_32FC1, input,
+		                                 kDetectionInputSize * sizeof(float));
+		info->binned_uint8.convertTo(binned_float_wrapper_mat, CV_32FC1, 1 / 255.0);
+	}
+}
 
-	OrtValue *output_tensors[] = {nullptr, nullptr, nullptr, nullptr};
-	const char *output_names[] = {"hand_exists", "cx", "cy", "size"};
+static void
+interpret_hand_detection(void *ptr)
+{
+	XRT_TRACE_MARKER();
 
-	{
-		XRT_TRACE_IDENT(model);
-		static_assert(ARRAY_SIZE(input_names) == ARRAY_SIZE(inputs));
-		static_assert(ARRAY_SIZE(output_names) == ARRAY_SIZE(output_tensors));
-		ORT(Run(wrap->session, nullptr, input_names, inputs, ARRAY_SIZE(input_names), output_names,
-		        ARRAY_SIZE(output_names), output_tensors));
-	}
+	hand_detection_run_info *info = (hand_detection_run_info *)ptr;
+	ht_view *view = info->view;
+	HandTracking *hgt = view->hgt;
+	onnx_wrap *wrap = &hgt->detection_model;
 
-	float *hand_exists = nullptr;
-	float *cx = nullptr;
-	float *cy = nullptr;
-	float *sizee = nullptr;
+	cv::Matx23f &go_back = info->go_back;
 
-	ORT(GetTensorMutableData(output_tensors[0], (void **)&hand_exists));
-	ORT(GetTensorMutableData(output_tensors[1], (void **)&cx));
-	ORT(GetTensorMutableData(output_tensors[2], (void **)&cy));
-	ORT(GetTensorMutableData(output_tensors[3], (void **)&sizee));
+	float *hand_exists = wrap->outputs[0].item(info->slot);
+	float *cx = wrap->outputs[1].item(info->slot);
+	float *cy = wrap->outputs[2].item(info->slot);
+	float *sizee = wrap->outputs[3].item(info->slot);
 
 
 
@@ -420,131 +538,69 @@ run_hand_detection(void *ptr)
 			int start_y = top_of_rect_y + ((kDetectionInputSize + kVisSpacerSize) * view->view);
 			cv::Rect p = cv::Rect(left_of_rect_x, start_y, kDetectionInputSize, kDetectionInputSize);
 
-			binned_uint8.copyTo(hgt->visualizers.mat(p));
+			info->binned_uint8.copyTo(hgt->visualizers.mat(p));
 		}
 	}
-
-	for (size_t i = 0; i < ARRAY_SIZE(output_tensors); i++) {
-		wrap->api->ReleaseValue(output_tensors[i]);
-	}
 }
 
-void
-init_keypoint_estimation(HandTracking *hgt, onnx_wrap *wrap)
+// Prepares, runs and interprets a single view, used when not batching.
+static void
+run_hand_detection_item(void *ptr)
 {
+	hand_detection_run_info *info = (hand_detection_run_info *)ptr;
+	HandTracking *hgt = info->view->hgt;
+	onnx_wrap *wrap = &hgt->detection_model;
 
-	std::filesystem::path path = hgt->models_folder;
-
-	path /= "grayscale_keypoint_jan18.onnx";
-
-	wrap->wraps.clear();
-
-
-	wrap->api = OrtGetApiBase()->GetApi(ORT_API_VERSION);
-
-
-	OrtSessionOptions *opts = nullptr;
-	ORT(CreateSessionOptions(&opts));
-
-	// TODO review options, config for threads?
-	ORT(SetSessionGraphOptimizationLevel(opts, ORT_ENABLE_ALL));
-	ORT(SetIntraOpNumThreads(opts, 1));
-
-
-	ORT(CreateEnv(ORT_LOGGING_LEVEL_FATAL, "monado_ht", &wrap->env));
-
-	ORT(CreateCpuMemoryInfo(OrtArenaAllocator, OrtMemTypeDefault, &wrap->meminfo));
-
-	// HG_DEBUG(this->device, "Loading hand detection model from file '%s'", path.c_str());
-	ORT(CreateSession(wrap->env, path.c_str(), opts, &wrap->session));
-	assert(wrap->session != NULL);
-
-	// size_t input_size = wrap->input_shape[0] * wrap->input_shape[1] * wrap->input_shape[2] *
-	// wrap->input_shape[3];
-
-	// wrap->data = (float *)malloc(input_size * sizeof(float));
-	{
-		model_input_wrap inputimg = {};
-		inputimg.name = "inputImg";
-		inputimg.dimensions[0] = 1;
-		inputimg.dimensions[1] = 1;
-		inputimg.dimensions[2] = 128;
-		inputimg.dimensions[3] = 128;
-		inputimg.num_dimensions = 4;
-
-		inputimg.data = (float *)malloc(128 * 128 * sizeof(float)); // SORRY IM BUSY
-
-
+	prepare_hand_detection(ptr);
+	run_model(hgt, wrap, wrap->item_sessions[info->slot], wrap->item_bindings[info->slot]);
+	interpret_hand_detection(ptr);
+}
 
-		ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                       //
-		                                   inputimg.data,                       //
-		                                   128 * 128 * sizeof(float),           //
-		                                   inputimg.dimensions,                 //
-		                                   inputimg.num_dimensions,             //
-		                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, //
-		                                   &inputimg.tensor));
+void
+run_hand_detection(HandTracking *hgt, hand_detection_run_info *infos, int count)
+{
+	XRT_TRACE_MARKER();
 
-		assert(inputimg.tensor);
-		int is_tensor;
-		ORT(IsTensor(inputimg.tensor, &is_tensor));
-		assert(is_tensor);
+	onnx_wrap *wrap = &hgt->detection_model;
+	assert(count <= wrap->max_batch);
 
-		wrap->wraps.push_back(inputimg);
+	for (int i = 0; i < count; i++) {
+		infos[i].slot = i;
 	}
 
-	{
-		model_input_wrap inputimg = {};
-		inputimg.name = "lastKeypoints";
-		inputimg.dimensions[0] = 1;
-		inputimg.dimensions[1] = 42;
-		inputimg.num_dimensions = 2;
-
-		inputimg.data = (float *)malloc(1 * 42 * sizeof(float)); // SORRY IM BUSY
-
-
-
-		ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                       //
-		                                   inputimg.data,                       //
-		                                   1 * 42 * sizeof(float),              //
-		                                   inputimg.dimensions,                 //
-		                                   inputimg.num_dimensions,             //
-		                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, //
-		                                   &inputimg.tensor));
+	if (!should_batch(hgt, wrap)) {
+		if (count == 1) {
+			run_hand_detection_item(&infos[0]);
+			return;
+		}
 
-		assert(inputimg.tensor);
-		int is_tensor;
-		ORT(IsTensor(inputimg.tensor, &is_tensor));
-		assert(is_tensor);
-		wrap->wraps.push_back(inputimg);
+		for (int i = 0; i < count; i++) {
+			u_worker_group_push(hgt->group, run_hand_detection_item, &infos[i]);
+		}
+		u_worker_group_wait_all(hgt->group);
+		return;
 	}
 
-	{
-		model_input_wrap inputimg = {};
-		inputimg.name = "useLastKeypoints";
-		inputimg.dimensions[0] = 1;
-		inputimg.num_dimensions = 1;
-
-		inputimg.data = (float *)malloc(1 * sizeof(float)); // SORRY IM BUSY
-
-
+	for (int i = 0; i < count; i++) {
+		u_worker_group_push(hgt->group, prepare_hand_detection, &infos[i]);
+	}
+	u_worker_group_wait_all(hgt->group);
 
-		ORT(CreateTensorWithDataAsOrtValue(wrap->meminfo,                       //
-		                                   inputimg.data,                       //
-		                                   1 * sizeof(float),                   //
-		                                   inputimg.dimensions,                 //
-		                                   inputimg.num_dimensions,             //
-		                                   ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT, //
-		                                   &inputimg.tensor));
+	run_model(hgt, wrap, wrap->session, wrap->batch_bindings[count - 1]);
 
-		assert(inputimg.tensor);
-		int is_tensor;
-		ORT(IsTensor(inputimg.tensor, &is_tensor));
-		assert(is_tensor);
-		wrap->wraps.push_back(inputimg);
+	// Cheap, not worth waking up the workers.
+	for (int i = 0; i < count; i++) {
+		interpret_hand_detection(&infos[i]);
 	}
+}
 
-
-	wrap->api->ReleaseSessionOptions(opts);
+void
+init_keypoint_estimation(HandTracking *hgt, onnx_wrap *wrap, int num_threads)
+{
+	init_model(hgt, wrap, "grayscale_keypoint_jan18.onnx",                //
+	           {"inputImg", "lastKeypoints", "useLastKeypoints"},         //
+	           {"heatmap_xy", "heatmap_depth", "scalar_extras", "curls"}, //
+	           kMaxModelBatch, num_threads);
 }
 
 enum xrt_hand_joint joints_ml_to_xr[21]{
@@ -633,24 +689,26 @@ set_predicted_zero(float *data)
 	}
 }
 
-void
-run_keypoint_estimation(void *ptr)
+static void
+prepare_keypoint_estimation(void *ptr)
 {
 	XRT_TRACE_MARKER();
-	keypoint_estimation_run_info info = *(keypoint_estimation_run_info *)ptr;
+	keypoint_estimation_run_info &info = *(keypoint_estimation_run_info *)ptr;
 
-	onnx_wrap *wrap = &info.view->keypoint[info.hand_idx];
 	struct HandTracking *hgt = info.view->hgt;
+	onnx_wrap *wrap = &hgt->keypoint_model;
+	float *input_img = wrap->inputs[0].item(info.slot);
+	float *input_last_keypoints = wrap->inputs[1].item(info.slot);
+	float *input_use_last_keypoints = wrap->inputs[2].item(info.slot);
 
 	int view_idx = info.view->view;
 	int hand_idx = info.hand_idx;
 	one_frame_one_view &this_output = hgt->keypoint_outputs[hand_idx].views[view_idx];
-	MLOutput2D &px_coord = this_output.keypoints_in_scaled_stereographic;
 	// Factor out starting here
 
 	hand_region_of_interest &output = info.view->regions_of_interest_this_frame[hand_idx];
 
-	cv::Mat data_128x128_uint8;
+	cv::Mat &data_128x128_uint8 = info.data_128x128_uint8;
 
 	projection_instructions instr(info.view->hgdist);
 	instr.rot_quat = Eigen::Quaternionf::Identity();
@@ -709,8 +767,8 @@ run_keypoint_estimation(void *ptr)
 		make_projection_instructions_angular(center, hand_idx, angle,
 		                                     hgt->tuneable_values.after_detection_fac.val, twist, instr);
 
-		wrap->wraps[2].data[0] = 0.0f;
-		set_predicted_zero(wrap->wraps[1].data);
+		input_use_last_keypoints[0] = 0.0f;
+		set_predicted_zero(input_last_keypoints);
 	} else {
 		Eigen::Array<float, 3, 21> keypoints_in_camera;
 
@@ -736,66 +794,60 @@ run_keypoint_estimation(void *ptr)
 
 		if (hgt->tuneable_values.enable_pose_predicted_input) {
 			for (int ml_joint_idx = 0; ml_joint_idx < 21; ml_joint_idx++) {
-				float *data = wrap->wraps[1].data;
+				float *data = input_last_keypoints;
 				data[(ml_joint_idx * 2) + 0] = bleh[ml_joint_idx].pos_2d.x;
 				data[(ml_joint_idx * 2) + 1] = bleh[ml_joint_idx].pos_2d.y;
 				// data[(ml_joint_idx * 2) + 2] = bleh[ml_joint_idx].depth_relative_to_midpxm;
 			}
 
 
-			wrap->wraps[2].data[0] = 1.0f;
+			input_use_last_keypoints[0] = 1.0f;
 		} else {
-			wrap->wraps[2].data[0] = 0.0f;
-			set_predicted_zero(wrap->wraps[1].data);
+			input_use_last_keypoints[0] = 0.0f;
+			set_predicted_zero(input_last_keypoints);
 		}
 	}
 
-	stereographic_project_image(dist, instr, hgt->views[view_idx].run_model_on_this,
-	                            &hgt->views[view_idx].debug_out_to_this, info.hand_idx ? RED : YELLOW,
-	                            data_128x128_uint8);
-
-
-	xrt::auxiliary::math::map_quat(this_output.look_dir) = instr.rot_quat;
-	this_output.stereographic_radius = instr.stereographic_radius;
+	cv::Mat &run_model_on_this = hgt->views[view_idx].run_model_on_this;
 
-	bool is_hand = true;
+	// May hand back the instructions the cached map was made for, so read the crop pose after this.
+	stereographic_crop_map(dist, instr, run_model_on_this, hgt->tuneable_values.crop_map_reuse_px.val,
+	                       info.view->crop_maps[hand_idx]);
 
-	{
-		XRT_TRACE_IDENT(convert_format);
-
-		// here!
-		cv::Mat data_128x128_float(cv::Size(128, 128), CV_32FC1, wrap->wraps[0].data, 128 * sizeof(float));
-
-		is_hand = is_hand && normalizeGrayscaleImage(data_128x128_uint8, data_128x128_float);
+	if (hgt->debug_scribble) {
+		draw_stereographic_crop_boundary(dist, instr, info.hand_idx ? RED : YELLOW,
+		                                 hgt->views[view_idx].debug_out_to_this);
 	}
 
 
-	// Ending here
-
-
-	const OrtValue *inputs[] = {wrap->wraps[0].tensor, wrap->wraps[1].tensor, wrap->wraps[2].tensor};
-	const char *input_names[] = {wrap->wraps[0].name, wrap->wraps[1].name, wrap->wraps[2].name};
-
-	OrtValue *output_tensors[] = {nullptr, nullptr, nullptr, nullptr};
-	const char *output_names[] = {"heatmap_xy", "heatmap_depth", "scalar_extras", "curls"};
+	xrt::auxiliary::math::map_quat(this_output.look_dir) = instr.rot_quat;
+	this_output.stereographic_radius = instr.stereographic_radius;
 
-	{
-		XRT_TRACE_IDENT(model);
-		assert(ARRAY_SIZE(input_names) == ARRAY_SIZE(inputs));
-		assert(ARRAY_SIZE(output_names) == ARRAY_SIZE(output_tensors));
-		ORT(Run(wrap->session, nullptr, input_names, inputs, ARRAY_SIZE(input_names), output_names,
-		        ARRAY_SIZE(output_names), output_tensors));
-	}
+	// Samples, gathers statistics and writes the model input in one go.
+	info.is_hand = sample_crop_and_normalize(info.view->crop_maps[hand_idx], run_model_on_this,
+	                                         data_128x128_uint8, input_img);
+}
 
-	// To here
+// Interpret model outputs!
+static void
+interpret_keypoint_estimation(void *ptr)
+{
+	XRT_TRACE_MARKER();
+	keypoint_estimation_run_info &info = *(keypoint_estimation_run_info *)ptr;
 
-	// Interpret model outputs!
+	struct HandTracking *hgt = info.view->hgt;
+	onnx_wrap *wrap = &hgt->keypoint_model;
 
+	int view_idx = info.view->view;
+	int hand_idx = info.hand_idx;
+	one_frame_one_view &this_output = hgt->keypoint_outputs[hand_idx].views[view_idx];
+	MLOutput2D &px_coord = this_output.keypoints_in_scaled_stereographic;
 
-	float *out_data = nullptr;
+	cv::Mat &data_128x128_uint8 = info.data_128x128_uint8;
+	bool is_hand = info.is_hand;
 
 
-	ORT(GetTensorMutableData(output_tensors[0], (void **)&out_data));
+	float *out_data = wrap->outputs[0].item(info.slot);
 
 	// I don't know why this was added
 	// float *confidences = info.view->keypoint_outputs.views[hand_idx].confidences;
@@ -839,8 +891,7 @@ run_keypoint_estimation(void *ptr)
 	}
 
 
-	float *out_data_depth = nullptr;
-	ORT(GetTensorMutableData(output_tensors[1], (void **)&out_data_depth));
+	float *out_data_depth = wrap->outputs[1].item(info.slot);
 
 	for (int joint_idx = 0; joint_idx < 21; joint_idx++) {
 		float *p_ptr = &out_data_depth[(joint_idx * 22)];
@@ -860,8 +911,7 @@ run_keypoint_estimation(void *ptr)
 		}
 	}
 
-	float *out_data_extras = nullptr;
-	ORT(GetTensorMutableData(output_tensors[2], (void **)&out_data_extras));
+	float *out_data_extras = wrap->outputs[2].item(info.slot);
 
 	float is_hand_explicit = out_data_extras[0];
 
@@ -878,8 +928,7 @@ run_keypoint_estimation(void *ptr)
 	this_output.active = is_hand;
 
 
-	float *out_data_curls = nullptr;
-	ORT(GetTensorMutableData(output_tensors[3], (void **)&out_data_curls));
+	float *out_data_curls = wrap->outputs[3].item(info.slot);
 
 	for (int i = 0; i < 5; i++) {
 		float curl = out_data_curls[i];
@@ -965,20 +1014,87 @@ run_keypoint_estimation(void *ptr)
 			cv::line(hgt->visualizers.mat, center, pt2, {0}, 1);
 		}
 	}
+}
 
-	for (size_t i = 0; i < ARRAY_SIZE(output_tensors); i++) {
-		wrap->api->ReleaseValue(output_tensors[i]);
+// Prepares, runs and interprets a single crop, used when not batching.
+static void
+run_keypoint_estimation_item(void *ptr)
+{
+	keypoint_estimation_run_info *info = (keypoint_estimation_run_info *)ptr;
+	HandTracking *hgt = info->view->hgt;
+	onnx_wrap *wrap = &hgt->keypoint_model;
+
+	prepare_keypoint_estimation(ptr);
+	run_model(hgt, wrap, wrap->item_sessions[info->slot], wrap->item_bindings[info->slot]);
+	interpret_keypoint_estimation(ptr);
+}
+
+void
+run_keypoint_estimation(HandTracking *hgt, keypoint_estimation_run_info **infos, int count)
+{
+	XRT_TRACE_MARKER();
+
+	onnx_wrap *wrap = &hgt->keypoint_model;
+	assert(count <= wrap->max_batch);
+
+	for (int i = 0; i < count; i++) {
+		infos[i]->slot = i;
+	}
+
+	if (!should_batch(hgt, wrap)) {
+		for (int i = 0; i < count; i++) {
+			u_worker_group_push(hgt->group, run_keypoint_estimation_item, infos[i]);
+		}
+		u_worker_group_wait_all(hgt->group);
+		return;
+	}
+
+	// Crop all hands in all views, then run them through the model together.
+	for (int i = 0; i < count; i++) {
+		u_worker_group_push(hgt->group, prepare_keypoint_estimation, infos[i]);
+	}
+	u_worker_group_wait_all(hgt->group);
+
+	run_model(hgt, wrap, wrap->session, wrap->batch_bindings[count - 1]);
+
+	for (int i = 0; i < count; i++) {
+		u_worker_group_push(hgt->group, interpret_keypoint_estimation, infos[i]);
 	}
+	u_worker_group_wait_all(hgt->group);
 }
 
 void
 release_onnx_wrap(onnx_wrap *wrap)
 {
+	if (wrap->api == nullptr) {
+		return;
+	}
+
+	// Bindings and tensors first, they point into the session and our buffers.
+	for (int i = 0; i < kMaxModelBatch; i++) {
+		if (wrap->batch_bindings[i] != nullptr) {
+			wrap->api->ReleaseIoBinding(wrap->batch_bindings[i]);
+		}
+		if (wrap->item_bindings[i] != nullptr) {
+			wrap->api->ReleaseIoBinding(wrap->item_bindings[i]);
+		}
+	}
+	for (OrtValue *value : wrap->values) {
+		wrap->api->ReleaseValue(value);
+	}
+	for (model_io_wrap &io : wrap->inputs) {
+		free(io.data);
+	}
+	for (model_io_wrap &io : wrap->outputs) {
+		free(io.data);
+	}
+
 	wrap->api->ReleaseMemoryInfo(wrap->meminfo);
 	wrap->api->ReleaseSession(wrap->session);
-	for (model_input_wrap &a : wrap->wraps) {
-		wrap->api->ReleaseValue(a.tensor);
-		free(a.data);
+	for (int i = 0; i < kMaxModelBatch; i++) {
+		if (wrap->item_sessions[i] != nullptr) {
+			wrap->api->ReleaseSession(wrap->item_sessions[i]);
+		}
 	}
 	wrap->api->ReleaseEnv(wrap->env);
 }
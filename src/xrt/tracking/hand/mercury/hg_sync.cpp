@@ -26,6 +26,7 @@ namespace xrt::tracking::hand::mercury {
 
 DEBUG_GET_ONCE_LOG_OPTION(mercury_log, "MERCURY_LOG", U_LOGGING_WARN)
 DEBUG_GET_ONCE_BOOL_OPTION(mercury_optimize_hand_size, "MERCURY_optimize_hand_size", true)
+DEBUG_GET_ONCE_BOOL_OPTION(mercury_batch_model_inference, "MERCURY_BATCH_MODEL_INFERENCE", true)
 
 // Flags to tell state tracker that these are indeed valid joints
 static const enum xrt_space_relation_flags valid_flags_ht = (enum xrt_space_relation_flags)(
@@ -147,16 +148,20 @@ check_outside_view(struct HandTracking *hgt, struct t_camera_extra_info_one_view
 	return false;
 }
 
+// If num_outside is set, also writes a region of interest around the hand to rois[view_idx][hand_idx]. If debug_out
+// is set it points to one debug image per view.
 static void
 back_project(struct HandTracking *hgt,        //
              Eigen::Array<float, 3, 21> &pts, //
              int hand_idx,                    //
-             bool also_debug_output,          //
-             int num_outside[2])
+             cv::Mat *debug_out,              //
+             int num_outside[2],              //
+             hand_region_of_interest rois[2][2])
 {
+	bool also_debug_output = debug_out != NULL;
 
 	for (int view_idx = 0; view_idx < 2; view_idx++) {
-		cv::Mat debug = hgt->views[view_idx].debug_out_to_this;
+		cv::Mat debug = also_debug_output ? debug_out[view_idx] : cv::Mat();
 		xrt_pose move_amount = {};
 
 		if (view_idx == 0) {
@@ -225,8 +230,8 @@ back_project(struct HandTracking *hgt,        //
 			float size = r * 2;
 
 
-			hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].center_px = center;
-			hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].size_px = size;
+			rois[view_idx][hand_idx].center_px = center;
+			rois[view_idx][hand_idx].size_px = size;
 			if (also_debug_output) {
 				handSquare(debug, center, size, GREEN);
 			}
@@ -247,13 +252,11 @@ back_project(struct HandTracking *hgt,        //
 
 static void
 back_project_keypoint_output(struct HandTracking *hgt, //
-                             int hand_idx,             //
-                             int view_idx)
+                             one_frame_one_view &view, //
+                             int view_idx,             //
+                             cv::Mat &debug)
 {
 
-	cv::Mat debug = hgt->views[view_idx].debug_out_to_this;
-	one_frame_one_view &view = hgt->keypoint_outputs[hand_idx].views[view_idx];
-
 	for (int i = 0; i < 21; i++) {
 
 		//!@todo We're trivially rewriting the stereographic projection for like the 2nd or 3rd time here. We
@@ -317,6 +320,10 @@ handle_changed_image_size(HandTracking *hgt, xrt_size &new_one_view_size)
 		    hgt->views[view_idx].hgdist_orig.cx / hgt->multiply_px_coord_for_undistort;
 		hgt->views[view_idx].hgdist.cy =
 		    hgt->views[view_idx].hgdist_orig.cy / hgt->multiply_px_coord_for_undistort;
+
+		// Made with the old camera model.
+		hgt->views[view_idx].crop_maps[0].valid = false;
+		hgt->views[view_idx].crop_maps[1].valid = false;
 	}
 	return true;
 }
@@ -344,19 +351,29 @@ correct_direction(xrt_vec2 in)
 	return m_vec3_normalize(out);
 }
 
+// Called by the keypoint stage before hand detection, so that a new user's first frame already runs the detection
+// model in both views. The optimizer stage calls reset_for_new_user when it gets to the same frame.
 void
 check_new_user_event(struct HandTracking *hgt)
 {
+	hgt->new_user_this_frame = false;
 	if (hgt->tuneable_values.new_user_event) {
 		hgt->tuneable_values.new_user_event = false;
-		hgt->hand_seen_before[0] = false;
-		hgt->hand_seen_before[1] = false;
-		hgt->refinement.hand_size_refinement_schedule_x = 0;
-		hgt->refinement.optimizing = true;
-		hgt->target_hand_size = STANDARD_HAND_SIZE;
+		hgt->new_user_this_frame = true;
+		hgt->start_state.optimizing_hand_size = true;
 	}
 }
 
+static void
+reset_for_new_user(struct HandTracking *hgt)
+{
+	hgt->hand_seen_before[0] = false;
+	hgt->hand_seen_before[1] = false;
+	hgt->refinement.hand_size_refinement_schedule_x = 0;
+	hgt->refinement.optimizing = true;
+	hgt->target_hand_size = STANDARD_HAND_SIZE;
+}
+
 
 
 static float
@@ -375,12 +392,14 @@ void
 dispatch_and_process_hand_detections(struct HandTracking *hgt)
 {
 	if (hgt->tuneable_values.always_run_detection_model) {
-		// Pretend like nothing was detected last frame.
+		// Pretend like nothing was detected last frame. The history belongs to the optimizer stage, it clears it
+		// when it gets to this frame.
 		for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
 			hgt->this_frame_hand_detected[hand_idx] = false;
 
-			hgt->history_hands[hand_idx].clear();
+			hgt->start_state.history_hands[hand_idx].clear();
 		}
+		hgt->clear_history_this_frame = true;
 	}
 
 	hand_detection_run_info infos[2] = {};
@@ -407,14 +426,12 @@ dispatch_and_process_hand_detections(struct HandTracking *hgt)
 
 	int num_views = 0;
 
-	if (hgt->tuneable_values.always_run_detection_model || hgt->refinement.optimizing ||
+	if (hgt->tuneable_values.always_run_detection_model || hgt->start_state.optimizing_hand_size ||
 	    hgt->tuneable_values.detection_model_in_both_views) {
-		u_worker_group_push(hgt->group, run_hand_detection, &infos[0]);
-		u_worker_group_push(hgt->group, run_hand_detection, &infos[1]);
+		run_hand_detection(hgt, infos, 2);
 		num_views = 2;
-		u_worker_group_wait_all(hgt->group);
 	} else {
-		run_hand_detection(&infos[active_camera]);
+		run_hand_detection(hgt, &infos[active_camera], 1);
 		num_views = 1;
 	}
 
@@ -428,7 +445,8 @@ dispatch_and_process_hand_detections(struct HandTracking *hgt)
 		}
 
 
-		if (hgt->tuneable_values.always_run_detection_model || !hgt->last_frame_hand_detected[hand_idx]) {
+		if (hgt->tuneable_values.always_run_detection_model ||
+		    !hgt->start_state.last_frame_hand_detected[hand_idx]) {
 
 
 			bool good_to_go = true;
@@ -502,10 +520,13 @@ hand_joint_set_to_eigen_21(const xrt_hand_joint_set &set, Eigen::Array<float, 3,
 	}
 }
 
-// Most of the time, this codepath runs - we predict where the hand should be based on the last
+// Most of the time, this codepath runs - we predict where the hand should be at time_now based on the last
 // two frames.
 void
-predict_new_regions_of_interest(struct HandTracking *hgt)
+predict_new_regions_of_interest(struct HandTracking *hgt, //
+                                hg_tracked_state &state,  //
+                                uint64_t time_now,        //
+                                cv::Mat *debug_out)
 {
 
 	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
@@ -513,21 +534,20 @@ predict_new_regions_of_interest(struct HandTracking *hgt)
 		// If we only have *one* frame, we just reuse the same bounding box and hope the hand
 		// hasn't moved too much. @todo
 
-		auto &hh = hgt->history_hands[hand_idx];
+		auto &hh = state.history_hands[hand_idx];
 
 
 		if (hh.size() < 2) {
-			HG_TRACE(hgt, "continuing, size is %zu", hgt->history_hands[hand_idx].size());
+			HG_TRACE(hgt, "continuing, size is %zu", hh.size());
 			continue;
 		}
 
 		// We can only do this *after* we know we're predicting - this would otherwise overwrite the detection
 		// model.
-		hgt->this_frame_hand_detected[hand_idx] = hgt->last_frame_hand_detected[hand_idx];
+		state.this_frame_hand_detected[hand_idx] = state.last_frame_hand_detected[hand_idx];
 
-		uint64_t time_two_frames_ago = *hgt->history_timestamps.get_at_age(1);
-		uint64_t time_one_frame_ago = *hgt->history_timestamps.get_at_age(0);
-		uint64_t time_now = hgt->current_frame_timestamp;
+		uint64_t time_two_frames_ago = *state.history_timestamps.get_at_age(1);
+		uint64_t time_one_frame_ago = *state.history_timestamps.get_at_age(0);
 
 
 
@@ -547,22 +567,21 @@ predict_new_regions_of_interest(struct HandTracking *hgt)
 
 		add *= (dt_now * hgt->tuneable_values.amount_to_lerp_prediction.val) / dt_past;
 
-		hgt->pose_predicted_keypoints[hand_idx] = n_minus_one + add;
+		state.pose_predicted_keypoints[hand_idx] = n_minus_one + add;
 
 
 		int num_outside[2];
-		back_project(hgt, hgt->pose_predicted_keypoints[hand_idx], hand_idx,
-		             hgt->tuneable_values.scribble_predictions_into_next_frame && hgt->debug_scribble,
-		             num_outside);
+		back_project(hgt, state.pose_predicted_keypoints[hand_idx], hand_idx,
+		             hgt->tuneable_values.scribble_predictions_into_next_frame ? debug_out : NULL, num_outside,
+		             state.rois);
 
 		for (int view_idx = 0; view_idx < 2; view_idx++) {
 			if (num_outside[view_idx] < hgt->tuneable_values.max_num_outside_view) {
-				hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].provenance =
-				    ROIProvenance::POSE_PREDICTION;
-				hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].found = true;
+				state.rois[view_idx][hand_idx].provenance = ROIProvenance::POSE_PREDICTION;
+				state.rois[view_idx][hand_idx].found = true;
 
 			} else {
-				hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].found = false;
+				state.rois[view_idx][hand_idx].found = false;
 			}
 		}
 	}
@@ -635,6 +654,93 @@ scribble_image_boundary(struct HandTracking *hgt)
 	}
 }
 
+// Sets up this frame's regions of interest from the hands the optimizer stage last published. If it hasn't finished
+// the previous frame yet, as happens when the stages are pipelined, its predictions are for the wrong frame: predict
+// again from the same history, but to this frame's timestamp.
+static void
+start_from_tracked_state(struct HandTracking *hgt, uint64_t previous_frame_timestamp)
+{
+	os_mutex_lock(&hgt->tracked_state_mutex);
+	hgt->start_state = hgt->tracked_state;
+	os_mutex_unlock(&hgt->tracked_state_mutex);
+
+	hg_tracked_state &state = hgt->start_state;
+
+	if (state.timestamp != previous_frame_timestamp && !hgt->tuneable_values.always_run_detection_model) {
+		cv::Mat debug_out[2] = {hgt->views[0].debug_out_to_this, hgt->views[1].debug_out_to_this};
+		predict_new_regions_of_interest(hgt, state, hgt->current_frame_timestamp,
+		                                hgt->debug_scribble ? debug_out : NULL);
+	}
+
+	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+		hgt->views[0].regions_of_interest_this_frame[hand_idx] = state.rois[0][hand_idx];
+		hgt->views[1].regions_of_interest_this_frame[hand_idx] = state.rois[1][hand_idx];
+		hgt->this_frame_hand_detected[hand_idx] = state.this_frame_hand_detected[hand_idx];
+		hgt->pose_predicted_keypoints[hand_idx] = state.pose_predicted_keypoints[hand_idx];
+	}
+}
+
+// Gives this frame's keypoint stage results to the optimizer stage, first waiting for it to take the previous frame's.
+static void
+hand_off_keypoint_results(struct HandTracking *hgt, xrt_frame *debug_frame)
+{
+	hg_keypoint_results results = {};
+
+	results.timestamp = hgt->current_frame_timestamp;
+	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+		results.rois[0][hand_idx] = hgt->views[0].regions_of_interest_this_frame[hand_idx];
+		results.rois[1][hand_idx] = hgt->views[1].regions_of_interest_this_frame[hand_idx];
+		results.this_frame_hand_detected[hand_idx] = hgt->this_frame_hand_detected[hand_idx];
+		results.keypoint_outputs[hand_idx] = hgt->keypoint_outputs[hand_idx];
+	}
+
+	results.new_user = hgt->new_user_this_frame;
+	results.clear_history = hgt->clear_history_this_frame;
+
+	results.debug_scribble = hgt->debug_scribble;
+	if (hgt->debug_scribble) {
+		// Moves our references over to the results.
+		results.debug_frame = debug_frame;
+		results.model_frame = hgt->visualizers.xrtframe;
+		results.debug_out[0] = hgt->views[0].debug_out_to_this;
+		results.debug_out[1] = hgt->views[1].debug_out_to_this;
+
+		// We don't dereference the model inputs/outputs frame after pushing it; we make a copy of it next frame
+		// and dereference it then.
+		xrt_frame_reference(&hgt->visualizers.old_frame, hgt->visualizers.xrtframe);
+		hgt->visualizers.xrtframe = NULL;
+	}
+
+	uint64_t wait_start_ns = os_monotonic_get_ns();
+
+	os_mutex_lock(&hgt->handoff.mutex);
+	while (hgt->handoff.full) {
+		os_cond_wait(&hgt->handoff.cond, &hgt->handoff.mutex);
+	}
+	hgt->handoff.results = std::move(results);
+	hgt->handoff.full = true;
+	os_mutex_unlock(&hgt->handoff.mutex);
+
+	hgt->stage_timing.handoff_wait_ms = (float)time_ns_to_ms_f(os_monotonic_get_ns() - wait_start_ns);
+}
+
+// Takes the oldest keypoint stage results, returns false if there are none.
+static bool
+take_keypoint_results(struct HandTracking *hgt, hg_keypoint_results &out_results)
+{
+	os_mutex_lock(&hgt->handoff.mutex);
+	bool full = hgt->handoff.full;
+	if (full) {
+		out_results = std::move(hgt->handoff.results);
+		hgt->handoff.results = {};
+		hgt->handoff.full = false;
+		os_cond_signal(&hgt->handoff.cond);
+	}
+	os_mutex_unlock(&hgt->handoff.mutex);
+
+	return full;
+}
+
 /*
  *
  * Member functions.
@@ -644,9 +750,15 @@ scribble_image_boundary(struct HandTracking *hgt)
 HandTracking::HandTracking()
 {
 	this->base.process = &HandTracking::cCallbackProcess;
+	this->base.infer = &HandTracking::cCallbackInfer;
+	this->base.optimize = &HandTracking::cCallbackOptimize;
 	this->base.destroy = &HandTracking::cCallbackDestroy;
 	u_sink_debug_init(&this->debug_sink_ann);
 	u_sink_debug_init(&this->debug_sink_model);
+
+	os_mutex_init(&this->handoff.mutex);
+	os_cond_init(&this->handoff.cond);
+	os_mutex_init(&this->tracked_state_mutex);
 }
 
 HandTracking::~HandTracking()
@@ -655,15 +767,15 @@ HandTracking::~HandTracking()
 	u_sink_debug_destroy(&this->debug_sink_model);
 
 	xrt_frame_reference(&this->visualizers.old_frame, NULL);
+	xrt_frame_reference(&this->handoff.results.debug_frame, NULL);
+	xrt_frame_reference(&this->handoff.results.model_frame, NULL);
 
-	release_onnx_wrap(&this->views[0].keypoint[0]);
-	release_onnx_wrap(&this->views[0].keypoint[1]);
-	release_onnx_wrap(&this->views[0].detection);
-
+	os_mutex_destroy(&this->handoff.mutex);
+	os_cond_destroy(&this->handoff.cond);
+	os_mutex_destroy(&this->tracked_state_mutex);
 
-	release_onnx_wrap(&this->views[1].keypoint[0]);
-	release_onnx_wrap(&this->views[1].keypoint[1]);
-	release_onnx_wrap(&this->views[1].detection);
+	release_onnx_wrap(&this->keypoint_model);
+	release_onnx_wrap(&this->detection_model);
 
 	u_worker_group_reference(&this->group, NULL);
 
@@ -686,11 +798,23 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 {
 	XRT_TRACE_MARKER();
 
+	cCallbackInfer(ht_sync, left_frame, right_frame);
+	cCallbackOptimize(ht_sync, out_left_hand, out_right_hand, out_timestamp_ns);
+}
+
+void
+HandTracking::cCallbackInfer(struct t_hand_tracking_sync *ht_sync,
+                             struct xrt_frame *left_frame,
+                             struct xrt_frame *right_frame)
+{
+	XRT_TRACE_MARKER();
+
 	HandTracking *hgt = (struct HandTracking *)ht_sync;
 
-	hgt->current_frame_timestamp = left_frame->timestamp;
+	uint64_t start_ns = os_monotonic_get_ns();
 
-	struct xrt_hand_joint_set *out_xrt_hands[2] = {out_left_hand, out_right_hand};
+	uint64_t previous_frame_timestamp = hgt->current_frame_timestamp;
+	hgt->current_frame_timestamp = left_frame->timestamp;
 
 
 	/*
@@ -725,9 +849,6 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 	hgt->views[1].run_model_on_this = cv::Mat(view_size, CV_8UC1, right_frame->data, right_frame->stride);
 
 
-	*out_timestamp_ns = hgt->current_frame_timestamp; // No filtering, fine to do this now. Also just a reminder
-	                                                  // that this took you 2 HOURS TO DEBUG THAT ONE TIME.
-
 	hgt->debug_scribble =
 	    u_sink_debug_is_active(&hgt->debug_sink_ann) && u_sink_debug_is_active(&hgt->debug_sink_model);
 
@@ -777,14 +898,20 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 		}
 	}
 
-	check_new_user_event(hgt);
-
+	// Start from the hands as the optimizer stage last left them.
+	start_from_tracked_state(hgt, previous_frame_timestamp);
 
+	check_new_user_event(hgt);
+	hgt->clear_history_this_frame = false;
 
 	// Every now and then if we're not already tracking both hands, try to detect new hands.
-	bool saw_both_hands_last_frame = hgt->last_frame_hand_detected[0] && hgt->last_frame_hand_detected[1];
+	bool saw_both_hands_last_frame =
+	    hgt->start_state.last_frame_hand_detected[0] && hgt->start_state.last_frame_hand_detected[1];
+	hgt->stage_timing.detection_ms = 0;
 	if (!saw_both_hands_last_frame) {
+		uint64_t detection_start_ns = os_monotonic_get_ns();
 		dispatch_and_process_hand_detections(hgt);
+		hgt->stage_timing.detection_ms = (float)time_ns_to_ms_f(os_monotonic_get_ns() - detection_start_ns);
 	}
 
 	stop_everything_if_hands_are_overlapping(hgt);
@@ -800,7 +927,9 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 	}
 
 
-	// Dispatch keypoint estimator neural nets
+	// Run keypoint estimator neural nets
+	struct keypoint_estimation_run_info *keypoint_infos[kMaxModelBatch];
+	int keypoint_count = 0;
 	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
 		for (int view_idx = 0; view_idx < 2; view_idx++) {
 			if (!hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].found) {
@@ -810,20 +939,59 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 			struct keypoint_estimation_run_info &inf = hgt->views[view_idx].run_info[hand_idx];
 			inf.view = &hgt->views[view_idx];
 			inf.hand_idx = hand_idx;
-			u_worker_group_push(hgt->group, hgt->keypoint_estimation_run_func,
-			                    &hgt->views[view_idx].run_info[hand_idx]);
+			keypoint_infos[keypoint_count++] = &inf;
+		}
+	}
+	uint64_t keypoint_start_ns = os_monotonic_get_ns();
+	run_keypoint_estimation(hgt, keypoint_infos, keypoint_count);
+
+	uint64_t end_ns = os_monotonic_get_ns();
+	hgt->stage_timing.keypoint_ms = (float)time_ns_to_ms_f(end_ns - keypoint_start_ns);
+	hgt->stage_timing.infer_ms = (float)time_ns_to_ms_f(end_ns - start_ns);
+
+	hand_off_keypoint_results(hgt, debug_frame);
+}
+
+void
+HandTracking::cCallbackOptimize(struct t_hand_tracking_sync *ht_sync,
+                                struct xrt_hand_joint_set *out_left_hand,
+                                struct xrt_hand_joint_set *out_right_hand,
+                                uint64_t *out_timestamp_ns)
+{
+	XRT_TRACE_MARKER();
+
+	HandTracking *hgt = (struct HandTracking *)ht_sync;
+
+	hg_keypoint_results res = {};
+	if (!take_keypoint_results(hgt, res)) {
+		// The keypoint stage gave up on this frame, leave the hands as they were.
+		return;
+	}
+
+	uint64_t start_ns = os_monotonic_get_ns();
+
+	struct xrt_hand_joint_set *out_xrt_hands[2] = {out_left_hand, out_right_hand};
+
+	*out_timestamp_ns = res.timestamp; // No filtering, fine to do this now. Also just a reminder
+	                                   // that this took you 2 HOURS TO DEBUG THAT ONE TIME.
+
+	if (res.new_user) {
+		reset_for_new_user(hgt);
+	}
+
+	if (res.clear_history) {
+		for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+			hgt->history_hands[hand_idx].clear();
 		}
 	}
-	u_worker_group_wait_all(hgt->group);
 
 	// Spaghetti logic for optimizing hand size
 	bool any_hands_are_only_visible_in_one_view = false;
 
 	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
-		any_hands_are_only_visible_in_one_view =                             //
-		    any_hands_are_only_visible_in_one_view ||                        //
-		    (hgt->views[0].regions_of_interest_this_frame[hand_idx].found != //
-		     hgt->views[1].regions_of_interest_this_frame[hand_idx].found);
+		any_hands_are_only_visible_in_one_view =      //
+		    any_hands_are_only_visible_in_one_view || //
+		    (res.rois[0][hand_idx].found != res.rois[1][hand_idx].found);
 	}
 
 	constexpr float mul_max = 1.0;
@@ -848,8 +1016,8 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 
 	// if either hand was not visible before the last new-user event but is visible now, reset the schedule
 	// a bit.
-	if ((hgt->this_frame_hand_detected[0] && !hgt->hand_seen_before[0]) ||
-	    (hgt->this_frame_hand_detected[1] && !hgt->hand_seen_before[1])) {
+	if ((res.this_frame_hand_detected[0] && !hgt->hand_seen_before[0]) ||
+	    (res.this_frame_hand_detected[1] && !hgt->hand_seen_before[1])) {
 		hgt->refinement.hand_size_refinement_schedule_x =
 		    std::min(hgt->refinement.hand_size_refinement_schedule_x, frame_max / 2);
 	}
@@ -864,37 +1032,38 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 
 
 		for (int view_idx = 0; view_idx < 2; view_idx++) {
-			if (!hgt->views[view_idx].regions_of_interest_this_frame[hand_idx].found) {
+			if (!res.rois[view_idx][hand_idx].found) {
 				// to the next view
 				continue;
 			}
 
-			if (!hgt->keypoint_outputs[hand_idx].views[view_idx].active) {
+			if (!res.keypoint_outputs[hand_idx].views[view_idx].active) {
 				HG_DEBUG(hgt, "Removing hand %d because keypoint estimator said to!", hand_idx);
-				hgt->this_frame_hand_detected[hand_idx] = false;
+				res.this_frame_hand_detected[hand_idx] = false;
 			}
 		}
 
-		if (!hgt->this_frame_hand_detected[hand_idx]) {
+		if (!res.this_frame_hand_detected[hand_idx]) {
 			continue;
 		}
 
 
 		for (int view = 0; view < 2; view++) {
-			hand_region_of_interest &from_model = hgt->views[view].regions_of_interest_this_frame[hand_idx];
+			hand_region_of_interest &from_model = res.rois[view][hand_idx];
 			if (!from_model.found) {
-				hgt->keypoint_outputs[hand_idx].views[view].active = false;
+				res.keypoint_outputs[hand_idx].views[view].active = false;
 			}
 		}
 
-		if (hgt->tuneable_values.scribble_keypoint_model_outputs && hgt->debug_scribble) {
+		if (hgt->tuneable_values.scribble_keypoint_model_outputs && res.debug_scribble) {
 			for (int view_idx = 0; view_idx < 2; view_idx++) {
 
-				if (!hgt->keypoint_outputs[hand_idx].views[view_idx].active) {
+				if (!res.keypoint_outputs[hand_idx].views[view_idx].active) {
 					continue;
 				}
 
-				back_project_keypoint_output(hgt, hand_idx, view_idx);
+				back_project_keypoint_output(hgt, res.keypoint_outputs[hand_idx].views[view_idx], view_idx,
+				                             res.debug_out[view_idx]);
 			}
 		}
 
@@ -908,7 +1077,7 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 		if (hgt->last_frame_hand_detected[hand_idx]) {
 			if (hgt->tuneable_values.enable_framerate_based_smoothing) {
 				int64_t one_before = *hgt->history_timestamps.get_at_age(0);
-				int64_t now = hgt->current_frame_timestamp;
+				int64_t now = res.timestamp;
 
 				uint64_t diff = now - one_before;
 				double diff_d = time_ns_to_s(diff);
@@ -925,7 +1094,7 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 		//!@todo optimize: We can have one of these on each thread
 		float reprojection_error;
 		lm::optimizer_run(hand,                                     //
-		                  hgt->keypoint_outputs[hand_idx],          //
+		                  res.keypoint_outputs[hand_idx],           //
 		                  !hgt->last_frame_hand_detected[hand_idx], //
 		                  smoothing_factor,
 		                  optimize_hand_size,                              //
@@ -940,13 +1109,13 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 
 		if (reprojection_error > reprojection_error_threshold) {
 			HG_DEBUG(hgt, "Reprojection error above threshold!");
-			hgt->this_frame_hand_detected[hand_idx] = false;
+			res.this_frame_hand_detected[hand_idx] = false;
 			continue;
 		}
 
 		if (hand_too_far(hgt, *put_in_set)) {
 			HG_DEBUG(hgt, "Hand too far away");
-			hgt->this_frame_hand_detected[hand_idx] = false;
+			res.this_frame_hand_detected[hand_idx] = false;
 			continue;
 		}
 
@@ -956,7 +1125,7 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 
 		if (!any_hands_are_only_visible_in_one_view) {
 			hgt->refinement.hand_size_refinement_schedule_x +=
-			    hand_confidence_value(reprojection_error, hgt->keypoint_outputs[hand_idx]);
+			    hand_confidence_value(reprojection_error, res.keypoint_outputs[hand_idx]);
 		}
 
 		u_hand_joints_apply_joint_width(put_in_set);
@@ -972,11 +1141,14 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 
 		hand_joint_set_to_eigen_21(*put_in_set, asf);
 
-		back_project(hgt,                                                                    //
-		             asf,                                                                    //
-		             hand_idx,                                                               //
-		             hgt->tuneable_values.scribble_optimizer_outputs && hgt->debug_scribble, //
-		             NULL                                                                    //
+		bool scribble_optimizer_output = hgt->tuneable_values.scribble_optimizer_outputs && res.debug_scribble;
+
+		back_project(hgt,                                              //
+		             asf,                                              //
+		             hand_idx,                                         //
+		             scribble_optimizer_output ? res.debug_out : NULL, //
+		             NULL,                                             //
+		             NULL                                              //
 		);
 
 		hgt->history_hands[hand_idx].push_back(asf);
@@ -984,7 +1156,7 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 	}
 
 	// Push our timestamp back as well
-	hgt->history_timestamps.push_back(hgt->current_frame_timestamp);
+	hgt->history_timestamps.push_back(res.timestamp);
 
 	// More hand-size-optimization spaghetti
 	if (num_hands > 0) {
@@ -993,36 +1165,51 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 
 	// State tracker tweaks
 	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
-		out_xrt_hands[hand_idx]->is_active = hgt->this_frame_hand_detected[hand_idx];
-		hgt->last_frame_hand_detected[hand_idx] = hgt->this_frame_hand_detected[hand_idx];
+		out_xrt_hands[hand_idx]->is_active = res.this_frame_hand_detected[hand_idx];
+		hgt->last_frame_hand_detected[hand_idx] = res.this_frame_hand_detected[hand_idx];
 
 		hgt->hand_seen_before[hand_idx] =
-		    hgt->hand_seen_before[hand_idx] || hgt->this_frame_hand_detected[hand_idx];
+		    hgt->hand_seen_before[hand_idx] || res.this_frame_hand_detected[hand_idx];
 
 		if (!hgt->last_frame_hand_detected[hand_idx]) {
-			hgt->views[0].regions_of_interest_this_frame[hand_idx].found = false;
-			hgt->views[1].regions_of_interest_this_frame[hand_idx].found = false;
+			res.rois[0][hand_idx].found = false;
+			res.rois[1][hand_idx].found = false;
 			hgt->history_hands[hand_idx].clear();
 			hgt->hand_tracked_for_num_frames[hand_idx] = 0;
 		}
 	}
 
-	// estimators next frame. Also, if next frame's hand will be outside of the camera's field of view, mark it as
-	// inactive this frame. This stops issues where our hand detector detects hands that are slightly too close to
-	// the edge, causing flickery hands.
+	// Everything the keypoint stage of the next frame starts from.
+	hg_tracked_state next = hgt->tracked_state;
+	next.timestamp = res.timestamp;
+	next.optimizing_hand_size = hgt->refinement.optimizing;
+	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
+		next.rois[0][hand_idx] = res.rois[0][hand_idx];
+		next.rois[1][hand_idx] = res.rois[1][hand_idx];
+		next.last_frame_hand_detected[hand_idx] = hgt->last_frame_hand_detected[hand_idx];
+		next.this_frame_hand_detected[hand_idx] = res.this_frame_hand_detected[hand_idx];
+		next.history_hands[hand_idx] = hgt->history_hands[hand_idx];
+	}
+	next.history_timestamps = hgt->history_timestamps;
+
+	// Predict regions of interest for the keypoint estimators next frame. Also, if next frame's hand will be outside
+	// of the camera's field of view, mark it as inactive this frame. This stops issues where our hand detector
+	// detects hands that are slightly too close to the edge, causing flickery hands.
 	if (!hgt->tuneable_values.always_run_detection_model) {
-		predict_new_regions_of_interest(hgt);
-		bool still_found[2] = {hgt->last_frame_hand_detected[0], hgt->last_frame_hand_detected[1]};
-		still_found[0] = hgt->views[0].regions_of_interest_this_frame[0].found ||
-		                 hgt->views[1].regions_of_interest_this_frame[0].found;
-		still_found[1] = hgt->views[0].regions_of_interest_this_frame[1].found ||
-		                 hgt->views[1].regions_of_interest_this_frame[1].found;
+		predict_new_regions_of_interest(hgt, next, res.timestamp, res.debug_scribble ? res.debug_out : NULL);
+		bool still_found[2] = {};
+		still_found[0] = next.rois[0][0].found || next.rois[1][0].found;
+		still_found[1] = next.rois[0][1].found || next.rois[1][1].found;
 
 		for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
 			out_xrt_hands[hand_idx]->is_active = still_found[hand_idx];
 		}
 	}
 
+	os_mutex_lock(&hgt->tracked_state_mutex);
+	hgt->tracked_state = next;
+	os_mutex_unlock(&hgt->tracked_state_mutex);
+
 	for (int hand_idx = 0; hand_idx < 2; hand_idx++) {
 		// Don't send the hand to OpenXR until it's been tracked for 4 frames
 		if (hgt->hand_tracked_for_num_frames[hand_idx] < hgt->tuneable_values.num_frames_before_display) {
@@ -1031,18 +1218,17 @@ HandTracking::cCallbackProcess(struct t_hand_tracking_sync *ht_sync,
 	}
 
 	// If the debug UI is active, push to the frame-timing widget
-	u_frame_times_widget_push_sample(&hgt->ft_widget, hgt->current_frame_timestamp);
+	u_frame_times_widget_push_sample(&hgt->ft_widget, res.timestamp);
 
-	// If the debug UI is active, push our debug frame
-	if (hgt->debug_scribble) {
-		u_sink_debug_push_frame(&hgt->debug_sink_ann, debug_frame);
-		xrt_frame_reference(&debug_frame, NULL);
+	hgt->stage_timing.optimize_ms = (float)time_ns_to_ms_f(os_monotonic_get_ns() - start_ns);
 
-		// We don't dereference the model inputs/outputs frame here; we make a copy of it next frame and
-		// dereference it then.
-		u_sink_debug_push_frame(&hgt->debug_sink_model, hgt->visualizers.xrtframe);
-		xrt_frame_reference(&hgt->visualizers.old_frame, hgt->visualizers.xrtframe);
-		xrt_frame_reference(&hgt->visualizers.xrtframe, NULL);
+	// If the debug UI is active, push our debug frames
+	if (res.debug_scribble) {
+		u_sink_debug_push_frame(&hgt->debug_sink_ann, res.debug_frame);
+		xrt_frame_reference(&res.debug_frame, NULL);
+
+		u_sink_debug_push_frame(&hgt->debug_sink_model, res.model_frame);
+		xrt_frame_reference(&res.model_frame, NULL);
 	}
 
 	// done!
@@ -1097,20 +1283,14 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 	hgt->views[0].camera_info = extra_camera_info.views[0];
 	hgt->views[1].camera_info = extra_camera_info.views[1];
 
-	init_hand_detection(hgt, &hgt->views[0].detection);
-	init_hand_detection(hgt, &hgt->views[1].detection);
-
-	init_keypoint_estimation(hgt, &hgt->views[0].keypoint[0]);
-	init_keypoint_estimation(hgt, &hgt->views[0].keypoint[1]);
+	int num_threads = 4;
 
-	init_keypoint_estimation(hgt, &hgt->views[1].keypoint[0]);
-	init_keypoint_estimation(hgt, &hgt->views[1].keypoint[1]);
-	hgt->keypoint_estimation_run_func = xrt::tracking::hand::mercury::run_keypoint_estimation;
+	init_hand_detection(hgt, &hgt->detection_model, num_threads);
+	init_keypoint_estimation(hgt, &hgt->keypoint_model, num_threads);
 
 	hgt->views[0].view = 0;
 	hgt->views[1].view = 1;
 
-	int num_threads = 4;
 	hgt->pool = u_worker_thread_pool_create(num_threads - 1, num_threads, "Hand Tracking");
 	hgt->group = u_worker_group_create(hgt->pool);
 
@@ -1124,6 +1304,11 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 
 	u_var_add_ro_f32(hgt, &hgt->ft_widget.fps, "FPS!");
 	u_var_add_f32_timing(hgt, hgt->ft_widget.debug_var, "Frame timing!");
+	u_var_add_ro_f32(hgt, &hgt->stage_timing.detection_ms, "Detection model (ms)");
+	u_var_add_ro_f32(hgt, &hgt->stage_timing.keypoint_ms, "Keypoint model (ms)");
+	u_var_add_ro_f32(hgt, &hgt->stage_timing.infer_ms, "Detection and keypoint models (ms)");
+	u_var_add_ro_f32(hgt, &hgt->stage_timing.handoff_wait_ms, "Waiting for the optimizer (ms)");
+	u_var_add_ro_f32(hgt, &hgt->stage_timing.optimize_ms, "Optimizer and prediction (ms)");
 
 	u_var_add_f32(hgt, &hgt->target_hand_size, "Hand size (Meters between wrist and middle-proximal joint)");
 	u_var_add_ro_f32(hgt, &hgt->refinement.hand_size_refinement_schedule_x, "Schedule (X value)");
@@ -1133,6 +1318,7 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 	u_var_add_bool(hgt, &hgt->tuneable_values.new_user_event, "Trigger new-user event!");
 
 	hgt->tuneable_values.optimize_hand_size = debug_get_bool_option_mercury_optimize_hand_size();
+	hgt->tuneable_values.batch_model_inference = debug_get_bool_option_mercury_batch_model_inference();
 
 	hgt->tuneable_values.dyn_radii_fac.max = 4.0f;
 	hgt->tuneable_values.dyn_radii_fac.min = 0.3f;
@@ -1192,6 +1378,12 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 	hgt->tuneable_values.max_hand_dist.step = 0.05f;
 	hgt->tuneable_values.max_hand_dist.val = 1.7f;
 
+	// Keypoint crops whose projection would move by less than this many pixels keep last frame's crop map.
+	hgt->tuneable_values.crop_map_reuse_px.max = 4.0f;
+	hgt->tuneable_values.crop_map_reuse_px.min = 0.0f;
+	hgt->tuneable_values.crop_map_reuse_px.step = 0.05f;
+	hgt->tuneable_values.crop_map_reuse_px.val = 0.5f;
+
 	u_var_add_draggable_f32(hgt, &hgt->tuneable_values.amt_use_depth, "Amount to use depth prediction");
 
 
@@ -1207,6 +1399,7 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 	u_var_add_draggable_f32(hgt, &hgt->tuneable_values.max_reprojection_error, "Max reprojection error");
 	u_var_add_draggable_f32(hgt, &hgt->tuneable_values.opt_smooth_factor, "Optimizer smoothing factor");
 	u_var_add_draggable_f32(hgt, &hgt->tuneable_values.max_hand_dist, "Max hand distance");
+	u_var_add_draggable_f32(hgt, &hgt->tuneable_values.crop_map_reuse_px, "Crop map reuse tolerance (px)");
 
 	u_var_add_i32(hgt, &hgt->tuneable_values.max_num_outside_view,
 	              "max allowed number of hand joints outside view");
@@ -1226,6 +1419,8 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 	u_var_add_bool(hgt, &hgt->tuneable_values.enable_framerate_based_smoothing,
 	               "Enable framerate-based smoothing (Don't use; surprisingly seems to make things worse)");
 	u_var_add_bool(hgt, &hgt->tuneable_values.detection_model_in_both_views, "Run detection model in both views ");
+	u_var_add_bool(hgt, &hgt->tuneable_values.batch_model_inference,
+	               "Run all crops through the models at once (off: one single threaded session per crop)");
 
 
 
@@ -1236,3 +1431,15 @@ t_hand_tracking_sync_mercury_create(struct t_stereo_camera_calibration *calib,
 
 	return &hgt->base;
 }
+
+extern "C" void
+t_hand_tracking_sync_mercury_get_timings(struct t_hand_tracking_sync *ht_sync,
+                                         struct t_hand_tracking_mercury_timings *out_timings)
+{
+	HandTracking &hgt = HandTracking::fromC(ht_sync);
+
+	out_timings->detection_ms = hgt.stage_timing.detection_ms;
+	out_timings->keypoint_ms = hgt.stage_timing.keypoint_ms;
+	out_timings->infer_ms = hgt.stage_timing.infer_ms;
+	out_timings->optimize_ms = hgt.stage_timing.optimize_ms;
+}
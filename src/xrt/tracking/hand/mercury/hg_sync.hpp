@@ -12,6 +12,7 @@
 
 #include "hg_interface.h"
 #include "hg_debug_instrumentation.hpp"
+#include "hg_image_distorter.hpp"
 
 #include "tracking/t_hand_tracking.h"
 #include "tracking/t_camera_models.h"
@@ -35,6 +36,9 @@
 #include "util/u_frame.h"
 #include "util/u_var.h"
 
+#include "os/os_threading.h"
+#include "os/os_time.h"
+
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -129,37 +133,56 @@ struct Hand3D
 	struct xrt_vec3 kps[21];
 };
 
-using hand21_2d = std::array<vec2_5, 21>;
+// Two hands in two views.
+static constexpr int kMaxModelBatch = 4;
 
-struct projection_instructions
+// An input or output of a model, the buffer has room for the largest batch the model is run with.
+struct model_io_wrap
 {
-	Eigen::Quaternionf rot_quat = Eigen::Quaternionf::Identity();
-	float stereographic_radius = 0;
-	bool flip = false;
-	const t_camera_model_params &dist;
-
-	projection_instructions(const t_camera_model_params &dist) : dist(dist) {}
-};
+	const char *name;
 
-struct model_input_wrap
-{
 	float *data = nullptr;
+	// Shape of one item, dimensions[0] is the batch dimension.
 	int64_t dimensions[4];
 	size_t num_dimensions = 0;
+	// Number of floats in one item.
+	size_t item_size = 0;
 
-	OrtValue *tensor = nullptr;
-	const char *name;
+	float *
+	item(int slot)
+	{
+		return data + (slot * item_size);
+	}
 };
 
+// One batching session per model, shared by all views and hands. All tensors and bindings are made up front, so
+// running the model doesn't allocate.
 struct onnx_wrap
 {
 	const OrtApi *api = nullptr;
 	OrtEnv *env = nullptr;
 
 	OrtMemoryInfo *meminfo = nullptr;
+	// Runs batches, with as many intra-op threads as the worker pool.
 	OrtSession *session = nullptr;
+	// Runs the item in slot i on its own. Like the per-crop path these have one intra-op thread each and the items
+	// run in parallel on the worker group.
+	OrtSession *item_sessions[kMaxModelBatch] = {};
 
-	std::vector<model_input_wrap> wraps = {};
+	int max_batch = 0;
+	// Whether the model has a dynamic batch dimension, if not items are run one at a time.
+	bool can_batch = false;
+
+	std::vector<model_io_wrap> inputs = {};
+	std::vector<model_io_wrap> outputs = {};
+
+	// batch_bindings[n - 1] runs the items in slots [0, n) in one go on session, only set up if can_batch.
+	OrtIoBinding *batch_bindings[kMaxModelBatch] = {};
+	// item_bindings[i] runs the item in slot i on item_sessions[i].
+	OrtIoBinding *item_bindings[kMaxModelBatch] = {};
+
+	// Every tensor referenced by the bindings.
+	std::vector<OrtValue *> values = {};
 };
 
 // Multipurpose.
@@ -187,6 +210,12 @@ struct hand_detection_run_info
 	// If some hands are already tracked, we have logic that only copies new ROIs to this frame's regions of
 	// interest.
 	hand_region_of_interest outputs[2];
+
+	// Where this view goes in the model's batch.
+	int slot;
+	// Model input before normalization, and the transform back to the camera image.
+	cv::Mat binned_uint8;
+	cv::Matx23f go_back;
 };
 
 
@@ -194,13 +223,17 @@ struct keypoint_estimation_run_info
 {
 	ht_view *view;
 	bool hand_idx;
+
+	// Where this crop goes in the model's batch.
+	int slot;
+	// Model input before normalization, for debug scribbling.
+	cv::Mat data_128x128_uint8;
+	bool is_hand;
 };
 
 struct ht_view
 {
 	HandTracking *hgt;
-	onnx_wrap detection;
-	onnx_wrap keypoint[2];
 	int view;
 
 	struct t_camera_extra_info_one_view camera_info;
@@ -216,6 +249,9 @@ struct ht_view
 	struct hand_region_of_interest regions_of_interest_this_frame[2]; // left, right
 
 	struct keypoint_estimation_run_info run_info[2];
+
+	// Where the keypoint model crops were last sampled from, left, right
+	struct crop_map crop_maps[2];
 };
 
 
@@ -240,6 +276,51 @@ struct model_output_visualizers
 	xrt_frame *old_frame = NULL;
 };
 
+// What the keypoint stage of a frame starts from: the hands as the optimizer stage left them after a frame, with
+// regions of interest predicted from them. Published by the optimizer stage at the end of each frame.
+struct hg_tracked_state
+{
+	// Timestamp of the frame the optimizer stage made this from.
+	uint64_t timestamp = 0;
+
+	// left view, right view THEN left hand, right hand
+	hand_region_of_interest rois[2][2] = {};
+
+	bool last_frame_hand_detected[2] = {false, false};
+	bool this_frame_hand_detected[2] = {false, false};
+
+	// Whether the hand size is still being refined, we run the detection model in both views until it is done.
+	bool optimizing_hand_size = true;
+
+	HistoryBuffer<Eigen::Array<float, 3, 21>, 2> history_hands[2] = {};
+	HistoryBuffer<uint64_t, 2> history_timestamps = {};
+
+	Eigen::Array<float, 3, 21> pose_predicted_keypoints[2];
+};
+
+// Everything the optimizer stage needs from the keypoint stage of one frame.
+struct hg_keypoint_results
+{
+	uint64_t timestamp = 0;
+
+	// left view, right view THEN left hand, right hand
+	hand_region_of_interest rois[2][2] = {};
+	bool this_frame_hand_detected[2] = {false, false};
+	struct one_frame_input keypoint_outputs[2];
+
+	// The keypoint stage saw a new-user event before running hand detection on this frame.
+	bool new_user = false;
+
+	// The keypoint stage forgot the tracked hands to run hand detection on this frame.
+	bool clear_history = false;
+
+	// The debug images are owned by the results until the optimizer stage pushes them.
+	bool debug_scribble = false;
+	xrt_frame *debug_frame = NULL;
+	xrt_frame *model_frame = NULL;
+	cv::Mat debug_out[2];
+};
+
 /*!
  * Main class of Mercury hand tracking.
  *
@@ -266,6 +347,9 @@ public:
 
 	struct ht_view views[2] = {};
 
+	onnx_wrap detection_model;
+	onnx_wrap keypoint_model;
+
 	struct model_output_visualizers visualizers;
 
 	u_worker_thread_pool *pool;
@@ -276,20 +360,47 @@ public:
 	float baseline = {};
 	xrt_pose hand_pose_camera_offset = {};
 
+	// Timestamp of the frame the keypoint stage is on.
 	uint64_t current_frame_timestamp = {};
 
+	// Whether the keypoint stage is scribbling into debug images this frame.
 	bool debug_scribble = false;
 
+	// Passed on to the optimizer stage in hg_keypoint_results, see there.
+	bool new_user_this_frame = false;
+	bool clear_history_this_frame = false;
+
 	char models_folder[1024];
 
 	enum u_logging_level log_level = U_LOGGING_INFO;
 
 	lm::KinematicHandLM *kinematic_hands[2];
 
-	// These are produced by the keypoint estimator and consumed by the nonlinear optimizer
+	// These are produced by the keypoint estimator and handed to the nonlinear optimizer
 	// left hand, right hand THEN left view, right view
 	struct one_frame_input keypoint_outputs[2];
 
+	// The keypoint stage hands its results for one frame over to the optimizer stage here. There is only room for
+	// one frame, so the keypoint stage of the next frame can run while the optimizer works on this one, but not
+	// further ahead.
+	struct
+	{
+		struct os_mutex mutex;
+		struct os_cond cond;
+		bool full = false;
+		hg_keypoint_results results = {};
+	} handoff;
+
+	// Written by the optimizer stage at the end of each frame, copied at the start of the keypoint stage.
+	struct os_mutex tracked_state_mutex;
+	struct hg_tracked_state tracked_state = {};
+
+	// The keypoint stage's copy of tracked_state for the frame it is on.
+	struct hg_tracked_state start_state = {};
+
+	// Everything from here to target_hand_size belongs to the optimizer stage, except this_frame_hand_detected,
+	// pose_predicted_keypoints and detection_counter, which belong to the keypoint stage.
+
 	// Used to track whether this hand has *ever* been seen during this user's session, so that we can spend some
 	// extra time optimizing their hand size if one of their hands isn't visible for the first bit.
 	bool hand_seen_before[2] = {false, false};
@@ -326,15 +437,23 @@ public:
 	xrt_frame *debug_frame;
 
 
-	// This should be removed.
-	void (*keypoint_estimation_run_func)(void *);
-
-
 
 	struct xrt_pose left_in_right = {};
 
 	u_frame_times_widget ft_widget = {};
 
+	// How long each stage took for the last frame.
+	struct
+	{
+		// Parts of infer_ms, detection_ms is zero if the detection model didn't run.
+		float detection_ms = 0;
+		float keypoint_ms = 0;
+		float infer_ms = 0;
+		// Time the keypoint stage waited for the optimizer stage to take the previous frame.
+		float handoff_wait_ms = 0;
+		float optimize_ms = 0;
+	} stage_timing;
+
 	struct hg_tuneable_values tuneable_values;
 
 public:
@@ -355,53 +474,38 @@ public:
 	                 struct xrt_hand_joint_set *out_right_hand,
 	                 uint64_t *out_timestamp_ns);
 
+	static void
+	cCallbackInfer(struct t_hand_tracking_sync *ht_sync,
+	               struct xrt_frame *left_frame,
+	               struct xrt_frame *right_frame);
+
+	static void
+	cCallbackOptimize(struct t_hand_tracking_sync *ht_sync,
+	                  struct xrt_hand_joint_set *out_left_hand,
+	                  struct xrt_hand_joint_set *out_right_hand,
+	                  uint64_t *out_timestamp_ns);
+
 	static void
 	cCallbackDestroy(t_hand_tracking_sync *ht_sync);
 };
 
 
 void
-init_hand_detection(HandTracking *hgt, onnx_wrap *wrap);
+init_hand_detection(HandTracking *hgt, onnx_wrap *wrap, int num_threads);
 
+// Runs the detection model on each view in @p infos, in one batch if enabled and the model supports it.
 void
-run_hand_detection(void *ptr);
+run_hand_detection(HandTracking *hgt, hand_detection_run_info *infos, int count);
 
 void
-init_keypoint_estimation(HandTracking *hgt, onnx_wrap *wrap);
+init_keypoint_estimation(HandTracking *hgt, onnx_wrap *wrap, int num_threads);
 
+// Runs the keypoint model on each crop in @p infos, in one batch if enabled and the model supports it.
 void
-run_keypoint_estimation(void *ptr);
+run_keypoint_estimation(HandTracking *hgt, keypoint_estimation_run_info **infos, int count);
 
 void
 release_onnx_wrap(onnx_wrap *wrap);
 
 
-void
-make_projection_instructions(t_camera_model_params &dist,
-                             bool flip_after,
-                             float expand_val,
-                             float twist,
-                             Eigen::Array<float, 3, 21> &joints,
-                             projection_instructions &out_instructions,
-                             hand21_2d &out_hand);
-
-
-void
-make_projection_instructions_angular(xrt_vec3 direction_3d,
-                                     bool flip_after,
-                                     float angular_radius,
-                                     float expand_val,
-                                     float twist,
-                                     projection_instructions &out_instructions);
-
-void
-stereographic_project_image(const t_camera_model_params &dist,
-                            const projection_instructions &instructions,
-                            cv::Mat &input_image,
-                            cv::Mat *debug_image,
-                            const cv::Scalar boundary_color,
-                            cv::Mat &out);
-
-
-
 } // namespace xrt::tracking::hand::mercury
@@ -0,0 +1,615 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Hand-written Jacobian for the Levenberg-Marquardt kinematic optimizer
+ * @ingroup tracking
+ */
+
+/*
+
+Included from lm_main.cpp, after CostFunctor.
+
+Gives the same residuals and Jacobian as running CostFunctor through ceres::TinySolverAutoDiffFunction, but without
+pushing ceres::Jets through the whole kinematic chain. The chain is evaluated once with plain floats, and the
+derivatives are carried along by hand:
+
+* Each bone's relative orientation only depends on a few parameters, whose derivatives are worked out in closed form
+  below.
+* Absolute orientations and positions only pick those up through quaternion products and rotations, which are
+  linear in each of their arguments.
+* The residuals then only need the derivatives of the joint positions.
+
+Anything changed in the residuals or parameters in lm_main.cpp or lm_optimizer_params_packer.inl has to be changed here
+too, tests_levenbergmarquardt checks that the two agree.
+
+*/
+
+#pragma once
+
+#ifdef USE_ANALYTIC_JACOBIAN
+
+#if !defined(USE_HAND_SIZE) || !defined(USE_HAND_TRANSLATION) || !defined(USE_HAND_ORIENTATION) ||                    \
+    !defined(USE_EVERYTHING_ELSE) || defined(USE_HAND_PLAUSIBILITY) || defined(USE_HAND_CURLS)
+#error "The analytic Jacobian only knows the default parameters and residuals, undefine USE_ANALYTIC_JACOBIAN."
+#endif
+
+namespace xrt::tracking::hand::mercury::lm {
+
+// Where each part of the hand is in the parameter vector, see OptimizerHandUnpackFromVector.
+static constexpr int kParamWristLocation = 0;
+static constexpr int kParamWristOrientation = kParamWristLocation + kHandTranslationDim;
+static constexpr int kParamThumb = kParamWristOrientation + kHandOrientationDim;
+static constexpr int kParamFingers = kParamThumb + kThumbDim;
+static constexpr int kParamHandSize = kParamFingers + kFingerDim * 4;
+
+// Quaternions are (x, y, z, w) here, like Quat.
+using QuatVec = Eigen::Matrix<HandScalar, 4, 1>;
+
+static inline QuatVec
+quat_vec(const Quat<HandScalar> &q)
+{
+	return QuatVec(q.x, q.y, q.z, q.w);
+}
+
+// QuaternionProduct(a, b) == quat_product_left(a) * b
+static inline Eigen::Matrix<HandScalar, 4, 4>
+quat_product_left(const Quat<HandScalar> &a)
+{
+	Eigen::Matrix<HandScalar, 4, 4> m;
+	// clang-format off
+	m <<  a.w, -a.z,  a.y, a.x,
+	      a.z,  a.w, -a.x, a.y,
+	     -a.y,  a.x,  a.w, a.z,
+	     -a.x, -a.y, -a.z, a.w;
+	// clang-format on
+	return m;
+}
+
+// QuaternionProduct(a, b) == quat_product_right(b) * a
+static inline Eigen::Matrix<HandScalar, 4, 4>
+quat_product_right(const Quat<HandScalar> &b)
+{
+	Eigen::Matrix<HandScalar, 4, 4> m;
+	// clang-format off
+	m <<  b.w,  b.z, -b.y, b.x,
+	     -b.z,  b.w,  b.x, b.y,
+	      b.y, -b.x,  b.w, b.z,
+	     -b.x, -b.y, -b.z, b.w;
+	// clang-format on
+	return m;
+}
+
+// Derivative of UnitQuaternionRotatePoint(q, pt) with respect to q, which it is a polynomial in.
+static inline Eigen::Matrix<HandScalar, 3, 4>
+rotate_point_jacobian(const Quat<HandScalar> &q, const Vec3<HandScalar> &pt)
+{
+	Eigen::Matrix<HandScalar, 3, 1> u(q.x, q.y, q.z);
+	Eigen::Matrix<HandScalar, 3, 1> v(pt.x, pt.y, pt.z);
+	Eigen::Matrix<HandScalar, 3, 1> uv = 2 * u.cross(v);
+
+	Eigen::Matrix<HandScalar, 3, 4> j;
+	for (int i = 0; i < 3; i++) {
+		Eigen::Matrix<HandScalar, 3, 1> e = Eigen::Matrix<HandScalar, 3, 1>::Unit(i);
+		Eigen::Matrix<HandScalar, 3, 1> duv = 2 * e.cross(v);
+		j.col(i) = q.w * duv + e.cross(uv) + u.cross(duv);
+	}
+	j.col(3) = uv;
+	return j;
+}
+
+static inline Eigen::Matrix<HandScalar, 3, 3>
+rotation_matrix(const Quat<HandScalar> &q)
+{
+	Eigen::Matrix<HandScalar, 3, 3> m;
+	for (int i = 0; i < 3; i++) {
+		Vec3<HandScalar> e(i == 0 ? 1.f : 0.f, i == 1 ? 1.f : 0.f, i == 2 ? 1.f : 0.f);
+		Vec3<HandScalar> out;
+		UnitQuaternionRotatePoint(q, e, out);
+		m.col(i) << out.x, out.y, out.z;
+	}
+	return m;
+}
+
+// Derivative of AngleAxisToQuaternion. Also right for SwingToQuaternion and CurlToQuaternion, which are the same
+// thing with the other components at zero.
+static inline Eigen::Matrix<HandScalar, 4, 3>
+angle_axis_to_quaternion_jacobian(HandScalar a0, HandScalar a1, HandScalar a2)
+{
+	const HandScalar a[3] = {a0, a1, a2};
+	const HandScalar theta_squared = a0 * a0 + a1 * a1 + a2 * a2;
+
+	Eigen::Matrix<HandScalar, 4, 3> j = Eigen::Matrix<HandScalar, 4, 3>::Zero();
+
+	if (likely(theta_squared > 0.0f)) {
+		const HandScalar theta = sqrtf(theta_squared);
+		const HandScalar sin_half_theta = sinf(theta * 0.5f);
+		const HandScalar cos_half_theta = cosf(theta * 0.5f);
+		const HandScalar k = sin_half_theta / theta;
+
+		// dk/dtheta, divided by theta so that multiplying by a[i] gives dk/da[i].
+		const HandScalar dk_over_theta = (cos_half_theta * 0.5f * theta - sin_half_theta) / (theta_squared * theta);
+
+		for (int c = 0; c < 3; c++) {
+			for (int r = 0; r < 3; r++) {
+				j(r, c) = a[r] * dk_over_theta * a[c];
+			}
+			j(c, c) += k;
+			j(3, c) = -sin_half_theta * 0.5f * a[c] / theta;
+		}
+	} else {
+		// Same as the Taylor series used for the values.
+		j(0, 0) = 0.5f;
+		j(1, 1) = 0.5f;
+		j(2, 2) = 0.5f;
+	}
+	return j;
+}
+
+// Derivative of SwingTwistToQuaternion with respect to swing x, swing y and twist.
+static inline Eigen::Matrix<HandScalar, 4, 3>
+swing_twist_to_quaternion_jacobian(const Vec2<HandScalar> &swing, HandScalar twist)
+{
+	const HandScalar sx = swing.x;
+	const HandScalar sy = swing.y;
+	const HandScalar theta_squared = sx * sx + sy * sy;
+
+	const HandScalar cos_half_twist = cosf(twist * 0.5f);
+	const HandScalar sin_half_twist = sinf(twist * 0.5f);
+
+	// Values and derivatives (divided by theta, see above) of cos(theta/2) and sin(theta/2)/theta.
+	HandScalar cos_half_theta = 1.0f;
+	HandScalar k = 0.5f;
+	HandScalar dcos_over_theta = 0.0f;
+	HandScalar dk_over_theta = 0.0f;
+
+	if (theta_squared > 0.0f) {
+		const HandScalar theta = sqrtf(theta_squared);
+		const HandScalar sin_half_theta = sinf(theta * 0.5f);
+
+		cos_half_theta = cosf(theta * 0.5f);
+		k = sin_half_theta / theta;
+		dcos_over_theta = -sin_half_theta * 0.5f / theta;
+		dk_over_theta = (cos_half_theta * 0.5f * theta - sin_half_theta) / (theta_squared * theta);
+	}
+
+	const HandScalar x_factor = sx * cos_half_twist + sy * sin_half_twist;
+	const HandScalar y_factor = sy * cos_half_twist - sx * sin_half_twist;
+
+	Eigen::Matrix<HandScalar, 4, 3> j;
+
+	// Swing x.
+	j(0, 0) = cos_half_twist * k + x_factor * dk_over_theta * sx;
+	j(1, 0) = -sin_half_twist * k + y_factor * dk_over_theta * sx;
+	j(2, 0) = dcos_over_theta * sx * sin_half_twist;
+	j(3, 0) = dcos_over_theta * sx * cos_half_twist;
+
+	// Swing y.
+	j(0, 1) = sin_half_twist * k + x_factor * dk_over_theta * sy;
+	j(1, 1) = cos_half_twist * k + y_factor * dk_over_theta * sy;
+	j(2, 1) = dcos_over_theta * sy * sin_half_twist;
+	j(3, 1) = dcos_over_theta * sy * cos_half_twist;
+
+	// Twist.
+	j(0, 2) = (-sx * sin_half_twist + sy * cos_half_twist) * 0.5f * k;
+	j(1, 2) = (-sy * sin_half_twist - sx * cos_half_twist) * 0.5f * k;
+	j(2, 2) = cos_half_theta * cos_half_twist * 0.5f;
+	j(3, 2) = -cos_half_theta * sin_half_twist * 0.5f;
+
+	return j;
+}
+
+// Derivative of LMToModel.
+static inline HandScalar
+lm_to_model_derivative(HandScalar lm, minmax mm)
+{
+	return cosf(lm) * ((mm.max - mm.min) * 0.5f);
+}
+
+template <bool optimize_hand_size> struct AnalyticCostFunction
+{
+	using Scalar = HandScalar;
+	enum
+	{
+		NUM_RESIDUALS = Eigen::Dynamic,
+		NUM_PARAMETERS = calc_input_size(optimize_hand_size),
+	};
+
+	// Derivatives of a scalar, vector or quaternion with respect to all of the parameters.
+	using Row = Eigen::Matrix<HandScalar, 1, NUM_PARAMETERS>;
+	using Jacobian3 = Eigen::Matrix<HandScalar, 3, NUM_PARAMETERS>;
+	using Jacobian4 = Eigen::Matrix<HandScalar, 4, NUM_PARAMETERS>;
+
+	// Writes the rows of the column-major Jacobian in the same order as ResidualHelper writes residuals.
+	struct RowHelper
+	{
+		Eigen::Map<Eigen::Matrix<HandScalar, Eigen::Dynamic, NUM_PARAMETERS>> jacobian;
+		size_t out_row_idx = 0;
+
+		RowHelper(HandScalar *jacobian, size_t num_residuals) : jacobian(jacobian, num_residuals, NUM_PARAMETERS)
+		{}
+
+		void
+		AddRow(const Row &row)
+		{
+			this->jacobian.row(out_row_idx++) = row;
+		}
+	};
+
+	const CostFunctor<optimize_hand_size> &cost_functor;
+
+	AnalyticCostFunction(const CostFunctor<optimize_hand_size> &cost_functor) : cost_functor(cost_functor) {}
+
+	int
+	NumResiduals() const
+	{
+		return (int)cost_functor.NumResiduals();
+	}
+
+	bool
+	operator()(const HandScalar *x, HandScalar *residuals, HandScalar *jacobian) const
+	{
+		// The values come from the very same code the autodiff path runs.
+		if (!cost_functor(x, residuals)) {
+			return false;
+		}
+
+		if (jacobian != nullptr) {
+			XRT_TRACE_IDENT(analytic_jacobian);
+			evaluate_jacobian(x, jacobian);
+		}
+		return true;
+	}
+
+	void
+	evaluate_jacobian(const HandScalar *x, HandScalar *jacobian) const
+	{
+		const KinematicHandLM &state = cost_functor.parent;
+
+		OptimizerHand<HandScalar> hand = {};
+		Quat<HandScalar> tmp = state.this_frame_pre_rotation;
+		OptimizerHandInit<HandScalar>(hand, tmp);
+		OptimizerHandUnpackFromVector(x, state, hand);
+
+		Translations55<HandScalar> translations_absolute = {};
+		Orientations54<HandScalar> orientations_absolute = {};
+		eval_hand_with_orientation(state, hand, state.is_right, translations_absolute, orientations_absolute);
+
+		// Derivatives of the joint positions, in the same order as cjrc.
+		Jacobian3 d_joints[kNumNNJoints];
+		Row d_hand_size = Row::Zero();
+		if constexpr (optimize_hand_size) {
+			d_hand_size(kParamHandSize) = lm_to_model_derivative(x[kParamHandSize], the_limit.hand_size);
+		}
+
+		eval_joint_derivatives(state, hand, x, orientations_absolute, d_hand_size, d_joints);
+
+		RowHelper helper(jacobian, cost_functor.NumResiduals());
+
+		positions_part(state, hand, translations_absolute, d_joints, d_hand_size, helper);
+		stability_part(state, hand, x, d_hand_size, helper);
+
+		assert(helper.out_row_idx == (size_t)cost_functor.NumResiduals());
+	}
+
+	// Follows eval_hand_with_orientation.
+	static void
+	eval_joint_derivatives(const KinematicHandLM &state,
+	                       const OptimizerHand<HandScalar> &hand,
+	                       const HandScalar *x,
+	                       const Orientations54<HandScalar> &orientations_absolute,
+	                       const Row &d_hand_size,
+	                       Jacobian3 out_d_joints[kNumNNJoints])
+	{
+		Orientations54<HandScalar> rel_orientations = {};
+		Translations55<HandScalar> rel_translations = {};
+		eval_hand_set_rel_orientations(hand, rel_orientations);
+		eval_hand_set_rel_translations(hand, rel_translations);
+
+		// Relative orientations' derivatives, only the thumb and fingers' own parameters move them.
+		Jacobian4 d_rel[kNumFingers][kNumOrientationsInFinger];
+		for (size_t finger = 0; finger < kNumFingers; finger++) {
+			for (size_t bone = 0; bone < kNumOrientationsInFinger; bone++) {
+				d_rel[finger][bone].setZero();
+			}
+		}
+
+		{
+			const OptimizerThumb<HandScalar> &thumb = hand.thumb;
+			Eigen::Matrix<HandScalar, 4, 3> j =
+			    swing_twist_to_quaternion_jacobian(thumb.metacarpal.swing, thumb.metacarpal.twist);
+
+			d_rel[0][1].col(kParamThumb + 0) =
+			    j.col(0) * lm_to_model_derivative(x[kParamThumb + 0], the_limit.thumb_mcp_swing_x);
+			d_rel[0][1].col(kParamThumb + 1) =
+			    j.col(1) * lm_to_model_derivative(x[kParamThumb + 1], the_limit.thumb_mcp_swing_y);
+			d_rel[0][1].col(kParamThumb + 2) =
+			    j.col(2) * lm_to_model_derivative(x[kParamThumb + 2], the_limit.thumb_mcp_twist);
+
+			for (int i = 0; i < 2; i++) {
+				int p = kParamThumb + 3 + i;
+				d_rel[0][2 + i].col(p) = angle_axis_to_quaternion_jacobian(thumb.rots[i], 0, 0).col(0) *
+				                         lm_to_model_derivative(x[p], the_limit.thumb_curls[i]);
+			}
+		}
+
+		for (int finger_idx = 0; finger_idx < 4; finger_idx++) {
+			const OptimizerFinger<HandScalar> &finger = hand.finger[finger_idx];
+			const FingerLimit &limit = the_limit.fingers[finger_idx];
+			int p = kParamFingers + finger_idx * kFingerDim;
+
+			// The metacarpal is constant.
+			Eigen::Matrix<HandScalar, 4, 3> j =
+			    angle_axis_to_quaternion_jacobian(finger.proximal_swing.x, finger.proximal_swing.y, 0);
+
+			d_rel[finger_idx + 1][1].col(p + 0) =
+			    j.col(0) * lm_to_model_derivative(x[p + 0], limit.pxm_swing_x);
+			d_rel[finger_idx + 1][1].col(p + 1) =
+			    j.col(1) * lm_to_model_derivative(x[p + 1], limit.pxm_swing_y);
+
+			for (int i = 0; i < 2; i++) {
+				d_rel[finger_idx + 1][2 + i].col(p + 2 + i) =
+				    angle_axis_to_quaternion_jacobian(finger.rots[i], 0, 0).col(0) *
+				    lm_to_model_derivative(x[p + 2 + i], limit.curls[i]);
+			}
+		}
+
+		// Wrist.
+		Jacobian3 d_wrist_location = Jacobian3::Zero();
+		d_wrist_location.template middleCols<3>(kParamWristLocation).setIdentity();
+
+		Jacobian4 d_wrist_orientation = Jacobian4::Zero();
+		{
+			const Vec3<HandScalar> &aax = hand.wrist_post_orientation_aax;
+			d_wrist_orientation.template middleCols<3>(kParamWristOrientation) =
+			    quat_product_left(state.this_frame_pre_rotation) *
+			    angle_axis_to_quaternion_jacobian(aax.x, aax.y, aax.z);
+		}
+
+		out_d_joints[0] = d_wrist_location;
+
+		int joint_acc_idx = 1;
+
+		for (size_t finger = 0; finger < kNumFingers; finger++) {
+			Jacobian4 d_orientations[kNumOrientationsInFinger];
+
+			const Quat<HandScalar> *last_orientation = &hand.wrist_final_orientation;
+			const Jacobian4 *d_last_orientation = &d_wrist_orientation;
+			for (size_t bone = 0; bone < kNumOrientationsInFinger; bone++) {
+				d_orientations[bone] = quat_product_right(rel_orientations.q[finger][bone]) *
+				                           (*d_last_orientation) +
+				                       quat_product_left(*last_orientation) * d_rel[finger][bone];
+
+				last_orientation = &orientations_absolute.q[finger][bone];
+				d_last_orientation = &d_orientations[bone];
+			}
+
+			Jacobian3 d_translation = d_wrist_location;
+
+			last_orientation = &hand.wrist_final_orientation;
+			d_last_orientation = &d_wrist_orientation;
+			for (size_t bone = 0; bone < kNumJointsInFinger; bone++) {
+				const Vec3<HandScalar> &rel_translation = rel_translations.t[finger][bone];
+
+				Vec3<HandScalar> rotated;
+				UnitQuaternionRotatePoint(*last_orientation, rel_translation, rotated);
+
+				Jacobian3 d_rotated =
+				    hand.hand_size * rotate_point_jacobian(*last_orientation, rel_translation) *
+				    (*d_last_orientation);
+				d_rotated.row(0) += rotated.x * d_hand_size;
+				d_rotated.row(1) += rotated.y * d_hand_size;
+				d_rotated.row(2) += rotated.z * d_hand_size;
+
+				if (state.is_right) {
+					d_rotated.row(0) *= -1;
+				}
+
+				d_translation += d_rotated;
+
+				// The joints the residuals look at, skipping the metacarpal root.
+				if (bone > 0) {
+					out_d_joints[joint_acc_idx++] = d_translation;
+				}
+
+				if (bone < 4) {
+					last_orientation = &orientations_absolute.q[finger][bone];
+					d_last_orientation = &d_orientations[bone];
+				}
+			}
+		}
+	}
+
+	// Follows CostFunctor_PositionsPart and diff_stereographic.
+	static void
+	positions_part(const KinematicHandLM &state,
+	               const OptimizerHand<HandScalar> &hand,
+	               const Translations55<HandScalar> &translations_absolute,
+	               const Jacobian3 d_joints[kNumNNJoints],
+	               const Row &d_hand_size,
+	               RowHelper &helper)
+	{
+		for (int view = 0; view < 2; view++) {
+			if (!state.observation->views[view].active) {
+				continue;
+			}
+			const one_frame_one_view &obs = state.observation->views[view];
+
+			Vec3<HandScalar> joints_rel_camera[kNumNNJoints] = {};
+			cjrc(state, hand, translations_absolute, view, joints_rel_camera);
+
+			// Both of the rotations in calc_joint_rel_camera are constant.
+			Quat<HandScalar> move_orientation = Quat<HandScalar>::Identity();
+			if (view != 0) {
+				move_orientation = state.left_in_right_orientation;
+			}
+			xrt_quat extra_rot = obs.look_dir;
+			math_quat_invert(&extra_rot, &extra_rot);
+			Quat<HandScalar> after_orientation(extra_rot.x, extra_rot.y, extra_rot.z, extra_rot.w);
+
+			Eigen::Matrix<HandScalar, 3, 3> to_camera =
+			    rotation_matrix(after_orientation) * rotation_matrix(move_orientation);
+
+			Jacobian3 d_joints_rel_camera[kNumNNJoints];
+			for (size_t i = 0; i < kNumNNJoints; i++) {
+				d_joints_rel_camera[i].noalias() = to_camera * d_joints[i];
+			}
+
+			// Derivatives of the joints' distances to the camera.
+			auto d_norm = [&](int i, HandScalar norm) -> Row {
+				const Vec3<HandScalar> &p = joints_rel_camera[i];
+				return (p.x * d_joints_rel_camera[i].row(0) + p.y * d_joints_rel_camera[i].row(1) +
+				        p.z * d_joints_rel_camera[i].row(2)) /
+				       norm;
+			};
+
+			HandScalar middlepxmdepth = joints_rel_camera[Joint21::INDX_PXM].norm();
+			Row d_middlepxmdepth = d_norm(Joint21::INDX_PXM, middlepxmdepth);
+
+			for (int i = 0; i < 21; i++) {
+				const vec2_5 &kp = obs.keypoints_in_scaled_stereographic[i];
+
+				stereographic_rows(joints_rel_camera[i], d_joints_rel_camera[i], kp.confidence_xy, helper);
+
+				if (i == Joint21::MIDL_PXM) {
+					continue;
+				}
+
+				if (state.first_frame) {
+					helper.AddRow(Row::Zero());
+					continue;
+				}
+
+				HandScalar norm = joints_rel_camera[i].norm();
+				HandScalar rel_depth = (norm - middlepxmdepth) / hand.hand_size;
+
+				Row d_rel_depth = (d_norm(i, norm) - d_middlepxmdepth) / hand.hand_size;
+				d_rel_depth -= (rel_depth / hand.hand_size) * d_hand_size;
+
+				helper.AddRow(d_rel_depth * HandScalar(pow(kp.confidence_depth, 3)) * state.depth_err_mul);
+			}
+		}
+	}
+
+	static void
+	stereographic_rows(const Vec3<HandScalar> &p,
+	                   const Jacobian3 &d_p,
+	                   const HandScalar confidence_xy,
+	                   RowHelper &helper)
+	{
+		Vec3<HandScalar> dir = p;
+		normalize_vector_inplace(dir);
+
+		HandScalar len = p.norm();
+
+		Jacobian3 d_dir;
+		if (len <= FLT_EPSILON) {
+			// normalize_vector_inplace gave up and just set z.
+			d_dir = d_p;
+			d_dir.row(2).setZero();
+		} else {
+			Row dir_dot_d_p = dir.x * d_p.row(0) + dir.y * d_p.row(1) + dir.z * d_p.row(2);
+			d_dir.row(0) = (d_p.row(0) - dir.x * dir_dot_d_p) / len;
+			d_dir.row(1) = (d_p.row(1) - dir.y * dir_dot_d_p) / len;
+			d_dir.row(2) = (d_p.row(2) - dir.z * dir_dot_d_p) / len;
+		}
+
+		// unit_vector_stereographic_projection
+		HandScalar inv_denom = 1.0f / (1.0f - dir.z);
+		HandScalar inv_denom_squared = inv_denom * inv_denom;
+
+		helper.AddRow((d_dir.row(0) * inv_denom + dir.x * inv_denom_squared * d_dir.row(2)) * confidence_xy);
+		helper.AddRow((d_dir.row(1) * inv_denom + dir.y * inv_denom_squared * d_dir.row(2)) * confidence_xy);
+	}
+
+	// Follows computeResidualStability, every residual in there is a scaled parameter.
+	static void
+	stability_part(const KinematicHandLM &state,
+	               const OptimizerHand<HandScalar> &hand,
+	               const HandScalar *x,
+	               const Row &d_hand_size,
+	               RowHelper &helper)
+	{
+		HandStability stab(state.smoothing_factor);
+
+		auto param_row = [](int param, HandScalar value) -> Row {
+			Row row = Row::Zero();
+			row(param) = value;
+			return row;
+		};
+
+		if constexpr (optimize_hand_size) {
+			helper.AddRow(d_hand_size * (stab.stabilityHandSize * state.hand_size_err_mul));
+		}
+
+		if (state.first_frame) {
+			return;
+		}
+
+		for (int i = 0; i < 3; i++) {
+			helper.AddRow(param_row(kParamWristLocation + i, stab.stabilityRootPosition));
+		}
+
+		const Vec3<HandScalar> &aax = hand.wrist_post_orientation_aax;
+		const HandScalar orientation_mul[3] = {stab.stabilityHandOrientationXY, stab.stabilityHandOrientationXY,
+		                                       stab.stabilityHandOrientationZ};
+
+		const float epsilon = 0.001;
+		if (aax.x < epsilon && aax.y < epsilon && aax.z < epsilon) {
+			for (int i = 0; i < 3; i++) {
+				helper.AddRow(param_row(kParamWristOrientation + i, orientation_mul[i]));
+			}
+		} else {
+			// d(2 sin(|a|/2) * a/|a|)/da
+			const HandScalar a[3] = {aax.x, aax.y, aax.z};
+			HandScalar magnitude = aax.norm();
+			HandScalar magnitude_sin = 2 * sinf(0.5f * magnitude);
+			HandScalar d_magnitude_sin = cosf(0.5f * magnitude);
+
+			for (int i = 0; i < 3; i++) {
+				Row row = Row::Zero();
+				HandScalar axis_i = a[i] / magnitude;
+				for (int j = 0; j < 3; j++) {
+					HandScalar axis_j = a[j] / magnitude;
+					HandScalar d_axis = ((i == j ? 1.0f : 0.0f) - axis_i * axis_j) / magnitude;
+					row(kParamWristOrientation + j) =
+					    (d_magnitude_sin * axis_j * axis_i + magnitude_sin * d_axis) * orientation_mul[i];
+				}
+				helper.AddRow(row);
+			}
+		}
+
+		const int t = kParamThumb;
+		helper.AddRow(param_row(t + 0, lm_to_model_derivative(x[t + 0], the_limit.thumb_mcp_swing_x) *
+		                                   stab.stabilityThumbMCPSwing));
+		helper.AddRow(param_row(t + 1, lm_to_model_derivative(x[t + 1], the_limit.thumb_mcp_swing_y) *
+		                                   stab.stabilityThumbMCPSwing));
+		helper.AddRow(param_row(t + 2, lm_to_model_derivative(x[t + 2], the_limit.thumb_mcp_twist) *
+		                                   stab.stabilityThumbMCPTwist));
+		helper.AddRow(param_row(t + 3, lm_to_model_derivative(x[t + 3], the_limit.thumb_curls[0]) *
+		                                   stab.stabilityCurlRoot));
+		helper.AddRow(param_row(t + 4, lm_to_model_derivative(x[t + 4], the_limit.thumb_curls[1]) *
+		                                   stab.stabilityCurlRoot));
+
+		for (int finger_idx = 0; finger_idx < 4; finger_idx++) {
+			const FingerLimit &limit = the_limit.fingers[finger_idx];
+			const int p = kParamFingers + finger_idx * kFingerDim;
+
+			HandScalar obs_curl = HandScalar(get_avg_curl_value(*state.observation, finger_idx + 1));
+			HandScalar curl_sub_mul = calc_stability_curl_multiplier(state.last_frame.finger[finger_idx], obs_curl);
+
+			helper.AddRow(param_row(p + 0, lm_to_model_derivative(x[p + 0], limit.pxm_swing_x) *
+			                                   stab.stabilityFingerPXMSwingX * curl_sub_mul));
+			helper.AddRow(param_row(p + 1, lm_to_model_derivative(x[p + 1], limit.pxm_swing_y) *
+			                                   stab.stabilityFingerPXMSwingY));
+			helper.AddRow(param_row(p + 2, lm_to_model_derivative(x[p + 2], limit.curls[0]) *
+			                                   stab.stabilityCurlRoot * curl_sub_mul));
+			helper.AddRow(param_row(p + 3, lm_to_model_derivative(x[p + 3], limit.curls[1]) *
+			                                   stab.stabilityCurlRoot * curl_sub_mul));
+		}
+	}
+};
+
+} // namespace xrt::tracking::hand::mercury::lm
+
+#endif
@@ -13,6 +13,7 @@
 #include "math/m_eigen_interop.hpp"
 #include "util/u_logging.h"
 #include "../kine_common.hpp"
+#include "lm_interface.hpp"
 
 namespace xrt::tracking::hand::mercury::lm {
 
@@ -53,6 +54,10 @@ static constexpr size_t kNumOrientationsInFinger = 4;
 
 #undef RESIDUALS_HACKING
 
+// Use the hand-written Jacobian in lm_analytic_jacobian.inl instead of autodiff. It only knows the parameters and
+// residuals you get with the defaults above, so undefine this when hacking on those.
+#define USE_ANALYTIC_JACOBIAN
+
 static constexpr size_t kMetacarpalBoneDim = 3;
 static constexpr size_t kProximalBoneDim = 2;
 static constexpr size_t kFingerDim = kProximalBoneDim + 2;
@@ -558,6 +563,12 @@ struct KinematicHandLM
 	Quat<HandScalar> left_in_right_orientation = {};
 
 	Eigen::Matrix<HandScalar, calc_input_size(true), 1> TinyOptimizerInput = {};
+
+#ifdef USE_ANALYTIC_JACOBIAN
+	JacobianMethod jacobian_method = JacobianMethod::Analytic;
+#else
+	JacobianMethod jacobian_method = JacobianMethod::Autodiff;
+#endif
 };
 
 template <typename T> struct Translations55
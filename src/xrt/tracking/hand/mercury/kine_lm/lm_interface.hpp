@@ -12,6 +12,8 @@
 // #include "lm_defines.hpp"
 #include "../kine_common.hpp"
 
+#include <vector>
+
 namespace xrt::tracking::hand::mercury::lm {
 
 // Yes, this is a weird in-between-C-and-C++ API. Fight me, I like it this way.
@@ -19,6 +21,14 @@ namespace xrt::tracking::hand::mercury::lm {
 // Opaque struct.
 struct KinematicHandLM;
 
+// How the optimizer gets the Jacobian of its cost function.
+enum class JacobianMethod
+{
+	Autodiff,
+	// Hand-written, much cheaper. The default if USE_ANALYTIC_JACOBIAN is defined in lm_defines.hpp.
+	Analytic,
+};
+
 // Constructor
 void
 optimizer_create(xrt_pose left_in_right,
@@ -57,6 +67,30 @@ optimizer_run(KinematicHandLM *hand,
               float &out_hand_size,
               float &out_reprojection_error);
 
+/*!
+ * Sets the state up for @p observation like @ref optimizer_run does, then evaluates the cost function and its Jacobian
+ * at the starting point moved by @p offset instead of optimizing. For comparing Jacobian methods.
+ *
+ * @param offset: Added to the starting parameters, may be NULL.
+ * @param[out] out_jacobian: Column-major, with as many rows as @p out_residuals.
+ */
+void
+optimizer_evaluate(KinematicHandLM *hand,
+                   one_frame_input &observation,
+                   bool hand_was_untracked_last_frame,
+                   float smoothing_factor,
+                   bool optimize_hand_size,
+                   float target_hand_size,
+                   float hand_size_err_mul,
+                   float amt_use_depth,
+                   const float *offset,
+                   std::vector<float> &out_residuals,
+                   std::vector<float> &out_jacobian);
+
+// Returns false if the method was not built in.
+bool
+optimizer_set_jacobian_method(KinematicHandLM *hand, JacobianMethod method);
+
 // Destructor
 void
 optimizer_destroy(KinematicHandLM **hand);
@@ -723,6 +723,13 @@ CostFunctor<optimize_hand_size>::operator()(const T *const x, T *residual) const
 	return true;
 }
 
+} // namespace xrt::tracking::hand::mercury::lm
+
+// Needs the cost functor and everything it uses.
+#include "lm_analytic_jacobian.inl"
+
+namespace xrt::tracking::hand::mercury::lm {
+
 // look at tests_quat_change_of_basis
 #if 0
 template <typename T>
@@ -841,24 +848,18 @@ eval_to_viz_hand(KinematicHandLM &state,
 }
 
 template <bool optimize_hand_size>
-inline float
-opt_run(KinematicHandLM &state, one_frame_input &observation, xrt_hand_joint_set &out_viz_hand)
+using AutoDiffCostFunction = ceres::TinySolverAutoDiffFunction<CostFunctor<optimize_hand_size>,
+                                                               Eigen::Dynamic,
+                                                               calc_input_size(optimize_hand_size),
+                                                               HandScalar>;
+
+template <bool optimize_hand_size, typename Function>
+inline void
+opt_solve(KinematicHandLM &state, Function &f)
 {
 	constexpr size_t input_size = calc_input_size(optimize_hand_size);
 
-	size_t residual_size = calc_residual_size(state.use_stability, optimize_hand_size, state.num_observation_views);
-
-	LM_DEBUG(state, "Running with %zu inputs and %zu residuals, viewed in %d cameras", input_size, residual_size,
-	         state.num_observation_views);
-
-	CostFunctor<optimize_hand_size> cf(state, residual_size);
-
-	using AutoDiffCostFunctor =
-	    ceres::TinySolverAutoDiffFunction<CostFunctor<optimize_hand_size>, Eigen::Dynamic, input_size, HandScalar>;
-
-	AutoDiffCostFunctor f(cf);
-
-	ceres::TinySolver<AutoDiffCostFunctor> solver = {};
+	ceres::TinySolver<Function> solver = {};
 	solver.options.max_num_iterations = 30;
 
 	//!@todo We don't yet know what "good" termination conditions are.
@@ -912,9 +913,67 @@ opt_run(KinematicHandLM &state, one_frame_input &observation, xrt_hand_joint_set
 			LM_DEBUG(state, "Suspiciouisly low number of iterations!");
 		}
 	}
+}
+
+template <bool optimize_hand_size>
+inline float
+opt_run(KinematicHandLM &state, one_frame_input &observation, xrt_hand_joint_set &out_viz_hand)
+{
+	constexpr size_t input_size = calc_input_size(optimize_hand_size);
+
+	size_t residual_size = calc_residual_size(state.use_stability, optimize_hand_size, state.num_observation_views);
+
+	LM_DEBUG(state, "Running with %zu inputs and %zu residuals, viewed in %d cameras", input_size, residual_size,
+	         state.num_observation_views);
+
+	CostFunctor<optimize_hand_size> cf(state, residual_size);
+
+#ifdef USE_ANALYTIC_JACOBIAN
+	if (state.jacobian_method == JacobianMethod::Analytic) {
+		AnalyticCostFunction<optimize_hand_size> f(cf);
+		opt_solve<optimize_hand_size>(state, f);
+		return 0;
+	}
+#endif
+
+	AutoDiffCostFunction<optimize_hand_size> f(cf);
+	opt_solve<optimize_hand_size>(state, f);
 	return 0;
 }
 
+template <bool optimize_hand_size>
+static void
+opt_evaluate(KinematicHandLM &state,
+             const float *offset,
+             std::vector<float> &out_residuals,
+             std::vector<float> &out_jacobian)
+{
+	constexpr size_t input_size = calc_input_size(optimize_hand_size);
+
+	size_t residual_size = calc_residual_size(state.use_stability, optimize_hand_size, state.num_observation_views);
+
+	CostFunctor<optimize_hand_size> cf(state, residual_size);
+
+	Eigen::Matrix<HandScalar, input_size, 1> inp = state.TinyOptimizerInput.head<input_size>();
+	if (offset != nullptr) {
+		inp += Eigen::Map<const Eigen::Matrix<HandScalar, input_size, 1>>(offset);
+	}
+
+	out_residuals.resize(residual_size);
+	out_jacobian.resize(residual_size * input_size);
+
+#ifdef USE_ANALYTIC_JACOBIAN
+	if (state.jacobian_method == JacobianMethod::Analytic) {
+		AnalyticCostFunction<optimize_hand_size> f(cf);
+		f(inp.data(), out_residuals.data(), out_jacobian.data());
+		return;
+	}
+#endif
+
+	AutoDiffCostFunction<optimize_hand_size> f(cf);
+	f(inp.data(), out_residuals.data(), out_jacobian.data());
+}
+
 void
 optimizer_finish(KinematicHandLM &state, xrt_hand_joint_set &out_viz_hand, float &out_reprojection_error)
 {
@@ -950,22 +1009,17 @@ optimizer_finish(KinematicHandLM &state, xrt_hand_joint_set &out_viz_hand, float
 	out_reprojection_error = sum;
 }
 
-void
-optimizer_run(KinematicHandLM *hand,
-              one_frame_input &observation,
-              bool hand_was_untracked_last_frame,
-              float smoothing_factor, //!<- Unused if this is the first frame
-              bool optimize_hand_size,
-              float target_hand_size,
-              float hand_size_err_mul,
-              float amt_use_depth,
-              xrt_hand_joint_set &out_viz_hand,
-              float &out_hand_size,
-              float &out_reprojection_error) // NOLINT(bugprone-easily-swappable-parameters)
+// Gets the state ready to optimize for this observation.
+static void
+optimizer_prepare(KinematicHandLM &state,
+                  one_frame_input &observation,
+                  bool hand_was_untracked_last_frame,
+                  float smoothing_factor,
+                  bool optimize_hand_size,
+                  float target_hand_size,
+                  float hand_size_err_mul,
+                  float amt_use_depth) // NOLINT(bugprone-easily-swappable-parameters)
 {
-	numerics_checker::set_floating_exceptions();
-
-	KinematicHandLM &state = *hand;
 	state.smoothing_factor = smoothing_factor;
 
 	xrt_pose blah = XRT_POSE_IDENTITY;
@@ -1047,7 +1101,27 @@ optimizer_run(KinematicHandLM *hand,
 
 
 #endif
+}
 
+void
+optimizer_run(KinematicHandLM *hand,
+              one_frame_input &observation,
+              bool hand_was_untracked_last_frame,
+              float smoothing_factor, //!<- Unused if this is the first frame
+              bool optimize_hand_size,
+              float target_hand_size,
+              float hand_size_err_mul,
+              float amt_use_depth,
+              xrt_hand_joint_set &out_viz_hand,
+              float &out_hand_size,
+              float &out_reprojection_error) // NOLINT(bugprone-easily-swappable-parameters)
+{
+	numerics_checker::set_floating_exceptions();
+
+	KinematicHandLM &state = *hand;
+
+	optimizer_prepare(state, observation, hand_was_untracked_last_frame, smoothing_factor, optimize_hand_size,
+	                  target_hand_size, hand_size_err_mul, amt_use_depth);
 
 	// For now, we have to statically instantiate different versions of the optimizer depending on
 	// how many input parameters there are. For now, there are only two cases - either we are
@@ -1097,6 +1171,47 @@ optimizer_run(KinematicHandLM *hand,
 
 
 
+void
+optimizer_evaluate(KinematicHandLM *hand,
+                   one_frame_input &observation,
+                   bool hand_was_untracked_last_frame,
+                   float smoothing_factor,
+                   bool optimize_hand_size,
+                   float target_hand_size,
+                   float hand_size_err_mul,
+                   float amt_use_depth,
+                   const float *offset,
+                   std::vector<float> &out_residuals,
+                   std::vector<float> &out_jacobian) // NOLINT(bugprone-easily-swappable-parameters)
+{
+	numerics_checker::set_floating_exceptions();
+
+	KinematicHandLM &state = *hand;
+
+	optimizer_prepare(state, observation, hand_was_untracked_last_frame, smoothing_factor, optimize_hand_size,
+	                  target_hand_size, hand_size_err_mul, amt_use_depth);
+
+	if (optimize_hand_size) {
+		opt_evaluate<true>(state, offset, out_residuals, out_jacobian);
+	} else {
+		opt_evaluate<false>(state, offset, out_residuals, out_jacobian);
+	}
+
+	numerics_checker::remove_floating_exceptions();
+}
+
+bool
+optimizer_set_jacobian_method(KinematicHandLM *hand, JacobianMethod method)
+{
+#ifndef USE_ANALYTIC_JACOBIAN
+	if (method == JacobianMethod::Analytic) {
+		return false;
+	}
+#endif
+	hand->jacobian_method = method;
+	return true;
+}
+
 void
 optimizer_create(xrt_pose left_in_right, bool is_right, u_logging_level log_level, KinematicHandLM **out_kinematic_hand)
 {
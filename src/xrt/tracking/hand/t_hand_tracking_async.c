@@ -11,8 +11,11 @@
 #include "util/u_misc.h"
 #include "util/u_trace_marker.h"
 #include "util/u_logging.h"
+#include "util/u_debug.h"
+#include "util/u_time.h"
 #include "util/u_var.h"
 #include "os/os_threading.h"
+#include "os/os_time.h"
 
 #include "math/m_space.h"
 #include "math/m_relation_history.h"
@@ -20,6 +23,8 @@
 
 //!@todo Definitely needs a destroy function, will leak a ton.
 
+DEBUG_GET_ONCE_BOOL_OPTION(ht_pipelined, "HT_PIPELINED", false)
+
 struct ht_async_impl
 {
 	struct t_hand_tracking_async base;
@@ -51,6 +56,28 @@ struct ht_async_impl
 	// running is so we can stop the thread when Monado exits
 	struct os_thread_helper mainloop;
 
+	/*!
+	 * Runs the second half of the tracker when pipelined, so the mainloop
+	 * can start on the next frames as soon as the first half is done.
+	 * Started by the mainloop the first time it runs pipelined.
+	 */
+	struct
+	{
+		struct os_thread_helper thread;
+
+		//! Only touched by the mainloop.
+		bool started;
+
+		//! Frames given to infer but not optimized yet, protected by the thread's lock.
+		int pending;
+	} optimizer;
+
+	//! Split the tracker into two stages on two threads, if it supports it.
+	bool pipelined;
+
+	//! Time from the camera capturing the frames to the hands being available, for the last frames.
+	float latency_ms;
+
 	volatile bool hand_tracking_work_active;
 };
 
@@ -60,6 +87,116 @@ ht_async_impl(struct t_hand_tracking_async *base)
 	return (struct ht_async_impl *)base;
 }
 
+//! Make the hands in working available to get_hand.
+static void
+ht_async_publish(struct ht_async_impl *hta)
+{
+	os_mutex_lock(&hta->present.mutex);
+	hta->present.timestamp = hta->working.timestamp;
+	for (int i = 0; i < 2; i++) {
+		hta->present.hands[i] = hta->working.hands[i];
+
+		struct xrt_space_relation wrist_rel =
+		    hta->working.hands[i].values.hand_joint_set_default[XRT_HAND_JOINT_WRIST].relation;
+
+		m_relation_history_estimate_motion(hta->present.relation_hist[i], //
+		                                   &wrist_rel,                    //
+		                                   hta->working.timestamp,        //
+		                                   &wrist_rel);
+		m_relation_history_push(hta->present.relation_hist[i], &wrist_rel, hta->working.timestamp);
+	}
+	os_mutex_unlock(&hta->present.mutex);
+
+	hta->latency_ms = (float)time_ns_to_ms_f((int64_t)os_monotonic_get_ns() - (int64_t)hta->working.timestamp);
+}
+
+static void *
+ht_async_optimizer_loop(void *ptr)
+{
+	U_TRACE_SET_THREAD_NAME("Hand Tracking: Optimizer");
+
+	struct ht_async_impl *hta = (struct ht_async_impl *)ptr;
+
+	os_thread_helper_lock(&hta->optimizer.thread);
+
+	while (os_thread_helper_is_running_locked(&hta->optimizer.thread)) {
+
+		// Nothing to optimize, wait.
+		if (hta->optimizer.pending == 0) {
+			os_thread_helper_wait_locked(&hta->optimizer.thread);
+			continue;
+		}
+
+		os_thread_helper_unlock(&hta->optimizer.thread);
+
+		t_ht_sync_optimize(hta->provider, &hta->working.hands[0], &hta->working.hands[1],
+		                   &hta->working.timestamp);
+		ht_async_publish(hta);
+
+		os_thread_helper_lock(&hta->optimizer.thread);
+		hta->optimizer.pending--;
+
+		// The mainloop may be waiting for us to finish.
+		os_thread_helper_signal_locked(&hta->optimizer.thread);
+	}
+
+	os_thread_helper_unlock(&hta->optimizer.thread);
+
+	return NULL;
+}
+
+//! Wait for the optimizer thread to finish the frames given to it, called from the mainloop.
+static void
+ht_async_wait_for_optimizer(struct ht_async_impl *hta)
+{
+	os_thread_helper_lock(&hta->optimizer.thread);
+	while (hta->optimizer.pending > 0 && os_thread_helper_is_running_locked(&hta->optimizer.thread)) {
+		os_thread_helper_wait_locked(&hta->optimizer.thread);
+	}
+	os_thread_helper_unlock(&hta->optimizer.thread);
+}
+
+static void
+ht_async_process(struct ht_async_impl *hta)
+{
+	bool pipelined = hta->pipelined && t_ht_sync_can_pipeline(hta->provider);
+
+	if (pipelined && !hta->optimizer.started) {
+		int ret = os_thread_helper_start(&hta->optimizer.thread, ht_async_optimizer_loop, hta);
+		if (ret != 0) {
+			U_LOG_E("Failed to start the optimizer thread, not pipelining: %d", ret);
+			hta->pipelined = false;
+			pipelined = false;
+		} else {
+			hta->optimizer.started = true;
+		}
+	}
+
+	if (!pipelined) {
+		// Switched from pipelined, don't run over frames still in the pipeline.
+		ht_async_wait_for_optimizer(hta);
+
+		t_ht_sync_process(hta->provider, hta->frames[0], hta->frames[1], &hta->working.hands[0],
+		                  &hta->working.hands[1], &hta->working.timestamp);
+
+		xrt_frame_reference(&hta->frames[0], NULL);
+		xrt_frame_reference(&hta->frames[1], NULL);
+		ht_async_publish(hta);
+		return;
+	}
+
+	// Blocks if the optimizer hasn't picked up the results of the last frames yet.
+	t_ht_sync_infer(hta->provider, hta->frames[0], hta->frames[1]);
+
+	xrt_frame_reference(&hta->frames[0], NULL);
+	xrt_frame_reference(&hta->frames[1], NULL);
+
+	os_thread_helper_lock(&hta->optimizer.thread);
+	hta->optimizer.pending++;
+	os_thread_helper_signal_locked(&hta->optimizer.thread);
+	os_thread_helper_unlock(&hta->optimizer.thread);
+}
+
 static void *
 ht_async_mainloop(void *ptr)
 {
@@ -85,26 +222,7 @@ ht_async_mainloop(void *ptr)
 
 		os_thread_helper_unlock(&hta->mainloop);
 
-		t_ht_sync_process(hta->provider, hta->frames[0], hta->frames[1], &hta->working.hands[0],
-		                  &hta->working.hands[1], &hta->working.timestamp);
-
-		xrt_frame_reference(&hta->frames[0], NULL);
-		xrt_frame_reference(&hta->frames[1], NULL);
-		os_mutex_lock(&hta->present.mutex);
-		hta->present.timestamp = hta->working.timestamp;
-		for (int i = 0; i < 2; i++) {
-			hta->present.hands[i] = hta->working.hands[i];
-
-			struct xrt_space_relation wrist_rel =
-			    hta->working.hands[i].values.hand_joint_set_default[XRT_HAND_JOINT_WRIST].relation;
-
-			m_relation_history_estimate_motion(hta->present.relation_hist[i], //
-			                                   &wrist_rel,                    //
-			                                   hta->working.timestamp,        //
-			                                   &wrist_rel);
-			m_relation_history_push(hta->present.relation_hist[i], &wrist_rel, hta->working.timestamp);
-		}
-		os_mutex_unlock(&hta->present.mutex);
+		ht_async_process(hta);
 
 		hta->hand_tracking_work_active = false;
 
@@ -208,7 +326,13 @@ void
 ht_async_break_apart(struct xrt_frame_node *node)
 {
 	struct ht_async_impl *hta = ht_async_impl(container_of(node, struct t_hand_tracking_async, node));
+
+	/*
+	 * Stop the mainloop before the optimizer: the mainloop might be blocked
+	 * waiting on the optimizer, which has to keep running to unblock it.
+	 */
 	os_thread_helper_stop_and_wait(&hta->mainloop);
+	os_thread_helper_stop_and_wait(&hta->optimizer.thread);
 }
 
 void
@@ -216,6 +340,7 @@ ht_async_destroy(struct xrt_frame_node *node)
 {
 	struct ht_async_impl *hta = ht_async_impl(container_of(node, struct t_hand_tracking_async, node));
 	os_thread_helper_destroy(&hta->mainloop);
+	os_thread_helper_destroy(&hta->optimizer.thread);
 	os_mutex_destroy(&hta->present.mutex);
 
 	t_ht_sync_destroy(&hta->provider);
@@ -267,10 +392,16 @@ t_hand_tracking_async_default_create(struct xrt_frame_context *xfctx, struct t_h
 	u_var_add_bool(hta, &hta->use_prediction, "Predict wrist movement");
 	u_var_add_draggable_f32(hta, &hta->prediction_offset_ms, "Amount to time-travel (ms)");
 
+	hta->pipelined = debug_get_bool_option_ht_pipelined();
+
+	u_var_add_bool(hta, &hta->pipelined, "Run inference on the next frames while optimizing");
+	u_var_add_ro_f32(hta, &hta->latency_ms, "Latency, frame capture to hands (ms)");
+
 
 	os_mutex_init(&hta->present.mutex);
 	os_thread_helper_init(&hta->mainloop);
 	os_thread_helper_start(&hta->mainloop, ht_async_mainloop, hta);
+	os_thread_helper_init(&hta->optimizer.thread);
 	xrt_frame_context_add(xfctx, &hta->base.node);
 
 	return &hta->base;
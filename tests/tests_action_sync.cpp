@@ -0,0 +1,346 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Action sync tests, using hand made action set attachments.
+ */
+
+#include "util/u_time.h"
+#include "util/u_hashmap.h"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <xrt/xrt_defines.h>
+#include <xrt/xrt_system.h>
+
+#include <oxr/oxr_input_transform.h>
+#include <oxr/oxr_logger.h>
+#include <oxr/oxr_objects.h>
+
+#include <memory>
+#include <vector>
+
+
+/*
+ *
+ * Test setup.
+ *
+ * A session with a number of action sets attached, each with boolean actions
+ * bound to a shared pool of inputs on the left and right hand, all inputs are on
+ * one device. This is what
+ * @ref oxr_session_attach_action_sets would have produced, without needing a
+ * instance, system devices or interaction profiles.
+ *
+ */
+
+struct test_device
+{
+	xrt_device base;
+	uint32_t update_count;
+};
+
+static void
+test_update_inputs(xrt_device *xdev)
+{
+	((test_device *)xdev)->update_count++;
+}
+
+struct test_action_set
+{
+	oxr_action_set act_set = {};
+	oxr_action_set_ref ref = {};
+	std::vector<oxr_action_ref> act_refs;
+	std::vector<oxr_action_input> inputs;
+};
+
+struct test_setup
+{
+	oxr_logger log = {};
+	xrt_system_devices xsysd = {};
+	std::unique_ptr<oxr_instance> inst = std::make_unique<oxr_instance>();
+	oxr_system sys = {};
+	std::unique_ptr<oxr_session> sess = std::make_unique<oxr_session>();
+
+	oxr_input_transform identity = {};
+	test_device dev = {};
+	std::vector<xrt_input> xinputs;
+	std::vector<std::unique_ptr<test_action_set>> sets;
+
+	test_setup(uint32_t input_count)
+	{
+		oxr_log_init(&log, "test");
+
+		*inst = {};
+		inst->timekeeping = time_state_create(0);
+
+		sys.inst = inst.get();
+		sys.xsysd = &xsysd;
+
+		*sess = {};
+		sess->sys = &sys;
+		sess->state = XR_SESSION_STATE_FOCUSED;
+		u_hashmap_int_create(&sess->act_sets_attachments_by_key);
+
+		identity.type = INPUT_TRANSFORM_IDENTITY;
+
+		xinputs.resize(input_count);
+		for (xrt_input &xinput : xinputs) {
+			xinput.active = true;
+			xinput.name = XRT_INPUT_SIMPLE_SELECT_CLICK;
+		}
+
+		dev.base.update_inputs = test_update_inputs;
+		dev.base.inputs = xinputs.data();
+		dev.base.input_count = xinputs.size();
+		xsysd.xdevs[0] = &dev.base;
+		xsysd.xdev_count = 1;
+	}
+
+	~test_setup()
+	{
+		for (size_t i = 0; i < sess->action_set_attachment_count; i++) {
+			free(sess->act_set_attachments[i].act_attachments);
+		}
+		free(sess->act_set_attachments);
+		free(sess->sync_plan.active_sets);
+		free(sess->sync_plan.inputs);
+
+		u_hashmap_int_destroy(&sess->act_sets_attachments_by_key);
+		time_state_destroy(&inst->timekeeping);
+	}
+
+	/*!
+	 * Adds a action set with @p action_count boolean actions, action k is
+	 * bound to input @p first_input + k on both hands.
+	 */
+	void
+	add_set(uint32_t priority, uint32_t action_count, uint32_t first_input)
+	{
+		auto tas = std::make_unique<test_action_set>();
+		uint32_t key = (uint32_t)sets.size() + 1;
+
+		tas->act_set.act_set_key = key;
+		tas->act_set.data = &tas->ref;
+		tas->ref.act_set_key = key;
+		tas->ref.priority = priority;
+
+		tas->act_refs.resize(action_count);
+		tas->inputs.resize(action_count);
+		for (uint32_t k = 0; k < action_count; k++) {
+			tas->act_refs[k].action_type = XR_ACTION_TYPE_BOOLEAN_INPUT;
+			tas->act_refs[k].subaction_paths.left = true;
+			tas->act_refs[k].subaction_paths.right = true;
+
+			uint32_t index = (first_input + k) % (uint32_t)xinputs.size();
+			tas->inputs[k].xdev = &dev.base;
+			tas->inputs[k].input = &xinputs[index];
+			tas->inputs[k].transforms = &identity;
+			tas->inputs[k].transform_count = 1;
+			tas->inputs[k].bound_path = index + 1;
+		}
+
+		sets.push_back(std::move(tas));
+	}
+
+	//! Does the same as attaching the action sets.
+	void
+	attach()
+	{
+		sess->action_set_attachment_count = sets.size();
+		sess->act_set_attachments = U_TYPED_ARRAY_CALLOC(oxr_action_set_attachment, sets.size());
+
+		for (size_t i = 0; i < sets.size(); i++) {
+			test_action_set &tas = *sets[i];
+			oxr_action_set_attachment &attached = sess->act_set_attachments[i];
+
+			attached.sess = sess.get();
+			attached.act_set_ref = &tas.ref;
+			attached.act_set_key = tas.ref.act_set_key;
+			attached.action_attachment_count = tas.act_refs.size();
+			attached.act_attachments = U_TYPED_ARRAY_CALLOC(oxr_action_attachment, tas.act_refs.size());
+
+			for (size_t k = 0; k < tas.act_refs.size(); k++) {
+				oxr_action_attachment &act_attached = attached.act_attachments[k];
+				act_attached.act_set_attached = &attached;
+				act_attached.act_ref = &tas.act_refs[k];
+				act_attached.sess = sess.get();
+				act_attached.left.inputs = &tas.inputs[k];
+				act_attached.left.input_count = 1;
+				act_attached.right.inputs = &tas.inputs[k];
+				act_attached.right.input_count = 1;
+			}
+
+			u_hashmap_int_insert(sess->act_sets_attachments_by_key, attached.act_set_key, &attached);
+		}
+	}
+
+	std::vector<XrActiveActionSet>
+	active_sets()
+	{
+		std::vector<XrActiveActionSet> active(sets.size());
+		for (size_t i = 0; i < sets.size(); i++) {
+			active[i].actionSet = XRT_CAST_PTR_TO_OXR_HANDLE(XrActionSet, &sets[i]->act_set);
+			active[i].subactionPath = XR_NULL_PATH;
+		}
+		return active;
+	}
+
+	oxr_action_attachment &
+	action(size_t set, size_t k)
+	{
+		return sess->act_set_attachments[set].act_attachments[k];
+	}
+};
+
+
+/*
+ *
+ * Tests.
+ *
+ */
+
+TEST_CASE("action_sync_suppression")
+{
+	test_setup ts(8);
+
+	// Low priority set uses inputs 0-7, high priority only 0-3.
+	ts.add_set(0, 8, 0);
+	ts.add_set(1, 4, 0);
+	ts.attach();
+
+	std::vector<XrActiveActionSet> active = ts.active_sets();
+
+	SECTION("both sets active")
+	{
+		CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), (uint32_t)active.size(), active.data()) ==
+		      XR_SUCCESS);
+
+		// Inputs shared with the high priority set are suppressed.
+		for (size_t k = 0; k < 8; k++) {
+			INFO("action " << k);
+			CHECK(ts.action(0, k).any_state.active == (k >= 4));
+			CHECK(ts.action(0, k).left.plan_input_count == (k >= 4 ? 1 : 0));
+		}
+		for (size_t k = 0; k < 4; k++) {
+			CHECK(ts.action(1, k).any_state.active);
+		}
+
+		// 4 + 4 inputs left on each hand.
+		CHECK(ts.sess->sync_plan.input_count == 16);
+	}
+
+	SECTION("plan follows active sets")
+	{
+		CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), (uint32_t)active.size(), active.data()) ==
+		      XR_SUCCESS);
+		CHECK(!ts.action(0, 0).any_state.active);
+
+		// Only the low priority set, nothing is suppressed.
+		CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), 1, active.data()) == XR_SUCCESS);
+		CHECK(ts.sess->sync_plan.active_set_count == 1);
+		CHECK(ts.action(0, 0).any_state.active);
+		CHECK(!ts.action(1, 0).any_state.active);
+
+		// And back again.
+		CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), (uint32_t)active.size(), active.data()) ==
+		      XR_SUCCESS);
+		CHECK(!ts.action(0, 0).any_state.active);
+		CHECK(ts.action(1, 0).any_state.active);
+	}
+
+	SECTION("input changes are seen with a cached plan")
+	{
+		CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), (uint32_t)active.size(), active.data()) ==
+		      XR_SUCCESS);
+		CHECK(ts.action(0, 5).any_state.value.boolean == false);
+
+		ts.xinputs[5].value.boolean = true;
+		ts.xinputs[5].timestamp = 100;
+
+		CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), (uint32_t)active.size(), active.data()) ==
+		      XR_SUCCESS);
+		CHECK(ts.action(0, 5).any_state.value.boolean == true);
+		CHECK(ts.action(0, 5).any_state.changed);
+	}
+}
+
+TEST_CASE("action_sync_input_generation")
+{
+	test_setup ts(8);
+	ts.add_set(0, 8, 0);
+	ts.attach();
+
+	std::vector<XrActiveActionSet> active = ts.active_sets();
+	uint32_t count = (uint32_t)active.size();
+
+	SECTION("no generation, always updated")
+	{
+		for (int i = 0; i < 3; i++) {
+			CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), count, active.data()) == XR_SUCCESS);
+		}
+		CHECK(ts.dev.update_count == 3);
+	}
+
+	SECTION("generation skips idle device")
+	{
+		ts.dev.base.input_generation = 1;
+
+		for (int i = 0; i < 3; i++) {
+			CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), count, active.data()) == XR_SUCCESS);
+		}
+		CHECK(ts.dev.update_count == 1);
+		CHECK(ts.action(0, 2).any_state.active);
+		CHECK(!ts.action(0, 2).any_state.changed);
+
+		// Driver publishes a change.
+		ts.xinputs[2].value.boolean = true;
+		ts.xinputs[2].timestamp = 100;
+		ts.dev.base.input_generation++;
+
+		CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), count, active.data()) == XR_SUCCESS);
+		CHECK(ts.dev.update_count == 2);
+		CHECK(ts.action(0, 2).any_state.value.boolean);
+		CHECK(ts.action(0, 2).any_state.changed);
+
+		// Nothing new, value is kept but no longer changed.
+		CHECK(oxr_action_sync_data(&ts.log, ts.sess.get(), count, active.data()) == XR_SUCCESS);
+		CHECK(ts.dev.update_count == 2);
+		CHECK(ts.action(0, 2).any_state.value.boolean);
+		CHECK(!ts.action(0, 2).any_state.changed);
+		CHECK(ts.action(0, 2).any_state.timestamp == 100);
+	}
+}
+
+TEST_CASE("action_sync_throughput", "[.][benchmark]")
+{
+	// Synthetic 200 action profile, split over four overlapping sets.
+	test_setup ts(64);
+	ts.add_set(0, 50, 0);
+	ts.add_set(1, 50, 16);
+	ts.add_set(2, 50, 32);
+	ts.add_set(3, 50, 48);
+	ts.attach();
+
+	std::vector<XrActiveActionSet> active = ts.active_sets();
+	uint32_t count = (uint32_t)active.size();
+
+	BENCHMARK("recompile every sync")
+	{
+		ts.sess->sync_plan.valid = false;
+		return oxr_action_sync_data(&ts.log, ts.sess.get(), count, active.data());
+	};
+
+	BENCHMARK("cached plan")
+	{
+		return oxr_action_sync_data(&ts.log, ts.sess.get(), count, active.data());
+	};
+
+	// Idle controllers, the device publishes a generation that never changes.
+	ts.dev.base.input_generation = 1;
+
+	BENCHMARK("cached plan, idle device")
+	{
+		return oxr_action_sync_data(&ts.log, ts.sess.get(), count, active.data());
+	};
+}
@@ -0,0 +1,200 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Interaction profile binding tests, using the generated templates.
+ */
+
+#include "bindings/b_generated_bindings.h"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <oxr/oxr_input_transform.h>
+#include <oxr/oxr_logger.h>
+#include <oxr/oxr_objects.h>
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+
+/*
+ *
+ * Test setup.
+ *
+ * A instance with only paths set up, and one action for every path of every
+ * binding in every profile template, like a app suggesting everything it can.
+ *
+ */
+
+struct test_setup
+{
+	oxr_logger log = {};
+	std::unique_ptr<oxr_instance> inst = std::make_unique<oxr_instance>();
+	std::vector<std::unique_ptr<oxr_action>> actions;
+
+	test_setup()
+	{
+		oxr_log_init(&log, "test");
+
+		*inst = {};
+		REQUIRE(oxr_path_init(&log, inst.get()) == XR_SUCCESS);
+
+#define CACHE_SUBACTION_PATHS(NAME, NAME_CAPS, PATH)                                                                   \
+	oxr_path_get_or_create(&log, inst.get(), PATH, strlen(PATH), &inst->path_cache.NAME);
+		OXR_FOR_EACH_SUBACTION_PATH_DETAILED(CACHE_SUBACTION_PATHS)
+#undef CACHE_SUBACTION_PATHS
+	}
+
+	~test_setup()
+	{
+		oxr_binding_destroy_all(&log, inst.get());
+		oxr_path_destroy(&log, inst.get());
+	}
+
+	XrPath
+	path(const char *str)
+	{
+		XrPath ret = XR_NULL_PATH;
+		oxr_path_get_or_create(&log, inst.get(), str, strlen(str), &ret);
+		return ret;
+	}
+
+	//! Suggest a new action for each path in each binding of @p templ.
+	void
+	suggest(const profile_template &templ, std::vector<XrActionSuggestedBinding> &suggested)
+	{
+		suggested.clear();
+		for (size_t x = 0; x < templ.binding_count; x++) {
+			const binding_template &bt = templ.bindings[x];
+			for (size_t y = 0; bt.paths[y] != NULL; y++) {
+				auto act = std::make_unique<oxr_action>();
+				act->act_key = (uint32_t)actions.size() + 1;
+
+				XrActionSuggestedBinding s = {};
+				s.action = XRT_CAST_PTR_TO_OXR_HANDLE(XrAction, act.get());
+				s.binding = path(bt.paths[y]);
+				suggested.push_back(s);
+
+				actions.push_back(std::move(act));
+			}
+		}
+
+		XrInteractionProfileSuggestedBinding suggestion = {};
+		suggestion.type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING;
+		suggestion.interactionProfile = path(templ.path);
+		suggestion.countSuggestedBindings = (uint32_t)suggested.size();
+		suggestion.suggestedBindings = suggested.data();
+
+		oxr_dpad_state dpad_state = {};
+		REQUIRE(oxr_dpad_state_init(&dpad_state));
+		REQUIRE(oxr_action_suggest_interaction_profile_bindings(&log, inst.get(), &suggestion, &dpad_state) ==
+		        XR_SUCCESS);
+	}
+};
+
+
+/*
+ *
+ * Tests.
+ *
+ */
+
+TEST_CASE("binding_template_paths")
+{
+	// The path table is sorted and every index used is in range.
+	for (size_t x = 1; x < NUM_BINDING_PATHS; x++) {
+		CHECK(strcmp(binding_paths[x - 1].str, binding_paths[x].str) < 0);
+		CHECK(strlen(binding_paths[x].str) == binding_paths[x].length);
+	}
+
+	for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
+		const profile_template &templ = profile_templates[x];
+		CHECK(strcmp(binding_paths[templ.path_index].str, templ.path) == 0);
+
+		for (size_t y = 0; y < templ.binding_count; y++) {
+			const binding_template &bt = templ.bindings[y];
+			CHECK(strcmp(binding_paths[bt.subaction_path_index].str, bt.subaction_path) == 0);
+
+			uint32_t count = 0;
+			while (bt.paths[count] != NULL) {
+				CHECK(strcmp(binding_paths[bt.path_indices[count]].str, bt.paths[count]) == 0);
+				count++;
+			}
+			CHECK(count == bt.path_count);
+		}
+	}
+}
+
+TEST_CASE("binding_suggest")
+{
+	test_setup ts;
+	std::vector<XrActionSuggestedBinding> suggested;
+
+	for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
+		const profile_template &templ = profile_templates[x];
+		CAPTURE(templ.path);
+
+		ts.suggest(templ, suggested);
+
+		REQUIRE(ts.inst->profile_count == x + 1);
+		oxr_interaction_profile *p = ts.inst->profiles[x];
+		CHECK(p->path == ts.path(templ.path));
+		REQUIRE(p->binding_count == templ.binding_count);
+
+		// Each binding gets the key of every suggestion matching one of its paths, in order.
+		for (size_t y = 0; y < p->binding_count; y++) {
+			oxr_binding *b = &p->bindings[y];
+			CHECK(b->path_count == templ.bindings[y].path_count);
+
+			std::vector<uint32_t> expected_keys;
+			std::vector<uint32_t> expected_index;
+			for (const XrActionSuggestedBinding &s : suggested) {
+				for (uint32_t z = 0; z < b->path_count; z++) {
+					if (b->paths[z] == s.binding) {
+						expected_keys.push_back(XRT_CAST_OXR_HANDLE_TO_PTR(oxr_action *, s.action)->act_key);
+						expected_index.push_back(z);
+						break;
+					}
+				}
+			}
+
+			REQUIRE(b->key_count == expected_keys.size());
+			for (uint32_t k = 0; k < b->key_count; k++) {
+				CHECK(b->keys[k] == expected_keys[k]);
+				CHECK(b->preferred_binding_path_index[k] == expected_index[k]);
+			}
+		}
+	}
+}
+
+TEST_CASE("binding_suggest_all_profiles", "[.][benchmark]")
+{
+	// Paths created up front, only binding setup is measured.
+	test_setup ts;
+	std::vector<std::vector<XrActionSuggestedBinding>> suggested(NUM_PROFILE_TEMPLATES);
+	for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
+		ts.suggest(profile_templates[x], suggested[x]);
+	}
+
+	BENCHMARK("suggest all profiles")
+	{
+		oxr_binding_destroy_all(&ts.log, ts.inst.get());
+
+		for (size_t x = 0; x < NUM_PROFILE_TEMPLATES; x++) {
+			XrInteractionProfileSuggestedBinding suggestion = {};
+			suggestion.type = XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING;
+			suggestion.interactionProfile = ts.path(profile_templates[x].path);
+			suggestion.countSuggestedBindings = (uint32_t)suggested[x].size();
+			suggestion.suggestedBindings = suggested[x].data();
+
+			oxr_dpad_state dpad_state = {};
+			oxr_dpad_state_init(&dpad_state);
+			oxr_action_suggest_interaction_profile_bindings(&ts.log, ts.inst.get(), &suggestion,
+			                                                &dpad_state);
+		}
+
+		return ts.inst->profile_count;
+	};
+}
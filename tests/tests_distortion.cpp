@@ -0,0 +1,314 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Test batched distortion functions against the scalar ones.
+ */
+
+#include "xrt/xrt_device.h"
+
+#include "util/u_worker.h"
+#include "util/u_distortion_mesh.h"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <atomic>
+#include <vector>
+
+
+/*
+ *
+ * Constants and helpers.
+ *
+ */
+
+constexpr uint32_t kGridSize = 17;
+constexpr uint32_t kParallelGridSize = 64; // Enough points for several worker tasks
+constexpr float kTolerance = 0.00001f;
+
+static void
+make_grid(std::vector<float> &u, std::vector<float> &v, uint32_t size = kGridSize)
+{
+	u.clear();
+	v.clear();
+
+	for (uint32_t r = 0; r < size; r++) {
+		for (uint32_t c = 0; c < size; c++) {
+			u.push_back((float)c / (float)(size - 1));
+			v.push_back((float)r / (float)(size - 1));
+		}
+	}
+}
+
+static void
+check_triplets(const xrt_uv_triplet &a, const xrt_uv_triplet &b)
+{
+	CHECK(a.r.x == Approx(b.r.x).margin(kTolerance));
+	CHECK(a.r.y == Approx(b.r.y).margin(kTolerance));
+	CHECK(a.g.x == Approx(b.g.x).margin(kTolerance));
+	CHECK(a.g.y == Approx(b.g.y).margin(kTolerance));
+	CHECK(a.b.x == Approx(b.b.x).margin(kTolerance));
+	CHECK(a.b.y == Approx(b.b.y).margin(kTolerance));
+}
+
+static u_vive_values
+make_vive_values()
+{
+	u_vive_values values = {};
+	values.aspect_x_over_y = 0.9f;
+	values.grow_for_undistort = 0.6f;
+	values.undistort_r2_cutoff = 1.1f;
+	values.center[0] = {0.01f, -0.02f};
+	values.center[1] = {0.015f, -0.021f};
+	values.center[2] = {0.02f, -0.022f};
+
+	float coefficients[3][4] = {
+	    {-0.18f, 0.05f, -0.01f, 0.0f},
+	    {-0.2f, 0.06f, -0.02f, 0.01f},
+	    {-0.22f, 0.07f, -0.03f, 0.02f},
+	};
+	for (int i = 0; i < 3; i++) {
+		for (int k = 0; k < 4; k++) {
+			values.coefficients[i][k] = coefficients[i][k];
+		}
+	}
+
+	return values;
+}
+
+struct test_device
+{
+	xrt_device base;
+	u_vive_values values;
+	std::atomic<int> batch_calls;
+};
+
+static bool
+test_compute_distortion(xrt_device *xdev, uint32_t view, float u, float v, xrt_uv_triplet *result)
+{
+	test_device *td = (test_device *)xdev;
+	return u_compute_distortion_vive(&td->values, u, v, result);
+}
+
+static bool
+test_compute_distortion_batch(
+    xrt_device *xdev, uint32_t view, uint32_t count, const float *u, const float *v, xrt_uv_triplet *results)
+{
+	test_device *td = (test_device *)xdev;
+	td->batch_calls++;
+	return u_compute_distortion_vive_batch(&td->values, count, u, v, results);
+}
+
+
+/*
+ *
+ * Tests.
+ *
+ */
+
+TEST_CASE("distortion_batch_vive")
+{
+	u_vive_values values = make_vive_values();
+
+	std::vector<float> u, v;
+	make_grid(u, v);
+	std::vector<xrt_uv_triplet> batch(u.size());
+
+	CHECK(u_compute_distortion_vive_batch(&values, (uint32_t)u.size(), u.data(), v.data(), batch.data()));
+
+	for (size_t i = 0; i < u.size(); i++) {
+		xrt_uv_triplet scalar = {};
+		u_compute_distortion_vive(&values, u[i], v[i], &scalar);
+		check_triplets(batch[i], scalar);
+	}
+}
+
+TEST_CASE("distortion_batch_panotools")
+{
+	u_panotools_values values = {};
+	values.distortion_k[0] = 1.0f;
+	values.distortion_k[1] = 0.22f;
+	values.distortion_k[2] = 0.24f;
+	values.distortion_k[3] = 0.02f;
+	values.distortion_k[4] = 0.01f;
+	values.aberration_k[0] = 0.996f;
+	values.aberration_k[1] = 1.0f;
+	values.aberration_k[2] = 1.014f;
+	values.scale = 0.05f;
+	values.lens_center = {0.06f, 0.035f};
+	values.viewport_size = {0.126f, 0.071f};
+
+	std::vector<float> u, v;
+	make_grid(u, v);
+	std::vector<xrt_uv_triplet> batch(u.size());
+
+	CHECK(u_compute_distortion_panotools_batch(&values, (uint32_t)u.size(), u.data(), v.data(), batch.data()));
+
+	for (size_t i = 0; i < u.size(); i++) {
+		xrt_uv_triplet scalar = {};
+		u_compute_distortion_panotools(&values, u[i], v[i], &scalar);
+		check_triplets(batch[i], scalar);
+	}
+}
+
+TEST_CASE("distortion_batch_cardboard")
+{
+	u_cardboard_distortion_values values = {};
+	values.distortion_k[0] = 0.441f;
+	values.distortion_k[1] = 0.156f;
+	values.screen.size = {1.2f, 1.4f};
+	values.screen.offset = {0.6f, 0.7f};
+	values.texture.size = {1.6f, 1.8f};
+	values.texture.offset = {0.8f, 0.9f};
+
+	std::vector<float> u, v;
+	make_grid(u, v);
+	std::vector<xrt_uv_triplet> batch(u.size());
+
+	CHECK(u_compute_distortion_cardboard_batch(&values, (uint32_t)u.size(), u.data(), v.data(), batch.data()));
+
+	for (size_t i = 0; i < u.size(); i++) {
+		xrt_uv_triplet scalar = {};
+		u_compute_distortion_cardboard(&values, u[i], v[i], &scalar);
+		check_triplets(batch[i], scalar);
+	}
+}
+
+TEST_CASE("distortion_batch_ns_p2d")
+{
+	u_ns_p2d_values values = {};
+	for (int i = 0; i < 16; i++) {
+		values.x_coefficients_left[i] = 0.01f * (float)(i + 1);
+		values.x_coefficients_right[i] = -0.01f * (float)(i + 1);
+		values.y_coefficients_left[i] = 0.02f * (float)(16 - i);
+		values.y_coefficients_right[i] = -0.02f * (float)(16 - i);
+	}
+	for (int view = 0; view < 2; view++) {
+		values.fov[view] = {-0.9f, 0.8f, 0.85f, -0.95f};
+	}
+
+	std::vector<float> u, v;
+	make_grid(u, v);
+	std::vector<xrt_uv_triplet> batch(u.size());
+
+	for (int view = 0; view < 2; view++) {
+		CHECK(u_compute_distortion_ns_p2d_batch(&values, view, (uint32_t)u.size(), u.data(), v.data(),
+		                                        batch.data()));
+
+		for (size_t i = 0; i < u.size(); i++) {
+			xrt_uv_triplet scalar = {};
+			u_compute_distortion_ns_p2d(&values, view, u[i], v[i], &scalar);
+			check_triplets(batch[i], scalar);
+		}
+	}
+}
+
+TEST_CASE("distortion_batch_ns_meshgrid")
+{
+	constexpr int kPoints = 9;
+	std::vector<xrt_vec2> grid(kPoints * kPoints);
+	for (int r = 0; r < kPoints; r++) {
+		for (int c = 0; c < kPoints; c++) {
+			float x = (float)c / (kPoints - 1) * 2.0f - 1.0f;
+			float y = (float)r / (kPoints - 1) * 2.0f - 1.0f;
+			grid[r * kPoints + c] = {x * (1.0f + 0.1f * y * y), y * (1.0f + 0.1f * x * x)};
+		}
+	}
+
+	u_ns_meshgrid_values values = {};
+	values.num_grid_points_u = kPoints;
+	values.num_grid_points_v = kPoints;
+	values.grid[0] = grid.data();
+	values.grid[1] = grid.data();
+	values.fov[0] = {-0.9f, 0.8f, 0.85f, -0.95f};
+	values.fov[1] = {-0.8f, 0.9f, 0.85f, -0.95f};
+
+	std::vector<float> u, v;
+	make_grid(u, v);
+	std::vector<xrt_uv_triplet> batch(u.size());
+
+	for (int view = 0; view < 2; view++) {
+		CHECK(u_compute_distortion_ns_meshgrid_batch(&values, view, (uint32_t)u.size(), u.data(), v.data(),
+		                                             batch.data()));
+
+		for (size_t i = 0; i < u.size(); i++) {
+			xrt_uv_triplet scalar = {};
+			u_compute_distortion_ns_meshgrid(&values, view, u[i], v[i], &scalar);
+			check_triplets(batch[i], scalar);
+		}
+	}
+}
+
+TEST_CASE("distortion_batch_parallel")
+{
+	test_device td = {};
+	td.base.compute_distortion = test_compute_distortion;
+	td.values = make_vive_values();
+
+	std::vector<float> u, v;
+	make_grid(u, v, kParallelGridSize);
+	std::vector<xrt_uv_triplet> scalar(u.size());
+	std::vector<xrt_uv_triplet> parallel(u.size());
+	uint32_t count = (uint32_t)u.size();
+
+	u_worker_thread_pool *pool = u_distortion_mesh_create_worker_pool();
+	REQUIRE(pool != nullptr);
+
+	// No batch function, evaluated one by one.
+	CHECK(u_distortion_mesh_compute_batch(pool, &td.base, 0, count, u.data(), v.data(), scalar.data()));
+
+	// Batch function, split over the worker threads.
+	td.base.compute_distortion_batch = test_compute_distortion_batch;
+	CHECK(u_distortion_mesh_compute_batch(pool, &td.base, 0, count, u.data(), v.data(), parallel.data()));
+	CHECK(td.batch_calls > 1);
+
+	for (size_t i = 0; i < u.size(); i++) {
+		check_triplets(parallel[i], scalar[i]);
+	}
+
+	u_worker_thread_pool_reference(&pool, NULL);
+}
+
+TEST_CASE("distortion_batch_throughput", "[.][benchmark]")
+{
+	test_device td = {};
+	td.base.compute_distortion = test_compute_distortion;
+	td.values = make_vive_values();
+
+	// Same size as the compute distortion images.
+	std::vector<float> u, v;
+	for (uint32_t r = 0; r < 128; r++) {
+		for (uint32_t c = 0; c < 128; c++) {
+			u.push_back((float)c / 127.0f);
+			v.push_back((float)r / 127.0f);
+		}
+	}
+	std::vector<xrt_uv_triplet> results(u.size());
+	uint32_t count = (uint32_t)u.size();
+
+	BENCHMARK("scalar")
+	{
+		for (uint32_t i = 0; i < count; i++) {
+			xrt_device_compute_distortion(&td.base, 0, u[i], v[i], &results[i]);
+		}
+		return results[0].r.x;
+	};
+
+	BENCHMARK("batch")
+	{
+		u_compute_distortion_vive_batch(&td.values, count, u.data(), v.data(), results.data());
+		return results[0].r.x;
+	};
+
+	td.base.compute_distortion_batch = test_compute_distortion_batch;
+	u_worker_thread_pool *pool = u_distortion_mesh_create_worker_pool();
+
+	BENCHMARK("batch_parallel")
+	{
+		u_distortion_mesh_compute_batch(pool, &td.base, 0, count, u.data(), v.data(), results.data());
+		return results[0].r.x;
+	};
+
+	u_worker_thread_pool_reference(&pool, NULL);
+}
@@ -0,0 +1,73 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief EuRoC recorder tests.
+ */
+
+#include "os/os_time.h"
+#include "util/u_time.h"
+#include "util/u_frame.h"
+#include "tracking/t_euroc_recorder.h"
+
+#include "catch/catch.hpp"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+
+TEST_CASE("euroc_recorder_color_round_trip")
+{
+	namespace fs = std::filesystem;
+
+	fs::path path = fs::temp_directory_path() / "monado_tests_euroc_recorder";
+	fs::remove_all(path);
+
+	xrt_frame_context xfctx = {};
+	xrt_slam_sinks *sinks = euroc_recorder_create(&xfctx, path.string().c_str(), 1, true);
+	REQUIRE(sinks != nullptr);
+
+	// Every pixel has different red, green and blue values.
+	constexpr uint32_t kWidth = 16;
+	constexpr uint32_t kHeight = 8;
+	xrt_frame *xf = nullptr;
+	u_frame_create_one_off(XRT_FORMAT_R8G8B8, kWidth, kHeight, &xf);
+	xf->timestamp = 1000;
+	for (uint32_t y = 0; y < kHeight; y++) {
+		uint8_t *row = xf->data + y * xf->stride;
+		for (uint32_t x = 0; x < kWidth; x++) {
+			row[x * 3 + 0] = (uint8_t)(200 + x);
+			row[x * 3 + 1] = (uint8_t)(100 + y);
+			row[x * 3 + 2] = (uint8_t)(x * 8 + y);
+		}
+	}
+
+	xrt_sink_push_frame(sinks->cams[0], xf);
+
+	// The image is written asynchronously, once it exists destroying the nodes waits for the writers.
+	fs::path img_path = path / "mav0" / "cam0" / "data" / "1000.png";
+	for (int i = 0; i < 500 && !fs::exists(img_path); i++) {
+		os_nanosleep(U_TIME_1MS_IN_NS * 10);
+	}
+	xrt_frame_context_destroy_nodes(&xfctx);
+	REQUIRE(fs::exists(img_path));
+
+	// Read the image back the same way the EuRoC player does.
+	cv::Mat img = cv::imread(img_path.string(), cv::IMREAD_ANYCOLOR);
+	REQUIRE(img.channels() == 3);
+	cv::cvtColor(img, img, cv::COLOR_BGR2RGB);
+
+	REQUIRE(img.cols == (int)kWidth);
+	REQUIRE(img.rows == (int)kHeight);
+	for (uint32_t y = 0; y < kHeight; y++) {
+		const uint8_t *row = xf->data + y * xf->stride;
+		CHECK(memcmp(img.ptr(y), row, kWidth * 3) == 0);
+	}
+
+	xrt_frame_reference(&xf, NULL);
+	fs::remove_all(path);
+}
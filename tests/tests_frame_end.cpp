@@ -0,0 +1,296 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief xrEndFrame layer validation and submission tests.
+ */
+
+#include "xrt/xrt_compositor.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_system.h"
+
+#include "util/u_space_overseer.h"
+#include "util/u_time.h"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <oxr/oxr_input_transform.h>
+#include <oxr/oxr_logger.h>
+#include <oxr/oxr_objects.h>
+
+#include <memory>
+#include <vector>
+
+
+/*
+ *
+ * Test setup.
+ *
+ * A session with a fake compositor and head device, swapchains that are always
+ * released and layers in the local space, the parts of the instance and system
+ * that xrEndFrame touches are filled in by hand.
+ *
+ */
+
+struct test_compositor
+{
+	xrt_compositor base;
+	uint32_t layer_count;
+	uint32_t commit_count;
+};
+
+static xrt_result_t
+test_layer_begin(xrt_compositor *xc, const xrt_layer_frame_data *data)
+{
+	((test_compositor *)xc)->layer_count = 0;
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+test_layer_stereo_projection(
+    xrt_compositor *xc, xrt_device *xdev, xrt_swapchain *l_xsc, xrt_swapchain *r_xsc, const xrt_layer_data *data)
+{
+	((test_compositor *)xc)->layer_count++;
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+test_layer_quad(xrt_compositor *xc, xrt_device *xdev, xrt_swapchain *xsc, const xrt_layer_data *data)
+{
+	((test_compositor *)xc)->layer_count++;
+	return XRT_SUCCESS;
+}
+
+static xrt_result_t
+test_layer_commit(xrt_compositor *xc, xrt_graphics_sync_handle_t sync_handle)
+{
+	((test_compositor *)xc)->commit_count++;
+	return XRT_SUCCESS;
+}
+
+static void
+test_get_tracked_pose(xrt_device *xdev, xrt_input_name name, uint64_t at_timestamp_ns, xrt_space_relation *out_relation)
+{
+	xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+	rel.pose = XRT_POSE_IDENTITY;
+	rel.pose.position.y = 1.6f;
+	rel.relation_flags = (xrt_space_relation_flags)( //
+	    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT |   //
+	    XRT_SPACE_RELATION_POSITION_VALID_BIT);
+	*out_relation = rel;
+}
+
+struct test_setup
+{
+	oxr_logger log = {};
+	std::unique_ptr<oxr_instance> inst = std::make_unique<oxr_instance>();
+	xrt_system_devices xsysd = {};
+	oxr_system sys = {};
+	std::unique_ptr<oxr_session> sess = std::make_unique<oxr_session>();
+
+	u_space_overseer *uso = nullptr;
+	xrt_hmd_parts hmd = {};
+	xrt_tracking_origin origin = {};
+	xrt_device head = {};
+	test_compositor xc = {};
+
+	xrt_swapchain xsc = {};
+	oxr_swapchain sc = {};
+	oxr_space local = {};
+
+	std::vector<XrCompositionLayerQuad> quads;
+	XrCompositionLayerProjectionView views[2] = {};
+	XrCompositionLayerProjection proj = {};
+	std::vector<const XrCompositionLayerBaseHeader *> layers;
+
+	test_setup()
+	{
+		oxr_log_init(&log, "test");
+
+		*inst = {};
+		inst->timekeeping = time_state_create(0);
+
+		hmd.blend_modes[0] = XRT_BLEND_MODE_OPAQUE;
+		hmd.blend_mode_count = 1;
+		origin.offset = XRT_POSE_IDENTITY;
+		head.hmd = &hmd;
+		head.tracking_origin = &origin;
+		head.get_tracked_pose = test_get_tracked_pose;
+		xsysd.xdevs[0] = &head;
+		xsysd.xdev_count = 1;
+		xsysd.roles.head = &head;
+
+		uso = u_space_overseer_create();
+		xrt_space_overseer *xso = (xrt_space_overseer *)uso;
+		xrt_pose local_offset = XRT_POSE_IDENTITY;
+		u_space_overseer_legacy_setup(uso, xsysd.xdevs, xsysd.xdev_count, &head, &local_offset);
+
+		sys.inst = inst.get();
+		sys.xsysd = &xsysd;
+		sys.xso = xso;
+
+		xc.base.layer_begin = test_layer_begin;
+		xc.base.layer_stereo_projection = test_layer_stereo_projection;
+		xc.base.layer_quad = test_layer_quad;
+		xc.base.layer_commit = test_layer_commit;
+
+		*sess = {};
+		sess->sys = &sys;
+		sess->compositor = &xc.base;
+		sess->state = XR_SESSION_STATE_FOCUSED;
+		sess->has_ended_once = true;
+		os_mutex_init(&sess->active_wait_frames_lock);
+
+		xsc.image_count = 3;
+		sc.sess = sess.get();
+		sc.swapchain = &xsc;
+		sc.width = 1024;
+		sc.height = 1024;
+		sc.array_layer_count = 1;
+		sc.face_count = 1;
+		sc.released.yes = true;
+		sc.released.index = 0;
+
+		local.sess = sess.get();
+		local.pose = XRT_POSE_IDENTITY;
+		local.space_type = OXR_SPACE_TYPE_REFERENCE_LOCAL;
+	}
+
+	~test_setup()
+	{
+		os_mutex_destroy(&sess->active_wait_frames_lock);
+		xrt_space_overseer *xso = (xrt_space_overseer *)uso;
+		xrt_space_overseer_destroy(&xso);
+		time_state_destroy(&inst->timekeeping);
+	}
+
+	XrSwapchainSubImage
+	sub_image()
+	{
+		XrSwapchainSubImage sub = {};
+		sub.swapchain = XRT_CAST_PTR_TO_OXR_HANDLE(XrSwapchain, &sc);
+		sub.imageRect.extent = {512, 512};
+		return sub;
+	}
+
+	//! One projection layer and @p quad_count quad layers.
+	void
+	add_layers(uint32_t quad_count)
+	{
+		for (XrCompositionLayerProjectionView &view : views) {
+			view.type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW;
+			view.pose.orientation.w = 1.0f;
+			view.fov = {-0.8f, 0.8f, 0.8f, -0.8f};
+			view.subImage = sub_image();
+		}
+
+		proj.type = XR_TYPE_COMPOSITION_LAYER_PROJECTION;
+		proj.space = XRT_CAST_PTR_TO_OXR_HANDLE(XrSpace, &local);
+		proj.viewCount = 2;
+		proj.views = views;
+		layers.push_back((const XrCompositionLayerBaseHeader *)&proj);
+
+		quads.resize(quad_count);
+		for (uint32_t i = 0; i < quad_count; i++) {
+			XrCompositionLayerQuad &quad = quads[i];
+			quad.type = XR_TYPE_COMPOSITION_LAYER_QUAD;
+			quad.space = XRT_CAST_PTR_TO_OXR_HANDLE(XrSpace, &local);
+			quad.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+			quad.subImage = sub_image();
+			quad.pose.orientation.w = 1.0f;
+			quad.pose.position = {0.1f * (float)i, 1.0f, -1.0f};
+			quad.size = {0.5f, 0.5f};
+		}
+		for (XrCompositionLayerQuad &quad : quads) {
+			layers.push_back((const XrCompositionLayerBaseHeader *)&quad);
+		}
+	}
+
+	XrResult
+	end_frame()
+	{
+		sess->frame_started = true;
+		sess->frame_id.begun = 1;
+		sess->active_wait_frames = 1;
+
+		XrFrameEndInfo info = {};
+		info.type = XR_TYPE_FRAME_END_INFO;
+		info.displayTime = 1000000;
+		info.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+		info.layerCount = (uint32_t)layers.size();
+		info.layers = layers.data();
+
+		return oxr_session_frame_end(&log, sess.get(), &info);
+	}
+};
+
+
+/*
+ *
+ * Tests.
+ *
+ */
+
+TEST_CASE("frame_end_layer_cache")
+{
+	test_setup ts;
+	ts.add_layers(4);
+
+	REQUIRE(ts.end_frame() == XR_SUCCESS);
+	CHECK(ts.xc.layer_count == 5);
+	CHECK(ts.xc.commit_count == 1);
+	for (uint32_t i = 0; i < 5; i++) {
+		CHECK(ts.sess->layer_cache.layers[i].valid);
+	}
+
+	// All layers are in the same space, so it is located once.
+	CHECK(ts.sess->layer_cache.space_count == 1);
+
+	SECTION("unchanged layers")
+	{
+		REQUIRE(ts.end_frame() == XR_SUCCESS);
+		CHECK(ts.xc.layer_count == 5);
+		CHECK(ts.xc.commit_count == 2);
+	}
+
+	SECTION("cached layers still check the swapchain state")
+	{
+		ts.sc.released.yes = false;
+		CHECK(ts.end_frame() == XR_ERROR_LAYER_INVALID);
+	}
+
+	SECTION("changed layers are validated again")
+	{
+		ts.quads[2].subImage.imageRect.extent.width = 2048;
+		CHECK(ts.end_frame() == XR_ERROR_SWAPCHAIN_RECT_INVALID);
+
+		ts.quads[2].subImage.imageRect.extent.width = 512;
+		ts.views[1].subImage.imageArrayIndex = 1;
+		CHECK(ts.end_frame() == XR_ERROR_VALIDATION_FAILURE);
+	}
+
+	SECTION("chained layers are not cached")
+	{
+		XrCompositionLayerDepthInfoKHR depth = {};
+		depth.type = XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR;
+		ts.quads[0].next = &depth;
+
+		ts.sess->layer_cache.layers[1].valid = false;
+		ts.end_frame();
+		CHECK_FALSE(ts.sess->layer_cache.layers[1].valid);
+	}
+}
+
+TEST_CASE("frame_end_layer_count", "[.][benchmark]")
+{
+	for (uint32_t quad_count : {0, 3, 15}) {
+		test_setup ts;
+		ts.add_layers(quad_count);
+
+		BENCHMARK("xrEndFrame " + std::to_string(quad_count + 1) + " layers")
+		{
+			return ts.end_frame();
+		};
+	}
+}
@@ -0,0 +1,247 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Test the cached crop maps and fused crop normalization of Mercury hand tracking.
+ */
+
+#include "xrt/xrt_defines.h"
+#include "tracking/t_camera_models.h"
+
+#include "hg_image_distorter.hpp"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <opencv2/core.hpp>
+
+#include <random>
+#include <vector>
+
+
+using namespace xrt::tracking::hand::mercury;
+
+
+/*
+ *
+ * Constants and helpers.
+ *
+ */
+
+constexpr int kWidth = 640;
+constexpr int kHeight = 480;
+constexpr float kTolerance = 0.0001f;
+
+static t_camera_model_params
+make_camera()
+{
+	t_camera_model_params dist = {};
+	dist.fx = 280.0f;
+	dist.fy = 280.0f;
+	dist.cx = kWidth / 2.0f;
+	dist.cy = kHeight / 2.0f;
+	dist.model = T_DISTORTION_FISHEYE_KB4;
+	dist.fisheye.k1 = 0.01f;
+	dist.fisheye.k2 = -0.005f;
+	dist.fisheye.k3 = 0.001f;
+	dist.fisheye.k4 = 0.0f;
+	return dist;
+}
+
+static cv::Mat
+make_image()
+{
+	cv::Mat img(kHeight, kWidth, CV_8U);
+
+	std::mt19937 rng(42);
+	std::uniform_int_distribution<int> noise(0, 255);
+
+	for (int y = 0; y < kHeight; y++) {
+		for (int x = 0; x < kWidth; x++) {
+			img.at<uint8_t>(y, x) = (uint8_t)noise(rng);
+		}
+	}
+	return img;
+}
+
+static void
+aim(projection_instructions &instr, xrt_vec3 direction, float angular_radius)
+{
+	make_projection_instructions_angular(direction, false, angular_radius, 1.0f, 0.0f, instr);
+}
+
+// What the keypoint model input used to be made with.
+static void
+reference_normalize(const cv::Mat &in, cv::Mat &out)
+{
+	in.convertTo(out, CV_32FC1, 1 / 255.0);
+
+	cv::Mat mean;
+	cv::Mat stddev;
+	cv::meanStdDev(out, mean, stddev);
+
+	out *= 0.25 / stddev.at<double>(0, 0);
+
+	cv::meanStdDev(out, mean, stddev);
+	out += (0.5 - mean.at<double>(0, 0));
+}
+
+static void
+check_normalized(const cv::Mat &in, const float *out)
+{
+	cv::Mat expected;
+	reference_normalize(in, expected);
+
+	for (int y = 0; y < in.rows; y++) {
+		for (int x = 0; x < in.cols; x++) {
+			CHECK(out[y * in.cols + x] == Approx(expected.at<float>(y, x)).margin(kTolerance));
+		}
+	}
+}
+
+
+/*
+ *
+ * Tests.
+ *
+ */
+
+TEST_CASE("hand_crop_sample_and_normalize")
+{
+	t_camera_model_params dist = make_camera();
+	cv::Mat img = make_image();
+
+	// Partly outside of the image, so both kinds of pixels are sampled.
+	projection_instructions instr(dist);
+	aim(instr, {0.9f, 0.0f, -1.0f}, 0.4f);
+
+	crop_map map = {};
+	CHECK_FALSE(stereographic_crop_map(dist, instr, img, 0.0f, map));
+	REQUIRE(map.valid);
+	REQUIRE(map.offsets.size() == 128 * 128);
+
+	cv::Mat crop;
+	std::vector<float> tensor(128 * 128);
+	REQUIRE(sample_crop_and_normalize(map, img, crop, tensor.data()));
+
+	int outside = 0;
+	for (int i = 0; i < 128 * 128; i++) {
+		int32_t o = map.offsets[i];
+		if (o < 0) {
+			outside++;
+			CHECK(crop.data[i] == 0);
+		} else {
+			CHECK(crop.data[i] == img.data[o]);
+		}
+	}
+	CHECK(outside > 0);
+	CHECK(outside < 128 * 128);
+
+	check_normalized(crop, tensor.data());
+}
+
+TEST_CASE("hand_crop_normalize_image")
+{
+	cv::Mat img = make_image();
+	cv::Mat binned = img(cv::Rect(0, 0, 160, 160)).clone();
+
+	std::vector<float> tensor(160 * 160);
+	REQUIRE(normalize_grayscale_image(binned, tensor.data()));
+	check_normalized(binned, tensor.data());
+
+	SECTION("flat image")
+	{
+		cv::Mat flat(160, 160, CV_8U, cv::Scalar(17));
+		CHECK_FALSE(normalize_grayscale_image(flat, tensor.data()));
+	}
+}
+
+TEST_CASE("hand_crop_map_reuse")
+{
+	t_camera_model_params dist = make_camera();
+	cv::Mat img = make_image();
+
+	projection_instructions first(dist);
+	aim(first, {0.1f, 0.1f, -1.0f}, 0.3f);
+
+	crop_map map = {};
+	CHECK_FALSE(stereographic_crop_map(dist, first, img, 0.5f, map));
+
+	SECTION("small change keeps the map")
+	{
+		projection_instructions next(dist);
+		aim(next, {0.1001f, 0.1f, -1.0f}, 0.3f);
+		REQUIRE_FALSE(next.rot_quat.isApprox(first.rot_quat));
+
+		CHECK(stereographic_crop_map(dist, next, img, 0.5f, map));
+
+		// Keypoints must be read back with the projection the crop was actually made with.
+		CHECK(next.rot_quat.isApprox(first.rot_quat));
+		CHECK(next.stereographic_radius == first.stereographic_radius);
+	}
+
+	SECTION("large change makes a new map")
+	{
+		projection_instructions next(dist);
+		aim(next, {0.2f, 0.1f, -1.0f}, 0.3f);
+		Eigen::Quaternionf wanted = next.rot_quat;
+
+		CHECK_FALSE(stereographic_crop_map(dist, next, img, 0.5f, map));
+		CHECK(next.rot_quat.isApprox(wanted));
+		CHECK(map.rot_quat.isApprox(wanted));
+	}
+
+	SECTION("radius change makes a new map")
+	{
+		projection_instructions next(dist);
+		aim(next, {0.1f, 0.1f, -1.0f}, 0.33f);
+
+		CHECK_FALSE(stereographic_crop_map(dist, next, img, 0.5f, map));
+	}
+
+	SECTION("zero tolerance always makes a new map")
+	{
+		projection_instructions next(dist);
+		aim(next, {0.1f, 0.1f, -1.0f}, 0.3f);
+
+		CHECK_FALSE(stereographic_crop_map(dist, next, img, 0.0f, map));
+	}
+
+	SECTION("different image size makes a new map")
+	{
+		cv::Mat smaller = img(cv::Rect(0, 0, kWidth / 2, kHeight / 2)).clone();
+		projection_instructions next(dist);
+		aim(next, {0.1f, 0.1f, -1.0f}, 0.3f);
+
+		CHECK_FALSE(stereographic_crop_map(dist, next, smaller, 0.5f, map));
+		CHECK(map.cols == kWidth / 2);
+	}
+}
+
+TEST_CASE("hand_crop_throughput", "[.][benchmark]")
+{
+	t_camera_model_params dist = make_camera();
+	cv::Mat img = make_image();
+
+	projection_instructions instr(dist);
+	aim(instr, {0.1f, 0.1f, -1.0f}, 0.3f);
+
+	crop_map map = {};
+	cv::Mat crop;
+	std::vector<float> tensor(128 * 128);
+
+	BENCHMARK("make crop map")
+	{
+		return stereographic_crop_map(dist, instr, img, 0.0f, map);
+	};
+
+	BENCHMARK("reuse crop map")
+	{
+		return stereographic_crop_map(dist, instr, img, 0.5f, map);
+	};
+
+	BENCHMARK("sample and normalize")
+	{
+		return sample_crop_and_normalize(map, img, crop, tensor.data());
+	};
+}
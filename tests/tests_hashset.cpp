@@ -0,0 +1,109 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Hashset tests.
+ */
+
+#include "util/u_hashset.h"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+
+
+static void
+free_callback(struct u_hashset_item *item, void *priv)
+{
+	(*(int *)priv)++;
+	free(item);
+}
+
+TEST_CASE("hashset")
+{
+	u_hashset *hs = nullptr;
+	REQUIRE(u_hashset_create(&hs) == 0);
+	u_hashset_reserve(hs, 16);
+
+	u_hashset_item *a = nullptr;
+	u_hashset_item *b = nullptr;
+	REQUIRE(u_hashset_create_and_insert_str_c(hs, "/user/hand/left", &a) == 0);
+	REQUIRE(u_hashset_create_and_insert_str_c(hs, "/user/hand/right", &b) == 0);
+
+	SECTION("find")
+	{
+		u_hashset_item *found = nullptr;
+		CHECK(u_hashset_find_c_str(hs, "/user/hand/left", &found) == 0);
+		CHECK(found == a);
+		CHECK(strcmp(found->c_str(), "/user/hand/left") == 0);
+
+		// Not null terminated, only the first length chars are used.
+		const char *longer = "/user/hand/rightxxx";
+		CHECK(u_hashset_find_str(hs, longer, strlen("/user/hand/right"), &found) == 0);
+		CHECK(found == b);
+
+		CHECK(u_hashset_find_c_str(hs, "/user/hand", &found) != 0);
+	}
+
+	SECTION("duplicate insert fails")
+	{
+		u_hashset_item *dup = nullptr;
+		CHECK(u_hashset_create_and_insert_str_c(hs, "/user/hand/left", &dup) != 0);
+		CHECK(dup == nullptr);
+	}
+
+	SECTION("erase")
+	{
+		u_hashset_item *found = nullptr;
+		CHECK(u_hashset_erase_item(hs, a) == 0);
+		CHECK(u_hashset_find_c_str(hs, "/user/hand/left", &found) != 0);
+		free(a);
+
+		// Erased keys are not left pointing at freed memory.
+		a = nullptr;
+		REQUIRE(u_hashset_create_and_insert_str_c(hs, "/user/hand/left", &a) == 0);
+		CHECK(u_hashset_find_c_str(hs, "/user/hand/left", &found) == 0);
+		CHECK(found == a);
+	}
+
+	int count = 0;
+	u_hashset_clear_and_call_for_each(hs, free_callback, &count);
+	CHECK(count == 2);
+	u_hashset_destroy(&hs);
+	CHECK(hs == nullptr);
+}
+
+TEST_CASE("hashset_find", "[.][benchmark]")
+{
+	// Roughly the number of paths created for all interaction profiles.
+	constexpr int kCount = 2000;
+
+	u_hashset *hs = nullptr;
+	u_hashset_create(&hs);
+
+	std::vector<std::string> strs;
+	for (int i = 0; i < kCount; i++) {
+		strs.push_back("/interaction_profiles/vendor/controller_" + std::to_string(i) +
+		               "/user/hand/left/input/trigger/value");
+		u_hashset_item *item = nullptr;
+		u_hashset_create_and_insert_str(hs, strs.back().c_str(), strs.back().size(), &item);
+	}
+
+	BENCHMARK("find hit")
+	{
+		int found = 0;
+		for (const auto &str : strs) {
+			u_hashset_item *item = nullptr;
+			found += u_hashset_find_str(hs, str.c_str(), str.size(), &item) == 0;
+		}
+		return found;
+	};
+
+	int count = 0;
+	u_hashset_clear_and_call_for_each(hs, free_callback, &count);
+	u_hashset_destroy(&hs);
+}
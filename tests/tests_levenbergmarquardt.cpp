@@ -17,10 +17,13 @@
 #include "kine_common.hpp"
 #include "lm_interface.hpp"
 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch/catch.hpp"
 
 #include <thread>
 #include <chrono>
+#include <random>
+#include <vector>
 #include "fenv.h"
 
 using namespace xrt::tracking::hand::mercury;
@@ -84,3 +87,180 @@ TEST_CASE("LevenbergMarquardt")
 	CHECK(std::isfinite(out_reprojection_error));
 	CHECK(std::isfinite(out_hand_size));
 }
+
+
+/*
+ *
+ * Jacobians.
+ *
+ */
+
+// A hand seen from both cameras, slowly moving and curling over the frames.
+static one_frame_input
+make_moving_observation(int frame)
+{
+	one_frame_input input = {};
+
+	float t = frame * 0.05f;
+
+	for (int view = 0; view < 2; view++) {
+		input.views[view].active = true;
+		input.views[view].stereographic_radius = 0.5;
+		input.views[view].look_dir = XRT_QUAT_IDENTITY;
+		for (int i = 0; i < 5; i++) {
+			input.views[view].curls[i].value = -0.5f - 0.3f * sinf(t + i);
+			input.views[view].curls[i].variance = 1.0f;
+		}
+		for (int i = 0; i < 21; i++) {
+			float radius = 0.3f + 0.5f * (i / 21.0f);
+			xrt_vec2 dir = {radius * sinf(i + t) + 0.1f * view, radius * cosf(i + t)};
+
+			vec2_5 &kp = input.views[view].keypoints_in_scaled_stereographic[i];
+			kp.pos_2d = dir;
+			kp.depth_relative_to_midpxm = (i / 21.0f) - 0.5f + 0.1f * sinf(t);
+			kp.confidence_depth = 0.8f;
+			kp.confidence_xy = 0.5f + 0.5f * (i % 3) / 2.0f;
+		}
+	}
+	return input;
+}
+
+static void
+check_jacobians(lm::KinematicHandLM *autodiff_hand,
+                lm::KinematicHandLM *analytic_hand,
+                int frame,
+                bool untracked,
+                bool optimize_hand_size,
+                const std::vector<float> &offset)
+{
+	std::vector<float> autodiff_residuals;
+	std::vector<float> autodiff_jacobian;
+	std::vector<float> analytic_residuals;
+	std::vector<float> analytic_jacobian;
+
+	one_frame_input obs = make_moving_observation(frame);
+	lm::optimizer_evaluate(autodiff_hand, obs, untracked, 2.0f, optimize_hand_size, 0.09f, 0.5f, 0.5f,
+	                       offset.data(), autodiff_residuals, autodiff_jacobian);
+
+	obs = make_moving_observation(frame);
+	lm::optimizer_evaluate(analytic_hand, obs, untracked, 2.0f, optimize_hand_size, 0.09f, 0.5f, 0.5f,
+	                       offset.data(), analytic_residuals, analytic_jacobian);
+
+	REQUIRE(autodiff_residuals.size() == analytic_residuals.size());
+	REQUIRE(autodiff_jacobian.size() == analytic_jacobian.size());
+
+	for (size_t i = 0; i < autodiff_residuals.size(); i++) {
+		CHECK(analytic_residuals[i] == Approx(autodiff_residuals[i]).margin(0.00001));
+	}
+
+	// Only float precision, and the two take different routes.
+	for (size_t i = 0; i < autodiff_jacobian.size(); i++) {
+		INFO("row " << i % autodiff_residuals.size() << ", column " << i / autodiff_residuals.size());
+		CHECK(analytic_jacobian[i] == Approx(autodiff_jacobian[i]).epsilon(0.001).margin(0.0005));
+	}
+}
+
+TEST_CASE("LevenbergMarquardt analytic Jacobian")
+{
+	lm::KinematicHandLM *autodiff_hand;
+	lm::KinematicHandLM *analytic_hand;
+
+	bool is_right = GENERATE(false, true);
+	bool optimize_hand_size = GENERATE(false, true);
+
+	xrt_pose left_in_right = XRT_POSE_IDENTITY;
+	left_in_right.position.x = 0.1f;
+	left_in_right.orientation = {0.05f, -0.03f, 0.02f, 1.0f};
+	math_quat_normalize(&left_in_right.orientation);
+
+	lm::optimizer_create(left_in_right, is_right, U_LOGGING_WARN, &autodiff_hand);
+	lm::optimizer_create(left_in_right, is_right, U_LOGGING_WARN, &analytic_hand);
+
+	REQUIRE(lm::optimizer_set_jacobian_method(autodiff_hand, lm::JacobianMethod::Autodiff));
+	if (!lm::optimizer_set_jacobian_method(analytic_hand, lm::JacobianMethod::Analytic)) {
+		WARN("Analytic Jacobian not built in, nothing to compare.");
+		lm::optimizer_destroy(&autodiff_hand);
+		lm::optimizer_destroy(&analytic_hand);
+		return;
+	}
+
+	size_t num_params = optimize_hand_size ? 28 : 27;
+	std::vector<float> no_offset(num_params, 0.0f);
+
+	// Away from the special cases at zero.
+	std::vector<float> offset(num_params);
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> dist(-0.2f, 0.2f);
+	for (float &o : offset) {
+		o = dist(rng);
+	}
+
+	SECTION("first frame")
+	{
+		check_jacobians(autodiff_hand, analytic_hand, 0, true, optimize_hand_size, no_offset);
+		check_jacobians(autodiff_hand, analytic_hand, 0, true, optimize_hand_size, offset);
+	}
+
+	SECTION("tracked frames")
+	{
+		// Get both out of the first frame, with stability residuals and a last frame to be stable against. Both
+		// have to take the same path there, or they won't be compared at the same point.
+		lm::optimizer_set_jacobian_method(analytic_hand, lm::JacobianMethod::Autodiff);
+		for (int frame = 0; frame < 3; frame++) {
+			for (lm::KinematicHandLM *hand : {autodiff_hand, analytic_hand}) {
+				one_frame_input obs = make_moving_observation(frame);
+				xrt_hand_joint_set out = {};
+				float out_hand_size = 0.0f;
+				float out_reprojection_error = 0.0f;
+				lm::optimizer_run(hand, obs, frame == 0, 2.0f, optimize_hand_size, 0.09f, 0.5f, 0.5f, out,
+				                  out_hand_size, out_reprojection_error);
+			}
+		}
+		lm::optimizer_set_jacobian_method(analytic_hand, lm::JacobianMethod::Analytic);
+
+		check_jacobians(autodiff_hand, analytic_hand, 3, false, optimize_hand_size, no_offset);
+		check_jacobians(autodiff_hand, analytic_hand, 3, false, optimize_hand_size, offset);
+	}
+
+	lm::optimizer_destroy(&autodiff_hand);
+	lm::optimizer_destroy(&analytic_hand);
+}
+
+TEST_CASE("LevenbergMarquardt per-frame", "[.][benchmark]")
+{
+	// There are no recorded observations in the tree, so this plays back a generated sequence.
+	constexpr int kNumFrames = 120;
+	std::vector<one_frame_input> frames;
+	for (int frame = 0; frame < kNumFrames; frame++) {
+		frames.push_back(make_moving_observation(frame));
+	}
+
+	xrt_pose left_in_right = XRT_POSE_IDENTITY;
+	left_in_right.position.x = 0.1f;
+
+	for (lm::JacobianMethod method : {lm::JacobianMethod::Autodiff, lm::JacobianMethod::Analytic}) {
+		const char *name = method == lm::JacobianMethod::Autodiff ? "autodiff" : "analytic";
+
+		lm::KinematicHandLM *hand;
+		lm::optimizer_create(left_in_right, false, U_LOGGING_WARN, &hand);
+		if (!lm::optimizer_set_jacobian_method(hand, method)) {
+			lm::optimizer_destroy(&hand);
+			continue;
+		}
+
+		int frame = 0;
+		BENCHMARK(std::string("optimizer_run ") + name)
+		{
+			one_frame_input obs = frames[frame % kNumFrames];
+			xrt_hand_joint_set out = {};
+			float out_hand_size = 0.0f;
+			float out_reprojection_error = 0.0f;
+			lm::optimizer_run(hand, obs, frame == 0, 2.0f, true, 0.09f, 0.5f, 0.5f, out, out_hand_size,
+			                  out_reprojection_error);
+			frame++;
+			return out_reprojection_error;
+		};
+
+		lm::optimizer_destroy(&hand);
+	}
+}
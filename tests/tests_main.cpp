@@ -7,4 +7,5 @@
  */
 
 #define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch/catch.hpp"
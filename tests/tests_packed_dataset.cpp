@@ -0,0 +1,362 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Packed dataset container tests.
+ */
+
+#include "util/u_frame.h"
+#include "util/u_packed_dataset.h"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/*
+ *
+ * Helpers
+ *
+ */
+
+static std::string
+temp_path(const char *name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+//! A frame with smooth gradients and some noise, somewhat like a camera image.
+static xrt_frame *
+make_frame(uint32_t width, uint32_t height, uint64_t timestamp, uint32_t seed)
+{
+	xrt_frame *xf = nullptr;
+	u_frame_create_one_off(XRT_FORMAT_L8, width, height, &xf);
+	xf->timestamp = timestamp;
+
+	std::mt19937 rng(seed);
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			xf->data[y * xf->stride + x] = (uint8_t)((x / 8 + y / 8 + seed) & 0xff) ^ (rng() & 0x3);
+		}
+	}
+
+	return xf;
+}
+
+static bool
+frame_matches(const u_pd_record &rec, xrt_frame *xf)
+{
+	std::vector<uint8_t> pixels(u_pd_frame_size(&rec));
+	if (u_pd_frame_decode(&rec, pixels.data(), pixels.size()) != 0) {
+		return false;
+	}
+
+	for (uint32_t y = 0; y < xf->height; y++) {
+		if (memcmp(&pixels[y * rec.frame.header->stride], &xf->data[y * xf->stride], xf->width) != 0) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void
+write_session(const std::string &path, u_pd_codec codec, std::vector<xrt_frame *> &frames, uint32_t chunk_size)
+{
+	u_pd_writer *pdw = nullptr;
+	REQUIRE(u_pd_writer_create(path.c_str(), 2, chunk_size, &pdw) == 0);
+
+	for (size_t i = 0; i < frames.size(); i++) {
+		int64_t ts = (int64_t)frames[i]->timestamp;
+
+		for (int j = 0; j < 4; j++) {
+			xrt_imu_sample imu = {ts + j, {1.0 * j, 2.0, 3.0}, {4.0, 5.0, 6.0 * j}};
+			REQUIRE(u_pd_writer_push_imu(pdw, &imu) == 0);
+		}
+
+		xrt_pose_sample gt = {ts, {{0.0f, 0.0f, 0.0f, 1.0f}, {(float)i, 0.0f, 0.0f}}};
+		REQUIRE(u_pd_writer_push_gt(pdw, &gt) == 0);
+
+		REQUIRE(u_pd_writer_push_frame(pdw, (uint32_t)(i % 2), frames[i], codec) == 0);
+	}
+
+	REQUIRE(u_pd_writer_close(&pdw) == 0);
+	CHECK(pdw == nullptr);
+}
+
+
+/*
+ *
+ * Tests
+ *
+ */
+
+TEST_CASE("packed_dataset")
+{
+	std::string path = temp_path("monado_tests_packed_dataset.mpk");
+
+	std::vector<xrt_frame *> frames;
+	for (uint32_t i = 0; i < 8; i++) {
+		frames.push_back(make_frame(64 + i, 48, 1000 * (i + 1), i));
+	}
+
+	u_pd_codec codec = GENERATE(U_PD_CODEC_RAW, U_PD_CODEC_LZ4);
+	CAPTURE(codec);
+
+	// Small chunks to get more than one.
+	write_session(path, codec, frames, 4096);
+
+	u_pd_reader pdr;
+	REQUIRE(u_pd_reader_open(&pdr, path.c_str()) == 0);
+	CHECK(pdr.header.cam_count == 2);
+	CHECK(pdr.chunk_count > 1);
+
+	SECTION("records are read back in order")
+	{
+		size_t imu_count = 0;
+		size_t gt_count = 0;
+		size_t frame_count = 0;
+		u_pd_record rec;
+		while (u_pd_reader_next(&pdr, &rec)) {
+			switch (rec.type) {
+			case U_PD_RECORD_IMU:
+				CHECK(rec.imu.gyro_rad_secs.z == 6.0 * (imu_count % 4));
+				CHECK(rec.imu.accel_m_s2.x == 1.0 * (imu_count % 4));
+				imu_count++;
+				break;
+			case U_PD_RECORD_GT:
+				CHECK(rec.gt.pose.position.x == (float)gt_count);
+				gt_count++;
+				break;
+			case U_PD_RECORD_FRAME:
+				REQUIRE(frame_count < frames.size());
+				CHECK(((uintptr_t)rec.frame.data % U_PD_ALIGNMENT) == 0);
+				CHECK(rec.frame.header->cam_index == frame_count % 2);
+				CHECK(rec.frame.header->width == frames[frame_count]->width);
+				CHECK(rec.timestamp_ns == (int64_t)frames[frame_count]->timestamp);
+				CHECK(frame_matches(rec, frames[frame_count]));
+				if (codec == U_PD_CODEC_LZ4) {
+					CHECK(rec.frame.header->codec == U_PD_CODEC_LZ4);
+					CHECK(rec.frame.header->data_size < u_pd_frame_size(&rec));
+				}
+				frame_count++;
+				break;
+			default: FAIL("Unknown record type");
+			}
+		}
+
+		CHECK(imu_count == frames.size() * 4);
+		CHECK(gt_count == frames.size());
+		CHECK(frame_count == frames.size());
+	}
+
+	SECTION("seeking lands at or before the timestamp")
+	{
+		u_pd_reader_seek(&pdr, 6000);
+
+		u_pd_record rec;
+		REQUIRE(u_pd_reader_next(&pdr, &rec));
+		CHECK(rec.timestamp_ns <= 6000);
+
+		bool found = false;
+		do {
+			found = rec.type == U_PD_RECORD_FRAME && rec.timestamp_ns == 6000;
+		} while (!found && u_pd_reader_next(&pdr, &rec));
+		CHECK(found);
+
+		u_pd_reader_seek(&pdr, 1000000);
+		CHECK_FALSE(u_pd_reader_next(&pdr, &rec));
+	}
+
+	u_pd_reader_close(&pdr);
+	std::remove(path.c_str());
+
+	for (xrt_frame *xf : frames) {
+		xrt_frame_reference(&xf, nullptr);
+	}
+}
+
+TEST_CASE("packed_dataset_damaged")
+{
+	std::string path = temp_path("monado_tests_packed_dataset_damaged.mpk");
+
+	std::vector<xrt_frame *> frames;
+	for (uint32_t i = 0; i < 4; i++) {
+		frames.push_back(make_frame(32, 32, 1000 * (i + 1), i));
+	}
+	write_session(path, U_PD_CODEC_LZ4, frames, 0);
+
+	// Read the whole file to make damaged copies of it.
+	std::vector<uint8_t> contents(std::filesystem::file_size(path));
+	FILE *file = fopen(path.c_str(), "rb");
+	REQUIRE(fread(contents.data(), 1, contents.size(), file) == contents.size());
+	fclose(file);
+
+	u_pd_file_header header;
+	memcpy(&header, contents.data(), sizeof(header));
+	REQUIRE(header.index_offset != 0);
+
+	auto write_contents = [&](const std::vector<uint8_t> &data) {
+		FILE *f = fopen(path.c_str(), "wb");
+		fwrite(data.data(), 1, data.size(), f);
+		fclose(f);
+	};
+
+	SECTION("recording cut short is still readable")
+	{
+		// Header not updated and no index, cut in the middle of the last frame.
+		std::vector<uint8_t> cut(contents.begin(), contents.begin() + header.index_offset - 100);
+		u_pd_file_header cut_header = header;
+		cut_header.index_offset = 0;
+		cut_header.chunk_count = 0;
+		memcpy(cut.data(), &cut_header, sizeof(cut_header));
+		write_contents(cut);
+
+		u_pd_reader pdr;
+		REQUIRE(u_pd_reader_open(&pdr, path.c_str()) == 0);
+		CHECK(pdr.chunks == nullptr);
+
+		size_t frame_count = 0;
+		u_pd_record rec;
+		while (u_pd_reader_next(&pdr, &rec)) {
+			frame_count += rec.type == U_PD_RECORD_FRAME ? 1 : 0;
+		}
+		CHECK(frame_count == frames.size() - 1);
+
+		u_pd_reader_close(&pdr);
+	}
+
+	SECTION("damaged index is ignored")
+	{
+		REQUIRE(header.chunk_count > 0);
+
+		// Point the first chunk into the middle of a record.
+		std::vector<uint8_t> damaged = contents;
+		u_pd_chunk chunk;
+		memcpy(&chunk, damaged.data() + header.index_offset, sizeof(chunk));
+		chunk.offset += 4;
+		memcpy(damaged.data() + header.index_offset, &chunk, sizeof(chunk));
+		write_contents(damaged);
+
+		u_pd_reader pdr;
+		REQUIRE(u_pd_reader_open(&pdr, path.c_str()) == 0);
+		CHECK(pdr.chunks == nullptr);
+		CHECK(pdr.chunk_count == 0);
+		CHECK(pdr.records_end == header.index_offset);
+
+		// Seeking rewinds and all frames can still be read.
+		u_pd_reader_seek(&pdr, 3000);
+		size_t frame_count = 0;
+		u_pd_record rec;
+		while (u_pd_reader_next(&pdr, &rec)) {
+			frame_count += rec.type == U_PD_RECORD_FRAME ? 1 : 0;
+		}
+		CHECK(frame_count == frames.size());
+
+		u_pd_reader_close(&pdr);
+	}
+
+	SECTION("corrupt compressed data is rejected")
+	{
+		u_pd_reader pdr;
+		REQUIRE(u_pd_reader_open(&pdr, path.c_str()) == 0);
+
+		u_pd_record rec;
+		do {
+			REQUIRE(u_pd_reader_next(&pdr, &rec));
+		} while (rec.type != U_PD_RECORD_FRAME);
+
+		// Point the first match far before the start of the output.
+		size_t offset = rec.frame.data - pdr.data;
+		u_pd_reader_close(&pdr);
+
+		std::vector<uint8_t> corrupt = contents;
+		corrupt[offset] = 0x0f;
+		corrupt[offset + 1] = 0xff;
+		corrupt[offset + 2] = 0xff;
+		write_contents(corrupt);
+
+		REQUIRE(u_pd_reader_open(&pdr, path.c_str()) == 0);
+		do {
+			REQUIRE(u_pd_reader_next(&pdr, &rec));
+		} while (rec.type != U_PD_RECORD_FRAME);
+
+		std::vector<uint8_t> pixels(u_pd_frame_size(&rec));
+		CHECK(u_pd_frame_decode(&rec, pixels.data(), pixels.size()) != 0);
+
+		u_pd_reader_close(&pdr);
+	}
+
+	SECTION("not a packed dataset")
+	{
+		std::vector<uint8_t> garbage(256, 0x42);
+		write_contents(garbage);
+
+		u_pd_reader pdr;
+		CHECK(u_pd_reader_open(&pdr, path.c_str()) != 0);
+	}
+
+	std::remove(path.c_str());
+
+	for (xrt_frame *xf : frames) {
+		xrt_frame_reference(&xf, nullptr);
+	}
+}
+
+TEST_CASE("packed_dataset_throughput", "[.][benchmark]")
+{
+	std::string path = temp_path("monado_tests_packed_dataset_bench.mpk");
+
+	// One second of a stereo 640x480 camera at 30 fps.
+	std::vector<xrt_frame *> frames;
+	for (uint32_t i = 0; i < 60; i++) {
+		frames.push_back(make_frame(640, 480, 1000 * (i + 1), i));
+	}
+
+	for (u_pd_codec codec : {U_PD_CODEC_RAW, U_PD_CODEC_LZ4}) {
+		const char *name = codec == U_PD_CODEC_RAW ? "raw" : "lz4";
+
+		BENCHMARK(std::string("record ") + name)
+		{
+			write_session(path, codec, frames, 0);
+			return frames.size();
+		};
+
+		WARN(name << " file size: " << std::filesystem::file_size(path) / 1024 << " KiB");
+
+		std::vector<uint8_t> pixels(640 * 480);
+		BENCHMARK(std::string("playback ") + name)
+		{
+			u_pd_reader pdr;
+			u_pd_reader_open(&pdr, path.c_str());
+
+			size_t count = 0;
+			u_pd_record rec;
+			while (u_pd_reader_next(&pdr, &rec)) {
+				if (rec.type != U_PD_RECORD_FRAME) {
+					continue;
+				}
+				// Raw frames are used straight from the mapping.
+				if (rec.frame.header->codec != U_PD_CODEC_RAW) {
+					u_pd_frame_decode(&rec, pixels.data(), pixels.size());
+				}
+				count++;
+			}
+
+			u_pd_reader_close(&pdr);
+			return count;
+		};
+	}
+
+	std::remove(path.c_str());
+
+	for (xrt_frame *xf : frames) {
+		xrt_frame_reference(&xf, nullptr);
+	}
+}
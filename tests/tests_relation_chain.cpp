@@ -11,8 +11,11 @@
 #include "math/m_api.h"
 #include "math/m_space.h"
 
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
 #include "catch/catch.hpp"
 
+#include <random>
+
 
 /*
  *
@@ -226,3 +229,107 @@ TEST_CASE("Relation Chain Flags")
 		TEST_FLAGS(kFlagsValid, VNT, ONLY_POSITION, P);
 	}
 }
+
+
+/*
+ *
+ * Pose only fast path
+ *
+ */
+
+static xrt_pose
+make_random_pose(std::mt19937 &rng)
+{
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+	xrt_pose pose = {};
+	pose.orientation = {dist(rng), dist(rng), dist(rng), dist(rng)};
+	pose.position = {dist(rng) * 2.0f, dist(rng) * 2.0f, dist(rng) * 2.0f};
+	math_quat_normalize(&pose.orientation);
+
+	return pose;
+}
+
+static void
+fill_random_chain(std::mt19937 &rng, uint32_t count, struct xrt_relation_chain *xrc)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		xrt_space_relation relation = kSpaceRelationOneY;
+		relation.pose = make_random_pose(rng);
+		m_relation_chain_push_relation(xrc, &relation);
+	}
+}
+
+TEST_CASE("Relation Chain Pose Only")
+{
+	std::mt19937 rng(4321);
+	constexpr float kTolerance = 1e-5f;
+
+	for (uint32_t count = 2; count <= XRT_RELATION_CHAIN_CAPACITY; count++) {
+		CAPTURE(count);
+
+		struct xrt_relation_chain xrc = XRT_STRUCT_INIT;
+		fill_random_chain(rng, count, &xrc);
+
+		// Reference, fold the poses the same way as the chain is applied.
+		xrt_pose expected = xrc.steps[0].pose;
+		for (uint32_t i = 1; i < count; i++) {
+			math_pose_transform(&xrc.steps[i].pose, &expected, &expected);
+		}
+
+		struct xrt_space_relation fast = XRT_STRUCT_INIT;
+		m_relation_chain_resolve(&xrc, &fast);
+
+		// A zero velocity forces the general path without changing the pose.
+		xrc.steps[count - 1].relation_flags = (xrt_space_relation_flags)( //
+		    xrc.steps[count - 1].relation_flags |                           //
+		    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT);                   //
+
+		struct xrt_space_relation general = XRT_STRUCT_INIT;
+		m_relation_chain_resolve(&xrc, &general);
+
+		CHECK(fast.relation_flags == kFlagsValid);
+		CHECK(general.relation_flags == (kFlagsValid | XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT));
+
+		CHECK_THAT(fast.pose.position.x, Catch::Matchers::WithinAbs(general.pose.position.x, kTolerance));
+		CHECK_THAT(fast.pose.position.y, Catch::Matchers::WithinAbs(general.pose.position.y, kTolerance));
+		CHECK_THAT(fast.pose.position.z, Catch::Matchers::WithinAbs(general.pose.position.z, kTolerance));
+		CHECK_THAT(fast.pose.orientation.x, Catch::Matchers::WithinAbs(general.pose.orientation.x, kTolerance));
+		CHECK_THAT(fast.pose.orientation.y, Catch::Matchers::WithinAbs(general.pose.orientation.y, kTolerance));
+		CHECK_THAT(fast.pose.orientation.z, Catch::Matchers::WithinAbs(general.pose.orientation.z, kTolerance));
+		CHECK_THAT(fast.pose.orientation.w, Catch::Matchers::WithinAbs(general.pose.orientation.w, kTolerance));
+
+		CHECK_THAT(fast.pose.position.x, Catch::Matchers::WithinAbs(expected.position.x, kTolerance));
+		CHECK_THAT(fast.pose.position.y, Catch::Matchers::WithinAbs(expected.position.y, kTolerance));
+		CHECK_THAT(fast.pose.position.z, Catch::Matchers::WithinAbs(expected.position.z, kTolerance));
+	}
+}
+
+TEST_CASE("Relation Chain Resolve", "[.][benchmark]")
+{
+	std::mt19937 rng(1234);
+
+	// About what a xrLocateViews call with a stage space ends up with.
+	struct xrt_relation_chain xrc = XRT_STRUCT_INIT;
+	fill_random_chain(rng, 5, &xrc);
+
+	struct xrt_space_relation result = XRT_STRUCT_INIT;
+
+	BENCHMARK("poses only")
+	{
+		m_relation_chain_resolve(&xrc, &result);
+		return result.pose.position.x;
+	};
+
+	struct xrt_relation_chain xrc_velocity = xrc;
+	xrc_velocity.steps[0].relation_flags = (xrt_space_relation_flags)( //
+	    xrc_velocity.steps[0].relation_flags |                          //
+	    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT |                  //
+	    XRT_SPACE_RELATION_ANGULAR_VELOCITY_VALID_BIT);                 //
+
+	BENCHMARK("with velocity")
+	{
+		m_relation_chain_resolve(&xrc_velocity, &result);
+		return result.pose.position.x;
+	};
+}
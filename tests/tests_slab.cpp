@@ -0,0 +1,128 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Slab allocator tests.
+ */
+
+#include "util/u_slab.h"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <set>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+
+
+struct test_object
+{
+	uint64_t a;
+	uint32_t b;
+	uint8_t c[37];
+};
+
+TEST_CASE("slab")
+{
+	u_slab slab;
+	REQUIRE(U_SLAB_INIT_TYPED(&slab, test_object, 4) == 0);
+
+	CHECK(slab.object_size >= sizeof(test_object));
+	CHECK(slab.object_size % 16 == 0);
+
+	SECTION("objects are zeroed, aligned and unique")
+	{
+		std::set<void *> seen;
+		for (int i = 0; i < 10; i++) {
+			auto *obj = (test_object *)u_slab_alloc(&slab);
+			REQUIRE(obj != nullptr);
+			CHECK(((uintptr_t)obj % 16) == 0);
+			CHECK(obj->a == 0);
+			CHECK(obj->b == 0);
+			CHECK(seen.count(obj) == 0);
+			seen.insert(obj);
+			obj->a = 0xffffffff;
+		}
+
+		CHECK(slab.live_count == 10);
+		CHECK(slab.chunk_count == 3);
+	}
+
+	SECTION("freed objects are reused and zeroed")
+	{
+		auto *first = (test_object *)u_slab_alloc(&slab);
+		first->a = 42;
+		first->c[36] = 7;
+		u_slab_free(&slab, first);
+		CHECK(slab.live_count == 0);
+
+		auto *second = (test_object *)u_slab_alloc(&slab);
+		CHECK(second == first);
+		CHECK(second->a == 0);
+		CHECK(second->c[36] == 0);
+	}
+
+	SECTION("churn does not grow the slab")
+	{
+		std::vector<void *> objs;
+		for (int round = 0; round < 100; round++) {
+			for (int i = 0; i < 8; i++) {
+				objs.push_back(u_slab_alloc(&slab));
+			}
+			for (void *obj : objs) {
+				u_slab_free(&slab, obj);
+			}
+			objs.clear();
+		}
+
+		CHECK(slab.chunk_count == 2);
+		CHECK(slab.live_count == 0);
+	}
+
+	// Bulk teardown, also frees anything still allocated.
+	u_slab_alloc(&slab);
+	u_slab_fini(&slab);
+	CHECK(slab.chunks == nullptr);
+
+	// A zeroed slab, like after a failed init, can always be fini'd.
+	u_slab_fini(&slab);
+	CHECK(slab.object_size == 0);
+}
+
+TEST_CASE("slab_throughput", "[.][benchmark]")
+{
+	// Something like a app creating and destroying spaces every frame.
+	constexpr int kCount = 64;
+	std::vector<void *> objs(kCount);
+
+	BENCHMARK("calloc")
+	{
+		for (int i = 0; i < kCount; i++) {
+			objs[i] = calloc(1, sizeof(test_object));
+		}
+		for (int i = 0; i < kCount; i++) {
+			free(objs[i]);
+		}
+		return objs[0];
+	};
+
+	u_slab slab;
+	U_SLAB_INIT_TYPED(&slab, test_object, 0);
+
+	BENCHMARK("slab")
+	{
+		for (int i = 0; i < kCount; i++) {
+			objs[i] = u_slab_alloc(&slab);
+		}
+		for (int i = 0; i < kCount; i++) {
+			u_slab_free(&slab, objs[i]);
+		}
+		return objs[0];
+	};
+
+	// Only two chunks for all of the benchmark iterations.
+	WARN("slab chunk allocations: " << slab.chunk_count);
+
+	u_slab_fini(&slab);
+}
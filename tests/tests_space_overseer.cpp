@@ -0,0 +1,318 @@
+// Copyright 2023, Collabora, Ltd.
+// SPDX-License-Identifier: BSL-1.0
+/*!
+ * @file
+ * @brief Test batched space location and pose memo in u_space_overseer.
+ */
+
+#include "xrt/xrt_space.h"
+#include "xrt/xrt_device.h"
+
+#include "math/m_api.h"
+
+#include "util/u_space_overseer.h"
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch/catch.hpp"
+
+#include <vector>
+
+
+/*
+ *
+ * Test device.
+ *
+ */
+
+struct test_device
+{
+	xrt_device base;
+	xrt_pose pose;
+	uint32_t query_count;
+};
+
+static void
+test_get_tracked_pose(xrt_device *xdev, xrt_input_name name, uint64_t at_timestamp_ns, xrt_space_relation *out_relation)
+{
+	test_device *td = (test_device *)xdev;
+	td->query_count++;
+
+	// Move the pose a bit depending on the input and time.
+	xrt_space_relation rel = XRT_SPACE_RELATION_ZERO;
+	rel.pose = td->pose;
+	rel.pose.position.x += (float)(name & 0xff) * 0.01f;
+	rel.pose.position.y += (float)(at_timestamp_ns % 1000) * 0.001f;
+	rel.linear_velocity.z = 0.5f;
+	rel.relation_flags = (xrt_space_relation_flags)( //
+	    XRT_SPACE_RELATION_ORIENTATION_VALID_BIT |   //
+	    XRT_SPACE_RELATION_POSITION_VALID_BIT |      //
+	    XRT_SPACE_RELATION_LINEAR_VELOCITY_VALID_BIT);
+
+	*out_relation = rel;
+}
+
+static void
+init_device(test_device &td, const char *str, xrt_pose pose)
+{
+	td = {};
+	td.base.get_tracked_pose = test_get_tracked_pose;
+	snprintf(td.base.str, sizeof(td.base.str), "%s", str);
+	td.pose = pose;
+}
+
+static xrt_pose
+make_pose(float x, float y, float z, float angle)
+{
+	xrt_pose pose = XRT_POSE_IDENTITY;
+	xrt_vec3 axis = {0.0f, 1.0f, 0.0f};
+	math_quat_from_angle_vector(angle, &axis, &pose.orientation);
+	pose.position = {x, y, z};
+	return pose;
+}
+
+static void
+check_relations(const xrt_space_relation &a, const xrt_space_relation &b)
+{
+	CHECK(a.relation_flags == b.relation_flags);
+	CHECK(a.pose.position.x == Approx(b.pose.position.x).margin(0.0001f));
+	CHECK(a.pose.position.y == Approx(b.pose.position.y).margin(0.0001f));
+	CHECK(a.pose.position.z == Approx(b.pose.position.z).margin(0.0001f));
+	CHECK(a.pose.orientation.x == Approx(b.pose.orientation.x).margin(0.0001f));
+	CHECK(a.pose.orientation.y == Approx(b.pose.orientation.y).margin(0.0001f));
+	CHECK(a.pose.orientation.z == Approx(b.pose.orientation.z).margin(0.0001f));
+	CHECK(a.pose.orientation.w == Approx(b.pose.orientation.w).margin(0.0001f));
+	CHECK(a.linear_velocity.z == Approx(b.linear_velocity.z).margin(0.0001f));
+}
+
+
+/*
+ *
+ * Test setup, a head and two controllers in different tracking origins.
+ *
+ */
+
+struct test_setup
+{
+	u_space_overseer *uso = nullptr;
+	xrt_space_overseer *xso = nullptr;
+
+	test_device head;
+	test_device left;
+	test_device right;
+
+	// Pose and offset spaces to be located.
+	std::vector<xrt_space *> spaces;
+	std::vector<xrt_pose> offsets;
+
+	test_setup()
+	{
+		init_device(head, "Head", make_pose(0.0f, 1.6f, 0.0f, 0.1f));
+		init_device(left, "Left", make_pose(-0.2f, 1.2f, -0.3f, 0.4f));
+		init_device(right, "Right", make_pose(0.2f, 1.2f, -0.3f, -0.4f));
+
+		uso = u_space_overseer_create();
+		xso = (xrt_space_overseer *)uso;
+
+		xrt_space *root = xso->semantic.root;
+		xrt_space *head_origin = NULL;
+		xrt_space *hand_origin = NULL;
+
+		xrt_pose head_origin_offset = make_pose(0.0f, 0.0f, 0.5f, 0.0f);
+		xrt_pose hand_origin_offset = make_pose(1.0f, 0.0f, 0.0f, 1.5f);
+		u_space_overseer_create_offset_space(uso, root, &head_origin_offset, &head_origin);
+		u_space_overseer_create_offset_space(uso, root, &hand_origin_offset, &hand_origin);
+
+		u_space_overseer_link_space_to_device(uso, head_origin, &head.base);
+		u_space_overseer_link_space_to_device(uso, hand_origin, &left.base);
+		u_space_overseer_link_space_to_device(uso, hand_origin, &right.base);
+
+		xrt_space_reference(&head_origin, NULL);
+		xrt_space_reference(&hand_origin, NULL);
+
+		xrt_pose local_offset = make_pose(0.0f, 1.0f, 0.0f, 0.3f);
+		u_space_overseer_create_offset_space(uso, root, &local_offset, &xso->semantic.local);
+		u_space_overseer_create_pose_space(uso, &head.base, XRT_INPUT_GENERIC_HEAD_POSE, &xso->semantic.view);
+	}
+
+	~test_setup()
+	{
+		for (xrt_space *&xs : spaces) {
+			xrt_space_reference(&xs, NULL);
+		}
+		xrt_space_overseer_destroy(&xso);
+	}
+
+	//! Adds @p count spaces, cycling through the devices and inputs.
+	void
+	add_spaces(uint32_t count)
+	{
+		test_device *devices[] = {&left, &right};
+		xrt_input_name names[] = {XRT_INPUT_SIMPLE_GRIP_POSE, XRT_INPUT_SIMPLE_AIM_POSE};
+
+		for (uint32_t i = 0; i < count; i++) {
+			xrt_space *pose_space = NULL;
+			xrt_space *xs = NULL;
+
+			test_device *td = devices[i % 2];
+			xrt_input_name name = names[(i / 2) % 2];
+			u_space_overseer_create_pose_space(uso, &td->base, name, &pose_space);
+
+			// Every other one has a extra offset space.
+			if (i % 3 == 0) {
+				xrt_pose offset = make_pose(0.0f, 0.0f, -0.1f * (float)i, 0.0f);
+				u_space_overseer_create_offset_space(uso, pose_space, &offset, &xs);
+				xrt_space_reference(&pose_space, NULL);
+			} else {
+				xs = pose_space;
+			}
+
+			spaces.push_back(xs);
+			offsets.push_back(make_pose(0.01f * (float)i, 0.0f, 0.0f, 0.05f * (float)i));
+		}
+	}
+
+	void
+	reset_query_counts()
+	{
+		head.query_count = 0;
+		left.query_count = 0;
+		right.query_count = 0;
+	}
+};
+
+
+/*
+ *
+ * Tests.
+ *
+ */
+
+TEST_CASE("space_overseer_locate_spaces")
+{
+	test_setup ts;
+	ts.add_spaces(12);
+
+	uint64_t at_timestamp_ns = 123456;
+	xrt_pose base_offset = make_pose(0.1f, 0.0f, 0.2f, 0.2f);
+
+	SECTION("same as locate_space")
+	{
+		xrt_space *bases[] = {ts.xso->semantic.local, ts.xso->semantic.view, ts.spaces[1]};
+
+		for (xrt_space *base : bases) {
+			std::vector<xrt_space_relation> batch(ts.spaces.size());
+			xrt_space_overseer_locate_spaces(ts.xso, base, &base_offset, at_timestamp_ns, ts.spaces.data(),
+			                                 (uint32_t)ts.spaces.size(), ts.offsets.data(), batch.data());
+
+			for (size_t i = 0; i < ts.spaces.size(); i++) {
+				xrt_space_relation single = XRT_SPACE_RELATION_ZERO;
+				xrt_space_overseer_locate_space(ts.xso, base, &base_offset, at_timestamp_ns,
+				                                ts.spaces[i], &ts.offsets[i], &single);
+				check_relations(batch[i], single);
+			}
+		}
+	}
+
+	SECTION("each device input queried once")
+	{
+		std::vector<xrt_space_relation> batch(ts.spaces.size());
+
+		ts.reset_query_counts();
+		xrt_space_overseer_locate_spaces(ts.xso, ts.xso->semantic.view, &base_offset, at_timestamp_ns,
+		                                 ts.spaces.data(), (uint32_t)ts.spaces.size(), ts.offsets.data(),
+		                                 batch.data());
+
+		// Two inputs per controller and the head for the base.
+		CHECK(ts.head.query_count == 1);
+		CHECK(ts.left.query_count == 2);
+		CHECK(ts.right.query_count == 2);
+	}
+
+	SECTION("null spaces")
+	{
+		xrt_space *spaces[2] = {NULL, ts.spaces[0]};
+		xrt_space_relation batch[2];
+
+		xrt_space_overseer_locate_spaces(ts.xso, ts.xso->semantic.local, &base_offset, at_timestamp_ns, spaces, 2,
+		                                 ts.offsets.data(), batch);
+
+		CHECK(batch[0].relation_flags == 0);
+		CHECK(batch[1].relation_flags != 0);
+	}
+}
+
+TEST_CASE("space_overseer_pose_memo")
+{
+	test_setup ts;
+
+	xrt_pose identity = XRT_POSE_IDENTITY;
+	xrt_space_relation first = XRT_SPACE_RELATION_ZERO;
+	xrt_space_relation second = XRT_SPACE_RELATION_ZERO;
+
+	// Only queries the head.
+	auto locate_view = [&](uint64_t at_timestamp_ns, xrt_space_relation &out_relation) {
+		xrt_space_overseer_locate_space(ts.xso, ts.xso->semantic.local, &identity, at_timestamp_ns,
+		                                ts.xso->semantic.view, &identity, &out_relation);
+	};
+
+	SECTION("not used without a tracking generation")
+	{
+		ts.reset_query_counts();
+
+		locate_view(1000, first);
+		locate_view(1000, second);
+		CHECK(ts.head.query_count == 2);
+		check_relations(first, second);
+	}
+
+	SECTION("reused until the tracking generation changes")
+	{
+		ts.head.base.tracking_generation = 1;
+		ts.reset_query_counts();
+
+		// Same timestamp and generation is only asked once.
+		locate_view(1000, first);
+		locate_view(1000, second);
+		CHECK(ts.head.query_count == 1);
+		check_relations(first, second);
+
+		// New timestamp, must ask the device again.
+		locate_view(1500, second);
+		CHECK(ts.head.query_count == 2);
+		CHECK(second.pose.position.y != Approx(first.pose.position.y));
+
+		// New tracking data, must ask the device again for the same timestamp.
+		ts.head.pose.position.x += 1.0f;
+		xrt_atomic_u64_inc_return(&ts.head.base.tracking_generation);
+		locate_view(1000, second);
+		CHECK(ts.head.query_count == 3);
+		CHECK(second.pose.position.x != Approx(first.pose.position.x));
+	}
+}
+
+TEST_CASE("space_overseer_locate_spaces_throughput", "[.][benchmark]")
+{
+	uint32_t count = GENERATE(1, 4, 16, 64);
+
+	test_setup ts;
+	ts.add_spaces(count);
+
+	xrt_pose base_offset = XRT_POSE_IDENTITY;
+	std::vector<xrt_space_relation> results(count);
+
+	BENCHMARK("locate_space x" + std::to_string(count))
+	{
+		for (uint32_t i = 0; i < count; i++) {
+			xrt_space_overseer_locate_space(ts.xso, ts.xso->semantic.local, &base_offset, 1000, ts.spaces[i],
+			                                &ts.offsets[i], &results[i]);
+		}
+		return results[0].pose.position.x;
+	};
+
+	BENCHMARK("locate_spaces x" + std::to_string(count))
+	{
+		xrt_space_overseer_locate_spaces(ts.xso, ts.xso->semantic.local, &base_offset, 1000, ts.spaces.data(),
+		                                 count, ts.offsets.data(), results.data());
+		return results[0].pose.position.x;
+	};
+}